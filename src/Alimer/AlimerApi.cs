@@ -87,6 +87,9 @@ private static bool TryResolveLibrary(string libraryName, Assembly assembly, Dll
     } 
 #endif
 
+    [LibraryImport(LibraryName)]
+    public static partial void alimerShutdown();
+
     [LibraryImport(LibraryName)]
     public static partial LogLevel alimerGetLogLevel();
     [LibraryImport(LibraryName)]
@@ -616,4 +619,127 @@ public static void ktxTexture_Destroy(ktxTexture* This)
     [LibraryImport(LibraryName)]
     public static partial void alimerFontGetPixels(nint font, void* dest, int glyph, int width, int height, float scale);
     #endregion
+
+    #region Scene
+    public struct SceneNode
+    {
+        public byte* name;
+        public int meshIndex;
+        public int parentIndex;
+        public int skinIndex;
+        public Vector3 translation;
+        public Vector4 rotation;
+        public Vector3 scale;
+    }
+
+    public struct Scene
+    {
+        public uint meshCount;
+        public uint materialCount;
+        public uint nodeCount;
+        public uint skinCount;
+        public uint animationCount;
+        public uint imageCount;
+
+        public nint meshes;
+        public nint materials;
+        public SceneNode* nodes;
+        public nint skins;
+        public nint animations;
+        public nint images;
+
+        public ulong contentHash;
+    }
+
+    public struct SceneRayHit
+    {
+        public uint primitiveIndex;
+        public float distance;
+        public float u;
+        public float v;
+    }
+
+    public struct SceneImportOptions
+    {
+        public delegate* unmanaged<byte*, void**, nuint*, nint, Bool8> fileRead;
+        public delegate* unmanaged<void*, nuint, nint, void> fileRelease;
+        public delegate* unmanaged<byte*, ulong*, ulong*, nint, Bool8> fileStat;
+        public nint fileUserData;
+        public Bool8 decodeImages;
+    }
+
+    [LibraryImport(LibraryName)]
+    public static partial Scene* alimerSceneCreateFromMemory(void* data, nuint dataSize);
+
+    [LibraryImport(LibraryName)]
+    public static partial Scene* alimerSceneCreateFromMemoryWithOptions(void* data, nuint dataSize, SceneImportOptions* options);
+
+    [LibraryImport(LibraryName)]
+    public static partial void alimerSceneDestroy(Scene* scene);
+
+    [LibraryImport(LibraryName, StringMarshalling = StringMarshalling.Utf8)]
+    [return: MarshalAs(UnmanagedType.U1)]
+    public static partial bool alimerSceneSave(Scene* scene, string path);
+
+    [LibraryImport(LibraryName, StringMarshalling = StringMarshalling.Utf8)]
+    public static partial Scene* alimerSceneLoadCached(string cachePath, void* sourceData, nuint sourceDataSize, SceneImportOptions* options);
+
+    [LibraryImport(LibraryName)]
+    public static partial nint alimerTransformHierarchyCreate(uint nodeCount, int* parentIndices);
+
+    [LibraryImport(LibraryName)]
+    public static partial nint alimerTransformHierarchyCreateFromScene(Scene* scene);
+
+    [LibraryImport(LibraryName)]
+    public static partial void alimerTransformHierarchyDestroy(nint hierarchy);
+
+    [LibraryImport(LibraryName)]
+    public static partial uint alimerTransformHierarchyGetNodeCount(nint hierarchy);
+
+    [LibraryImport(LibraryName)]
+    public static partial void alimerTransformHierarchySetLocal(nint hierarchy, uint nodeIndex, Vector3* translation, Vector4* rotation, Vector3* scale);
+
+    [LibraryImport(LibraryName)]
+    public static partial void alimerTransformHierarchyGetLocal(nint hierarchy, uint nodeIndex, Vector3* translation, Vector4* rotation, Vector3* scale);
+
+    [LibraryImport(LibraryName)]
+    public static partial void alimerTransformHierarchyUpdate(nint hierarchy);
+
+    [LibraryImport(LibraryName)]
+    public static partial Matrix4x4* alimerTransformHierarchyGetWorldMatrices(nint hierarchy);
+
+    [LibraryImport(LibraryName)]
+    public static partial nint alimerAnimationInstanceCreate(Scene* scene, uint animationIndex);
+
+    [LibraryImport(LibraryName)]
+    public static partial void alimerAnimationInstanceDestroy(nint instance);
+
+    [LibraryImport(LibraryName)]
+    public static partial float alimerAnimationInstanceGetDuration(nint instance);
+
+    [LibraryImport(LibraryName)]
+    public static partial void alimerAnimationSample(uint count, nint* instances, float* times, [MarshalAs(UnmanagedType.U1)] bool loop, nint* hierarchies);
+
+    [LibraryImport(LibraryName)]
+    public static partial nint alimerSceneBVHCreate(uint count, Vector3* boundsMin, Vector3* boundsMax);
+
+    [LibraryImport(LibraryName)]
+    public static partial nint alimerSceneBVHCreateFromMesh(nint mesh);
+
+    [LibraryImport(LibraryName)]
+    public static partial void alimerSceneBVHDestroy(nint bvh);
+
+    [LibraryImport(LibraryName)]
+    public static partial uint alimerSceneBVHGetNodeCount(nint bvh);
+
+    [LibraryImport(LibraryName)]
+    [return: MarshalAs(UnmanagedType.U1)]
+    public static partial bool alimerSceneBVHRaycast(nint bvh, Vector3* origin, Vector3* direction, float maxDistance, SceneRayHit* hit);
+
+    [LibraryImport(LibraryName)]
+    public static partial uint alimerSceneBVHQueryFrustum(nint bvh, Vector4* planes, uint* results, uint maxResults);
+
+    [LibraryImport(LibraryName)]
+    public static partial uint alimerSceneBVHQueryBounds(nint bvh, Vector3* boundsMin, Vector3* boundsMax, uint* results, uint maxResults);
+    #endregion
 }
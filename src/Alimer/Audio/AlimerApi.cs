@@ -17,6 +17,7 @@ unsafe partial class AlimerApi
 
     public struct AudioConfig
     {
+        public AudioDevice playbackDevice;
         /// <summary>
         /// Audio output channel count.
         /// </summary>
@@ -25,6 +26,22 @@ public struct AudioConfig
         /// Audio output sample rate.
         /// </summary>
         public uint sampleRate;
+        /// <summary>
+        /// Audio decoded ahead by the streaming thread for every streaming source.
+        /// </summary>
+        public uint streamBufferMilliseconds;
+        /// <summary>
+        /// Maximum number of sources mixed at once, 0 uses the default.
+        /// </summary>
+        public uint maxRealVoices;
+        /// <summary>
+        /// Resampler used by sources (0 = linear, 1 = polyphase).
+        /// </summary>
+        public uint resampler;
+        /// <summary>
+        /// Don't open a playback device, the engine is mixed with <see cref="alimerAudioEngineRender"/>.
+        /// </summary>
+        public Bool8 offline;
     }
     #endregion
 
@@ -119,6 +136,21 @@ public struct AudioConfig
     public static partial int alimerAudioEngineGetChannelCount(AudioEngine engine);
     [LibraryImport(LibraryName)]
     public static partial int alimerAudioEngineGetSampleRate(AudioEngine engine);
+    [LibraryImport(LibraryName)]
+    public static partial ulong alimerAudioEngineGetTimeInPCMFrames(AudioEngine engine);
+
+    [LibraryImport(LibraryName)]
+    [return: MarshalAs(UnmanagedType.U1)]
+    public static partial bool alimerAudioEngineIsOffline(AudioEngine engine);
+    [LibraryImport(LibraryName)]
+    public static partial ulong alimerAudioEngineRender(AudioEngine engine, float* output, ulong frameCount);
+
+    [LibraryImport(LibraryName)]
+    public static partial void alimerAudioEngineUpdate(AudioEngine engine);
+    [LibraryImport(LibraryName)]
+    public static partial uint alimerAudioEngineGetMaxRealVoices(AudioEngine engine);
+    [LibraryImport(LibraryName)]
+    public static partial uint alimerAudioEngineGetRealVoiceCount(AudioEngine engine);
 
     /* AudioClip */
     [LibraryImport(LibraryName, StringMarshalling = StringMarshalling.Utf8)]
@@ -144,5 +176,7 @@ public struct AudioConfig
     [LibraryImport(LibraryName)]
     [return: MarshalAs(UnmanagedType.U1)]
     public static partial bool alimerAudioSourceIsPlaying(nint source);
+    [LibraryImport(LibraryName)]
+    public static partial void alimerAudioSourceSetSpatializationEnabled(nint source, [MarshalAs(UnmanagedType.U1)] bool value);
 
 }
@@ -156,6 +156,7 @@ protected override void Dispose(bool disposing)
         GraphicsManager.Dispose();
         AudioSystem.Shutdown();
         _platform.Destroy();
+        AlimerApi.alimerShutdown();
     }
 
     public virtual void ConfigureServices(IServiceRegistry services)
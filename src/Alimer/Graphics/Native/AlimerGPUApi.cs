@@ -31,6 +31,73 @@ public enum GPULogLevel
 
         Count
     }
+
+    public enum GPUMapMode
+    {
+        Read = 0,
+        Write = 1,
+    }
+
+    public enum GPUMapAsyncStatus
+    {
+        Success = 0,
+        Error = 1,
+        Aborted = 2,
+    }
+
+    public enum GPUBufferMapState
+    {
+        Unmapped = 0,
+        Pending = 1,
+        Mapped = 2,
+    }
+
+    [Flags]
+    public enum GPUBufferUsage : uint
+    {
+        None = 0,
+        Vertex = 1 << 0,
+        Index = 1 << 1,
+        Constant = 1 << 2,
+        ShaderRead = 1 << 3,
+        ShaderWrite = 1 << 4,
+        Indirect = 1 << 5,
+        Predication = 1 << 6,
+        RayTracing = 1 << 7,
+    }
+
+    public enum GPUCompareFunction
+    {
+        Undefined = 0,
+        Never,
+        Less,
+        Equal,
+        LessEqual,
+        Greater,
+        NotEqual,
+        GreaterEqual,
+        Always,
+    }
+
+    public enum GPUSamplerMinMagFilter
+    {
+        Nearest = 0,
+        Linear = 1,
+    }
+
+    public enum GPUSamplerMipFilter
+    {
+        Nearest = 0,
+        Linear = 1,
+    }
+
+    public enum GPUSamplerAddressMode
+    {
+        ClampToEdge = 0,
+        MirrorClampToEdge = 1,
+        Repeat = 2,
+        MirrorRepeat = 3,
+    }
     #endregion
 
     #region Structs
@@ -124,12 +191,43 @@ public struct GPUDeviceDesc
     {
         public byte* label;
         public uint maxFramesInFlight/* = 2*/;
+        public void* pipelineCacheData;
+        public nuint pipelineCacheDataSize;
+        public byte* pipelineCachePath;
     }
 
     public struct GPUCommandBufferDesc
     {
         public byte* label;
     }
+
+    public struct GPUBufferDesc
+    {
+        public byte* label;
+        public ulong size;
+        public GPUBufferUsage usage;
+        public MemoryType memoryType;
+    }
+
+    public struct GPUSamplerDesc
+    {
+        public byte* label;
+        public GPUSamplerMinMagFilter minFilter;
+        public GPUSamplerMinMagFilter magFilter;
+        public GPUSamplerMipFilter mipFilter;
+        public GPUSamplerAddressMode addressModeU;
+        public GPUSamplerAddressMode addressModeV;
+        public GPUSamplerAddressMode addressModeW;
+        public ushort maxAnisotropy;
+        public GPUCompareFunction compareFunction;
+        public float lodMinClamp;
+        public float lodMaxClamp;
+    }
+
+    public struct GPUCopyPassDesc
+    {
+        public byte* label;
+    }
     #endregion
 
     #region Handles
@@ -293,6 +391,75 @@ public struct GPUCommandBufferDesc
         public override readonly int GetHashCode() => Handle.GetHashCode();
         private readonly string DebuggerDisplay => $"{nameof(GPUCommandBuffer)} [0x{Handle:X}]";
     }
+
+    [DebuggerDisplay("{DebuggerDisplay,nq}")]
+    public readonly partial struct GPUCopyPassEncoder(nint handle) : IEquatable<GPUCopyPassEncoder>
+    {
+        public nint Handle { get; } = handle;
+        public readonly bool IsNull => Handle == 0;
+        public readonly bool IsNotNull => Handle != 0;
+
+        public static GPUCopyPassEncoder Null => new(0);
+        public static implicit operator GPUCopyPassEncoder(nint handle) => new(handle);
+        public static implicit operator nint(GPUCopyPassEncoder handle) => handle.Handle;
+
+        public static bool operator ==(GPUCopyPassEncoder left, GPUCopyPassEncoder right) => left.Handle == right.Handle;
+        public static bool operator !=(GPUCopyPassEncoder left, GPUCopyPassEncoder right) => left.Handle != right.Handle;
+        public static bool operator ==(GPUCopyPassEncoder left, nint right) => left.Handle == right;
+        public static bool operator !=(GPUCopyPassEncoder left, nint right) => left.Handle != right;
+        public bool Equals(GPUCopyPassEncoder other) => Handle == other.Handle;
+        /// <inheritdoc/>
+        public override bool Equals([NotNullWhen(true)] object? obj) => obj is GPUCopyPassEncoder handle && Equals(handle);
+        /// <inheritdoc/>
+        public override readonly int GetHashCode() => Handle.GetHashCode();
+        private readonly string DebuggerDisplay => $"{nameof(GPUCopyPassEncoder)} [0x{Handle:X}]";
+    }
+
+    [DebuggerDisplay("{DebuggerDisplay,nq}")]
+    public readonly partial struct GPUBuffer(nint handle) : IEquatable<GPUBuffer>
+    {
+        public nint Handle { get; } = handle;
+        public readonly bool IsNull => Handle == 0;
+        public readonly bool IsNotNull => Handle != 0;
+
+        public static GPUBuffer Null => new(0);
+        public static implicit operator GPUBuffer(nint handle) => new(handle);
+        public static implicit operator nint(GPUBuffer handle) => handle.Handle;
+
+        public static bool operator ==(GPUBuffer left, GPUBuffer right) => left.Handle == right.Handle;
+        public static bool operator !=(GPUBuffer left, GPUBuffer right) => left.Handle != right.Handle;
+        public static bool operator ==(GPUBuffer left, nint right) => left.Handle == right;
+        public static bool operator !=(GPUBuffer left, nint right) => left.Handle != right;
+        public bool Equals(GPUBuffer other) => Handle == other.Handle;
+        /// <inheritdoc/>
+        public override bool Equals([NotNullWhen(true)] object? obj) => obj is GPUBuffer handle && Equals(handle);
+        /// <inheritdoc/>
+        public override readonly int GetHashCode() => Handle.GetHashCode();
+        private readonly string DebuggerDisplay => $"{nameof(GPUBuffer)} [0x{Handle:X}]";
+    }
+
+    [DebuggerDisplay("{DebuggerDisplay,nq}")]
+    public readonly partial struct GPUSampler(nint handle) : IEquatable<GPUSampler>
+    {
+        public nint Handle { get; } = handle;
+        public readonly bool IsNull => Handle == 0;
+        public readonly bool IsNotNull => Handle != 0;
+
+        public static GPUSampler Null => new(0);
+        public static implicit operator GPUSampler(nint handle) => new(handle);
+        public static implicit operator nint(GPUSampler handle) => handle.Handle;
+
+        public static bool operator ==(GPUSampler left, GPUSampler right) => left.Handle == right.Handle;
+        public static bool operator !=(GPUSampler left, GPUSampler right) => left.Handle != right.Handle;
+        public static bool operator ==(GPUSampler left, nint right) => left.Handle == right;
+        public static bool operator !=(GPUSampler left, nint right) => left.Handle != right;
+        public bool Equals(GPUSampler other) => Handle == other.Handle;
+        /// <inheritdoc/>
+        public override bool Equals([NotNullWhen(true)] object? obj) => obj is GPUSampler handle && Equals(handle);
+        /// <inheritdoc/>
+        public override readonly int GetHashCode() => Handle.GetHashCode();
+        private readonly string DebuggerDisplay => $"{nameof(GPUSampler)} [0x{Handle:X}]";
+    }
     #endregion
 
     [LibraryImport(LibraryName)]
@@ -381,6 +548,19 @@ public struct GPUCommandBufferDesc
     /// Commit the current frame and advance to next frame
     [LibraryImport(LibraryName)]
     public static partial ulong agpuDeviceCommitFrame(GPUDevice device);
+    [LibraryImport(LibraryName)]
+    public static partial void agpuDeviceProcessEvents(GPUDevice device);
+
+    [LibraryImport(LibraryName)]
+    [return: MarshalAs(UnmanagedType.U1)]
+    public static partial bool agpuDeviceIsUploadComplete(GPUDevice device, ulong ticket);
+    [LibraryImport(LibraryName)]
+    public static partial void agpuDeviceWaitUpload(GPUDevice device, ulong ticket);
+
+    [LibraryImport(LibraryName)]
+    public static partial GPUBuffer agpuDeviceCreateBuffer(GPUDevice device, GPUBufferDesc* desc, void* initialData);
+    [LibraryImport(LibraryName)]
+    public static partial GPUSampler agpuDeviceCreateSampler(GPUDevice device, GPUSamplerDesc* desc);
     #endregion
 
     #region CommandQueue
@@ -395,5 +575,53 @@ public struct GPUCommandBufferDesc
 
     [LibraryImport(LibraryName)]
     public static partial void agpuCommandQueueSubmit(GPUCommandQueue queue, int numCommandBuffers, GPUCommandBuffer* commandBuffers);
+
+    [LibraryImport(LibraryName)]
+    public static partial ulong agpuCommandQueueWriteBuffer(GPUCommandQueue queue, GPUBuffer buffer, ulong bufferOffset, void* data, ulong size);
+    #endregion
+
+    #region CommandBuffer
+    [LibraryImport(LibraryName)]
+    public static partial GPUCopyPassEncoder agpuCommandBufferBeginCopyPass(GPUCommandBuffer commandBuffer, GPUCopyPassDesc* desc);
+
+    [LibraryImport(LibraryName)]
+    public static partial void agpuCommandBufferWaitUpload(GPUCommandBuffer commandBuffer, ulong ticket);
+
+    [LibraryImport(LibraryName)]
+    public static partial void agpuCopyPassEncoderCopyBufferToBuffer(GPUCopyPassEncoder copyPassEncoder, GPUBuffer source, ulong sourceOffset, GPUBuffer destination, ulong destinationOffset, ulong size);
+
+    [LibraryImport(LibraryName)]
+    public static partial void agpuCopyPassEncoderEnd(GPUCopyPassEncoder copyPassEncoder);
+    #endregion
+
+    #region Buffer
+    [LibraryImport(LibraryName)]
+    public static partial uint agpuBufferAddRef(GPUBuffer buffer);
+
+    [LibraryImport(LibraryName)]
+    public static partial uint agpuBufferRelease(GPUBuffer buffer);
+
+    [LibraryImport(LibraryName)]
+    public static partial ulong agpuBufferGetSize(GPUBuffer buffer);
+
+    [LibraryImport(LibraryName)]
+    public static partial void agpuBufferMapAsync(GPUBuffer buffer, GPUMapMode mode, ulong offset, ulong size, delegate* unmanaged<GPUMapAsyncStatus, nint, void> callback, nint userData);
+
+    [LibraryImport(LibraryName)]
+    public static partial GPUBufferMapState agpuBufferGetMapState(GPUBuffer buffer);
+
+    [LibraryImport(LibraryName)]
+    public static partial void* agpuBufferGetConstMappedRange(GPUBuffer buffer, ulong offset, ulong size);
+
+    [LibraryImport(LibraryName)]
+    public static partial void agpuBufferUnmap(GPUBuffer buffer);
+    #endregion
+
+    #region Sampler
+    [LibraryImport(LibraryName)]
+    public static partial uint agpuSamplerAddRef(GPUSampler sampler);
+
+    [LibraryImport(LibraryName)]
+    public static partial uint agpuSamplerRelease(GPUSampler sampler);
     #endregion
 }
@@ -234,10 +234,14 @@ typedef struct Blob {
     void* data;
     size_t size;
     char* name;
+    /// False for views created with alimerBlobCreateView, the data is not freed with the blob.
+    Bool32 ownsData;
 } Blob;
 
 /* Platform */
 ALIMER_API void alimerGetVersion(uint32_t* major, uint32_t* minor, uint32_t* patch);
+/// Stops the job system workers, call before unloading the library. Jobs queued afterwards run on the calling thread.
+ALIMER_API void alimerShutdown(void);
 
 /* Memory */
 ALIMER_API void* alimerCalloc(size_t count, size_t size);
@@ -263,6 +267,8 @@ ALIMER_API void alimerLogTrace(LogCategory category, const char* format, ...);
 
 /* Blog */
 ALIMER_API Blob* alimerBlobCreate(void* data, size_t size, const char* name);
+/// Create a blob referencing memory owned by someone else, which must outlive the blob.
+ALIMER_API Blob* alimerBlobCreateView(const void* data, size_t size, const char* name);
 ALIMER_API void alimerBlobDestroy(Blob* blob);
 
 /* PixelFormat */
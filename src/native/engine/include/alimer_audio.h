@@ -4,13 +4,17 @@
 #ifndef ALIMER_AUDIO_H_
 #define ALIMER_AUDIO_H_ 1
 
-#include "alimer_platform.h"
+#include "alimer.h"
+
+#define AUDIO_PROFILE_HISTOGRAM_SIZE 16
 
 /* Forward */
 typedef struct AudioDevice AudioDevice;
 typedef struct AudioEngine AudioEngine;
 typedef struct AudioClip AudioClip;
 typedef struct AudioSource AudioSource;
+typedef struct AudioBus AudioBus;
+typedef struct AudioEffect AudioEffect;
 
 /* Enums */
 typedef enum AudioDeviceType {
@@ -76,6 +80,41 @@ typedef enum AudioPositioning {
     _AudioPositioning_Force32 = 0x7FFFFFFF
 } AudioPositioning;
 
+typedef enum AudioClipMode {
+    /// Decompress short clips, stream long ones.
+    AudioClipMode_Auto,
+    /// Decode once into memory shared by every source, best for short and frequently played sounds.
+    AudioClipMode_Decompressed,
+    /// Every source decodes on its own while playing, best for music and long ambiences.
+    AudioClipMode_Streaming,
+
+    _AudioClipMode_Count,
+    _AudioClipMode_Force32 = 0x7FFFFFFF
+} AudioClipMode;
+
+typedef enum AudioResampler {
+    /// Linear interpolation, cheapest and used by default.
+    AudioResampler_Linear,
+    /// 16 tap windowed sinc filter, cleaner pitch shifts and sample rate conversion.
+    AudioResampler_Polyphase,
+
+    _AudioResampler_Count,
+    _AudioResampler_Force32 = 0x7FFFFFFF
+} AudioResampler;
+
+typedef enum AudioEffectType {
+    AudioEffectType_LowPass,
+    AudioEffectType_HighPass,
+    AudioEffectType_Reverb,
+    /// Reduces the level above the threshold, follows the sidechain bus instead when set (ducking).
+    AudioEffectType_Compressor,
+    /// Compressor with an infinite ratio and instant attack, keeps the peaks under the threshold.
+    AudioEffectType_Limiter,
+
+    _AudioEffectType_Count,
+    _AudioEffectType_Force32 = 0x7FFFFFFF
+} AudioEffectType;
+
 /* Structs */
 typedef struct AudioConfig {
     AudioDevice* playbackDevice DEFAULT_INITIALIZER(nullptr);
@@ -83,8 +122,89 @@ typedef struct AudioConfig {
     uint32_t channelCount DEFAULT_INITIALIZER(2);
     /// Audio output sample rate.
     uint32_t sampleRate DEFAULT_INITIALIZER(48000);
+    /// Audio decoded ahead by the streaming thread for every streaming source.
+    uint32_t streamBufferMilliseconds DEFAULT_INITIALIZER(500);
+    /// Maximum number of sources mixed at once, alimerAudioEngineUpdate virtualizes the others (0 uses the default).
+    uint32_t maxRealVoices DEFAULT_INITIALIZER(64);
+    /// Resampler used by sources for pitch, doppler and sample rate conversion.
+    AudioResampler resampler DEFAULT_INITIALIZER(AudioResampler_Linear);
+    /// Don't open a playback device, the engine is mixed with alimerAudioEngineRender faster than real time.
+    /// playbackDevice is ignored and alimerAudioInit is not required.
+    bool offline DEFAULT_INITIALIZER(false);
 } AudioConfig;
 
+typedef struct AudioClipCacheStats {
+    uint64_t hitCount;
+    uint64_t missCount;
+    uint64_t evictionCount;
+    uint32_t clipCount;
+    /// Decoded samples and encoded data kept alive by the cached clips.
+    uint64_t residentSize;
+    uint64_t budget;
+} AudioClipCacheStats;
+
+/// Audio thread timings since the engine was created or the profile reset, times are in nanoseconds.
+typedef struct AudioEngineProfile {
+    uint64_t callbackCount;
+    /// Callbacks that took longer than the audio they produced.
+    uint64_t overrunCount;
+    uint32_t streamUnderrunCount;
+    uint64_t callbackTime;
+    uint64_t maxCallbackTime;
+    /// Callback time split in applying game thread commands, computing the spatialization gains and mixing the node graph.
+    uint64_t commandTime;
+    uint64_t spatializationTime;
+    uint64_t mixTime;
+    /* Detailed profiling only: part of mixTime spent in voices and effects, and streaming thread decode time. */
+    uint64_t voiceTime;
+    uint64_t effectTime;
+    uint64_t decodeTime;
+    /// Callback time over the duration of the audio it produced.
+    float averageUtilization;
+    float peakUtilization;
+    /// Callbacks shorter than 32 << i microseconds, the last bucket counts the longer ones.
+    uint32_t histogram[AUDIO_PROFILE_HISTOGRAM_SIZE];
+    uint32_t droppedEventCount;
+} AudioEngineProfile;
+
+/// One audio callback, recorded while detailed profiling is enabled.
+typedef struct AudioProfileEvent {
+    /// Steady clock time at the start of the callback, in nanoseconds.
+    uint64_t timestamp;
+    uint64_t duration;
+    /// Duration of the audio produced by the callback.
+    uint64_t period;
+    uint32_t frameCount;
+    /// Playing voices mixed by the callback.
+    uint32_t voiceCount;
+} AudioProfileEvent;
+
+typedef struct AudioEffectDesc {
+    AudioEffectType type DEFAULT_INITIALIZER(AudioEffectType_LowPass);
+
+    /* LowPass and HighPass */
+    float cutoffFrequency DEFAULT_INITIALIZER(1000.0f);
+    /// Filter order, fixed at creation (1 to 8).
+    uint32_t filterOrder DEFAULT_INITIALIZER(2);
+
+    /* Reverb */
+    float roomSize DEFAULT_INITIALIZER(0.5f);
+    float damping DEFAULT_INITIALIZER(0.5f);
+    /// Stereo width of the reverb tail.
+    float width DEFAULT_INITIALIZER(1.0f);
+    float wetLevel DEFAULT_INITIALIZER(0.33f);
+    float dryLevel DEFAULT_INITIALIZER(1.0f);
+
+    /* Compressor and Limiter */
+    float thresholdDecibels DEFAULT_INITIALIZER(-12.0f);
+    float ratio DEFAULT_INITIALIZER(4.0f);
+    float attackMilliseconds DEFAULT_INITIALIZER(10.0f);
+    float releaseMilliseconds DEFAULT_INITIALIZER(100.0f);
+    float makeupGainDecibels DEFAULT_INITIALIZER(0.0f);
+    /// Bus whose level drives the gain reduction instead of the input (ducking), fixed at creation.
+    AudioBus* sidechain DEFAULT_INITIALIZER(nullptr);
+} AudioEffectDesc;
+
 /* Callbacks */
 typedef void AudioDeviceCallback(AudioDevice* device, void* userdata);
 
@@ -115,6 +235,33 @@ ALIMER_API uint64_t alimerAudioEngineGetTimeInPCMFrames(AudioEngine* engine);
 ALIMER_API uint64_t alimerAudioEngineGetTimeInMilliseconds(AudioEngine* engine);
 ALIMER_API void alimerAudioEngineSetTimeInPCMFrames(AudioEngine* engine, uint64_t value);
 ALIMER_API void alimerAudioEngineSetTimeInMilliseconds(AudioEngine* engine, uint64_t value);
+/// Number of audio callbacks in which a streaming source ran out of decoded data.
+ALIMER_API uint32_t alimerAudioEngineGetStreamUnderrunCount(AudioEngine* engine);
+
+/* Profiling */
+ALIMER_API void alimerAudioEngineGetProfile(AudioEngine* engine, AudioEngineProfile* result);
+ALIMER_API void alimerAudioEngineResetProfile(AudioEngine* engine);
+/// Detailed profiling also times every voice, effect and streaming decode and records one event per callback.
+ALIMER_API bool alimerAudioEngineIsProfilingEnabled(AudioEngine* engine);
+ALIMER_API void alimerAudioEngineSetProfilingEnabled(AudioEngine* engine, bool enabled);
+/// Drain the recorded callback events (up to 1024 are kept), for trace output. Call from a single thread.
+ALIMER_API uint32_t alimerAudioEngineReadProfileEvents(AudioEngine* engine, AudioProfileEvent* events, uint32_t maxCount);
+
+/* Offline rendering */
+ALIMER_API bool alimerAudioEngineIsOffline(AudioEngine* engine);
+/// Mix the next frameCount interleaved float frames of an offline engine into output.
+/// The engine clock only advances here, by exactly frameCount, and streaming sources are decoded in step.
+ALIMER_API uint64_t alimerAudioEngineRender(AudioEngine* engine, float* output, uint64_t frameCount);
+/// Render the next frameCount frames of an offline engine into a 32-bit float WAV file.
+ALIMER_API bool alimerAudioEngineRenderToFile(AudioEngine* engine, const char* path, uint64_t frameCount);
+
+/// Rank the playing sources by priority and audibility, the most important ones are mixed and the others are virtualized.
+/// Virtual sources keep advancing their cursor without being decoded or mixed. Call once per frame.
+ALIMER_API void alimerAudioEngineUpdate(AudioEngine* engine);
+ALIMER_API uint32_t alimerAudioEngineGetMaxRealVoices(AudioEngine* engine);
+ALIMER_API void alimerAudioEngineSetMaxRealVoices(AudioEngine* engine, uint32_t value);
+ALIMER_API uint32_t alimerAudioEngineGetRealVoiceCount(AudioEngine* engine);
+ALIMER_API uint32_t alimerAudioEngineGetVirtualVoiceCount(AudioEngine* engine);
 
 /* AudioListener */
 ALIMER_API uint32_t alimerAudioEngineGetListenerCount(AudioEngine* engine);
@@ -125,7 +272,13 @@ ALIMER_API void alimerAudioEngineListenerSetEnabled(AudioEngine* engine, uint32_
 
 /* AudioClip */
 ALIMER_API AudioClip* alimerAudioClipCreate(const char* filepath);
+/// The data is copied when the clip is streamed, it can be released after the call.
 ALIMER_API AudioClip* alimerAudioClipCreateFromMemory(const void* pData, size_t dataSize);
+ALIMER_API AudioClip* alimerAudioClipCreateWithMode(const char* filepath, AudioClipMode mode);
+ALIMER_API AudioClip* alimerAudioClipCreateFromMemoryWithMode(const void* pData, size_t dataSize, AudioClipMode mode);
+/// The clip takes ownership of the blob, streaming sources decode straight from its data.
+ALIMER_API AudioClip* alimerAudioClipCreateFromBlob(Blob* blob, AudioClipMode mode);
+ALIMER_API AudioClipMode alimerAudioClipGetMode(AudioClip* clip);
 ALIMER_API uint32_t alimerAudioClipAddRef(AudioClip* clip);
 ALIMER_API uint32_t alimerAudioClipRelease(AudioClip* clip);
 ALIMER_API AudioFormat alimerAudioClipGetFormat(AudioClip* clip);
@@ -134,6 +287,43 @@ ALIMER_API uint32_t alimerAudioClipGetSampleRate(AudioClip* clip);
 ALIMER_API uint64_t alimerAudioClipGetFrameCount(AudioClip* clip);
 ALIMER_API uint32_t alimerAudioClipGetStride(AudioClip* clip);
 
+/* AudioClip cache */
+/// Clips created from the same path, data or blob are shared while cached, a budget of 0 disables the cache.
+/// Clips no longer referenced outside the cache are evicted in LRU order once the resident size exceeds the budget,
+/// on the next clip creation, budget change or purge.
+ALIMER_API void alimerAudioClipCacheSetBudget(uint64_t sizeInBytes);
+ALIMER_API uint64_t alimerAudioClipCacheGetBudget(void);
+/// Evict every clip not referenced outside the cache.
+ALIMER_API void alimerAudioClipCachePurge(void);
+ALIMER_API void alimerAudioClipCacheGetStats(AudioClipCacheStats* stats);
+
+/* AudioBus */
+/// Buses mix their sources and child buses into one block and run their effects once on it. A null parent outputs to the engine.
+ALIMER_API AudioBus* alimerAudioBusCreate(AudioEngine* engine, AudioBus* parent);
+ALIMER_API uint32_t alimerAudioBusAddRef(AudioBus* bus);
+ALIMER_API uint32_t alimerAudioBusRelease(AudioBus* bus);
+ALIMER_API AudioBus* alimerAudioBusGetParent(AudioBus* bus);
+ALIMER_API float alimerAudioBusGetVolume(AudioBus* bus, VolumeUnit unit);
+ALIMER_API void alimerAudioBusSetVolume(AudioBus* bus, float value, VolumeUnit unit);
+/// Peak level of the last block mixed by the bus, after its effects.
+ALIMER_API float alimerAudioBusGetLevel(AudioBus* bus, VolumeUnit unit);
+/// Time spent in the effects of the bus while detailed profiling is enabled, in nanoseconds.
+ALIMER_API uint64_t alimerAudioBusGetProcessingTime(AudioBus* bus);
+/// Effects run in the order they were added, the returned effect is owned by the bus.
+ALIMER_API AudioEffect* alimerAudioBusAddEffect(AudioBus* bus, const AudioEffectDesc* desc);
+ALIMER_API void alimerAudioBusRemoveEffect(AudioBus* bus, AudioEffect* effect);
+ALIMER_API uint32_t alimerAudioBusGetEffectCount(AudioBus* bus);
+ALIMER_API AudioEffect* alimerAudioBusGetEffect(AudioBus* bus, uint32_t index);
+
+/* AudioEffect */
+ALIMER_API AudioEffectType alimerAudioEffectGetType(AudioEffect* effect);
+ALIMER_API bool alimerAudioEffectIsEnabled(AudioEffect* effect);
+/// Disabled effects pass their input through.
+ALIMER_API void alimerAudioEffectSetEnabled(AudioEffect* effect, bool enabled);
+ALIMER_API void alimerAudioEffectGetParameters(AudioEffect* effect, AudioEffectDesc* result);
+/// The type, filter order and sidechain of the effect are kept.
+ALIMER_API void alimerAudioEffectSetParameters(AudioEffect* effect, const AudioEffectDesc* desc);
+
 /* AudioSource */
 ALIMER_API AudioSource* alimerAudioSourceCreate(AudioEngine* engine, AudioClip* clip);
 ALIMER_API uint32_t alimerAudioSourceAddRef(AudioSource* source);
@@ -155,6 +345,17 @@ ALIMER_API void alimerAudioSourceSetPanMode(AudioSource* source, AudioPanMode va
 ALIMER_API float alimerAudioSourceGetPitch(const AudioSource* source);
 ALIMER_API void alimerAudioSourceSetPitch(AudioSource* source, float value);
 
+ALIMER_API AudioBus* alimerAudioSourceGetBus(const AudioSource* source);
+/// Route the source into a bus, null outputs straight to the engine.
+ALIMER_API void alimerAudioSourceSetBus(AudioSource* source, AudioBus* bus);
+
+/// Higher priority sources stay real before louder lower priority ones.
+ALIMER_API int32_t alimerAudioSourceGetPriority(const AudioSource* source);
+ALIMER_API void alimerAudioSourceSetPriority(AudioSource* source, int32_t value);
+ALIMER_API bool alimerAudioSourceIsVirtual(const AudioSource* source);
+/// Time spent decoding, resampling and spatializing the source while detailed profiling is enabled, in nanoseconds.
+ALIMER_API uint64_t alimerAudioSourceGetProcessingTime(const AudioSource* source);
+
 ALIMER_API bool alimerAudioSourceIsSpatializationEnabled(const AudioSource* source);
 ALIMER_API void alimerAudioSourceSetSpatializationEnabled(AudioSource* source, bool enabled);
 
@@ -167,6 +368,11 @@ ALIMER_API void alimerAudioSourceSetDirection(AudioSource* source, const Vector3
 ALIMER_API void alimerAudioSourceGetVelocity(const AudioSource* source, Vector3* result);
 ALIMER_API void alimerAudioSourceSetVelocity(AudioSource* source, const Vector3* value);
 
+/// Set the position, velocity and direction of count sources in one call, null arrays are left unchanged.
+/// The audio thread applies the whole batch in the same callback. Returns false without changing any source
+/// when the sources of one engine need more than 4096 commands (one per non-null array and source).
+ALIMER_API bool alimerAudioSourcesSetSpatialBatch(uint32_t count, AudioSource* const* sources, const Vector3* positions, const Vector3* velocities, const Vector3* directions);
+
 ALIMER_API AudioAttenuationModel alimerAudioSourceGetAttenuationModel(const AudioSource* source);
 ALIMER_API void alimerAudioSourceSetAttenuationModel(AudioSource* source, AudioAttenuationModel value);
 
@@ -205,6 +411,7 @@ ALIMER_API bool alimerAudioSourceIsLooping(const AudioSource* source);
 ALIMER_API bool alimerAudioSourceIsAtEnd(const AudioSource* source);
 ALIMER_API void alimerAudioSourceSeekToPCMFrame(const AudioSource* source, uint64_t frameIndex);
 ALIMER_API void alimerAudioSourceSeekToSecond(const AudioSource* source, float seekPointInSeconds);
+ALIMER_API uint32_t alimerAudioSourceGetStreamUnderrunCount(const AudioSource* source);
 ALIMER_API uint64_t alimerAudioSourceGetCursorInPCMFrames(const AudioSource* source);
 ALIMER_API uint64_t alimerAudioSourceGetLengthInPCMFrames(const AudioSource* source);
 ALIMER_API float alimerAudioSourceGetCursorInSeconds(const AudioSource* source);
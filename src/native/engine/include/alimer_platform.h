@@ -43,10 +43,30 @@ typedef uint32_t Flags;
 typedef uint32_t Bool32;
 
 /* Common types */
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+
 typedef struct Vector3 {
     float x;
     float y;
     float z;
 } Vector3;
 
+typedef struct Vector4 {
+    float x;
+    float y;
+    float z;
+    float w;
+} Vector4;
+
+/// Row-major 4x4 matrix using row vectors (translation in the last row), same layout as System.Numerics.Matrix4x4.
+typedef struct Matrix4x4 {
+    float m11, m12, m13, m14;
+    float m21, m22, m23, m24;
+    float m31, m32, m33, m34;
+    float m41, m42, m43, m44;
+} Matrix4x4;
+
 #endif /* ALIMER_PLATFORM_H_ */
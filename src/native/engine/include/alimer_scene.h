@@ -5,33 +5,243 @@
 #define ALIMER_SCENE_H_ 1
 
 #include "alimer.h"
+#include "alimer_image.h"
 
 /* Enums */
+typedef enum SceneAlphaMode {
+    SceneAlphaMode_Opaque = 0,
+    SceneAlphaMode_Mask,
+    SceneAlphaMode_Blend,
+
+    _SceneAlphaMode_Count,
+    _SceneAlphaMode_Force32 = 0x7FFFFFFF
+} SceneAlphaMode;
+
+/* Forward */
+typedef struct TransformHierarchy TransformHierarchy;
+typedef struct AnimationInstance AnimationInstance;
+typedef struct SceneBVH SceneBVH;
+
+typedef enum SceneAnimationPath {
+    SceneAnimationPath_Translation = 0,
+    SceneAnimationPath_Rotation,
+    SceneAnimationPath_Scale,
+
+    _SceneAnimationPath_Count,
+    _SceneAnimationPath_Force32 = 0x7FFFFFFF
+} SceneAnimationPath;
+
+typedef enum SceneAnimationInterpolation {
+    SceneAnimationInterpolation_Linear = 0,
+    SceneAnimationInterpolation_Step,
+    SceneAnimationInterpolation_CubicSpline,
+
+    _SceneAnimationInterpolation_Count,
+    _SceneAnimationInterpolation_Force32 = 0x7FFFFFFF
+} SceneAnimationInterpolation;
 
 /* Structs */
+typedef struct SceneSubMesh {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    /// Index into Scene::materials or -1 when the primitive has no material.
+    int32_t materialIndex;
+} SceneSubMesh;
+
 typedef struct SceneMesh {
     char* name;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t subMeshCount;
+    Vector3 boundsMin;
+    Vector3 boundsMax;
+    /// Vertex streams, null when the source mesh doesn't provide the attribute (positions are always present).
+    Vector3* positions;
+    Vector3* normals;
+    Vector4* tangents;
+    Vector2* texcoords;
+    /// Skinning streams, 4 joint indices (into SceneSkin::joints) and weights per vertex.
+    uint16_t* joints;
+    Vector4* weights;
+    uint32_t* indices;
+    SceneSubMesh* subMeshes;
 } SceneMesh;
 
+typedef struct SceneImage {
+    char* name;
+    /// External file reference, null for images embedded in the scene data.
+    char* uri;
+    char* mimeType;
+    /// Encoded bytes of embedded images, a view into the GLB or cache memory whenever possible.
+    Blob* data;
+    /// Decoded image, only when SceneImportOptions::decodeImages is set.
+    Image* image;
+} SceneImage;
+
 typedef struct SceneMaterial {
     char* name;
+    /// Texture references, indices into Scene::images or -1.
+    int32_t baseColorImage;
+    int32_t metallicRoughnessImage;
+    int32_t normalImage;
+    int32_t occlusionImage;
+    int32_t emissiveImage;
+    Vector4 baseColorFactor;
+    Vector3 emissiveFactor;
+    float metallicFactor;
+    float roughnessFactor;
+    float alphaCutoff;
+    SceneAlphaMode alphaMode;
+    Bool32 doubleSided;
 } SceneMaterial;
 
 typedef struct SceneNode {
     char* name;
+    /// Index into Scene::meshes or -1 when the node has no mesh.
+    int32_t meshIndex;
+    /// Index into Scene::nodes or -1 for root nodes.
+    int32_t parentIndex;
+    /// Index into Scene::skins or -1 when the node mesh is not skinned.
+    int32_t skinIndex;
+    /// Local transform relative to the parent node.
+    Vector3 translation;
+    Vector4 rotation;
+    Vector3 scale;
 } SceneNode;
 
+typedef struct SceneSkin {
+    char* name;
+    uint32_t jointCount;
+    /// Skeleton root node or -1.
+    int32_t skeletonIndex;
+    /// Joint node indices into Scene::nodes.
+    uint32_t* joints;
+    Matrix4x4* inverseBindMatrices;
+} SceneSkin;
+
+typedef struct SceneAnimationChannel {
+    uint32_t nodeIndex;
+    SceneAnimationPath path;
+    SceneAnimationInterpolation interpolation;
+    uint32_t keyCount;
+    /// Key times in seconds, sorted.
+    float* times;
+    /// Tightly packed Vector3 (translation, scale) or Vector4 (rotation) per key,
+    /// cubic spline channels store in-tangent, value and out-tangent for each key.
+    float* values;
+} SceneAnimationChannel;
+
+typedef struct SceneAnimation {
+    char* name;
+    float duration;
+    uint32_t channelCount;
+    SceneAnimationChannel* channels;
+} SceneAnimation;
+
+typedef struct SceneRayHit {
+    /// Triangle index (mesh BVH) or primitive index (bounds BVH).
+    uint32_t primitiveIndex;
+    float distance;
+    /// Barycentric coordinates of the hit, zero for bounds BVH.
+    float u;
+    float v;
+} SceneRayHit;
+
 typedef struct Scene {
     uint32_t meshCount;
     uint32_t materialCount;
     uint32_t nodeCount;
+    uint32_t skinCount;
+    uint32_t animationCount;
+    uint32_t imageCount;
 
     SceneMesh* meshes;
     SceneMaterial* materials;
+    /// Nodes sorted breadth-first: parents precede their children and nodes are grouped by depth.
     SceneNode* nodes;
+    SceneSkin* skins;
+    SceneAnimation* animations;
+    SceneImage* images;
+
+    /// Hash of the source data and of the path, size and modification time of the external files it references.
+    /// Only set by alimerSceneLoadCached, where it detects stale caches, zero for scenes imported directly.
+    uint64_t contentHash;
 } Scene;
 
+/* Callbacks */
+/// Read an external resource referenced by the scene (path is relative to the scene file), return false when missing.
+typedef bool (*SceneFileReadCallback)(const char* path, void** pData, size_t* pDataSize, void* userData);
+typedef void (*SceneFileReleaseCallback)(void* data, size_t dataSize, void* userData);
+/// Report the size and modification time of an external resource, return false when missing.
+typedef bool (*SceneFileStatCallback)(const char* path, uint64_t* pSize, uint64_t* pModifiedTime, void* userData);
+
+typedef struct SceneImportOptions {
+    /// Resolves external buffers and images, files are read from disk when null. Always called on the importing thread.
+    SceneFileReadCallback fileRead DEFAULT_INITIALIZER(nullptr);
+    SceneFileReleaseCallback fileRelease DEFAULT_INITIALIZER(nullptr);
+    /// Validates scene caches without reading the external files. When null with a custom fileRead,
+    /// alimerSceneLoadCached reads and hashes every external file instead.
+    SceneFileStatCallback fileStat DEFAULT_INITIALIZER(nullptr);
+    void* fileUserData DEFAULT_INITIALIZER(nullptr);
+    /// Decode referenced images on worker threads while the geometry is processed.
+    bool decodeImages DEFAULT_INITIALIZER(false);
+} SceneImportOptions;
+
+/// Embedded image views reference pData, which must outlive the scene.
 ALIMER_API Scene* alimerSceneCreateFromMemory(const void* pData, size_t dataSize);
+/// Same as alimerSceneCreateFromMemory with custom file resolution and image decoding, options can be null.
+ALIMER_API Scene* alimerSceneCreateFromMemoryWithOptions(const void* pData, size_t dataSize, const SceneImportOptions* options);
 ALIMER_API void alimerSceneDestroy(Scene* scene);
 
+/// Serialize the processed scene into a binary cache file that can be memory mapped by alimerSceneLoadCached.
+ALIMER_API bool alimerSceneSave(const Scene* scene, const char* path);
+/// Map the scene cache at cachePath. When source data is provided, the cache is validated against its content hash
+/// and rebuilt (imported from the source data and saved back to cachePath) when missing or stale.
+/// Embedded images of cached scenes reference the mapping, the source data can be released right away.
+ALIMER_API Scene* alimerSceneLoadCached(const char* cachePath, const void* pSourceData, size_t sourceDataSize, const SceneImportOptions* options);
+
+/* TransformHierarchy */
+/// Create a hierarchy from breadth-first sorted parent indices (-1 for roots), local transforms start as identity.
+ALIMER_API TransformHierarchy* alimerTransformHierarchyCreate(uint32_t nodeCount, const int32_t* parentIndices);
+/// Create a hierarchy matching Scene::nodes, including their local transforms.
+ALIMER_API TransformHierarchy* alimerTransformHierarchyCreateFromScene(const Scene* scene);
+ALIMER_API void alimerTransformHierarchyDestroy(TransformHierarchy* hierarchy);
+ALIMER_API uint32_t alimerTransformHierarchyGetNodeCount(const TransformHierarchy* hierarchy);
+ALIMER_API void alimerTransformHierarchySetLocal(TransformHierarchy* hierarchy, uint32_t nodeIndex, const Vector3* translation, const Vector4* rotation, const Vector3* scale);
+ALIMER_API void alimerTransformHierarchyGetLocal(const TransformHierarchy* hierarchy, uint32_t nodeIndex, Vector3* translation, Vector4* rotation, Vector3* scale);
+/// Update the local transform of count nodes, any of the arrays can be null to keep the current values.
+ALIMER_API void alimerTransformHierarchySetLocalBatch(TransformHierarchy* hierarchy, uint32_t count, const uint32_t* nodeIndices, const Vector3* translations, const Vector4* rotations, const Vector3* scales);
+/// Recompute the world matrices of changed nodes and their descendants, wide levels are split across worker threads.
+ALIMER_API void alimerTransformHierarchyUpdate(TransformHierarchy* hierarchy);
+/// World matrices indexed by node, valid until the hierarchy is destroyed.
+ALIMER_API const Matrix4x4* alimerTransformHierarchyGetWorldMatrices(const TransformHierarchy* hierarchy);
+
+/* Animation */
+ALIMER_API AnimationInstance* alimerAnimationInstanceCreate(const Scene* scene, uint32_t animationIndex);
+ALIMER_API void alimerAnimationInstanceDestroy(AnimationInstance* instance);
+ALIMER_API float alimerAnimationInstanceGetDuration(const AnimationInstance* instance);
+/// Sample count instances at the given times (wrapped when looping) and write the animated local transforms
+/// into the matching hierarchies, which must be distinct when instances are sampled in parallel.
+ALIMER_API void alimerAnimationSample(uint32_t count, AnimationInstance* const* instances, const float* times, bool loop, TransformHierarchy* const* hierarchies);
+/// Compute skinning matrices (inverse bind matrix * joint world matrix) for count updated hierarchies,
+/// palettes are written one after the other with SceneSkin::jointCount matrices each.
+ALIMER_API void alimerSceneSkinComputeJointMatrices(const Scene* scene, uint32_t skinIndex, uint32_t count, const TransformHierarchy* const* hierarchies, Matrix4x4* palettes);
+
+/* SceneBVH */
+/// Build a BVH over arbitrary bounds (for example node bounds), primitives with empty bounds (min > max) are skipped.
+ALIMER_API SceneBVH* alimerSceneBVHCreate(uint32_t count, const Vector3* boundsMin, const Vector3* boundsMax);
+/// Build a BVH over the triangles of a mesh, in mesh local space.
+ALIMER_API SceneBVH* alimerSceneBVHCreateFromMesh(const SceneMesh* mesh);
+ALIMER_API void alimerSceneBVHDestroy(SceneBVH* bvh);
+ALIMER_API uint32_t alimerSceneBVHGetNodeCount(const SceneBVH* bvh);
+/// Find the closest hit along the ray within maxDistance, direction doesn't need to be normalized (distance is in direction units).
+ALIMER_API bool alimerSceneBVHRaycast(const SceneBVH* bvh, const Vector3* origin, const Vector3* direction, float maxDistance, SceneRayHit* hit);
+/// Collect primitives intersecting the frustum planes (xyz = normal pointing inside, w = distance).
+/// Returns the total number of primitives found, at most maxResults are written to results.
+ALIMER_API uint32_t alimerSceneBVHQueryFrustum(const SceneBVH* bvh, const Vector4 planes[6], uint32_t* results, uint32_t maxResults);
+/// Collect primitives overlapping the box, returns the total count like alimerSceneBVHQueryFrustum.
+ALIMER_API uint32_t alimerSceneBVHQueryBounds(const SceneBVH* bvh, const Vector3* boundsMin, const Vector3* boundsMax, uint32_t* results, uint32_t maxResults);
+/// World space bounds of the nodes with a mesh, other nodes get empty bounds. Arrays hold Scene::nodeCount elements.
+ALIMER_API void alimerSceneComputeNodeBounds(const Scene* scene, const TransformHierarchy* hierarchy, Vector3* boundsMin, Vector3* boundsMax);
+
 #endif /* ALIMER_SCENE_H_ */
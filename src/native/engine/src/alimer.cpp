@@ -4,6 +4,15 @@
 #include "alimer_internal.h"
 #include "alimer.h"
 
+#include <stdio.h>
+
+#if !defined(_WIN32)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
 #if defined(ALIMER_GPU_D3D12)
 #include <directx/dxgiformat.h>
 #else
@@ -463,6 +472,11 @@ void alimerGetVersion(uint32_t* major, uint32_t* minor, uint32_t* patch)
     if (patch) *patch = ALIMER_VERSION_PATCH;
 }
 
+void alimerShutdown(void)
+{
+    jobs::Shutdown();
+}
+
 /* Memory */
 // TODO: Add custom memory allocation
 // TODO: Add tracy profile (TracyCAlloc)
@@ -518,14 +532,23 @@ Blob* alimerBlobCreate(void* data, size_t size, const char* name)
     blob->ref = 1;
     blob->data = data;
     blob->size = size;
+    blob->ownsData = true;
     if (name)
         blob->name = _alimer_strdup(name);
     return blob;
 }
 
+Blob* alimerBlobCreateView(const void* data, size_t size, const char* name)
+{
+    Blob* blob = alimerBlobCreate(const_cast<void*>(data), size, name);
+    blob->ownsData = false;
+    return blob;
+}
+
 void alimerBlobDestroy(Blob* blob)
 {
-    alimerFree(blob->data);
+    if (blob->ownsData)
+        alimerFree(blob->data);
     alimerFree(blob->name);
     alimerFree(blob);
 }
@@ -538,6 +561,136 @@ char* _alimer_strdup(const char* source)
     return result;
 }
 
+bool _alimer_map_file(const char* path, FileMapping* mapping)
+{
+    ALIMER_ASSERT(path);
+    ALIMER_ASSERT(mapping);
+
+    memset(mapping, 0, sizeof(FileMapping));
+
+#if defined(_WIN32)
+    WCHAR* widePath = Win32_CreateWideStringFromUTF8(path);
+    if (!widePath)
+        return false;
+
+    HANDLE file = CreateFileW(widePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    alimerFree(widePath);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE fileMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!fileMapping)
+        return false;
+
+    void* data = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(fileMapping);
+        return false;
+    }
+
+    mapping->data = data;
+    mapping->size = (size_t)fileSize.QuadPart;
+    mapping->handle = fileMapping;
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    mapping->data = data;
+    mapping->size = (size_t)fileStat.st_size;
+    return true;
+#endif
+}
+
+void _alimer_unmap_file(FileMapping* mapping)
+{
+    if (!mapping || !mapping->data)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(mapping->data);
+    CloseHandle((HANDLE)mapping->handle);
+#else
+    munmap((void*)mapping->data, mapping->size);
+#endif
+
+    memset(mapping, 0, sizeof(FileMapping));
+}
+
+bool _alimer_replace_file(const char* source, const char* target)
+{
+    ALIMER_ASSERT(source);
+    ALIMER_ASSERT(target);
+
+#if defined(_WIN32)
+    WCHAR* wideSource = Win32_CreateWideStringFromUTF8(source);
+    WCHAR* wideTarget = Win32_CreateWideStringFromUTF8(target);
+    const bool result = wideSource && wideTarget && MoveFileExW(wideSource, wideTarget, MOVEFILE_REPLACE_EXISTING) != 0;
+    alimerFree(wideSource);
+    alimerFree(wideTarget);
+    return result;
+#else
+    // The old inode stays alive for as long as it is mapped.
+    return rename(source, target) == 0;
+#endif
+}
+
+bool _alimer_stat_file(const char* path, uint64_t* size, uint64_t* modifiedTime)
+{
+    ALIMER_ASSERT(path);
+
+#if defined(_WIN32)
+    WCHAR* widePath = Win32_CreateWideStringFromUTF8(path);
+    if (!widePath)
+        return false;
+
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    const BOOL result = GetFileAttributesExW(widePath, GetFileExInfoStandard, &attributes);
+    alimerFree(widePath);
+    if (!result)
+        return false;
+
+    // FILETIME counts 100 nanosecond intervals.
+    *size = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+    *modifiedTime = (((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime) * 100;
+    return true;
+#else
+    struct stat fileStat;
+    if (stat(path, &fileStat) != 0)
+        return false;
+
+    *size = (uint64_t)fileStat.st_size;
+#if defined(__APPLE__)
+    *modifiedTime = (uint64_t)fileStat.st_mtimespec.tv_sec * 1000000000ull + (uint64_t)fileStat.st_mtimespec.tv_nsec;
+#else
+    *modifiedTime = (uint64_t)fileStat.st_mtim.tv_sec * 1000000000ull + (uint64_t)fileStat.st_mtim.tv_nsec;
+#endif
+    return true;
+#endif
+}
+
 /* PixelFormat */
 // Format mapping table. The rows must be in the exactly same order as Format enum members are defined.
 static const PixelFormatInfo kPixelFormatInfo[] = {
@@ -0,0 +1,274 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+#include "alimer_internal.h"
+#include "alimer_math.h"
+#include "alimer_scene.h"
+#include <vector>
+
+namespace
+{
+    /// Instances (or hierarchies) per job when a batch is split across worker threads.
+    constexpr uint32_t kBatchGroupSize = 8;
+
+    /// Linear steps tried from the cached key before falling back to binary search.
+    constexpr uint32_t kMaxLinearKeySteps = 4;
+
+    /// Find k such that times[k] <= time < times[k + 1], starting from the cached cursor.
+    uint32_t FindKey(const float* times, uint32_t keyCount, float time, uint32_t& cursor)
+    {
+        if (keyCount < 2 || time <= times[0])
+        {
+            cursor = 0;
+            return 0;
+        }
+
+        const uint32_t lastKey = keyCount - 1;
+        if (time >= times[lastKey])
+        {
+            cursor = lastKey;
+            return lastKey;
+        }
+
+        uint32_t low = 0;
+        uint32_t high = lastKey;
+        uint32_t key = cursor < lastKey ? cursor : lastKey - 1;
+        if (times[key] <= time)
+        {
+            // Playback usually moves forward by a key or two per sample.
+            for (uint32_t step = 0; step < kMaxLinearKeySteps; ++step)
+            {
+                if (time < times[key + 1])
+                {
+                    cursor = key;
+                    return key;
+                }
+                ++key;
+            }
+            low = key;
+        }
+        else
+        {
+            high = key;
+        }
+
+        // times[low] <= time < times[high]
+        while (high - low > 1)
+        {
+            const uint32_t middle = low + (high - low) / 2;
+            if (times[middle] <= time)
+                low = middle;
+            else
+                high = middle;
+        }
+
+        cursor = low;
+        return low;
+    }
+
+    template <uint32_t ComponentCount>
+    void SampleCubic(const float* values, uint32_t key, float t, float duration, float* result)
+    {
+        // Each key stores in-tangent, value and out-tangent.
+        const float* v0 = values + (key * 3 + 1) * ComponentCount;
+        const float* b0 = values + (key * 3 + 2) * ComponentCount;
+        const float* a1 = values + ((key + 1) * 3 + 0) * ComponentCount;
+        const float* v1 = values + ((key + 1) * 3 + 1) * ComponentCount;
+
+        const float t2 = t * t;
+        const float t3 = t2 * t;
+        const float h00 = 2.0f * t3 - 3.0f * t2 + 1.0f;
+        const float h10 = (t3 - 2.0f * t2 + t) * duration;
+        const float h01 = -2.0f * t3 + 3.0f * t2;
+        const float h11 = (t3 - t2) * duration;
+
+        for (uint32_t i = 0; i < ComponentCount; ++i)
+        {
+            result[i] = h00 * v0[i] + h10 * b0[i] + h01 * v1[i] + h11 * a1[i];
+        }
+    }
+}
+
+struct AnimationInstance final
+{
+    const SceneAnimation* animation = nullptr;
+    /// Last key found per channel.
+    std::vector<uint32_t> cursors;
+    /// Slot in the pose arrays written by each channel.
+    std::vector<uint32_t> channelSlots;
+
+    /* Pose of the animated nodes (SoA), starting from the rest pose. */
+    std::vector<uint32_t> nodes;
+    std::vector<Vector3> translations;
+    std::vector<Vector4> rotations;
+    std::vector<Vector3> scales;
+
+    void Sample(float time, bool loop, TransformHierarchy* hierarchy)
+    {
+        const float duration = animation->duration;
+        if (loop && duration > 0.0f)
+        {
+            time = fmodf(time, duration);
+            if (time < 0.0f)
+                time += duration;
+        }
+
+        for (uint32_t i = 0; i < animation->channelCount; ++i)
+        {
+            const SceneAnimationChannel& channel = animation->channels[i];
+            const uint32_t slot = channelSlots[i];
+            const uint32_t key = FindKey(channel.times, channel.keyCount, time, cursors[i]);
+
+            float t = 0.0f;
+            float keyDuration = 0.0f;
+            if (key + 1 < channel.keyCount)
+            {
+                keyDuration = channel.times[key + 1] - channel.times[key];
+                t = keyDuration > 0.0f ? (time - channel.times[key]) / keyDuration : 0.0f;
+                t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+            }
+
+            const bool interpolate = t > 0.0f && channel.interpolation != SceneAnimationInterpolation_Step;
+            if (channel.path == SceneAnimationPath_Rotation)
+            {
+                Vector4& rotation = rotations[slot];
+                if (!interpolate)
+                {
+                    const uint32_t valueIndex = channel.interpolation == SceneAnimationInterpolation_CubicSpline ? key * 3 + 1 : key;
+                    memcpy(&rotation, channel.values + valueIndex * 4, sizeof(Vector4));
+                }
+                else if (channel.interpolation == SceneAnimationInterpolation_CubicSpline)
+                {
+                    SampleCubic<4>(channel.values, key, t, keyDuration, &rotation.x);
+                    rotation = QuaternionBlend(rotation, 1.0f, rotation, 0.0f, true);
+                }
+                else
+                {
+                    Vector4 a;
+                    Vector4 b;
+                    memcpy(&a, channel.values + key * 4, sizeof(Vector4));
+                    memcpy(&b, channel.values + (key + 1) * 4, sizeof(Vector4));
+                    rotation = QuaternionSlerp(a, b, t);
+                }
+            }
+            else
+            {
+                Vector3& value = channel.path == SceneAnimationPath_Translation ? translations[slot] : scales[slot];
+                if (!interpolate)
+                {
+                    const uint32_t valueIndex = channel.interpolation == SceneAnimationInterpolation_CubicSpline ? key * 3 + 1 : key;
+                    memcpy(&value, channel.values + valueIndex * 3, sizeof(Vector3));
+                }
+                else if (channel.interpolation == SceneAnimationInterpolation_CubicSpline)
+                {
+                    SampleCubic<3>(channel.values, key, t, keyDuration, &value.x);
+                }
+                else
+                {
+                    const float* a = channel.values + key * 3;
+                    const float* b = a + 3;
+                    value = { a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t, a[2] + (b[2] - a[2]) * t };
+                }
+            }
+        }
+
+        alimerTransformHierarchySetLocalBatch(hierarchy, (uint32_t)nodes.size(), nodes.data(), translations.data(), rotations.data(), scales.data());
+    }
+};
+
+AnimationInstance* alimerAnimationInstanceCreate(const Scene* scene, uint32_t animationIndex)
+{
+    ALIMER_ASSERT(scene);
+
+    if (animationIndex >= scene->animationCount)
+    {
+        alimerLogError(LogCategory_System, "Invalid animation index %u", animationIndex);
+        return nullptr;
+    }
+
+    AnimationInstance* instance = new AnimationInstance();
+    instance->animation = &scene->animations[animationIndex];
+    instance->cursors.assign(instance->animation->channelCount, 0);
+    instance->channelSlots.resize(instance->animation->channelCount);
+
+    std::vector<int32_t> nodeSlots(scene->nodeCount, -1);
+    for (uint32_t i = 0; i < instance->animation->channelCount; ++i)
+    {
+        const uint32_t nodeIndex = instance->animation->channels[i].nodeIndex;
+        if (nodeSlots[nodeIndex] < 0)
+        {
+            const SceneNode& node = scene->nodes[nodeIndex];
+            nodeSlots[nodeIndex] = (int32_t)instance->nodes.size();
+            instance->nodes.push_back(nodeIndex);
+            instance->translations.push_back(node.translation);
+            instance->rotations.push_back(node.rotation);
+            instance->scales.push_back(node.scale);
+        }
+
+        instance->channelSlots[i] = (uint32_t)nodeSlots[nodeIndex];
+    }
+
+    return instance;
+}
+
+void alimerAnimationInstanceDestroy(AnimationInstance* instance)
+{
+    delete instance;
+}
+
+float alimerAnimationInstanceGetDuration(const AnimationInstance* instance)
+{
+    return instance->animation->duration;
+}
+
+void alimerAnimationSample(uint32_t count, AnimationInstance* const* instances, const float* times, bool loop, TransformHierarchy* const* hierarchies)
+{
+    if (count < kBatchGroupSize * 2 || jobs::GetThreadCount() == 1)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            instances[i]->Sample(times[i], loop, hierarchies[i]);
+        }
+        return;
+    }
+
+    jobs::Context context;
+    jobs::Dispatch(context, count, kBatchGroupSize, [=](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                instances[i]->Sample(times[i], loop, hierarchies[i]);
+            }
+        });
+    jobs::Wait(context);
+}
+
+void alimerSceneSkinComputeJointMatrices(const Scene* scene, uint32_t skinIndex, uint32_t count, const TransformHierarchy* const* hierarchies, Matrix4x4* palettes)
+{
+    ALIMER_ASSERT(scene);
+    ALIMER_ASSERT(skinIndex < scene->skinCount);
+
+    const SceneSkin& skin = scene->skins[skinIndex];
+    auto computePalettes = [&skin, hierarchies, palettes](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const Matrix4x4* worldMatrices = alimerTransformHierarchyGetWorldMatrices(hierarchies[i]);
+                Matrix4x4* palette = palettes + (size_t)i * skin.jointCount;
+                for (uint32_t joint = 0; joint < skin.jointCount; ++joint)
+                {
+                    MatrixMultiply(skin.inverseBindMatrices[joint], worldMatrices[skin.joints[joint]], palette[joint]);
+                }
+            }
+        };
+
+    if (count < kBatchGroupSize * 2 || jobs::GetThreadCount() == 1)
+    {
+        computePalettes(0, count);
+        return;
+    }
+
+    jobs::Context context;
+    jobs::Dispatch(context, count, kBatchGroupSize, computePalettes);
+    jobs::Wait(context);
+}
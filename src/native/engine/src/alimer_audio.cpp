@@ -4,6 +4,7 @@
 #if defined(ALIMER_AUDIO)
 #include "alimer_internal.h"
 #include "alimer_audio.h"
+#include "alimer_audio_mixer.h"
 
 ALIMER_DISABLE_WARNINGS()
 #define STB_VORBIS_HEADER_ONLY 
@@ -29,8 +30,17 @@ ALIMER_DISABLE_WARNINGS()
 
 ALIMER_ENABLE_WARNINGS()
 
+#include <cfloat>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
 
 namespace
 {
@@ -184,6 +194,144 @@ namespace
         }
     }
 
+    /// Single producer, single consumer ring buffer, Capacity must be a power of two.
+    template <typename T, uint32_t Capacity>
+    class SPSCQueue final
+    {
+    public:
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+        bool TryPush(const T& item)
+        {
+            const uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+            if (tail - headIndex.load(std::memory_order_acquire) == Capacity)
+                return false;
+
+            items[tail & (Capacity - 1)] = item;
+            tailIndex.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Push all items or none, the consumer sees them in a single pop sequence.
+        bool TryPush(const T* values, uint32_t count)
+        {
+            const uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+            if (Capacity - (tail - headIndex.load(std::memory_order_acquire)) < count)
+                return false;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                items[(tail + i) & (Capacity - 1)] = values[i];
+            }
+            tailIndex.store(tail + count, std::memory_order_release);
+            return true;
+        }
+
+        bool TryPop(T& item)
+        {
+            const uint32_t head = headIndex.load(std::memory_order_relaxed);
+            if (head == tailIndex.load(std::memory_order_acquire))
+                return false;
+
+            item = items[head & (Capacity - 1)];
+            headIndex.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        alignas(64) std::atomic<uint32_t> headIndex{ 0 };
+        alignas(64) std::atomic<uint32_t> tailIndex{ 0 };
+        T items[Capacity];
+    };
+
+    enum class AudioCommandType : uint32_t
+    {
+        Play,
+        Pause,
+        Stop,
+        SetVolume,
+        SetPan,
+        SetPitch,
+        SetPosition,
+        SetDirection,
+        SetVelocity,
+        SeekToPCMFrame,
+        Virtualize,
+        Realize,
+        AttachVoice,
+        DetachVoice,
+    };
+
+    struct AudioCommand
+    {
+        AudioCommandType type;
+        AudioSource* source;
+        union
+        {
+            float value;
+            ma_vec3f vector;
+            uint64_t frameIndex;
+        };
+    };
+
+    constexpr uint32_t kAudioCommandQueueCapacity = 4096;
+
+    /// Streaming voices decode this many frames at a time.
+    constexpr uint32_t kStreamChunkFrameCount = 1024;
+    /// How often the streaming thread checks the voices for free ring buffer space.
+    constexpr uint32_t kStreamRefillIntervalMilliseconds = 5;
+    /// Frames mixed per step by alimerAudioEngineRender, streams are refilled between steps.
+    constexpr uint32_t kOfflineBlockFrames = 512;
+
+    /// Fade applied when voices are virtualized or become real again.
+    constexpr uint32_t kVoiceFadeMilliseconds = 10;
+    /// Sources quieter than this (-80 dB) are virtualized regardless of the real voice budget.
+    constexpr float kMinAudibleGain = 0.0001f;
+    /// Real voices are favored when ranking, so that voices near the budget edge don't flip every update.
+    constexpr float kRealVoiceAudibilityBias = 1.25f;
+
+    /// Output frames mixed per pass of a voice.
+    constexpr uint32_t kMixerChunkFrames = 256;
+    /// Input frames a voice can hold per pass, bounds the pitch ratio to half of it.
+    constexpr uint32_t kMixerWindowFrames = 2048;
+    /// Input frames kept between passes for the resampler filter.
+    constexpr uint32_t kMixerHistoryFrames = 32;
+    static_assert(kPolyphaseLookBehind + kPolyphaseLookAhead + 1 <= kMixerHistoryFrames, "History too short for the polyphase filter");
+
+    /// Effects that work on short stack buffers process the node output in blocks of this many frames.
+    constexpr uint32_t kEffectBlockFrames = 256;
+    constexpr float kDenormalOffset = 1e-25f;
+
+    /* Freeverb tuning, in frames at 44.1 kHz. */
+    constexpr uint32_t kReverbCombCount = 8;
+    constexpr uint32_t kReverbAllpassCount = 4;
+    constexpr uint32_t kReverbCombTuning[kReverbCombCount] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
+    constexpr uint32_t kReverbAllpassTuning[kReverbAllpassCount] = { 556, 441, 341, 225 };
+    constexpr uint32_t kReverbStereoSpread = 23;
+    constexpr float kReverbInputGain = 0.015f;
+    constexpr float kReverbWetScale = 3.0f;
+    constexpr float kReverbDampingScale = 0.4f;
+    constexpr float kReverbRoomScale = 0.28f;
+    constexpr float kReverbRoomOffset = 0.7f;
+
+    /// Profile events kept until alimerAudioEngineReadProfileEvents drains them, newer events are dropped when full.
+    constexpr uint32_t kProfileEventCapacity = 1024;
+    /// Upper bound of the first callback duration histogram bucket, each next bucket doubles it.
+    constexpr uint64_t kProfileHistogramBaseNanoseconds = 32 * 1000;
+
+    inline uint64_t GetProfileTimestamp()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// AudioClipMode_Auto decompresses clips up to this decoded size and streams the rest.
+    constexpr uint64_t kMaxAutoDecompressedSize = 4 * 1024 * 1024;
+
+    /// Default size of the decoded and encoded data kept alive by the clip cache.
+    constexpr uint64_t kDefaultClipCacheBudget = 64 * 1024 * 1024;
+    /// Files up to this size are read and hashed on a path miss, so the same sound under another path is shared.
+    constexpr uint64_t kMaxClipCacheHashedFileSize = 16 * 1024 * 1024;
+
     static void log_callback(void* pUserData, ma_uint32 level, const char* message)
     {
         ALIMER_UNUSED(pUserData);
@@ -215,463 +363,3297 @@ struct AudioDevice final
     const ma_device_info* info;
 };
 
-struct AudioEngine final
+/// Audio thread timings, written by the audio and streaming threads and read by alimerAudioEngineGetProfile.
+/// Callback totals are always measured, per voice and per effect times only while detailed profiling is enabled.
+struct AudioProfileCounters final
 {
-    std::atomic_uint32_t refCount;
-    std::mutex readMutex;
-    ma_device device;
-    ma_engine handle;
-    ma_node* endpointNode = nullptr;
-    ma_node_graph* nodeGraph = nullptr;
-    uint32_t listenerCount = 0;
+    std::atomic<bool> detailed{ false };
+    std::atomic<uint64_t> callbackCount{ 0 };
+    std::atomic<uint64_t> overrunCount{ 0 };
+    std::atomic<uint64_t> callbackTime{ 0 };
+    std::atomic<uint64_t> maxCallbackTime{ 0 };
+    std::atomic<uint64_t> periodTime{ 0 };
+    std::atomic<float> peakUtilization{ 0.0f };
+    std::atomic<uint64_t> commandTime{ 0 };
+    std::atomic<uint64_t> spatializationTime{ 0 };
+    std::atomic<uint64_t> mixTime{ 0 };
+    std::atomic<uint64_t> voiceTime{ 0 };
+    std::atomic<uint64_t> effectTime{ 0 };
+    std::atomic<uint64_t> decodeTime{ 0 };
+    std::atomic<uint32_t> histogram[AUDIO_PROFILE_HISTOGRAM_SIZE] = {};
+    std::atomic<uint32_t> droppedEventCount{ 0 };
+
+    bool IsDetailed() const
+    {
+        return detailed.load(std::memory_order_relaxed);
+    }
+
+    static void Add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
 };
 
-struct AudioClip final
+/// Streaming source data: a background thread decodes into the ring buffer, the audio thread only copies out of it.
+struct StreamingVoice final
 {
-    std::atomic_uint32_t refCount;
-    ma_decoder* decoder = nullptr;
-    AudioFormat format = AudioFormat_Unknown;
+    ma_data_source_base base;
+    ma_decoder decoder;
     uint32_t channels = 0;
     uint32_t sampleRate = 0;
-    uint64_t frameCount = 0;
-};
+    uint64_t lengthInFrames = 0;
+
+    /// Interleaved float frames, frameCapacity is a power of two.
+    std::vector<float> ring;
+    uint32_t frameCapacity = 0;
+    alignas(64) std::atomic<uint64_t> readIndex{ 0 };
+    alignas(64) std::atomic<uint64_t> writeIndex{ 0 };
+    /// Write index at which the decoder reached the end, UINT64_MAX while more data follows.
+    std::atomic<uint64_t> endIndex{ UINT64_MAX };
+    std::atomic<bool> looping{ false };
+
+    /* Seeks are requested by the audio thread and performed by the streaming thread. */
+    std::atomic<uint64_t> seekFrame{ 0 };
+    std::atomic<uint32_t> seekSerial{ 0 };
+    std::atomic<uint32_t> seekAckSerial{ 0 };
+    /// Write index when the seek was performed, older frames in the ring are stale.
+    std::atomic<uint64_t> seekAckWriteIndex{ 0 };
+    /// Audio thread only: last seek whose stale frames were dropped.
+    uint32_t droppedSerial = 0;
+
+    std::atomic<uint64_t> cursor{ 0 };
+    std::atomic<uint32_t> underrunCount{ 0 };
+    std::atomic<uint32_t>* engineUnderrunCount = nullptr;
+    AudioProfileCounters* profile = nullptr;
+    /// Set while the voice is in AudioStreamer::voices, guarded by the streamer mutex.
+    bool registered = false;
+
+    static ma_result OnRead(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead)
+    {
+        StreamingVoice* voice = (StreamingVoice*)pDataSource;
+        float* output = (float*)pFramesOut;
+        const uint32_t serial = voice->seekSerial.load(std::memory_order_relaxed);
 
-struct AudioSource final
-{
-    std::atomic_uint32_t refCount;
-    AudioClip* clip = nullptr;
-    ma_sound* handle = nullptr;
-};
+        // Output silence until the streaming thread performed the last seek.
+        if (voice->seekAckSerial.load(std::memory_order_acquire) != serial)
+        {
+            memset(output, 0, frameCount * voice->channels * sizeof(float));
+            *pFramesRead = frameCount;
+            return MA_SUCCESS;
+        }
 
-static struct
-{
-    std::atomic_uint32_t refCount;
-    ma_log log;
-    ma_context context;
-} state;
+        if (voice->droppedSerial != serial)
+        {
+            voice->readIndex.store(voice->seekAckWriteIndex.load(std::memory_order_relaxed), std::memory_order_release);
+            voice->droppedSerial = serial;
+        }
 
-bool alimerAudioInit(void)
-{
-    if (state.refCount > 0)
-        return true;
+        const uint64_t read = voice->readIndex.load(std::memory_order_relaxed);
+        const uint64_t available = voice->writeIndex.load(std::memory_order_acquire) - read;
+        const uint64_t count = std::min<uint64_t>(available, frameCount);
+        const uint32_t offset = (uint32_t)(read & (voice->frameCapacity - 1));
+        const uint64_t firstCount = std::min<uint64_t>(count, voice->frameCapacity - offset);
+        memcpy(output, voice->ring.data() + (size_t)offset * voice->channels, firstCount * voice->channels * sizeof(float));
+        memcpy(output + firstCount * voice->channels, voice->ring.data(), (count - firstCount) * voice->channels * sizeof(float));
+        voice->readIndex.store(read + count, std::memory_order_release);
+
+        uint64_t cursor = voice->cursor.load(std::memory_order_relaxed) + count;
+        if (voice->lengthInFrames > 0 && cursor >= voice->lengthInFrames && voice->looping.load(std::memory_order_relaxed))
+            cursor %= voice->lengthInFrames;
+        voice->cursor.store(cursor, std::memory_order_relaxed);
+
+        if (count == frameCount)
+        {
+            *pFramesRead = count;
+            return MA_SUCCESS;
+        }
 
-    ma_result result = ma_log_init(nullptr, &state.log);
-    if (result != MA_SUCCESS)
+        if (read + count >= voice->endIndex.load(std::memory_order_acquire))
+        {
+            *pFramesRead = count;
+            return count > 0 ? MA_SUCCESS : MA_AT_END;
+        }
+
+        // The streaming thread fell behind, keep the timing with silence.
+        memset(output + count * voice->channels, 0, (frameCount - count) * voice->channels * sizeof(float));
+        voice->underrunCount.fetch_add(1, std::memory_order_relaxed);
+        voice->engineUnderrunCount->fetch_add(1, std::memory_order_relaxed);
+        *pFramesRead = frameCount;
+        return MA_SUCCESS;
+    }
+
+    static ma_result OnSeek(ma_data_source* pDataSource, ma_uint64 frameIndex)
     {
-        alimerLogError(LogCategory_Audio, "ma_log_init failed: %s", ma_result_description(result));
-        return false;
+        StreamingVoice* voice = (StreamingVoice*)pDataSource;
+        voice->cursor.store(frameIndex, std::memory_order_relaxed);
+        voice->seekFrame.store(frameIndex, std::memory_order_relaxed);
+        voice->seekSerial.store(voice->seekSerial.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return MA_SUCCESS;
     }
 
-    result = ma_log_register_callback(&state.log, ma_log_callback_init(log_callback, nullptr));
-    if (result != MA_SUCCESS)
+    static ma_result OnGetDataFormat(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap)
     {
-        ma_log_uninit(&state.log);
-        alimerLogError(LogCategory_Audio, "ma_log_register_callback failed: %s", ma_result_description(result));
-        return false;
+        StreamingVoice* voice = (StreamingVoice*)pDataSource;
+        *pFormat = ma_format_f32;
+        *pChannels = voice->channels;
+        *pSampleRate = voice->sampleRate;
+        ma_channel_map_init_standard(ma_standard_channel_map_default, pChannelMap, channelMapCap, voice->channels);
+        return MA_SUCCESS;
     }
 
-    ma_context_config contextConfig = ma_context_config_init();
-    contextConfig.pLog = &state.log;
+    static ma_result OnGetCursor(ma_data_source* pDataSource, ma_uint64* pCursor)
+    {
+        *pCursor = ((StreamingVoice*)pDataSource)->cursor.load(std::memory_order_relaxed);
+        return MA_SUCCESS;
+    }
 
-    result = ma_context_init(nullptr, 0, &contextConfig, &state.context);
-    if (result != MA_SUCCESS)
+    static ma_result OnGetLength(ma_data_source* pDataSource, ma_uint64* pLength)
     {
-        ma_log_uninit(&state.log);
-        alimerLogError(LogCategory_Audio, "ma_context_init failed: %s", ma_result_description(result));
-        return false;
+        *pLength = ((StreamingVoice*)pDataSource)->lengthInFrames;
+        return *pLength > 0 ? MA_SUCCESS : MA_NOT_IMPLEMENTED;
     }
 
-    state.refCount.store(1);
-    return true;
-}
+    static ma_result OnSetLooping(ma_data_source* pDataSource, ma_bool32 isLooping)
+    {
+        ((StreamingVoice*)pDataSource)->looping.store(isLooping == MA_TRUE, std::memory_order_relaxed);
+        return MA_SUCCESS;
+    }
 
-void alimerAudioShutdown(void)
-{
-    uint32_t newCount = --state.refCount;
-    if (newCount == 0)
+    /// Decode into the free part of the ring, called by the streaming thread (or before the voice is registered).
+    void Refill()
     {
-        ma_result result = ma_context_uninit(&state.context);
-        if (result != MA_SUCCESS)
+        const uint64_t start = (profile && profile->IsDetailed()) ? GetProfileTimestamp() : 0;
+        const uint64_t write = writeIndex.load(std::memory_order_relaxed);
+
+        // After a seek the audio thread drops everything written before it, that space can be reused right away.
+        const uint32_t serial = seekSerial.load(std::memory_order_acquire);
+        const bool seeking = serial != seekAckSerial.load(std::memory_order_relaxed);
+        if (seeking)
         {
-            alimerLogError(LogCategory_Audio, "ma_context_uninit failed: %s", ma_result_description(result));
+            ma_decoder_seek_to_pcm_frame(&decoder, seekFrame.load(std::memory_order_relaxed));
+            endIndex.store(UINT64_MAX, std::memory_order_relaxed);
+            seekAckWriteIndex.store(write, std::memory_order_relaxed);
         }
 
-        memset(&state, 0, sizeof(state));
+        FillRing(write);
+
+        // Acknowledge once the ring holds data from the new position, so the seek doesn't cause an underrun.
+        if (seeking)
+        {
+            seekAckSerial.store(serial, std::memory_order_release);
+        }
+
+        if (start != 0)
+        {
+            AudioProfileCounters::Add(profile->decodeTime, GetProfileTimestamp() - start);
+        }
     }
-}
 
-static AudioDeviceCallback* s_enumerateCallback = nullptr;
+    void FillRing(uint64_t write)
+    {
+        bool rewound = false;
+        while (endIndex.load(std::memory_order_relaxed) == UINT64_MAX)
+        {
+            // The audio thread may not have dropped the frames before the last seek yet.
+            const uint64_t consumed = std::max(readIndex.load(std::memory_order_acquire), seekAckWriteIndex.load(std::memory_order_relaxed));
+            if (frameCapacity - (write - consumed) < kStreamChunkFrameCount)
+                break;
 
-static ma_bool32 enumDevicesCallback(ma_context* context, ma_device_type type, const ma_device_info* info, void* userdata)
-{
-    const AudioDeviceType deviceType = FromMiniaudio(type);
-    AudioDevice device = { deviceType, info };
-    s_enumerateCallback(&device, userdata);
-    return MA_TRUE;
-}
+            const uint32_t offset = (uint32_t)(write & (frameCapacity - 1));
+            const uint64_t frameCount = std::min<uint64_t>(kStreamChunkFrameCount, frameCapacity - offset);
+            ma_uint64 framesRead = 0;
+            const ma_result result = ma_decoder_read_pcm_frames(&decoder, ring.data() + (size_t)offset * channels, frameCount, &framesRead);
+            write += framesRead;
+            writeIndex.store(write, std::memory_order_release);
+            rewound = rewound && framesRead == 0;
+
+            const bool failed = result != MA_SUCCESS && result != MA_AT_END;
+            if (framesRead < frameCount || failed)
+            {
+                // Don't spin on streams that return no data right after rewinding.
+                if (looping.load(std::memory_order_relaxed) && !failed && !rewound)
+                {
+                    ma_decoder_seek_to_pcm_frame(&decoder, 0);
+                    rewound = true;
+                }
+                else
+                {
+                    endIndex.store(write, std::memory_order_release);
+                }
+            }
+        }
+    }
+};
 
-void alimerAudioEnumerateDevices(AudioDeviceCallback* callback, void* userdata)
+static ma_data_source_vtable s_streamingVoiceVTable = {
+    StreamingVoice::OnRead,
+    StreamingVoice::OnSeek,
+    StreamingVoice::OnGetDataFormat,
+    StreamingVoice::OnGetCursor,
+    StreamingVoice::OnGetLength,
+    StreamingVoice::OnSetLooping,
+    MA_DATA_SOURCE_SELF_MANAGED_RANGE_AND_LOOP_POINT
+};
+
+/// Background thread keeping the streaming voices of an engine filled.
+struct AudioStreamer final
 {
-    s_enumerateCallback = callback;
-    ma_result result = ma_context_enumerate_devices(&state.context, enumDevicesCallback, userdata);
-    if (result != MA_SUCCESS)
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<StreamingVoice*> voices;
+    /// Copy of voices decoded without holding the mutex.
+    std::vector<StreamingVoice*> refillVoices;
+    /// Voice being decoded outside the mutex, Unregister waits until it is done with it.
+    StreamingVoice* refillingVoice = nullptr;
+    std::condition_variable refillCondition;
+    bool quit = false;
+    /// Offline engines refill the voices from alimerAudioEngineRender instead of a thread.
+    bool synchronous = false;
+
+    void Register(StreamingVoice* voice)
     {
-        alimerLogError(LogCategory_Audio, "ma_context_enumerate_devices failed: %s", ma_result_description(result));
-        return;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!synchronous && !thread.joinable())
+        {
+            thread = std::thread([this] { Run(); });
+        }
+
+        voice->registered = true;
+        voices.push_back(voice);
     }
-}
 
-/* AudioDevice */
-AudioDeviceType alimerAudioDeviceGetType(AudioDevice* device)
-{
-    return device->deviceType;
-}
+    void Unregister(StreamingVoice* voice)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        voice->registered = false;
+        voices.erase(std::remove(voices.begin(), voices.end(), voice), voices.end());
+        refillCondition.wait(lock, [&] { return refillingVoice != voice; });
+    }
 
-const char* alimerAudioDeviceGetName(AudioDevice* device)
-{
-    return device->info->name;
-}
+    void Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        condition.notify_one();
 
-bool alimerAudioDeviceIsDefault(AudioDevice* device)
-{
-    return device->info->isDefault == MA_TRUE;
-}
+        if (thread.joinable())
+            thread.join();
+    }
 
-/* AudioEngine */
-static void DataCallback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount)
-{
-    AudioEngine& thisEngine = *static_cast<AudioEngine*>(pDevice->pUserData);
-    std::unique_lock callbackLock(thisEngine.readMutex);
+    void RefillAll()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        Refill(lock);
+    }
 
-    if (thisEngine.handle.pResourceManager != nullptr)
+    /// Decodes every registered voice, the mutex is only held between voices so sources can be created and released meanwhile.
+    void Refill(std::unique_lock<std::mutex>& lock)
     {
-        if ((thisEngine.handle.pResourceManager->config.flags & MA_RESOURCE_MANAGER_FLAG_NO_THREADING) != 0)
+        refillVoices.assign(voices.begin(), voices.end());
+        for (StreamingVoice* voice : refillVoices)
         {
-            ma_resource_manager_process_next_job(thisEngine.handle.pResourceManager);
+            // Released since the snapshot was taken.
+            if (!voice->registered)
+                continue;
+
+            refillingVoice = voice;
+            lock.unlock();
+            voice->Refill();
+            lock.lock();
+            refillingVoice = nullptr;
+            refillCondition.notify_all();
         }
     }
 
-    ma_engine_read_pcm_frames(&thisEngine.handle, pOutput, frameCount, nullptr);
-}
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!quit)
+        {
+            Refill(lock);
+            condition.wait_for(lock, std::chrono::milliseconds(kStreamRefillIntervalMilliseconds));
+        }
+    }
+};
 
-AudioEngine* alimerAudioEngineCreate(const AudioConfig* config)
+/// Per engine buffers of the voice mixer, only used by the audio thread one voice at a time.
+struct MixerScratch final
 {
-    AudioEngine* engine = new AudioEngine();
-    engine->refCount.store(1);
+    /// Interleaved frames read from a voice data source.
+    float input[kMixerWindowFrames * kMixerMaxChannels];
+    /// Voice history followed by the new input frames, one plane per channel.
+    float window[kMixerMaxChannels][kMixerWindowFrames];
+    float resampled[kMixerMaxChannels][kMixerChunkFrames];
+    float mapped[kMixerMaxChannels][kMixerChunkFrames];
+    float silence[kMixerChunkFrames];
+    /// Output of reads that only advance the voice.
+    float discard[kMixerChunkFrames * kMixerMaxChannels];
+    float polyphaseFilter[(kPolyphasePhases + 1) * kPolyphaseTaps];
+};
 
-    ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
-    if (config && config->playbackDevice)
+/// Resamples, channel maps and spatializes the data of a source with the mixer kernels, the ma_sound playing it has pitch
+/// and spatialization disabled so it only applies volume, pan and fades.
+struct MixerVoice final
+{
+    static constexpr int32_t kMixedChannel = -1;
+    static constexpr int32_t kSilentChannel = -2;
+
+    ma_data_source_base base;
+    ma_data_source* input = nullptr;
+    ma_sound* sound = nullptr;
+    MixerScratch* scratch = nullptr;
+    AudioResampler resampler = AudioResampler_Linear;
+    uint32_t inputChannels = 0;
+    uint32_t inputSampleRate = 0;
+    uint32_t outputChannels = 0;
+    uint32_t outputSampleRate = 0;
+    ma_channel outputMap[kMixerMaxChannels] = {};
+
+    /// Output channel c copies input channel channelSources[c], or sums the inputs weighted by channelWeights[c].
+    int32_t channelSources[kMixerMaxChannels] = {};
+    float channelWeights[kMixerMaxChannels][kMixerMaxChannels] = {};
+
+    /* Resampler state, position is a fixed point frame index into the history planes. */
+    float history[kMixerMaxChannels][kMixerHistoryFrames];
+    uint32_t historyFrames = 0;
+    uint64_t position = 0;
+    bool inputEnded = false;
+    /// First history frame past the end of the input once it ended.
+    uint32_t endFrame = 0;
+    std::atomic<uint64_t> cursor{ 0 };
+    AudioProfileCounters* profile = nullptr;
+    /// Time spent decoding, resampling and panning this voice while detailed profiling is enabled.
+    std::atomic<uint64_t> processingTime{ 0 };
+
+    /* Spatialization, the target gains of all playing voices are computed at the start of each audio callback. */
+    std::atomic<bool> spatialize{ true };
+    /// Playing during the last update, a voice that starts doesn't ramp from stale gains.
+    bool active = false;
+    float gains[kMixerMaxChannels];
+    float targetGains[kMixerMaxChannels];
+    float dopplerPitch = 1.0f;
+
+    /// Intrusive list of the engine voices, audio thread only.
+    MixerVoice* previous = nullptr;
+    MixerVoice* next = nullptr;
+
+    /// Called once the target gains of a playing voice are updated.
+    void Activate()
     {
-        deviceConfig.playback.pDeviceID = &config->playbackDevice->info->id;
+        if (!active)
+        {
+            // Voices that just started don't ramp from their last gains.
+            memcpy(gains, targetGains, sizeof(gains));
+            active = true;
+        }
     }
-    deviceConfig.playback.format = ma_format_f32;
-    deviceConfig.playback.channels = (config != nullptr && config->channelCount > 0) ? config->channelCount : 2;
-    deviceConfig.sampleRate = (config != nullptr && config->sampleRate > 0) ? config->sampleRate : 48000;
-    deviceConfig.dataCallback = DataCallback;
-    deviceConfig.pUserData = engine;
 
-    ma_result result = ma_device_init(&state.context, &deviceConfig, &engine->device);
-    if (result != MA_SUCCESS)
+    uint32_t GetLookBehind() const
     {
-        alimerLogError(LogCategory_Audio, "Failed to initialize audio device");
-        delete engine;
-        return nullptr;
+        return resampler == AudioResampler_Polyphase ? kPolyphaseLookBehind : 0;
     }
 
-    ma_engine_config engineConfig = ma_engine_config_init();
-    engineConfig.pDevice = &engine->device;
-    engineConfig.pProcessUserData = engine;
-    engineConfig.listenerCount = 1;
-    result = ma_engine_init(&engineConfig, &engine->handle);
-    if (result != MA_SUCCESS)
+    uint32_t GetLookAhead() const
     {
-        alimerLogError(LogCategory_Audio, "Failed to initialize audio engine");
-        delete engine;
-        return nullptr;
+        return resampler == AudioResampler_Polyphase ? kPolyphaseLookAhead : 1;
     }
 
-    char name[512];
-    ma_device_get_name(&engine->device, ma_device_type_playback, name, 512, nullptr);
-    alimerLogInfo(LogCategory_Audio, "Audio engine created with success using playback device %s", name);
+    /// Input frames per output frame in 32.32 fixed point.
+    uint64_t GetStep() const
+    {
+        // Larger steps would skip input frames the window can't hold.
+        const double maxRatio = kMixerWindowFrames / 2;
+        const double ratio = (double)ma_sound_get_pitch(sound) * dopplerPitch * inputSampleRate / outputSampleRate;
+        return std::max<uint64_t>((uint64_t)(std::min(ratio, maxRatio) * kMixerFractionOne + 0.5), 1);
+    }
 
-    engine->endpointNode = ma_engine_get_endpoint(&engine->handle);
-    engine->nodeGraph = ma_engine_get_node_graph(&engine->handle);
-    engine->listenerCount = ma_engine_get_listener_count(&engine->handle);
+    void Reset()
+    {
+        // Start on silence so the filter reads valid history from the first frame.
+        historyFrames = GetLookBehind();
+        for (uint32_t channel = 0; channel < inputChannels; ++channel)
+        {
+            memset(history[channel], 0, sizeof(history[channel]));
+        }
+        position = (uint64_t)historyFrames << kMixerFractionBits;
+        inputEnded = false;
+        endFrame = 0;
+    }
 
-    return engine;
-}
+    /// Input frame at the current position, the frames kept for the filter have already been read from the input.
+    void UpdateCursor()
+    {
+        ma_uint64 inputCursor = 0;
+        ma_data_source_get_cursor_in_pcm_frames(input, &inputCursor);
 
-void alimerAudioEngineDestroy(AudioEngine* engine)
-{
-    uint32_t newCount = --engine->refCount;
-    if (newCount == 0)
+        const uint32_t bufferedFrames = inputEnded ? std::min(historyFrames, endFrame) : historyFrames;
+        const uint32_t index = (uint32_t)std::min<uint64_t>(position >> kMixerFractionBits, bufferedFrames);
+        uint64_t inputPosition = inputCursor + index - bufferedFrames;
+        if (inputCursor + index < bufferedFrames)
+        {
+            // The input looped back while the buffered frames are from its end.
+            ma_uint64 length = 0;
+            ma_data_source_get_length_in_pcm_frames(input, &length);
+            inputPosition += length;
+        }
+        cursor.store(inputPosition, std::memory_order_relaxed);
+    }
+
+    void MixChunk(uint64_t step, uint32_t frameCount, const float* gainStart, const float* gainEnd, float* output)
     {
-        ma_engine_uninit(&engine->handle);
-        delete engine;
+        MixerScratch& buffers = *scratch;
+        const float* inputs[kMixerMaxChannels];
+        if (step == kMixerFractionOne && (position & kMixerFractionMask) == 0)
+        {
+            // Same rate, the window is mixed in place.
+            const uint32_t index = (uint32_t)(position >> kMixerFractionBits);
+            for (uint32_t channel = 0; channel < inputChannels; ++channel)
+            {
+                inputs[channel] = buffers.window[channel] + index;
+            }
+        }
+        else
+        {
+            const float* windows[kMixerMaxChannels];
+            float* resampled[kMixerMaxChannels];
+            for (uint32_t channel = 0; channel < inputChannels; ++channel)
+            {
+                windows[channel] = buffers.window[channel];
+                resampled[channel] = buffers.resampled[channel];
+                inputs[channel] = buffers.resampled[channel];
+            }
+
+            if (resampler == AudioResampler_Polyphase)
+            {
+                ResamplePolyphase(windows, resampled, inputChannels, position, step, frameCount, buffers.polyphaseFilter);
+            }
+            else
+            {
+                ResampleLinear(windows, resampled, inputChannels, position, step, frameCount);
+            }
+        }
+
+        const float* outputs[kMixerMaxChannels];
+        for (uint32_t channel = 0; channel < outputChannels; ++channel)
+        {
+            const int32_t source = channelSources[channel];
+            if (source >= 0)
+            {
+                outputs[channel] = inputs[source];
+            }
+            else if (source == kSilentChannel)
+            {
+                outputs[channel] = buffers.silence;
+            }
+            else
+            {
+                float* mapped = buffers.mapped[channel];
+                memset(mapped, 0, frameCount * sizeof(float));
+                for (uint32_t inputChannel = 0; inputChannel < inputChannels; ++inputChannel)
+                {
+                    if (channelWeights[channel][inputChannel] != 0.0f)
+                        AccumulatePlane(mapped, inputs[inputChannel], channelWeights[channel][inputChannel], frameCount);
+                }
+                outputs[channel] = mapped;
+            }
+        }
+
+        InterleaveWithGains(outputs, outputChannels, frameCount, gainStart, gainEnd, output);
     }
-}
 
-void alimerAudioEngineStart(AudioEngine* engine)
-{
-    ma_result result = ma_engine_start(&engine->handle);
-    if (result != MA_SUCCESS)
+    uint64_t Read(float* output, uint64_t frameCount)
     {
-        alimerLogError(LogCategory_Audio, "ma_engine_start failed: %s", ma_result_description(result));
+        MixerScratch& buffers = *scratch;
+        const uint32_t lookBehind = GetLookBehind();
+        const uint32_t lookAhead = GetLookAhead();
+        const uint64_t step = GetStep();
+
+        // Gains ramp to their target over the whole read.
+        float startGains[kMixerMaxChannels];
+        float chunkGains[kMixerMaxChannels];
+        float endGains[kMixerMaxChannels];
+        memcpy(startGains, gains, sizeof(gains));
+        memcpy(chunkGains, gains, sizeof(gains));
+
+        uint64_t framesRead = 0;
+        while (framesRead < frameCount)
+        {
+            for (uint32_t channel = 0; channel < inputChannels; ++channel)
+            {
+                memcpy(buffers.window[channel], history[channel], historyFrames * sizeof(float));
+            }
+
+            // Read as many input frames as the chunk needs, bounded by the window.
+            const uint64_t maxIndex = kMixerWindowFrames - lookAhead - 1;
+            uint32_t chunkFrames = (uint32_t)std::min<uint64_t>(frameCount - framesRead, kMixerChunkFrames);
+            chunkFrames = (uint32_t)std::min<uint64_t>(chunkFrames, ((maxIndex << kMixerFractionBits) - position) / step + 1);
+            const uint32_t neededFrames = (uint32_t)((position + (chunkFrames - 1) * step) >> kMixerFractionBits) + lookAhead + 1;
+
+            uint32_t windowFrames = historyFrames;
+            if (neededFrames > windowFrames)
+            {
+                if (!inputEnded)
+                {
+                    ma_uint64 inputFrames = 0;
+                    ma_data_source_read_pcm_frames(input, buffers.input, neededFrames - windowFrames, &inputFrames);
+
+                    float* planes[kMixerMaxChannels];
+                    for (uint32_t channel = 0; channel < inputChannels; ++channel)
+                    {
+                        planes[channel] = buffers.window[channel] + windowFrames;
+                    }
+                    DeinterleaveFrames(buffers.input, inputChannels, (uint32_t)inputFrames, planes);
+                    windowFrames += (uint32_t)inputFrames;
+
+                    if (windowFrames < neededFrames)
+                    {
+                        inputEnded = true;
+                        endFrame = windowFrames;
+                    }
+                }
+
+                // Past the end of the input the filter reads silence.
+                for (uint32_t channel = 0; channel < inputChannels; ++channel)
+                {
+                    memset(buffers.window[channel] + windowFrames, 0, (neededFrames - windowFrames) * sizeof(float));
+                }
+                windowFrames = neededFrames;
+            }
+
+            if (inputEnded)
+            {
+                const uint64_t end = (uint64_t)endFrame << kMixerFractionBits;
+                const uint64_t remainingFrames = position < end ? (end - position + step - 1) / step : 0;
+                chunkFrames = (uint32_t)std::min<uint64_t>(chunkFrames, remainingFrames);
+            }
+
+            if (chunkFrames > 0)
+            {
+                const float t = (float)(framesRead + chunkFrames) / (float)frameCount;
+                for (uint32_t channel = 0; channel < outputChannels; ++channel)
+                {
+                    endGains[channel] = startGains[channel] + (targetGains[channel] - startGains[channel]) * t;
+                }
+
+                MixChunk(step, chunkFrames, chunkGains, endGains, output ? output + framesRead * outputChannels : buffers.discard);
+                memcpy(chunkGains, endGains, sizeof(endGains));
+            }
+
+            // Keep the frames the next chunk still reads.
+            position += chunkFrames * step;
+            const uint64_t index = std::max<uint64_t>(position >> kMixerFractionBits, lookBehind);
+            const uint32_t consumedFrames = (uint32_t)std::min<uint64_t>(index - lookBehind, windowFrames);
+            // Only the zero padding past the end of the input can exceed the history.
+            historyFrames = std::min(windowFrames - consumedFrames, kMixerHistoryFrames);
+            for (uint32_t channel = 0; channel < inputChannels; ++channel)
+            {
+                memcpy(history[channel], buffers.window[channel] + consumedFrames, historyFrames * sizeof(float));
+            }
+            position -= (uint64_t)consumedFrames << kMixerFractionBits;
+            endFrame -= std::min(endFrame, consumedFrames);
+            framesRead += chunkFrames;
+
+            if (inputEnded && position >= ((uint64_t)endFrame << kMixerFractionBits))
+                break;
+        }
+
+        memcpy(gains, chunkGains, sizeof(gains));
+        UpdateCursor();
+        return framesRead;
     }
-}
 
-void alimerAudioEngineStop(AudioEngine* engine)
-{
-    ma_result result = ma_device_stop(&engine->device);
-    if (result != MA_SUCCESS)
+    static ma_result OnRead(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead)
     {
-        alimerLogError(LogCategory_Audio, "ma_device_stop failed: %s", ma_result_description(result));
+        MixerVoice* voice = (MixerVoice*)pDataSource;
+        if (!voice->profile->IsDetailed())
+        {
+            *pFramesRead = voice->Read((float*)pFramesOut, frameCount);
+            return *pFramesRead < frameCount ? MA_AT_END : MA_SUCCESS;
+        }
+
+        const uint64_t start = GetProfileTimestamp();
+        *pFramesRead = voice->Read((float*)pFramesOut, frameCount);
+        const uint64_t elapsed = GetProfileTimestamp() - start;
+        AudioProfileCounters::Add(voice->processingTime, elapsed);
+        AudioProfileCounters::Add(voice->profile->voiceTime, elapsed);
+        return *pFramesRead < frameCount ? MA_AT_END : MA_SUCCESS;
     }
-}
 
-AudioEngineState alimerAudioEngineGetState(AudioEngine* engine)
-{
-    ma_device_state state = ma_device_get_state(&engine->device);
-    return static_cast<AudioEngineState>(state);
-}
+    static ma_result OnSeek(ma_data_source* pDataSource, ma_uint64 frameIndex)
+    {
+        MixerVoice* voice = (MixerVoice*)pDataSource;
+        const ma_result result = ma_data_source_seek_to_pcm_frame(voice->input, frameIndex);
+        voice->Reset();
+        voice->UpdateCursor();
+        return result;
+    }
 
-float alimerAudioEngineGetMasterVolume(AudioEngine* engine, VolumeUnit unit)
-{
-    float volume;
-    ma_result result = ma_device_get_master_volume(&engine->device, &volume);
-    if (result != MA_SUCCESS)
+    static ma_result OnGetDataFormat(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap)
     {
-        alimerLogError(LogCategory_Audio, "ma_device_get_master_volume failed: %s", ma_result_description(result));
-        return 0.f;
+        MixerVoice* voice = (MixerVoice*)pDataSource;
+        *pFormat = ma_format_f32;
+        *pChannels = voice->outputChannels;
+        *pSampleRate = voice->outputSampleRate;
+        ma_channel_map_copy_or_default(pChannelMap, channelMapCap, voice->outputMap, voice->outputChannels);
+        return MA_SUCCESS;
     }
 
-    return (unit == VolumeUnit_Linear) ? volume : ma_volume_linear_to_db(volume);
-}
+    static ma_result OnGetCursor(ma_data_source* pDataSource, ma_uint64* pCursor)
+    {
+        *pCursor = ((MixerVoice*)pDataSource)->cursor.load(std::memory_order_relaxed);
+        return MA_SUCCESS;
+    }
 
-void alimerAudioEngineSetMasterVolume(AudioEngine* engine, float value, VolumeUnit unit)
-{
-    if (unit == VolumeUnit_Decibels)
-        value = ma_volume_db_to_linear(value);
+    static ma_result OnGetLength(ma_data_source* pDataSource, ma_uint64* pLength)
+    {
+        return ma_data_source_get_length_in_pcm_frames(((MixerVoice*)pDataSource)->input, pLength);
+    }
 
-    ma_result result = ma_device_set_master_volume(&engine->device, value);
-    if (result != MA_SUCCESS)
+    static ma_result OnSetLooping(ma_data_source* pDataSource, ma_bool32 isLooping)
     {
-        alimerLogError(LogCategory_Audio, "ma_device_set_master_volume failed: %s", ma_result_description(result));
+        return ma_data_source_set_looping(((MixerVoice*)pDataSource)->input, isLooping);
     }
+};
+
+static ma_data_source_vtable s_mixerVoiceVTable = {
+    MixerVoice::OnRead,
+    MixerVoice::OnSeek,
+    MixerVoice::OnGetDataFormat,
+    MixerVoice::OnGetCursor,
+    MixerVoice::OnGetLength,
+    MixerVoice::OnSetLooping,
+    MA_DATA_SOURCE_SELF_MANAGED_RANGE_AND_LOOP_POINT
+};
+
+struct AudioEngine final
+{
+    std::atomic_uint32_t refCount;
+    ma_device device;
+    ma_engine handle;
+    ma_node* endpointNode = nullptr;
+    ma_node_graph* nodeGraph = nullptr;
+    uint32_t listenerCount = 0;
+    /// No device, the engine only advances in alimerAudioEngineRender.
+    bool offline = false;
+    /// Master volume of offline engines, applied by alimerAudioEngineRender.
+    float offlineMasterVolume = 1.0f;
+
+    /// Game thread changes consumed at the start of each audio callback, the audio thread never locks.
+    SPSCQueue<AudioCommand, kAudioCommandQueueCapacity> commands;
+    /// Serializes producers with each other and with device start/stop.
+    std::mutex commandMutex;
+    /// Commands of alimerAudioSourcesSetSpatialBatch, guarded by commandMutex.
+    std::vector<AudioCommand> batchCommands;
+    /// Bumped by ProcessCommands whenever it consumed commands, producers blocked on a full queue wait for it to change.
+    std::atomic<uint64_t> commandProgress{ 0 };
+    std::atomic<uint32_t> commandWaiterCount{ 0 };
+    std::mutex commandWaitMutex;
+    std::condition_variable commandCondition;
+
+    AudioStreamer streamer;
+    /// Ring buffer length of streaming voices.
+    uint32_t streamBufferMilliseconds = 0;
+    std::atomic<uint32_t> streamUnderrunCount{ 0 };
+
+    AudioProfileCounters profile;
+    /// One event per callback, audio thread produces and alimerAudioEngineReadProfileEvents consumes.
+    SPSCQueue<AudioProfileEvent, kProfileEventCapacity> profileEvents;
+
+    /* Voice management, game thread only. */
+    std::mutex sourcesMutex;
+    std::vector<AudioSource*> sources;
+    uint32_t maxRealVoices = 0;
+    uint32_t realVoiceCount = 0;
+    uint32_t virtualVoiceCount = 0;
+
+    /* Voice mixer, audio thread only. */
+    AudioResampler resampler = AudioResampler_Linear;
+    MixerScratch mixerScratch;
+    SpatialBatch spatialBatch;
+    MixerVoice* mixerVoices = nullptr;
+    uint32_t playingVoiceCount = 0;
+    ma_channel channelMap[kMixerMaxChannels] = {};
+    /// Output channel directions for directional panning, null for channels that aren't spatialized.
+    float channelDirectionStorage[kMixerMaxChannels][3] = {};
+    const float* channelDirections[kMixerMaxChannels] = {};
+
+    void PostCommand(const AudioCommand& command);
+    void PostCommands(const AudioCommand* batch, uint32_t count);
+    void ProcessCommands();
+    uint64_t WaitForCommandProgress(uint64_t progress);
+    void Mix(void* output, uint32_t frameCount);
+    bool IsDeviceStarted() const
+    {
+        return !offline && ma_device_get_state(&device) == ma_device_state_started;
+    }
+    void UpdateMixerVoices();
+    void FlushSpatialBatch(MixerVoice** voices);
+    void WaitForCommands(const AudioSource* source);
+};
+
+struct AudioClip final
+{
+    std::atomic_uint32_t refCount;
+    AudioClipMode mode = AudioClipMode_Decompressed;
+    AudioFormat format = AudioFormat_Unknown;
+    uint32_t channels = 0;
+    uint32_t sampleRate = 0;
+    uint64_t frameCount = 0;
+
+    /// Decoded float samples shared read-only by every source (AudioClipMode_Decompressed).
+    std::vector<float> samples;
+
+    /* Encoded data each source opens its own decoder on (AudioClipMode_Streaming). */
+    std::string filePath;
+    Blob* blob = nullptr;
+
+    uint64_t GetResidentSize() const
+    {
+        return samples.size() * sizeof(float) + (blob ? blob->size : 0);
+    }
+
+    ~AudioClip()
+    {
+        if (blob)
+            alimerBlobDestroy(blob);
+    }
+};
+
+/// Stage coefficients of a low or high pass filter, computed on the game thread and copied into the
+/// audio thread filter without touching its state.
+struct FilterCoefficients final
+{
+    uint32_t firstOrderCount = 0;
+    uint32_t secondOrderCount = 0;
+    ma_biquad_coefficient firstOrder = {};
+    ma_biquad_coefficient secondOrder[MA_MAX_FILTER_ORDER / 2][5] = {};
+
+    void StoreBiquad(uint32_t index, const ma_biquad& biquad)
+    {
+        secondOrder[index][0] = biquad.b0;
+        secondOrder[index][1] = biquad.b1;
+        secondOrder[index][2] = biquad.b2;
+        secondOrder[index][3] = biquad.a1;
+        secondOrder[index][4] = biquad.a2;
+    }
+
+    void LoadBiquad(uint32_t index, ma_biquad& biquad) const
+    {
+        biquad.b0 = secondOrder[index][0];
+        biquad.b1 = secondOrder[index][1];
+        biquad.b2 = secondOrder[index][2];
+        biquad.a1 = secondOrder[index][3];
+        biquad.a2 = secondOrder[index][4];
+    }
+
+    void Store(const ma_lpf& filter)
+    {
+        firstOrderCount = filter.lpf1Count;
+        secondOrderCount = filter.lpf2Count;
+        if (firstOrderCount > 0)
+            firstOrder = filter.pLPF1[0].a;
+        for (uint32_t i = 0; i < secondOrderCount; ++i)
+            StoreBiquad(i, filter.pLPF2[i].bq);
+    }
+
+    void Store(const ma_hpf& filter)
+    {
+        firstOrderCount = filter.hpf1Count;
+        secondOrderCount = filter.hpf2Count;
+        if (firstOrderCount > 0)
+            firstOrder = filter.pHPF1[0].a;
+        for (uint32_t i = 0; i < secondOrderCount; ++i)
+            StoreBiquad(i, filter.pHPF2[i].bq);
+    }
+
+    void Load(ma_lpf& filter) const
+    {
+        ALIMER_ASSERT(filter.lpf1Count == firstOrderCount && filter.lpf2Count == secondOrderCount);
+        if (firstOrderCount > 0)
+            filter.pLPF1[0].a = firstOrder;
+        for (uint32_t i = 0; i < secondOrderCount; ++i)
+            LoadBiquad(i, filter.pLPF2[i].bq);
+    }
+
+    void Load(ma_hpf& filter) const
+    {
+        ALIMER_ASSERT(filter.hpf1Count == firstOrderCount && filter.hpf2Count == secondOrderCount);
+        if (firstOrderCount > 0)
+            filter.pHPF1[0].a = firstOrder;
+        for (uint32_t i = 0; i < secondOrderCount; ++i)
+            LoadBiquad(i, filter.pHPF2[i].bq);
+    }
+};
+
+/// Freeverb style reverb, each comb and allpass filter runs over the whole block before the next one.
+struct ReverbState final
+{
+    struct Filter
+    {
+        std::vector<float> buffer;
+        uint32_t index = 0;
+        float store = 0.0f;
+    };
+
+    Filter combs[2][kReverbCombCount];
+    Filter allpasses[2][kReverbAllpassCount];
+
+    void Init(uint32_t sampleRate)
+    {
+        const double scale = sampleRate / 44100.0;
+        for (uint32_t side = 0; side < 2; ++side)
+        {
+            const uint32_t spread = side * kReverbStereoSpread;
+            for (uint32_t i = 0; i < kReverbCombCount; ++i)
+            {
+                combs[side][i].buffer.assign(std::max<uint32_t>((uint32_t)((kReverbCombTuning[i] + spread) * scale), 1), 0.0f);
+            }
+            for (uint32_t i = 0; i < kReverbAllpassCount; ++i)
+            {
+                allpasses[side][i].buffer.assign(std::max<uint32_t>((uint32_t)((kReverbAllpassTuning[i] + spread) * scale), 1), 0.0f);
+            }
+        }
+    }
+
+    void Process(const float* input, float* output, uint32_t side, uint32_t frameCount, float feedback, float damping)
+    {
+        memset(output, 0, frameCount * sizeof(float));
+        for (Filter& comb : combs[side])
+        {
+            float* buffer = comb.buffer.data();
+            const uint32_t size = (uint32_t)comb.buffer.size();
+            uint32_t index = comb.index;
+            float store = comb.store;
+            for (uint32_t i = 0; i < frameCount; ++i)
+            {
+                const float value = buffer[index];
+                // Adding and removing a tiny offset flushes denormals from the feedback path.
+                store = (value * (1.0f - damping) + store * damping) + kDenormalOffset - kDenormalOffset;
+                buffer[index] = input[i] + store * feedback;
+                if (++index == size)
+                    index = 0;
+                output[i] += value;
+            }
+            comb.index = index;
+            comb.store = store;
+        }
+
+        for (Filter& allpass : allpasses[side])
+        {
+            float* buffer = allpass.buffer.data();
+            const uint32_t size = (uint32_t)allpass.buffer.size();
+            uint32_t index = allpass.index;
+            for (uint32_t i = 0; i < frameCount; ++i)
+            {
+                const float value = buffer[index];
+                buffer[index] = output[i] + value * 0.5f;
+                if (++index == size)
+                    index = 0;
+                output[i] = value - output[i];
+            }
+            allpass.index = index;
+        }
+    }
+};
+
+struct AudioEffect final
+{
+    ma_node_base base;
+    AudioBus* bus = nullptr;
+    AudioEffectType type = AudioEffectType_LowPass;
+    uint32_t channels = 0;
+    uint32_t sampleRate = 0;
+    std::atomic<bool> enabled{ true };
+    AudioProfileCounters* profile = nullptr;
+    std::atomic<uint64_t> processingTime{ 0 };
+
+    /* Parameters set by the game thread, published through a triple buffer the audio thread swaps without waiting. */
+    static constexpr uint32_t kParametersChanged = 4;
+    /// Serializes game threads, never taken by the audio thread.
+    std::mutex parametersMutex;
+    AudioEffectDesc parameters;
+    AudioEffectDesc parameterSlots[3];
+    /// Filter coefficients matching the cutoff of the parameter slot with the same index.
+    FilterCoefficients filterSlots[3];
+    /// Game thread copies of the filters, only used to compute coefficients.
+    ma_lpf parameterLowPass;
+    ma_hpf parameterHighPass;
+    uint32_t writeSlot = 0;
+    std::atomic<uint32_t> sharedSlot{ 1 };
+    uint32_t readSlot = 2;
+
+    /* Audio thread state. */
+    AudioEffectDesc current;
+    ma_lpf lowPass;
+    ma_hpf highPass;
+    ReverbState reverb;
+    float envelope = 0.0f;
+
+    void UpdateParameters();
+    void Process(const float* input, float* output, uint32_t frameCount);
+    void ProcessReverb(const float* input, float* output, uint32_t frameCount);
+    void ProcessCompressor(const float* input, float* output, uint32_t frameCount);
+
+    static void OnProcess(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut)
+    {
+        ALIMER_UNUSED(pFrameCountIn);
+        AudioEffect* effect = (AudioEffect*)pNode;
+        effect->UpdateParameters();
+        if (!effect->enabled.load(std::memory_order_relaxed))
+        {
+            memcpy(ppFramesOut[0], ppFramesIn[0], *pFrameCountOut * effect->channels * sizeof(float));
+            return;
+        }
+
+        if (!effect->profile->IsDetailed())
+        {
+            effect->Process(ppFramesIn[0], ppFramesOut[0], *pFrameCountOut);
+            return;
+        }
+
+        const uint64_t start = GetProfileTimestamp();
+        effect->Process(ppFramesIn[0], ppFramesOut[0], *pFrameCountOut);
+        const uint64_t elapsed = GetProfileTimestamp() - start;
+        AudioProfileCounters::Add(effect->processingTime, elapsed);
+        AudioProfileCounters::Add(effect->profile->effectTime, elapsed);
+    }
+};
+
+/// Last node of a bus, measures the level read by the effects that use the bus as sidechain.
+struct AudioBusOutput final
+{
+    ma_node_base base;
+    uint32_t channels = 0;
+    std::atomic<float> level{ 0.0f };
+
+    static void OnProcess(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut)
+    {
+        ALIMER_UNUSED(pFrameCountIn);
+        AudioBusOutput* output = (AudioBusOutput*)pNode;
+        const uint32_t sampleCount = *pFrameCountOut * output->channels;
+        const float* input = ppFramesIn[0];
+        float peak = 0.0f;
+        for (uint32_t i = 0; i < sampleCount; ++i)
+        {
+            peak = std::max(peak, fabsf(input[i]));
+        }
+        memcpy(ppFramesOut[0], input, sampleCount * sizeof(float));
+        output->level.store(peak, std::memory_order_relaxed);
+    }
+};
+
+static ma_node_vtable s_audioEffectVTable = {
+    AudioEffect::OnProcess,
+    nullptr,
+    1,
+    1,
+    // Keep running on silence so reverb tails and compressor release finish.
+    MA_NODE_FLAG_CONTINUOUS_PROCESSING
+};
+
+static ma_node_vtable s_audioBusOutputVTable = {
+    AudioBusOutput::OnProcess,
+    nullptr,
+    1,
+    1,
+    MA_NODE_FLAG_CONTINUOUS_PROCESSING
+};
+
+/// Sources and child buses attach to the group, which feeds the effect chain and then the output node.
+struct AudioBus final
+{
+    std::atomic_uint32_t refCount;
+    AudioEngine* engine = nullptr;
+    AudioBus* parent = nullptr;
+    ma_sound_group group;
+    AudioBusOutput output;
+    /// Effects in processing order, game thread only.
+    std::vector<AudioEffect*> effects;
+};
+
+void AudioEffect::UpdateParameters()
+{
+    if ((sharedSlot.load(std::memory_order_relaxed) & kParametersChanged) == 0)
+        return;
+
+    readSlot = sharedSlot.exchange(readSlot, std::memory_order_acq_rel) & ~kParametersChanged;
+    const bool cutoffChanged = parameterSlots[readSlot].cutoffFrequency != current.cutoffFrequency;
+    current = parameterSlots[readSlot];
+    if (!cutoffChanged)
+        return;
+
+    // The game thread already computed the coefficients, the filter state is kept.
+    if (type == AudioEffectType_LowPass)
+    {
+        filterSlots[readSlot].Load(lowPass);
+    }
+    else if (type == AudioEffectType_HighPass)
+    {
+        filterSlots[readSlot].Load(highPass);
+    }
+}
+
+void AudioEffect::Process(const float* input, float* output, uint32_t frameCount)
+{
+    switch (type)
+    {
+        case AudioEffectType_LowPass:
+            ma_lpf_process_pcm_frames(&lowPass, output, input, frameCount);
+            break;
+        case AudioEffectType_HighPass:
+            ma_hpf_process_pcm_frames(&highPass, output, input, frameCount);
+            break;
+        case AudioEffectType_Reverb:
+            ProcessReverb(input, output, frameCount);
+            break;
+        case AudioEffectType_Compressor:
+        case AudioEffectType_Limiter:
+            ProcessCompressor(input, output, frameCount);
+            break;
+        default:
+            memcpy(output, input, frameCount * channels * sizeof(float));
+            break;
+    }
+}
+
+void AudioEffect::ProcessReverb(const float* input, float* output, uint32_t frameCount)
+{
+    const float feedback = current.roomSize * kReverbRoomScale + kReverbRoomOffset;
+    const float damping = current.damping * kReverbDampingScale;
+    const float wet = current.wetLevel * kReverbWetScale;
+    const float wetMain = wet * (current.width * 0.5f + 0.5f);
+    const float wetCross = wet * ((1.0f - current.width) * 0.5f);
+    const float dry = current.dryLevel;
+
+    float mono[kEffectBlockFrames];
+    float left[kEffectBlockFrames];
+    float right[kEffectBlockFrames];
+    for (uint32_t offset = 0; offset < frameCount; offset += kEffectBlockFrames)
+    {
+        const uint32_t blockFrames = std::min(frameCount - offset, kEffectBlockFrames);
+        const float* blockInput = input + offset * channels;
+        float* blockOutput = output + offset * channels;
+
+        // The reverb is fed the sum of the first two channels, the others only get the dry signal.
+        const uint32_t reverbChannels = std::min(channels, 2u);
+        for (uint32_t i = 0; i < blockFrames; ++i)
+        {
+            float sum = 0.0f;
+            for (uint32_t channel = 0; channel < reverbChannels; ++channel)
+            {
+                sum += blockInput[i * channels + channel];
+            }
+            mono[i] = sum * kReverbInputGain;
+        }
+
+        reverb.Process(mono, left, 0, blockFrames, feedback, damping);
+        reverb.Process(mono, right, 1, blockFrames, feedback, damping);
+
+        for (uint32_t i = 0; i < blockFrames; ++i)
+        {
+            const float* frameInput = blockInput + i * channels;
+            float* frameOutput = blockOutput + i * channels;
+            if (channels == 1)
+            {
+                frameOutput[0] = (left[i] + right[i]) * 0.5f * wet + frameInput[0] * dry;
+                continue;
+            }
+
+            frameOutput[0] = left[i] * wetMain + right[i] * wetCross + frameInput[0] * dry;
+            frameOutput[1] = right[i] * wetMain + left[i] * wetCross + frameInput[1] * dry;
+            for (uint32_t channel = 2; channel < channels; ++channel)
+            {
+                frameOutput[channel] = frameInput[channel] * dry;
+            }
+        }
+    }
+}
+
+void AudioEffect::ProcessCompressor(const float* input, float* output, uint32_t frameCount)
+{
+    const bool limiter = type == AudioEffectType_Limiter;
+    const float threshold = ma_volume_db_to_linear(current.thresholdDecibels);
+    // Gain reduction in log2 domain: (threshold / envelope) ^ slope.
+    const float slope = limiter ? 1.0f : 1.0f - 1.0f / std::max(current.ratio, 1.0f);
+    const float attackMilliseconds = limiter ? 0.0f : current.attackMilliseconds;
+    const float attack = attackMilliseconds > 0.0f ? expf(-1000.0f / (attackMilliseconds * sampleRate)) : 0.0f;
+    const float release = current.releaseMilliseconds > 0.0f ? expf(-1000.0f / (current.releaseMilliseconds * sampleRate)) : 0.0f;
+    const float makeup = ma_volume_db_to_linear(current.makeupGainDecibels);
+    const float sidechainLevel = current.sidechain ? current.sidechain->output.level.load(std::memory_order_relaxed) : 0.0f;
+
+    float envelope = this->envelope;
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        const float* frameInput = input + i * channels;
+        float* frameOutput = output + i * channels;
+
+        float peak = sidechainLevel;
+        if (!current.sidechain)
+        {
+            for (uint32_t channel = 0; channel < channels; ++channel)
+            {
+                peak = std::max(peak, fabsf(frameInput[channel]));
+            }
+        }
+
+        const float coefficient = peak > envelope ? attack : release;
+        envelope = peak + coefficient * (envelope - peak);
+
+        float gain = makeup;
+        if (envelope > threshold)
+        {
+            gain *= exp2f(slope * log2f(threshold / envelope));
+        }
+
+        for (uint32_t channel = 0; channel < channels; ++channel)
+        {
+            frameOutput[channel] = frameInput[channel] * gain;
+        }
+    }
+    this->envelope = envelope + kDenormalOffset - kDenormalOffset;
+}
+
+struct AudioSource final
+{
+    std::atomic_uint32_t refCount;
+    AudioEngine* engine = nullptr;
+    AudioClip* clip = nullptr;
+    ma_sound* handle = nullptr;
+    /// Each source owns its cursor, either into the decoded clip samples or through its own decoder.
+    ma_audio_buffer_ref bufferRef = {};
+    bool bufferRefInitialized = false;
+    StreamingVoice* stream = nullptr;
+    /// Bus the sound is attached to, null for the engine endpoint.
+    AudioBus* bus = nullptr;
+    /// Resamples and spatializes the clip data for the sound, null when the channel counts exceed the mixer.
+    MixerVoice* voice = nullptr;
+
+    /// Commands posted but not yet applied by the audio thread.
+    std::atomic_uint32_t pendingCommands;
+    std::atomic_uint32_t pendingTransportCommands;
+
+    /* Last values requested by the game thread, returned until the audio thread applies them. */
+    bool playRequested = false;
+    float volume = 1.0f;
+    float pan = 0.0f;
+    float pitch = 1.0f;
+    ma_vec3f position = {};
+    ma_vec3f direction = {};
+    ma_vec3f velocity = {};
+    int32_t priority = 0;
+    /// Virtualization requested by the last alimerAudioEngineUpdate.
+    bool virtualRequested = false;
+
+    /* Virtual voice state, written by the audio thread. The cursor keeps advancing with the engine clock while the sound isn't mixed. */
+    bool isVirtual = false;
+    bool virtualPlaying = false;
+    uint64_t virtualStartTime = 0;
+    uint64_t virtualStartCursor = 0;
+    /// Engine time at which a virtual, non looping voice reaches its end.
+    std::atomic<uint64_t> virtualEndTime{ UINT64_MAX };
+    std::atomic<bool> virtualPlayingShared{ false };
+
+    double GetPlaybackRate() const
+    {
+        return ma_sound_get_pitch(handle) * (double)clip->sampleRate / ma_engine_get_sample_rate(&engine->handle);
+    }
+
+    uint64_t GetVirtualCursor(uint64_t time) const
+    {
+        if (!virtualPlaying)
+            return virtualStartCursor;
+
+        const uint64_t cursor = virtualStartCursor + (uint64_t)((time - virtualStartTime) * GetPlaybackRate());
+        if (clip->frameCount == 0 || cursor < clip->frameCount)
+            return cursor;
+
+        return ma_sound_is_looping(handle) ? cursor % clip->frameCount : clip->frameCount;
+    }
+
+    /// Restart the virtual clock from the given cursor and publish the state to the game thread.
+    void SetVirtualCursor(uint64_t time, uint64_t cursor, bool playing)
+    {
+        virtualStartTime = time;
+        virtualStartCursor = cursor;
+        virtualPlaying = playing;
+
+        uint64_t endTime = UINT64_MAX;
+        if (playing && clip->frameCount > 0 && !ma_sound_is_looping(handle))
+        {
+            const uint64_t remaining = cursor < clip->frameCount ? clip->frameCount - cursor : 0;
+            endTime = time + (uint64_t)(remaining / GetPlaybackRate());
+        }
+        virtualEndTime.store(endTime, std::memory_order_relaxed);
+        virtualPlayingShared.store(playing, std::memory_order_release);
+    }
+
+    void Post(AudioCommandType type)
+    {
+        AudioCommand command = {};
+        command.type = type;
+        command.source = this;
+        engine->PostCommand(command);
+    }
+
+    void Post(AudioCommandType type, float value)
+    {
+        AudioCommand command = {};
+        command.type = type;
+        command.source = this;
+        command.value = value;
+        engine->PostCommand(command);
+    }
+
+    void Post(AudioCommandType type, const ma_vec3f& vector)
+    {
+        AudioCommand command = {};
+        command.type = type;
+        command.source = this;
+        command.vector = vector;
+        engine->PostCommand(command);
+    }
+};
+
+/// Transport commands on virtual voices only move the virtual cursor.
+static void ApplyVirtualCommand(const AudioCommand& command)
+{
+    AudioSource* source = command.source;
+    const uint64_t time = ma_engine_get_time_in_pcm_frames(&source->engine->handle);
+    switch (command.type)
+    {
+        case AudioCommandType::Play:
+        {
+            uint64_t cursor = source->GetVirtualCursor(time);
+            if (source->clip->frameCount > 0 && cursor >= source->clip->frameCount)
+                cursor = 0;
+            source->SetVirtualCursor(time, cursor, true);
+            break;
+        }
+        case AudioCommandType::Pause:
+            source->SetVirtualCursor(time, source->GetVirtualCursor(time), false);
+            break;
+        case AudioCommandType::Stop:
+            source->SetVirtualCursor(time, 0, false);
+            break;
+        case AudioCommandType::SeekToPCMFrame:
+            source->SetVirtualCursor(time, command.frameIndex, source->virtualPlaying);
+            break;
+        default:
+            break;
+    }
+}
+
+static void VirtualizeVoice(AudioSource* source)
+{
+    ma_sound* sound = source->handle;
+    const uint64_t time = ma_engine_get_time_in_pcm_frames(&source->engine->handle);
+
+    ma_uint64 cursor = 0;
+    ma_sound_get_cursor_in_pcm_frames(sound, &cursor);
+    source->isVirtual = true;
+    source->SetVirtualCursor(time, cursor, ma_sound_is_playing(sound) == MA_TRUE);
+
+    if (source->virtualPlaying)
+    {
+        ma_sound_stop_with_fade_in_pcm_frames(sound, ma_engine_get_sample_rate(&source->engine->handle) * kVoiceFadeMilliseconds / 1000);
+    }
+}
+
+static void RealizeVoice(AudioSource* source)
+{
+    ma_sound* sound = source->handle;
+    const uint64_t time = ma_engine_get_time_in_pcm_frames(&source->engine->handle);
+    const uint64_t cursor = source->GetVirtualCursor(time);
+    const bool playing = source->virtualPlaying;
+    source->isVirtual = false;
+    source->SetVirtualCursor(time, 0, false);
+
+    ma_sound_reset_stop_time_and_fade(sound);
+    ma_sound_stop(sound);
+    if (source->clip->frameCount > 0 && cursor >= source->clip->frameCount)
+    {
+        // Finished while virtual.
+        ma_sound_seek_to_pcm_frame(sound, 0);
+        return;
+    }
+
+    ma_sound_seek_to_pcm_frame(sound, cursor);
+    if (playing)
+    {
+        ma_sound_set_fade_in_pcm_frames(sound, 0.0f, 1.0f, ma_engine_get_sample_rate(&source->engine->handle) * kVoiceFadeMilliseconds / 1000);
+        ma_sound_start(sound);
+    }
+}
+
+static void AttachMixerVoice(AudioEngine* engine, MixerVoice* voice)
+{
+    voice->previous = nullptr;
+    voice->next = engine->mixerVoices;
+    if (engine->mixerVoices)
+        engine->mixerVoices->previous = voice;
+    engine->mixerVoices = voice;
+}
+
+static void DetachMixerVoice(AudioEngine* engine, MixerVoice* voice)
+{
+    if (voice->previous)
+        voice->previous->next = voice->next;
+    else if (engine->mixerVoices == voice)
+        engine->mixerVoices = voice->next;
+
+    if (voice->next)
+        voice->next->previous = voice->previous;
+
+    voice->previous = nullptr;
+    voice->next = nullptr;
+}
+
+static void ApplyCommand(const AudioCommand& command)
+{
+    ma_sound* sound = command.source->handle;
+    const bool isTransport = command.type == AudioCommandType::Play || command.type == AudioCommandType::Pause || command.type == AudioCommandType::Stop;
+    if (command.source->isVirtual && (isTransport || command.type == AudioCommandType::SeekToPCMFrame))
+    {
+        ApplyVirtualCommand(command);
+    }
+    else
+    {
+        switch (command.type)
+        {
+            case AudioCommandType::Play:
+                ma_sound_reset_stop_time_and_fade(sound);
+                ma_sound_start(sound);
+                break;
+            case AudioCommandType::Pause:
+                ma_sound_stop(sound);
+                break;
+            case AudioCommandType::Stop:
+                ma_sound_stop(sound);
+                ma_sound_seek_to_pcm_frame(sound, 0);
+                break;
+            case AudioCommandType::SetVolume:
+                ma_sound_set_volume(sound, command.value);
+                break;
+            case AudioCommandType::SetPan:
+                ma_sound_set_pan(sound, command.value);
+                break;
+            case AudioCommandType::SetPitch:
+                if (command.source->isVirtual)
+                {
+                    // Rebase the virtual clock so the new rate only applies from now on.
+                    const uint64_t time = ma_engine_get_time_in_pcm_frames(&command.source->engine->handle);
+                    command.source->SetVirtualCursor(time, command.source->GetVirtualCursor(time), command.source->virtualPlaying);
+                }
+                ma_sound_set_pitch(sound, command.value);
+                break;
+            case AudioCommandType::SetPosition:
+                ma_sound_set_position(sound, command.vector.x, command.vector.y, command.vector.z);
+                break;
+            case AudioCommandType::SetDirection:
+                ma_sound_set_direction(sound, command.vector.x, command.vector.y, command.vector.z);
+                break;
+            case AudioCommandType::SetVelocity:
+                ma_sound_set_velocity(sound, command.vector.x, command.vector.y, command.vector.z);
+                break;
+            case AudioCommandType::SeekToPCMFrame:
+                ma_sound_seek_to_pcm_frame(sound, command.frameIndex);
+                break;
+            case AudioCommandType::Virtualize:
+                if (!command.source->isVirtual)
+                    VirtualizeVoice(command.source);
+                break;
+            case AudioCommandType::Realize:
+                if (command.source->isVirtual)
+                    RealizeVoice(command.source);
+                break;
+            case AudioCommandType::AttachVoice:
+                AttachMixerVoice(command.source->engine, command.source->voice);
+                break;
+            case AudioCommandType::DetachVoice:
+                DetachMixerVoice(command.source->engine, command.source->voice);
+                break;
+        }
+    }
+
+    if (isTransport)
+    {
+        command.source->pendingTransportCommands.fetch_sub(1, std::memory_order_release);
+    }
+    command.source->pendingCommands.fetch_sub(1, std::memory_order_release);
+}
+
+void AudioEngine::PostCommand(const AudioCommand& command)
+{
+    std::lock_guard<std::mutex> lock(commandMutex);
+    command.source->pendingCommands.fetch_add(1, std::memory_order_relaxed);
+    if (command.type == AudioCommandType::Play || command.type == AudioCommandType::Pause || command.type == AudioCommandType::Stop)
+    {
+        command.source->pendingTransportCommands.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t progress = commandProgress.load(std::memory_order_acquire);
+    while (!commands.TryPush(command))
+    {
+        // Start/stop hold commandMutex, so a stopped device can't begin a callback while we drain.
+        if (!IsDeviceStarted())
+        {
+            ProcessCommands();
+        }
+        else
+        {
+            progress = WaitForCommandProgress(progress);
+        }
+    }
+}
+
+void AudioEngine::PostCommands(const AudioCommand* batch, uint32_t count)
+{
+    // Caller holds commandMutex and has checked the batch fits in the queue. It is published with
+    // a single store, so the audio thread applies all of it in the same callback.
+    ALIMER_ASSERT(count <= kAudioCommandQueueCapacity);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        batch[i].source->pendingCommands.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t progress = commandProgress.load(std::memory_order_acquire);
+    while (!commands.TryPush(batch, count))
+    {
+        if (!IsDeviceStarted())
+        {
+            ProcessCommands();
+        }
+        else
+        {
+            progress = WaitForCommandProgress(progress);
+        }
+    }
+}
+
+void AudioEngine::ProcessCommands()
+{
+    AudioCommand command;
+    bool processed = false;
+    while (commands.TryPop(command))
+    {
+        ApplyCommand(command);
+        processed = true;
+    }
+
+    if (processed)
+    {
+        commandProgress.fetch_add(1, std::memory_order_release);
+
+        // Only wakes producers blocked on a full queue, otherwise the audio thread makes no syscall.
+        if (commandWaiterCount.load() > 0)
+        {
+            commandCondition.notify_all();
+        }
+    }
+}
+
+uint64_t AudioEngine::WaitForCommandProgress(uint64_t progress)
+{
+    std::unique_lock<std::mutex> lock(commandWaitMutex);
+    commandWaiterCount.fetch_add(1);
+
+    // The audio thread notifies without taking the mutex, the timeout covers a wakeup sent
+    // between the predicate check and the wait.
+    commandCondition.wait_for(lock, std::chrono::milliseconds(1), [&] {
+        return commandProgress.load(std::memory_order_acquire) != progress;
+    });
+
+    commandWaiterCount.fetch_sub(1);
+    return commandProgress.load(std::memory_order_acquire);
+}
+
+void AudioEngine::FlushSpatialBatch(MixerVoice** voices)
+{
+    SpatialBatch& batch = spatialBatch;
+    const uint32_t count = batch.count;
+
+    // The kernels work on groups of 4, pad with copies of the last voice.
+    while ((batch.count & 3) != 0)
+    {
+        const uint32_t last = count - 1;
+        const uint32_t lane = batch.count++;
+        for (float* values : { batch.positionX, batch.positionY, batch.positionZ, batch.directionX, batch.directionY, batch.directionZ,
+                               batch.toListenerX, batch.toListenerY, batch.toListenerZ, batch.velocityX, batch.velocityY, batch.velocityZ,
+                               batch.listenerVelocityX, batch.listenerVelocityY, batch.listenerVelocityZ, batch.speedOfSound, batch.dopplerFactor,
+                               batch.attenuationModel, batch.minDistance, batch.maxDistance, batch.rolloff, batch.minGain, batch.maxGain,
+                               batch.coneInnerCos, batch.coneOuterCos, batch.coneOuterGain, batch.directionalAttenuation, batch.minChannelGain })
+        {
+            values[lane] = values[last];
+        }
+    }
+
+    const uint32_t outputChannels = ma_engine_get_channels(&handle);
+    ComputeSpatialGains(batch, outputChannels, channelDirections);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        MixerVoice* voice = voices[i];
+        for (uint32_t channel = 0; channel < outputChannels; ++channel)
+        {
+            voice->targetGains[channel] = batch.channelGains[channel][i];
+        }
+        voice->dopplerPitch = batch.dopplerPitch[i];
+        voice->Activate();
+    }
+    batch.count = 0;
+}
+
+void AudioEngine::UpdateMixerVoices()
+{
+    const uint32_t outputChannels = ma_engine_get_channels(&handle);
+    MixerVoice* batchVoices[kSpatialBatchSize];
+    spatialBatch.count = 0;
+    playingVoiceCount = 0;
+
+    for (MixerVoice* voice = mixerVoices; voice != nullptr; voice = voice->next)
+    {
+        ma_sound* sound = voice->sound;
+        if (!ma_sound_is_playing(sound))
+        {
+            voice->active = false;
+            continue;
+        }
+        playingVoiceCount++;
+
+        const ma_spatializer& spatializer = sound->engineNode.spatializer;
+        const uint32_t listenerIndex = ma_sound_get_listener_index(sound);
+        const ma_spatializer_listener& listener = handle.listeners[listenerIndex];
+        if (!voice->spatialize.load(std::memory_order_relaxed) || !listener.isEnabled)
+        {
+            // A disabled listener hears nothing, like in ma_engine.
+            const float gain = voice->spatialize.load(std::memory_order_relaxed) ? 0.0f : 1.0f;
+            for (uint32_t channel = 0; channel < outputChannels; ++channel)
+            {
+                voice->targetGains[channel] = gain;
+            }
+            voice->dopplerPitch = 1.0f;
+            voice->Activate();
+        }
+        else
+        {
+            ma_vec3f relativePosition;
+            ma_vec3f relativeDirection;
+            ma_spatializer_get_relative_position_and_direction(&spatializer, &listener, &relativePosition, &relativeDirection);
+            const ma_vec3f position = ma_spatializer_get_position(&spatializer);
+            const ma_vec3f listenerPosition = ma_spatializer_listener_get_position(&listener);
+            const ma_vec3f velocity = ma_spatializer_get_velocity(&spatializer);
+            const ma_vec3f listenerVelocity = ma_spatializer_listener_get_velocity(&listener);
+
+            SpatialBatch& batch = spatialBatch;
+            const uint32_t lane = batch.count++;
+            batch.positionX[lane] = relativePosition.x;
+            batch.positionY[lane] = relativePosition.y;
+            batch.positionZ[lane] = relativePosition.z;
+            batch.directionX[lane] = relativeDirection.x;
+            batch.directionY[lane] = relativeDirection.y;
+            batch.directionZ[lane] = relativeDirection.z;
+            batch.toListenerX[lane] = listenerPosition.x - position.x;
+            batch.toListenerY[lane] = listenerPosition.y - position.y;
+            batch.toListenerZ[lane] = listenerPosition.z - position.z;
+            batch.velocityX[lane] = velocity.x;
+            batch.velocityY[lane] = velocity.y;
+            batch.velocityZ[lane] = velocity.z;
+            batch.listenerVelocityX[lane] = listenerVelocity.x;
+            batch.listenerVelocityY[lane] = listenerVelocity.y;
+            batch.listenerVelocityZ[lane] = listenerVelocity.z;
+            batch.speedOfSound[lane] = listener.config.speedOfSound;
+            batch.dopplerFactor[lane] = spatializer.dopplerFactor;
+            batch.attenuationModel[lane] = (float)FromMiniaudio(spatializer.attenuationModel);
+            batch.minDistance[lane] = spatializer.minDistance;
+            batch.maxDistance[lane] = spatializer.maxDistance;
+            batch.rolloff[lane] = spatializer.rolloff;
+            batch.minGain[lane] = spatializer.minGain;
+            batch.maxGain[lane] = spatializer.maxGain;
+            // A full cone is the same as no cone.
+            const bool hasCone = spatializer.coneInnerAngleInRadians < 6.283185f;
+            batch.coneInnerCos[lane] = hasCone ? cosf(spatializer.coneInnerAngleInRadians * 0.5f) : -2.0f;
+            batch.coneOuterCos[lane] = hasCone ? cosf(spatializer.coneOuterAngleInRadians * 0.5f) : -2.0f;
+            batch.coneOuterGain[lane] = spatializer.coneOuterGain;
+            batch.directionalAttenuation[lane] = spatializer.directionalAttenuationFactor;
+            batch.minChannelGain[lane] = spatializer.minSpatializationChannelGain;
+            batchVoices[lane] = voice;
+
+            if (batch.count == kSpatialBatchSize)
+                FlushSpatialBatch(batchVoices);
+        }
+    }
+
+    if (spatialBatch.count > 0)
+        FlushSpatialBatch(batchVoices);
+}
+
+void AudioEngine::WaitForCommands(const AudioSource* source)
+{
+    uint64_t progress = commandProgress.load(std::memory_order_acquire);
+    while (source->pendingCommands.load(std::memory_order_acquire) > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(commandMutex);
+            if (!IsDeviceStarted())
+            {
+                ProcessCommands();
+                continue;
+            }
+        }
+
+        progress = WaitForCommandProgress(progress);
+    }
+}
+
+static struct
+{
+    std::atomic_uint32_t refCount;
+    ma_log log;
+    ma_context context;
+} state;
+
+bool alimerAudioInit(void)
+{
+    if (state.refCount > 0)
+        return true;
+
+    ma_result result = ma_log_init(nullptr, &state.log);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "ma_log_init failed: %s", ma_result_description(result));
+        return false;
+    }
+
+    result = ma_log_register_callback(&state.log, ma_log_callback_init(log_callback, nullptr));
+    if (result != MA_SUCCESS)
+    {
+        ma_log_uninit(&state.log);
+        alimerLogError(LogCategory_Audio, "ma_log_register_callback failed: %s", ma_result_description(result));
+        return false;
+    }
+
+    ma_context_config contextConfig = ma_context_config_init();
+    contextConfig.pLog = &state.log;
+
+    result = ma_context_init(nullptr, 0, &contextConfig, &state.context);
+    if (result != MA_SUCCESS)
+    {
+        ma_log_uninit(&state.log);
+        alimerLogError(LogCategory_Audio, "ma_context_init failed: %s", ma_result_description(result));
+        return false;
+    }
+
+    state.refCount.store(1);
+    return true;
+}
+
+void alimerAudioShutdown(void)
+{
+    uint32_t newCount = --state.refCount;
+    if (newCount == 0)
+    {
+        ma_result result = ma_context_uninit(&state.context);
+        if (result != MA_SUCCESS)
+        {
+            alimerLogError(LogCategory_Audio, "ma_context_uninit failed: %s", ma_result_description(result));
+        }
+
+        memset(&state, 0, sizeof(state));
+    }
+}
+
+static AudioDeviceCallback* s_enumerateCallback = nullptr;
+
+static ma_bool32 enumDevicesCallback(ma_context* context, ma_device_type type, const ma_device_info* info, void* userdata)
+{
+    const AudioDeviceType deviceType = FromMiniaudio(type);
+    AudioDevice device = { deviceType, info };
+    s_enumerateCallback(&device, userdata);
+    return MA_TRUE;
+}
+
+void alimerAudioEnumerateDevices(AudioDeviceCallback* callback, void* userdata)
+{
+    s_enumerateCallback = callback;
+    ma_result result = ma_context_enumerate_devices(&state.context, enumDevicesCallback, userdata);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "ma_context_enumerate_devices failed: %s", ma_result_description(result));
+        return;
+    }
+}
+
+/* AudioDevice */
+AudioDeviceType alimerAudioDeviceGetType(AudioDevice* device)
+{
+    return device->deviceType;
+}
+
+const char* alimerAudioDeviceGetName(AudioDevice* device)
+{
+    return device->info->name;
+}
+
+bool alimerAudioDeviceIsDefault(AudioDevice* device)
+{
+    return device->info->isDefault == MA_TRUE;
+}
+
+/* AudioEngine */
+void AudioEngine::Mix(void* output, uint32_t frameCount)
+{
+    const uint64_t start = GetProfileTimestamp();
+    ProcessCommands();
+    const uint64_t commandsEnd = GetProfileTimestamp();
+    UpdateMixerVoices();
+    const uint64_t spatializationEnd = GetProfileTimestamp();
+
+    if (handle.pResourceManager != nullptr)
+    {
+        if ((handle.pResourceManager->config.flags & MA_RESOURCE_MANAGER_FLAG_NO_THREADING) != 0)
+        {
+            ma_resource_manager_process_next_job(handle.pResourceManager);
+        }
+    }
+
+    ma_engine_read_pcm_frames(&handle, output, frameCount, nullptr);
+    const uint64_t end = GetProfileTimestamp();
+
+    const uint64_t duration = end - start;
+    const uint64_t period = (uint64_t)frameCount * 1000000000ull / ma_engine_get_sample_rate(&handle);
+    const float utilization = period > 0 ? (float)duration / (float)period : 0.0f;
+    AudioProfileCounters::Add(profile.callbackCount, 1);
+    AudioProfileCounters::Add(profile.callbackTime, duration);
+    AudioProfileCounters::Add(profile.periodTime, period);
+    AudioProfileCounters::Add(profile.commandTime, commandsEnd - start);
+    AudioProfileCounters::Add(profile.spatializationTime, spatializationEnd - commandsEnd);
+    AudioProfileCounters::Add(profile.mixTime, end - spatializationEnd);
+    if (duration > period)
+    {
+        AudioProfileCounters::Add(profile.overrunCount, 1);
+    }
+
+    // Only the audio thread writes the maxima.
+    if (duration > profile.maxCallbackTime.load(std::memory_order_relaxed))
+        profile.maxCallbackTime.store(duration, std::memory_order_relaxed);
+    if (utilization > profile.peakUtilization.load(std::memory_order_relaxed))
+        profile.peakUtilization.store(utilization, std::memory_order_relaxed);
+
+    uint32_t bucket = 0;
+    while (bucket < AUDIO_PROFILE_HISTOGRAM_SIZE - 1 && duration >= (kProfileHistogramBaseNanoseconds << bucket))
+    {
+        ++bucket;
+    }
+    profile.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    if (profile.IsDetailed())
+    {
+        AudioProfileEvent event = {};
+        event.timestamp = start;
+        event.duration = duration;
+        event.period = period;
+        event.frameCount = frameCount;
+        event.voiceCount = playingVoiceCount;
+        if (!profileEvents.TryPush(event))
+        {
+            profile.droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+static void DataCallback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount)
+{
+    ALIMER_UNUSED(pInput);
+    static_cast<AudioEngine*>(pDevice->pUserData)->Mix(pOutput, frameCount);
+}
+
+AudioEngine* alimerAudioEngineCreate(const AudioConfig* config)
+{
+    AudioEngine* engine = new AudioEngine();
+    engine->refCount.store(1);
+
+    const uint32_t channelCount = (config != nullptr && config->channelCount > 0) ? config->channelCount : 2;
+    const uint32_t sampleRate = (config != nullptr && config->sampleRate > 0) ? config->sampleRate : 48000;
+    engine->offline = (config != nullptr) && config->offline;
+    engine->streamBufferMilliseconds = (config != nullptr && config->streamBufferMilliseconds > 0) ? config->streamBufferMilliseconds : 500;
+    engine->maxRealVoices = (config != nullptr && config->maxRealVoices > 0) ? config->maxRealVoices : 64;
+    engine->resampler = (config != nullptr) ? config->resampler : AudioResampler_Linear;
+    engine->streamer.synchronous = engine->offline;
+
+    ma_engine_config engineConfig = ma_engine_config_init();
+    engineConfig.pProcessUserData = engine;
+    engineConfig.listenerCount = 1;
+    if (engine->offline)
+    {
+        engineConfig.noDevice = MA_TRUE;
+        engineConfig.channels = channelCount;
+        engineConfig.sampleRate = sampleRate;
+    }
+    else
+    {
+        ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+        if (config && config->playbackDevice)
+        {
+            deviceConfig.playback.pDeviceID = &config->playbackDevice->info->id;
+        }
+        deviceConfig.playback.format = ma_format_f32;
+        deviceConfig.playback.channels = channelCount;
+        deviceConfig.sampleRate = sampleRate;
+        deviceConfig.dataCallback = DataCallback;
+        deviceConfig.pUserData = engine;
+
+        ma_result result = ma_device_init(&state.context, &deviceConfig, &engine->device);
+        if (result != MA_SUCCESS)
+        {
+            alimerLogError(LogCategory_Audio, "Failed to initialize audio device");
+            delete engine;
+            return nullptr;
+        }
+
+        engineConfig.pDevice = &engine->device;
+    }
+
+    ma_result result = ma_engine_init(&engineConfig, &engine->handle);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "Failed to initialize audio engine");
+        if (!engine->offline)
+            ma_device_uninit(&engine->device);
+        delete engine;
+        return nullptr;
+    }
+
+    if (engine->offline)
+    {
+        alimerLogInfo(LogCategory_Audio, "Offline audio engine created with success (%u channels, %u Hz)", channelCount, sampleRate);
+    }
+    else
+    {
+        char name[512];
+        ma_device_get_name(&engine->device, ma_device_type_playback, name, 512, nullptr);
+        alimerLogInfo(LogCategory_Audio, "Audio engine created with success using playback device %s", name);
+    }
+
+    engine->endpointNode = ma_engine_get_endpoint(&engine->handle);
+    engine->nodeGraph = ma_engine_get_node_graph(&engine->handle);
+    engine->listenerCount = ma_engine_get_listener_count(&engine->handle);
+
+    if (engine->resampler == AudioResampler_Polyphase)
+    {
+        BuildPolyphaseFilter(engine->mixerScratch.polyphaseFilter);
+    }
+
+    // Pan against the speaker layout of the listeners (side channels for stereo).
+    const uint32_t outputChannels = std::min(ma_engine_get_channels(&engine->handle), kMixerMaxChannels);
+    memcpy(engine->channelMap, ma_spatializer_listener_get_channel_map(&engine->handle.listeners[0]), outputChannels * sizeof(ma_channel));
+    for (uint32_t channel = 0; channel < outputChannels; ++channel)
+    {
+        if (!ma_is_spatial_channel_position(engine->channelMap[channel]))
+            continue;
+
+        const ma_vec3f direction = ma_get_channel_direction(engine->channelMap[channel]);
+        engine->channelDirectionStorage[channel][0] = direction.x;
+        engine->channelDirectionStorage[channel][1] = direction.y;
+        engine->channelDirectionStorage[channel][2] = direction.z;
+        engine->channelDirections[channel] = engine->channelDirectionStorage[channel];
+    }
+
+    return engine;
+}
+
+void alimerAudioEngineDestroy(AudioEngine* engine)
+{
+    uint32_t newCount = --engine->refCount;
+    if (newCount == 0)
+    {
+        // The engine doesn't own the device, stop the callbacks before tearing the engine down.
+        if (!engine->offline)
+            ma_device_uninit(&engine->device);
+
+        engine->streamer.Shutdown();
+        ma_engine_uninit(&engine->handle);
+        delete engine;
+    }
+}
+
+void alimerAudioEngineStart(AudioEngine* engine)
+{
+    if (engine->offline)
+        return;
+
+    std::lock_guard<std::mutex> lock(engine->commandMutex);
+    ma_result result = ma_engine_start(&engine->handle);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "ma_engine_start failed: %s", ma_result_description(result));
+    }
+}
+
+void alimerAudioEngineStop(AudioEngine* engine)
+{
+    if (engine->offline)
+        return;
+
+    std::lock_guard<std::mutex> lock(engine->commandMutex);
+    ma_result result = ma_device_stop(&engine->device);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "ma_device_stop failed: %s", ma_result_description(result));
+    }
+}
+
+AudioEngineState alimerAudioEngineGetState(AudioEngine* engine)
+{
+    if (engine->offline)
+        return AudioEngineState_Started;
+
+    ma_device_state state = ma_device_get_state(&engine->device);
+    return static_cast<AudioEngineState>(state);
+}
+
+float alimerAudioEngineGetMasterVolume(AudioEngine* engine, VolumeUnit unit)
+{
+    if (engine->offline)
+        return (unit == VolumeUnit_Linear) ? engine->offlineMasterVolume : ma_volume_linear_to_db(engine->offlineMasterVolume);
+
+    float volume;
+    ma_result result = ma_device_get_master_volume(&engine->device, &volume);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "ma_device_get_master_volume failed: %s", ma_result_description(result));
+        return 0.f;
+    }
+
+    return (unit == VolumeUnit_Linear) ? volume : ma_volume_linear_to_db(volume);
+}
+
+void alimerAudioEngineSetMasterVolume(AudioEngine* engine, float value, VolumeUnit unit)
+{
+    if (unit == VolumeUnit_Decibels)
+        value = ma_volume_db_to_linear(value);
+
+    if (engine->offline)
+    {
+        engine->offlineMasterVolume = value < 0.0f ? 0.0f : value;
+        return;
+    }
+
+    ma_result result = ma_device_set_master_volume(&engine->device, value);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "ma_device_set_master_volume failed: %s", ma_result_description(result));
+    }
+}
+
+float alimerAudioEngineGetVolume(AudioEngine* engine, VolumeUnit unit)
+{
+    const float volume = ma_engine_get_volume(&engine->handle);
+    return (unit == VolumeUnit_Linear) ? volume : ma_volume_linear_to_db(volume);
+}
+
+void alimerAudioEngineSetVolume(AudioEngine* engine, float value, VolumeUnit unit)
+{
+    if (unit == VolumeUnit_Decibels)
+        value = ma_volume_db_to_linear(value);
+
+    ma_engine_set_volume(&engine->handle, value);
+}
+
+uint32_t alimerAudioEngineGetChannelCount(AudioEngine* engine)
+{
+    return ma_engine_get_channels(&engine->handle);
+}
+
+uint32_t alimerAudioEngineGetSampleRate(AudioEngine* engine)
+{
+    return ma_engine_get_sample_rate(&engine->handle);
+}
+
+uint64_t alimerAudioEngineGetTimeInPCMFrames(AudioEngine* engine)
+{
+    return ma_engine_get_time_in_pcm_frames(&engine->handle);
+}
+
+uint64_t alimerAudioEngineGetTimeInMilliseconds(AudioEngine* engine)
+{
+    return ma_engine_get_time_in_milliseconds(&engine->handle);
+}
+
+void alimerAudioEngineSetTimeInPCMFrames(AudioEngine* engine, uint64_t value)
+{
+    ma_result result = ma_engine_set_time_in_pcm_frames(&engine->handle, value);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "ma_engine_set_time_in_pcm_frames failed: %s", ma_result_description(result));
+    }
+}
+
+void alimerAudioEngineSetTimeInMilliseconds(AudioEngine* engine, uint64_t value)
+{
+    ma_result result = ma_engine_set_time_in_milliseconds(&engine->handle, value);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "ma_engine_set_time_in_milliseconds failed: %s", ma_result_description(result));
+    }
+}
+
+uint32_t alimerAudioEngineGetStreamUnderrunCount(AudioEngine* engine)
+{
+    return engine->streamUnderrunCount.load(std::memory_order_relaxed);
+}
+
+bool alimerAudioEngineIsProfilingEnabled(AudioEngine* engine)
+{
+    return engine->profile.IsDetailed();
+}
+
+void alimerAudioEngineSetProfilingEnabled(AudioEngine* engine, bool enabled)
+{
+    engine->profile.detailed.store(enabled, std::memory_order_relaxed);
+}
+
+void alimerAudioEngineGetProfile(AudioEngine* engine, AudioEngineProfile* result)
+{
+    ALIMER_ASSERT(result);
+
+    const AudioProfileCounters& profile = engine->profile;
+    result->callbackCount = profile.callbackCount.load(std::memory_order_relaxed);
+    result->overrunCount = profile.overrunCount.load(std::memory_order_relaxed);
+    result->streamUnderrunCount = engine->streamUnderrunCount.load(std::memory_order_relaxed);
+    result->callbackTime = profile.callbackTime.load(std::memory_order_relaxed);
+    result->maxCallbackTime = profile.maxCallbackTime.load(std::memory_order_relaxed);
+    result->commandTime = profile.commandTime.load(std::memory_order_relaxed);
+    result->spatializationTime = profile.spatializationTime.load(std::memory_order_relaxed);
+    result->mixTime = profile.mixTime.load(std::memory_order_relaxed);
+    result->voiceTime = profile.voiceTime.load(std::memory_order_relaxed);
+    result->effectTime = profile.effectTime.load(std::memory_order_relaxed);
+    result->decodeTime = profile.decodeTime.load(std::memory_order_relaxed);
+
+    const uint64_t periodTime = profile.periodTime.load(std::memory_order_relaxed);
+    result->averageUtilization = periodTime > 0 ? (float)((double)result->callbackTime / (double)periodTime) : 0.0f;
+    result->peakUtilization = profile.peakUtilization.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < AUDIO_PROFILE_HISTOGRAM_SIZE; ++i)
+    {
+        result->histogram[i] = profile.histogram[i].load(std::memory_order_relaxed);
+    }
+    result->droppedEventCount = profile.droppedEventCount.load(std::memory_order_relaxed);
+}
+
+void alimerAudioEngineResetProfile(AudioEngine* engine)
+{
+    // Counters are reset one by one, a callback running meanwhile may be partially counted.
+    AudioProfileCounters& profile = engine->profile;
+    for (std::atomic<uint64_t>* counter : { &profile.callbackCount, &profile.overrunCount, &profile.callbackTime, &profile.maxCallbackTime, &profile.periodTime,
+                                            &profile.commandTime, &profile.spatializationTime, &profile.mixTime, &profile.voiceTime, &profile.effectTime, &profile.decodeTime })
+    {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    profile.peakUtilization.store(0.0f, std::memory_order_relaxed);
+    for (std::atomic<uint32_t>& bucket : profile.histogram)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    profile.droppedEventCount.store(0, std::memory_order_relaxed);
+}
+
+uint32_t alimerAudioEngineReadProfileEvents(AudioEngine* engine, AudioProfileEvent* events, uint32_t maxCount)
+{
+    uint32_t count = 0;
+    while (count < maxCount && engine->profileEvents.TryPop(events[count]))
+    {
+        ++count;
+    }
+    return count;
+}
+
+bool alimerAudioEngineIsOffline(AudioEngine* engine)
+{
+    return engine->offline;
+}
+
+uint64_t alimerAudioEngineRender(AudioEngine* engine, float* output, uint64_t frameCount)
+{
+    ALIMER_ASSERT(output);
+
+    if (!engine->offline)
+    {
+        alimerLogError(LogCategory_Audio, "alimerAudioEngineRender requires an engine created with AudioConfig::offline");
+        return 0;
+    }
+
+    const uint32_t channelCount = ma_engine_get_channels(&engine->handle);
+    uint64_t framesRendered = 0;
+    while (framesRendered < frameCount)
+    {
+        const uint32_t blockFrames = (uint32_t)std::min<uint64_t>(frameCount - framesRendered, kOfflineBlockFrames);
+        float* block = output + framesRendered * channelCount;
+
+        // Decode exactly what the block needs, no thread can run ahead or behind.
+        engine->streamer.RefillAll();
+        {
+            std::lock_guard<std::mutex> lock(engine->commandMutex);
+            engine->Mix(block, blockFrames);
+        }
+
+        if (engine->offlineMasterVolume != 1.0f)
+        {
+            ma_apply_volume_factor_f32(block, (ma_uint64)blockFrames * channelCount, engine->offlineMasterVolume);
+        }
+
+        framesRendered += blockFrames;
+    }
+
+    return framesRendered;
+}
+
+static bool WavWriteBytes(FILE* file, const void* data, size_t size)
+{
+    return fwrite(data, 1, size, file) == size;
+}
+
+static bool WavWriteUInt16(FILE* file, uint16_t value)
+{
+    const uint8_t bytes[2] = { (uint8_t)value, (uint8_t)(value >> 8) };
+    return WavWriteBytes(file, bytes, sizeof(bytes));
+}
+
+static bool WavWriteUInt32(FILE* file, uint32_t value)
+{
+    const uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    return WavWriteBytes(file, bytes, sizeof(bytes));
+}
+
+bool alimerAudioEngineRenderToFile(AudioEngine* engine, const char* path, uint64_t frameCount)
+{
+    ALIMER_ASSERT(path);
+
+    if (!engine->offline)
+    {
+        alimerLogError(LogCategory_Audio, "alimerAudioEngineRenderToFile requires an engine created with AudioConfig::offline");
+        return false;
+    }
+
+    const uint32_t channelCount = ma_engine_get_channels(&engine->handle);
+    const uint32_t sampleRate = ma_engine_get_sample_rate(&engine->handle);
+    const uint32_t blockAlign = channelCount * (uint32_t)sizeof(float);
+    const uint64_t dataSize = frameCount * blockAlign;
+
+    // RIFF sizes are 32 bit: 4 (WAVE) + 26 (fmt) + 12 (fact) + 8 (data header).
+    constexpr uint32_t kHeaderSize = 4 + 26 + 12 + 8;
+    if (dataSize > UINT32_MAX - kHeaderSize)
+    {
+        alimerLogError(LogCategory_Audio, "Cannot render %llu frames to WAV file '%s', data exceeds 4GB", (unsigned long long)frameCount, path);
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        alimerLogError(LogCategory_Audio, "Failed to open '%s' for writing", path);
+        return false;
+    }
+
+    // IEEE float WAVE, non-PCM formats carry cbSize in fmt and a fact chunk.
+    bool success = WavWriteBytes(file, "RIFF", 4)
+        && WavWriteUInt32(file, kHeaderSize + (uint32_t)dataSize)
+        && WavWriteBytes(file, "WAVE", 4)
+        && WavWriteBytes(file, "fmt ", 4)
+        && WavWriteUInt32(file, 18)
+        && WavWriteUInt16(file, 3) // WAVE_FORMAT_IEEE_FLOAT
+        && WavWriteUInt16(file, (uint16_t)channelCount)
+        && WavWriteUInt32(file, sampleRate)
+        && WavWriteUInt32(file, sampleRate * blockAlign)
+        && WavWriteUInt16(file, (uint16_t)blockAlign)
+        && WavWriteUInt16(file, 32)
+        && WavWriteUInt16(file, 0)
+        && WavWriteBytes(file, "fact", 4)
+        && WavWriteUInt32(file, 4)
+        && WavWriteUInt32(file, (uint32_t)frameCount)
+        && WavWriteBytes(file, "data", 4)
+        && WavWriteUInt32(file, (uint32_t)dataSize);
+
+    std::vector<float> block((size_t)kOfflineBlockFrames * channelCount);
+    uint64_t framesWritten = 0;
+    while (success && framesWritten < frameCount)
+    {
+        const uint64_t blockFrames = std::min<uint64_t>(frameCount - framesWritten, kOfflineBlockFrames);
+        alimerAudioEngineRender(engine, block.data(), blockFrames);
+        // Samples are little endian floats, same as every platform we ship on.
+        success = WavWriteBytes(file, block.data(), (size_t)blockFrames * blockAlign);
+        framesWritten += blockFrames;
+    }
+
+    fclose(file);
+    if (!success)
+    {
+        alimerLogError(LogCategory_Audio, "Failed to write WAV file '%s'", path);
+    }
+
+    return success;
+}
+
+static float ComputeAudibility(const AudioSource* source, const ma_vec3f* listeners, uint32_t listenerCount)
+{
+    const ma_sound* sound = source->handle;
+    if (!alimerAudioSourceIsSpatializationEnabled(source) || listenerCount == 0)
+        return source->volume;
+
+    float distance = FLT_MAX;
+    if (ma_sound_get_positioning(sound) == ma_positioning_relative)
+    {
+        distance = ma_vec3f_len(source->position);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < listenerCount; ++i)
+        {
+            distance = std::min(distance, ma_vec3f_dist(source->position, listeners[i]));
+        }
+    }
+
+    // Same distance attenuation as the spatializer, the cone is ignored.
+    const float minDistance = ma_sound_get_min_distance(sound);
+    const float maxDistance = ma_sound_get_max_distance(sound);
+    const float rolloff = ma_sound_get_rolloff(sound);
+    float attenuation = 1.0f;
+    switch (ma_sound_get_attenuation_model(sound))
+    {
+        case ma_attenuation_model_inverse:
+            attenuation = ma_attenuation_inverse(distance, minDistance, maxDistance, rolloff);
+            break;
+        case ma_attenuation_model_linear:
+            attenuation = ma_attenuation_linear(distance, minDistance, maxDistance, rolloff);
+            break;
+        case ma_attenuation_model_exponential:
+            attenuation = ma_attenuation_exponential(distance, minDistance, maxDistance, rolloff);
+            break;
+        default:
+            break;
+    }
+
+    attenuation = ma_clamp(attenuation, ma_sound_get_min_gain(sound), ma_sound_get_max_gain(sound));
+    return source->volume * attenuation;
+}
+
+void alimerAudioEngineUpdate(AudioEngine* engine)
+{
+    ma_vec3f listeners[MA_ENGINE_MAX_LISTENERS];
+    uint32_t listenerCount = 0;
+    for (uint32_t i = 0; i < engine->listenerCount; ++i)
+    {
+        if (ma_engine_listener_is_enabled(&engine->handle, i))
+            listeners[listenerCount++] = ma_engine_listener_get_position(&engine->handle, i);
+    }
+
+    struct VoiceCandidate
+    {
+        AudioSource* source;
+        int32_t priority;
+        float audibility;
+    };
+
+    std::lock_guard<std::mutex> lock(engine->sourcesMutex);
+    std::vector<VoiceCandidate> candidates;
+    candidates.reserve(engine->sources.size());
+    for (AudioSource* source : engine->sources)
+    {
+        if (!alimerAudioSourceIsPlaying(source))
+            continue;
+
+        float audibility = ComputeAudibility(source, listeners, listenerCount);
+        if (!source->virtualRequested)
+            audibility *= kRealVoiceAudibilityBias;
+
+        candidates.push_back({ source, source->priority, audibility });
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const VoiceCandidate& lhs, const VoiceCandidate& rhs)
+        {
+            if (lhs.priority != rhs.priority)
+                return lhs.priority > rhs.priority;
+            return lhs.audibility > rhs.audibility;
+        });
+
+    uint32_t realVoiceCount = 0;
+    for (const VoiceCandidate& candidate : candidates)
+    {
+        const bool real = realVoiceCount < engine->maxRealVoices && candidate.audibility >= kMinAudibleGain;
+        if (real)
+            realVoiceCount++;
+
+        AudioSource* source = candidate.source;
+        if (source->virtualRequested == real)
+        {
+            source->virtualRequested = !real;
+            source->Post(real ? AudioCommandType::Realize : AudioCommandType::Virtualize);
+        }
+    }
+
+    engine->realVoiceCount = realVoiceCount;
+    engine->virtualVoiceCount = (uint32_t)candidates.size() - realVoiceCount;
+}
+
+uint32_t alimerAudioEngineGetMaxRealVoices(AudioEngine* engine)
+{
+    return engine->maxRealVoices;
+}
+
+void alimerAudioEngineSetMaxRealVoices(AudioEngine* engine, uint32_t value)
+{
+    engine->maxRealVoices = value;
+}
+
+uint32_t alimerAudioEngineGetRealVoiceCount(AudioEngine* engine)
+{
+    return engine->realVoiceCount;
+}
+
+uint32_t alimerAudioEngineGetVirtualVoiceCount(AudioEngine* engine)
+{
+    return engine->virtualVoiceCount;
+}
+
+/* AudioListener */
+uint32_t alimerAudioEngineGetListenerCount(AudioEngine* engine)
+{
+    return engine->listenerCount;
+}
+
+void alimerAudioEngineListenerSetPosition(AudioEngine* engine, uint32_t listenerIndex, const Vector3* position)
+{
+    ALIMER_ASSERT(position);
+
+    ma_engine_listener_set_position(&engine->handle, listenerIndex, position->x, position->y, position->z);
+}
+
+void alimerAudioEngineListenerGetPosition(const AudioEngine* engine, uint32_t listenerIndex, Vector3* result)
+{
+    FromMiniaudio(ma_engine_listener_get_position(&engine->handle, listenerIndex), result);
+}
+
+bool alimerAudioEngineListenerIsEnabled(AudioEngine* engine, uint32_t listenerIndex)
+{
+    return ma_engine_listener_is_enabled(&engine->handle, listenerIndex) == MA_TRUE;
+}
+
+void alimerAudioEngineListenerSetEnabled(AudioEngine* engine, uint32_t listenerIndex, bool enabled)
+{
+    ma_engine_listener_set_enabled(&engine->handle, listenerIndex, enabled ? MA_TRUE : MA_FALSE);
+}
+
+static ma_result InitDecoder(const AudioClip* clip, ma_decoder* decoder)
+{
+    // Always decode to float, the mixer and the decompressed clips work on float samples.
+    const ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, 0);
+    if (clip->blob)
+        return ma_decoder_init_memory(clip->blob->data, clip->blob->size, &config, decoder);
+
+    return ma_decoder_init_file(clip->filePath.c_str(), &config, decoder);
+}
+
+static bool DecodeClip(AudioClip* clip, ma_decoder* decoder)
+{
+    const uint64_t channels = clip->channels;
+    if (clip->frameCount > 0)
+    {
+        clip->samples.resize(clip->frameCount * channels);
+        ma_uint64 framesRead = 0;
+        ma_result result = ma_decoder_read_pcm_frames(decoder, clip->samples.data(), clip->frameCount, &framesRead);
+        if (result != MA_SUCCESS && result != MA_AT_END)
+            return false;
+
+        clip->frameCount = framesRead;
+        clip->samples.resize(framesRead * channels);
+        return true;
+    }
+
+    // Length unknown up front, decode in chunks.
+    constexpr uint64_t kChunkFrameCount = 16384;
+    for (;;)
+    {
+        const size_t offset = clip->samples.size();
+        clip->samples.resize(offset + kChunkFrameCount * channels);
+
+        ma_uint64 framesRead = 0;
+        ma_result result = ma_decoder_read_pcm_frames(decoder, clip->samples.data() + offset, kChunkFrameCount, &framesRead);
+        clip->samples.resize(offset + framesRead * channels);
+        clip->frameCount += framesRead;
+        if (result == MA_AT_END || framesRead < kChunkFrameCount)
+            return true;
+        if (result != MA_SUCCESS)
+            return false;
+    }
+}
+
+static AudioClip* CreateClip(AudioClip* clip, AudioClipMode mode)
+{
+    ma_decoder decoder;
+    ma_result result = InitDecoder(clip, &decoder);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "Failed to decode audio clip: %s", ma_result_description(result));
+        delete clip;
+        return nullptr;
+    }
+
+    // Report the format of the source data, not the float output of the decoder.
+    ma_format format = ma_format_unknown;
+    ma_data_source_get_data_format(decoder.pBackend, &format, nullptr, nullptr, nullptr, 0);
+    ma_decoder_get_data_format(&decoder, nullptr, &clip->channels, &clip->sampleRate, nullptr, 0);
+    clip->format = FromMiniaudio(format);
+
+    ma_uint64 frameCount = 0;
+    ma_decoder_get_length_in_pcm_frames(&decoder, &frameCount);
+    clip->frameCount = static_cast<uint64_t>(frameCount);
+
+    if (mode == AudioClipMode_Auto)
+    {
+        const uint64_t decodedSize = clip->frameCount * clip->channels * sizeof(float);
+        mode = (clip->frameCount > 0 && decodedSize <= kMaxAutoDecompressedSize) ? AudioClipMode_Decompressed : AudioClipMode_Streaming;
+    }
+    clip->mode = mode;
+
+    if (mode == AudioClipMode_Decompressed)
+    {
+        const bool decoded = DecodeClip(clip, &decoder);
+        ma_decoder_uninit(&decoder);
+        if (!decoded)
+        {
+            alimerLogError(LogCategory_Audio, "Failed to decode audio clip");
+            delete clip;
+            return nullptr;
+        }
+
+        // The encoded data isn't needed anymore.
+        clip->filePath.clear();
+        if (clip->blob)
+        {
+            alimerBlobDestroy(clip->blob);
+            clip->blob = nullptr;
+        }
+    }
+    else
+    {
+        ma_decoder_uninit(&decoder);
+    }
+
+    return clip;
+}
+
+/// Clips are immutable, so identical loads share one clip and its decoded samples.
+/// The cache holds a reference on every clip, clips only referenced by the cache are evicted in LRU order over the budget.
+static struct ClipCache
+{
+    struct Entry
+    {
+        AudioClip* clip;
+        uint64_t size;
+        uint64_t contentKey;
+        std::vector<std::string> pathKeys;
+    };
+
+    std::mutex mutex;
+    std::list<Entry> entries; // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> paths;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> contents;
+    uint64_t budget = kDefaultClipCacheBudget;
+    uint64_t residentSize = 0;
+    uint64_t hitCount = 0;
+    uint64_t missCount = 0;
+    uint64_t evictionCount = 0;
+
+    ~ClipCache()
+    {
+        for (Entry& entry : entries)
+        {
+            alimerAudioClipRelease(entry.clip);
+        }
+    }
+
+    static std::string GetPathKey(const char* path, AudioClipMode mode)
+    {
+        std::string key(1, (char)('0' + mode));
+        key += path;
+        return key;
+    }
+
+    static uint64_t GetContentKey(const void* data, size_t size, AudioClipMode mode)
+    {
+        return Hash64(data, size, (uint64_t)mode);
+    }
+
+    /// Caller holds the mutex. Releasing a clip never locks the cache, clips released since are evicted here.
+    AudioClip* Touch(std::list<Entry>::iterator it)
+    {
+        entries.splice(entries.begin(), entries, it);
+        hitCount++;
+        alimerAudioClipAddRef(it->clip);
+        Evict(budget);
+        return it->clip;
+    }
+
+    AudioClip* FindPath(const std::string& pathKey)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = paths.find(pathKey);
+        return it != paths.end() ? Touch(it->second) : nullptr;
+    }
+
+    /// Same data under another path, the path becomes an alias of the cached clip.
+    AudioClip* FindContent(uint64_t contentKey, const std::string* pathKey)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = contents.find(contentKey);
+        if (it == contents.end())
+            return nullptr;
+
+        if (pathKey && paths.emplace(*pathKey, it->second).second)
+        {
+            it->second->pathKeys.push_back(*pathKey);
+        }
+        return Touch(it->second);
+    }
+
+    AudioClip* Insert(AudioClip* clip, const std::string* pathKey, const uint64_t* contentKey)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Another thread loaded the same clip meanwhile, keep the cached one.
+        std::list<Entry>::iterator existing = entries.end();
+        if (pathKey)
+        {
+            auto it = paths.find(*pathKey);
+            if (it != paths.end())
+                existing = it->second;
+        }
+        if (existing == entries.end() && contentKey)
+        {
+            auto it = contents.find(*contentKey);
+            if (it != contents.end())
+                existing = it->second;
+        }
+        if (existing != entries.end())
+        {
+            alimerAudioClipRelease(clip);
+            return Touch(existing);
+        }
+
+        missCount++;
+        Entry entry;
+        entry.clip = clip;
+        entry.size = clip->GetResidentSize();
+        entry.contentKey = contentKey ? *contentKey : 0;
+        if (pathKey)
+            entry.pathKeys.push_back(*pathKey);
+        entries.push_front(std::move(entry));
+
+        if (pathKey)
+            paths[*pathKey] = entries.begin();
+        if (contentKey)
+            contents[*contentKey] = entries.begin();
+
+        alimerAudioClipAddRef(clip);
+        residentSize += entries.front().size;
+        Evict(budget);
+        return clip;
+    }
+
+    /// Caller holds the mutex, a target of 0 evicts every unreferenced clip.
+    void Evict(uint64_t targetSize)
+    {
+        auto it = entries.end();
+        while ((targetSize == 0 || residentSize > targetSize) && it != entries.begin())
+        {
+            --it;
+            if (it->clip->refCount.load() != 1)
+                continue;
+
+            for (const std::string& pathKey : it->pathKeys)
+            {
+                paths.erase(pathKey);
+            }
+            auto content = contents.find(it->contentKey);
+            if (content != contents.end() && content->second == it)
+                contents.erase(content);
+
+            residentSize -= it->size;
+            evictionCount++;
+            alimerAudioClipRelease(it->clip);
+            it = entries.erase(it);
+        }
+    }
+} s_clipCache;
+
+static bool IsClipCacheEnabled()
+{
+    std::lock_guard<std::mutex> lock(s_clipCache.mutex);
+    return s_clipCache.budget > 0;
+}
+
+static Blob* ReadClipFile(const char* filepath, uint64_t maxSize)
+{
+    FILE* file = fopen(filepath, "rb");
+    if (!file)
+        return nullptr;
+
+    Blob* blob = nullptr;
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size > 0 && (uint64_t)size <= maxSize)
+    {
+        void* data = alimerMalloc((size_t)size);
+        if (fread(data, 1, (size_t)size, file) == (size_t)size)
+        {
+            blob = alimerBlobCreate(data, (size_t)size, nullptr);
+        }
+        else
+        {
+            alimerFree(data);
+        }
+    }
+
+    fclose(file);
+    return blob;
+}
+
+AudioClip* alimerAudioClipCreate(const char* filepath)
+{
+    return alimerAudioClipCreateWithMode(filepath, AudioClipMode_Auto);
+}
+
+AudioClip* alimerAudioClipCreateFromMemory(const void* pData, size_t dataSize)
+{
+    return alimerAudioClipCreateFromMemoryWithMode(pData, dataSize, AudioClipMode_Auto);
+}
+
+AudioClip* alimerAudioClipCreateWithMode(const char* filepath, AudioClipMode mode)
+{
+    ALIMER_ASSERT(filepath);
+
+    const bool useCache = IsClipCacheEnabled();
+    const std::string pathKey = useCache ? ClipCache::GetPathKey(filepath, mode) : std::string();
+    if (useCache)
+    {
+        if (AudioClip* cachedClip = s_clipCache.FindPath(pathKey))
+            return cachedClip;
+
+        // Streamed clips decode from the file, don't load it just to hash it.
+        Blob* blob = (mode != AudioClipMode_Streaming) ? ReadClipFile(filepath, kMaxClipCacheHashedFileSize) : nullptr;
+        if (blob)
+        {
+            const uint64_t contentKey = ClipCache::GetContentKey(blob->data, blob->size, mode);
+            if (AudioClip* cachedClip = s_clipCache.FindContent(contentKey, &pathKey))
+            {
+                alimerBlobDestroy(blob);
+                return cachedClip;
+            }
+
+            AudioClip* clip = new AudioClip();
+            clip->refCount.store(1);
+            clip->blob = blob;
+            clip = CreateClip(clip, mode);
+            return clip ? s_clipCache.Insert(clip, &pathKey, &contentKey) : nullptr;
+        }
+    }
+
+    AudioClip* clip = new AudioClip();
+    clip->refCount.store(1);
+    clip->filePath = filepath;
+    clip = CreateClip(clip, mode);
+    return (clip && useCache) ? s_clipCache.Insert(clip, &pathKey, nullptr) : clip;
+}
+
+AudioClip* alimerAudioClipCreateFromMemoryWithMode(const void* pData, size_t dataSize, AudioClipMode mode)
+{
+    ALIMER_ASSERT(pData && dataSize > 0);
+
+    const bool useCache = IsClipCacheEnabled();
+    const uint64_t contentKey = useCache ? ClipCache::GetContentKey(pData, dataSize, mode) : 0;
+    if (useCache)
+    {
+        if (AudioClip* cachedClip = s_clipCache.FindContent(contentKey, nullptr))
+            return cachedClip;
+    }
+
+    // Streaming sources decode from the clip after this call returns, keep a copy.
+    void* data = alimerMalloc(dataSize);
+    memcpy(data, pData, dataSize);
+
+    AudioClip* clip = new AudioClip();
+    clip->refCount.store(1);
+    clip->blob = alimerBlobCreate(data, dataSize, nullptr);
+    clip = CreateClip(clip, mode);
+    return (clip && useCache) ? s_clipCache.Insert(clip, nullptr, &contentKey) : clip;
+}
+
+AudioClip* alimerAudioClipCreateFromBlob(Blob* blob, AudioClipMode mode)
+{
+    ALIMER_ASSERT(blob && blob->size > 0);
+
+    const bool useCache = IsClipCacheEnabled();
+    const uint64_t contentKey = useCache ? ClipCache::GetContentKey(blob->data, blob->size, mode) : 0;
+    if (useCache)
+    {
+        if (AudioClip* cachedClip = s_clipCache.FindContent(contentKey, nullptr))
+        {
+            alimerBlobDestroy(blob);
+            return cachedClip;
+        }
+    }
+
+    AudioClip* clip = new AudioClip();
+    clip->refCount.store(1);
+    clip->blob = blob;
+    clip = CreateClip(clip, mode);
+    return (clip && useCache) ? s_clipCache.Insert(clip, nullptr, &contentKey) : clip;
+}
+
+uint32_t alimerAudioClipAddRef(AudioClip* clip)
+{
+    return ++clip->refCount;
+}
+
+uint32_t alimerAudioClipRelease(AudioClip* clip)
+{
+    uint32_t newCount = --clip->refCount;
+    if (newCount == 0)
+    {
+        delete clip;
+    }
+    return newCount;
+}
+
+void alimerAudioClipCacheSetBudget(uint64_t sizeInBytes)
+{
+    std::lock_guard<std::mutex> lock(s_clipCache.mutex);
+    s_clipCache.budget = sizeInBytes;
+    s_clipCache.Evict(sizeInBytes);
+}
+
+uint64_t alimerAudioClipCacheGetBudget(void)
+{
+    std::lock_guard<std::mutex> lock(s_clipCache.mutex);
+    return s_clipCache.budget;
+}
+
+void alimerAudioClipCachePurge(void)
+{
+    std::lock_guard<std::mutex> lock(s_clipCache.mutex);
+    s_clipCache.Evict(0);
+}
+
+void alimerAudioClipCacheGetStats(AudioClipCacheStats* stats)
+{
+    ALIMER_ASSERT(stats);
+
+    std::lock_guard<std::mutex> lock(s_clipCache.mutex);
+    stats->hitCount = s_clipCache.hitCount;
+    stats->missCount = s_clipCache.missCount;
+    stats->evictionCount = s_clipCache.evictionCount;
+    stats->clipCount = (uint32_t)s_clipCache.entries.size();
+    stats->residentSize = s_clipCache.residentSize;
+    stats->budget = s_clipCache.budget;
+}
+
+AudioClipMode alimerAudioClipGetMode(AudioClip* clip)
+{
+    return clip->mode;
+}
+
+AudioFormat alimerAudioClipGetFormat(AudioClip* clip)
+{
+    return clip->format;
+}
+
+uint32_t alimerAudioClipGetChannelCount(AudioClip* clip)
+{
+    return clip->channels;
+}
+
+uint32_t alimerAudioClipGetSampleRate(AudioClip* clip)
+{
+    return clip->sampleRate;
+}
+
+uint64_t alimerAudioClipGetFrameCount(AudioClip* clip)
+{
+    return clip->frameCount;
+}
+
+uint32_t alimerAudioClipGetStride(AudioClip* clip)
+{
+    return clip->channels * FormatSize(clip->format);
+}
+
+/* AudioBus */
+AudioBus* alimerAudioBusCreate(AudioEngine* engine, AudioBus* parent)
+{
+    AudioBus* bus = new AudioBus();
+    bus->refCount.store(1);
+    bus->engine = engine;
+
+    ma_result result = ma_sound_group_init(&engine->handle, MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_NO_SPATIALIZATION, nullptr, &bus->group);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "Failed to initialize audio bus: %s", ma_result_description(result));
+        delete bus;
+        return nullptr;
+    }
+
+    bus->output.channels = ma_engine_get_channels(&engine->handle);
+    ma_node_config nodeConfig = ma_node_config_init();
+    nodeConfig.vtable = &s_audioBusOutputVTable;
+    nodeConfig.pInputChannels = &bus->output.channels;
+    nodeConfig.pOutputChannels = &bus->output.channels;
+    result = ma_node_init(engine->nodeGraph, &nodeConfig, nullptr, &bus->output.base);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "Failed to initialize audio bus: %s", ma_result_description(result));
+        ma_sound_group_uninit(&bus->group);
+        delete bus;
+        return nullptr;
+    }
+
+    if (parent)
+    {
+        alimerAudioBusAddRef(parent);
+        bus->parent = parent;
+    }
+
+    ma_node_attach_output_bus(&bus->output.base, 0, parent ? (ma_node*)&parent->group : engine->endpointNode, 0);
+    ma_node_attach_output_bus(&bus->group, 0, &bus->output.base, 0);
+    return bus;
+}
+
+static void DestroyEffect(AudioEffect* effect)
+{
+    // Uninit waits for the audio thread to stop processing the node, only then the sidechain bus can go.
+    ma_node_uninit(&effect->base, nullptr);
+    if (effect->type == AudioEffectType_LowPass)
+    {
+        ma_lpf_uninit(&effect->lowPass, nullptr);
+        ma_lpf_uninit(&effect->parameterLowPass, nullptr);
+    }
+    else if (effect->type == AudioEffectType_HighPass)
+    {
+        ma_hpf_uninit(&effect->highPass, nullptr);
+        ma_hpf_uninit(&effect->parameterHighPass, nullptr);
+    }
+
+    if (effect->current.sidechain)
+    {
+        alimerAudioBusRelease(effect->current.sidechain);
+    }
+    delete effect;
+}
+
+uint32_t alimerAudioBusAddRef(AudioBus* bus)
+{
+    return ++bus->refCount;
+}
+
+uint32_t alimerAudioBusRelease(AudioBus* bus)
+{
+    uint32_t newCount = --bus->refCount;
+    if (newCount == 0)
+    {
+        // Sources and child buses hold a reference, only the chain itself is left attached.
+        ma_sound_group_uninit(&bus->group);
+        for (AudioEffect* effect : bus->effects)
+        {
+            DestroyEffect(effect);
+        }
+        ma_node_uninit(&bus->output.base, nullptr);
+
+        if (bus->parent)
+        {
+            alimerAudioBusRelease(bus->parent);
+        }
+        delete bus;
+    }
+    return newCount;
+}
+
+AudioBus* alimerAudioBusGetParent(AudioBus* bus)
+{
+    return bus->parent;
 }
 
-float alimerAudioEngineGetVolume(AudioEngine* engine, VolumeUnit unit)
+float alimerAudioBusGetVolume(AudioBus* bus, VolumeUnit unit)
 {
-    const float volume = ma_engine_get_volume(&engine->handle);
+    const float volume = ma_sound_group_get_volume(&bus->group);
     return (unit == VolumeUnit_Linear) ? volume : ma_volume_linear_to_db(volume);
 }
 
-void alimerAudioEngineSetVolume(AudioEngine* engine, float value, VolumeUnit unit)
+void alimerAudioBusSetVolume(AudioBus* bus, float value, VolumeUnit unit)
 {
     if (unit == VolumeUnit_Decibels)
         value = ma_volume_db_to_linear(value);
 
-    ma_engine_set_volume(&engine->handle, value);
+    ma_sound_group_set_volume(&bus->group, value);
 }
 
-uint32_t alimerAudioEngineGetChannelCount(AudioEngine* engine)
+float alimerAudioBusGetLevel(AudioBus* bus, VolumeUnit unit)
 {
-    return ma_engine_get_channels(&engine->handle);
+    const float level = bus->output.level.load(std::memory_order_relaxed);
+    return (unit == VolumeUnit_Linear) ? level : ma_volume_linear_to_db(level);
 }
 
-uint32_t alimerAudioEngineGetSampleRate(AudioEngine* engine)
+AudioEffect* alimerAudioBusAddEffect(AudioBus* bus, const AudioEffectDesc* desc)
 {
-    return ma_engine_get_sample_rate(&engine->handle);
-}
+    ALIMER_ASSERT(desc);
 
-uint64_t alimerAudioEngineGetTimeInPCMFrames(AudioEngine* engine)
-{
-    return ma_engine_get_time_in_pcm_frames(&engine->handle);
-}
+    if (desc->type >= _AudioEffectType_Count)
+    {
+        alimerLogError(LogCategory_Audio, "Invalid audio effect type %u", (uint32_t)desc->type);
+        return nullptr;
+    }
 
-uint64_t alimerAudioEngineGetTimeInMilliseconds(AudioEngine* engine)
-{
-    return ma_engine_get_time_in_milliseconds(&engine->handle);
-}
+    AudioEffect* effect = new AudioEffect();
+    effect->bus = bus;
+    effect->profile = &bus->engine->profile;
+    effect->type = desc->type;
+    effect->channels = ma_engine_get_channels(&bus->engine->handle);
+    effect->sampleRate = ma_engine_get_sample_rate(&bus->engine->handle);
+    effect->parameters = *desc;
+    effect->parameters.filterOrder = std::min(std::max(desc->filterOrder, 1u), (uint32_t)MA_MAX_FILTER_ORDER);
+    effect->current = effect->parameters;
+
+    ma_result result = MA_SUCCESS;
+    switch (effect->type)
+    {
+        case AudioEffectType_LowPass:
+        {
+            const ma_lpf_config config = ma_lpf_config_init(ma_format_f32, effect->channels, effect->sampleRate, desc->cutoffFrequency, effect->current.filterOrder);
+            result = ma_lpf_init(&config, nullptr, &effect->lowPass);
+            if (result == MA_SUCCESS)
+            {
+                result = ma_lpf_init(&config, nullptr, &effect->parameterLowPass);
+                if (result != MA_SUCCESS)
+                    ma_lpf_uninit(&effect->lowPass, nullptr);
+            }
+            break;
+        }
+        case AudioEffectType_HighPass:
+        {
+            const ma_hpf_config config = ma_hpf_config_init(ma_format_f32, effect->channels, effect->sampleRate, desc->cutoffFrequency, effect->current.filterOrder);
+            result = ma_hpf_init(&config, nullptr, &effect->highPass);
+            if (result == MA_SUCCESS)
+            {
+                result = ma_hpf_init(&config, nullptr, &effect->parameterHighPass);
+                if (result != MA_SUCCESS)
+                    ma_hpf_uninit(&effect->highPass, nullptr);
+            }
+            break;
+        }
+        case AudioEffectType_Reverb:
+            effect->reverb.Init(effect->sampleRate);
+            break;
+        default:
+            break;
+    }
 
-void alimerAudioEngineSetTimeInPCMFrames(AudioEngine* engine, uint64_t value)
-{
-    ma_result result = ma_engine_set_time_in_pcm_frames(&engine->handle, value);
     if (result != MA_SUCCESS)
     {
-        alimerLogError(LogCategory_Audio, "ma_engine_set_time_in_pcm_frames failed: %s", ma_result_description(result));
+        alimerLogError(LogCategory_Audio, "Failed to initialize audio effect: %s", ma_result_description(result));
+        delete effect;
+        return nullptr;
     }
+
+    // Taken as soon as the effect holds the sidechain, the audio thread reads its level until DestroyEffect.
+    if (effect->current.sidechain)
+    {
+        alimerAudioBusAddRef(effect->current.sidechain);
+    }
+
+    ma_node_config nodeConfig = ma_node_config_init();
+    nodeConfig.vtable = &s_audioEffectVTable;
+    nodeConfig.pInputChannels = &effect->channels;
+    nodeConfig.pOutputChannels = &effect->channels;
+    result = ma_node_init(bus->engine->nodeGraph, &nodeConfig, nullptr, &effect->base);
+    if (result != MA_SUCCESS)
+    {
+        alimerLogError(LogCategory_Audio, "Failed to initialize audio effect: %s", ma_result_description(result));
+        DestroyEffect(effect);
+        return nullptr;
+    }
+
+    // Insert in front of the output node, attaching is safe while the audio thread is mixing.
+    ma_node* previous = bus->effects.empty() ? (ma_node*)&bus->group : (ma_node*)&bus->effects.back()->base;
+    ma_node_attach_output_bus(&effect->base, 0, &bus->output.base, 0);
+    ma_node_attach_output_bus(previous, 0, &effect->base, 0);
+    bus->effects.push_back(effect);
+    return effect;
 }
 
-void alimerAudioEngineSetTimeInMilliseconds(AudioEngine* engine, uint64_t value)
+void alimerAudioBusRemoveEffect(AudioBus* bus, AudioEffect* effect)
 {
-    ma_result result = ma_engine_set_time_in_milliseconds(&engine->handle, value);
-    if (result != MA_SUCCESS)
+    auto it = std::find(bus->effects.begin(), bus->effects.end(), effect);
+    if (it == bus->effects.end())
     {
-        alimerLogError(LogCategory_Audio, "ma_engine_set_time_in_milliseconds failed: %s", ma_result_description(result));
+        alimerLogError(LogCategory_Audio, "Audio effect doesn't belong to the bus");
+        return;
     }
+
+    ma_node* previous = (it == bus->effects.begin()) ? (ma_node*)&bus->group : (ma_node*)&(*(it - 1))->base;
+    ma_node* next = (it + 1 == bus->effects.end()) ? (ma_node*)&bus->output.base : (ma_node*)&(*(it + 1))->base;
+    ma_node_attach_output_bus(previous, 0, next, 0);
+    bus->effects.erase(it);
+    DestroyEffect(effect);
 }
 
-/* AudioListener */
-uint32_t alimerAudioEngineGetListenerCount(AudioEngine* engine)
+uint32_t alimerAudioBusGetEffectCount(AudioBus* bus)
 {
-    return engine->listenerCount;
+    return (uint32_t)bus->effects.size();
 }
 
-void alimerAudioEngineListenerSetPosition(AudioEngine* engine, uint32_t listenerIndex, const Vector3* position)
+AudioEffect* alimerAudioBusGetEffect(AudioBus* bus, uint32_t index)
 {
-    ALIMER_ASSERT(position);
+    if (index >= bus->effects.size())
+        return nullptr;
 
-    ma_engine_listener_set_position(&engine->handle, listenerIndex, position->x, position->y, position->z);
+    return bus->effects[index];
 }
 
-void alimerAudioEngineListenerGetPosition(const AudioEngine* engine, uint32_t listenerIndex, Vector3* result)
+uint64_t alimerAudioBusGetProcessingTime(AudioBus* bus)
 {
-    FromMiniaudio(ma_engine_listener_get_position(&engine->handle, listenerIndex), result);
+    uint64_t time = 0;
+    for (const AudioEffect* effect : bus->effects)
+    {
+        time += effect->processingTime.load(std::memory_order_relaxed);
+    }
+    return time;
 }
 
-bool alimerAudioEngineListenerIsEnabled(AudioEngine* engine, uint32_t listenerIndex)
+/* AudioEffect */
+AudioEffectType alimerAudioEffectGetType(AudioEffect* effect)
 {
-    return ma_engine_listener_is_enabled(&engine->handle, listenerIndex) == MA_TRUE;
+    return effect->type;
 }
 
-void alimerAudioEngineListenerSetEnabled(AudioEngine* engine, uint32_t listenerIndex, bool enabled)
+bool alimerAudioEffectIsEnabled(AudioEffect* effect)
 {
-    ma_engine_listener_set_enabled(&engine->handle, listenerIndex, enabled ? MA_TRUE : MA_FALSE);
+    return effect->enabled.load(std::memory_order_relaxed);
 }
 
-static bool alimerAudioClipInitFromDecoder(AudioClip* clip)
+void alimerAudioEffectSetEnabled(AudioEffect* effect, bool enabled)
 {
-    ma_format format = ma_format_unknown;
-    ma_decoder_get_data_format(clip->decoder, &format, &clip->channels, &clip->sampleRate, nullptr, 0);
-    clip->format = FromMiniaudio(format);
-
-    ma_uint64 frames = 0;
-    ma_result result = ma_decoder_get_length_in_pcm_frames(clip->decoder, &frames);
-    if (result != MA_SUCCESS)
-        return false;
-
-    clip->frameCount = static_cast<uint64_t>(frames);
-
-    //ma_uint64 availableFrames;
-    //ma_decoder_get_available_frames(clip->decoder, &availableFrames);
-    return true;
+    effect->enabled.store(enabled, std::memory_order_relaxed);
 }
 
-AudioClip* alimerAudioClipCreate(const char* filepath)
+void alimerAudioEffectGetParameters(AudioEffect* effect, AudioEffectDesc* result)
 {
-    AudioClip* clip = new AudioClip();
-    clip->refCount.store(1);
-    clip->decoder = (ma_decoder*)ma_malloc(sizeof(ma_decoder), nullptr);
+    std::lock_guard<std::mutex> lock(effect->parametersMutex);
+    *result = effect->parameters;
+}
 
-    ma_result result = ma_decoder_init_file(filepath, nullptr, clip->decoder);
-    if (result != MA_SUCCESS)
+void alimerAudioEffectSetParameters(AudioEffect* effect, const AudioEffectDesc* desc)
+{
+    std::lock_guard<std::mutex> lock(effect->parametersMutex);
+    const AudioEffectDesc previous = effect->parameters;
+    effect->parameters = *desc;
+    effect->parameters.type = previous.type;
+    effect->parameters.filterOrder = previous.filterOrder;
+    effect->parameters.sidechain = previous.sidechain;
+
+    // Coefficients are computed here rather than on the audio thread, which only copies them.
+    const bool cutoffChanged = effect->parameters.cutoffFrequency != previous.cutoffFrequency;
+    if (effect->type == AudioEffectType_LowPass)
     {
-        ma_free(clip->decoder, nullptr);
-        delete clip;
-        return nullptr;
+        if (cutoffChanged)
+        {
+            const ma_lpf_config config = ma_lpf_config_init(ma_format_f32, effect->channels, effect->sampleRate, effect->parameters.cutoffFrequency, effect->parameters.filterOrder);
+            ma_lpf_reinit(&config, &effect->parameterLowPass);
+        }
+        effect->filterSlots[effect->writeSlot].Store(effect->parameterLowPass);
     }
-
-    if (!alimerAudioClipInitFromDecoder(clip))
+    else if (effect->type == AudioEffectType_HighPass)
     {
-        ma_free(clip->decoder, nullptr);
-        delete clip;
-        return nullptr;
+        if (cutoffChanged)
+        {
+            const ma_hpf_config config = ma_hpf_config_init(ma_format_f32, effect->channels, effect->sampleRate, effect->parameters.cutoffFrequency, effect->parameters.filterOrder);
+            ma_hpf_reinit(&config, &effect->parameterHighPass);
+        }
+        effect->filterSlots[effect->writeSlot].Store(effect->parameterHighPass);
     }
 
-    return clip;
+    effect->parameterSlots[effect->writeSlot] = effect->parameters;
+    effect->writeSlot = effect->sharedSlot.exchange(effect->writeSlot | AudioEffect::kParametersChanged, std::memory_order_acq_rel) & ~AudioEffect::kParametersChanged;
 }
 
-AudioClip* alimerAudioClipCreateFromMemory(const void* pData, size_t dataSize)
+/* AudioSource */
+static ma_result CreateStreamingVoice(AudioEngine* engine, const AudioClip* clip, StreamingVoice** pVoice)
 {
-    AudioClip* clip = new AudioClip();
-    clip->refCount.store(1);
-    clip->decoder = (ma_decoder*)ma_malloc(sizeof(ma_decoder), nullptr);
-
-    ma_result result = ma_decoder_init_memory(pData, dataSize, nullptr, clip->decoder);
+    StreamingVoice* voice = new StreamingVoice();
+    ma_result result = InitDecoder(clip, &voice->decoder);
     if (result != MA_SUCCESS)
     {
-        ma_free(clip->decoder, nullptr);
-        delete clip;
-        return nullptr;
+        delete voice;
+        return result;
     }
 
-    if (!alimerAudioClipInitFromDecoder(clip))
+    ma_data_source_config baseConfig = ma_data_source_config_init();
+    baseConfig.vtable = &s_streamingVoiceVTable;
+    result = ma_data_source_init(&baseConfig, &voice->base);
+    if (result != MA_SUCCESS)
     {
-        ma_free(clip->decoder, nullptr);
-        delete clip;
-        return nullptr;
+        ma_decoder_uninit(&voice->decoder);
+        delete voice;
+        return result;
     }
 
-    return clip;
+    voice->channels = clip->channels;
+    voice->sampleRate = clip->sampleRate;
+    voice->lengthInFrames = clip->frameCount;
+    voice->engineUnderrunCount = &engine->streamUnderrunCount;
+    voice->profile = &engine->profile;
 
-}
+    const uint64_t prefetchFrames = std::max<uint64_t>((uint64_t)clip->sampleRate * engine->streamBufferMilliseconds / 1000, kStreamChunkFrameCount * 4);
+    voice->frameCapacity = kStreamChunkFrameCount;
+    while (voice->frameCapacity < prefetchFrames)
+        voice->frameCapacity *= 2;
+    voice->ring.resize((size_t)voice->frameCapacity * voice->channels);
 
-uint32_t alimerAudioClipAddRef(AudioClip* clip)
-{
-    return ++clip->refCount;
+    // Fill the ring up front so that playback can start right away.
+    voice->Refill();
+    engine->streamer.Register(voice);
+
+    *pVoice = voice;
+    return MA_SUCCESS;
 }
 
-uint32_t alimerAudioClipRelease(AudioClip* clip)
+static ma_result CreateMixerVoice(AudioEngine* engine, ma_data_source* input, const AudioClip* clip, MixerVoice** pVoice)
 {
-    uint32_t newCount = --clip->refCount;
-    if (newCount == 0)
+    MixerVoice* voice = new MixerVoice();
+    ma_data_source_config baseConfig = ma_data_source_config_init();
+    baseConfig.vtable = &s_mixerVoiceVTable;
+    ma_result result = ma_data_source_init(&baseConfig, &voice->base);
+    if (result != MA_SUCCESS)
+    {
+        delete voice;
+        return result;
+    }
+
+    voice->input = input;
+    voice->scratch = &engine->mixerScratch;
+    voice->profile = &engine->profile;
+    voice->resampler = engine->resampler;
+    voice->inputChannels = clip->channels;
+    voice->inputSampleRate = clip->sampleRate;
+    voice->outputChannels = ma_engine_get_channels(&engine->handle);
+    voice->outputSampleRate = ma_engine_get_sample_rate(&engine->handle);
+    std::fill(voice->gains, voice->gains + kMixerMaxChannels, 1.0f);
+    std::fill(voice->targetGains, voice->targetGains + kMixerMaxChannels, 1.0f);
+    voice->Reset();
+
+    // Same conversion as the miniaudio spatializer, taken from the response of each input channel.
+    ma_channel inputMap[kMixerMaxChannels];
+    ma_get_default_channel_map_for_spatializer(inputMap, kMixerMaxChannels, voice->inputChannels);
+    memcpy(voice->outputMap, engine->channelMap, sizeof(voice->outputMap));
+    for (uint32_t inputChannel = 0; inputChannel < voice->inputChannels; ++inputChannel)
     {
-        if (clip->decoder)
+        float impulse[kMixerMaxChannels] = {};
+        float response[kMixerMaxChannels] = {};
+        impulse[inputChannel] = 1.0f;
+        ma_channel_map_apply_f32(response, voice->outputMap, voice->outputChannels, impulse, inputMap, voice->inputChannels, 1, ma_channel_mix_mode_rectangular, ma_mono_expansion_mode_default);
+        for (uint32_t channel = 0; channel < voice->outputChannels; ++channel)
         {
-            ma_decoder_uninit(clip->decoder);
-            ma_free(clip->decoder, nullptr);
+            voice->channelWeights[channel][inputChannel] = response[channel];
         }
-
-        delete clip;
     }
-    return newCount;
-}
-
-AudioFormat alimerAudioClipGetFormat(AudioClip* clip)
-{
-    return clip->format;
-}
-
-uint32_t alimerAudioClipGetChannelCount(AudioClip* clip)
-{
-    return clip->channels;
-}
 
-uint32_t alimerAudioClipGetSampleRate(AudioClip* clip)
-{
-    return clip->sampleRate;
-}
+    for (uint32_t channel = 0; channel < voice->outputChannels; ++channel)
+    {
+        int32_t source = MixerVoice::kSilentChannel;
+        for (uint32_t inputChannel = 0; inputChannel < voice->inputChannels; ++inputChannel)
+        {
+            const float weight = voice->channelWeights[channel][inputChannel];
+            if (weight == 0.0f)
+                continue;
 
-uint64_t alimerAudioClipGetFrameCount(AudioClip* clip)
-{
-    return clip->frameCount;
-}
+            source = (source == MixerVoice::kSilentChannel && weight == 1.0f) ? (int32_t)inputChannel : MixerVoice::kMixedChannel;
+        }
+        voice->channelSources[channel] = source;
+    }
 
-uint32_t alimerAudioClipGetStride(AudioClip* clip)
-{
-    return clip->channels * FormatSize(clip->format);
+    *pVoice = voice;
+    return MA_SUCCESS;
 }
 
-/* AudioSource */
 AudioSource* alimerAudioSourceCreate(AudioEngine* engine, AudioClip* clip)
 {
     AudioSource* source = new AudioSource();
     source->refCount.store(1);
+    source->engine = engine;
     source->clip = clip;
     alimerAudioClipAddRef(clip);
-    source->handle = (ma_sound*)ma_malloc(sizeof(ma_sound), nullptr);
 
-    ma_uint32 soundFlags = 0; // MA_SOUND_FLAG_STREAM
-    ma_result result = ma_sound_init_from_data_source(&engine->handle, clip->decoder, soundFlags, nullptr, source->handle);
+    ma_data_source* dataSource = nullptr;
+    ma_result result;
+    if (clip->mode == AudioClipMode_Decompressed)
+    {
+        result = ma_audio_buffer_ref_init(ma_format_f32, clip->channels, clip->samples.data(), clip->frameCount, &source->bufferRef);
+        source->bufferRefInitialized = result == MA_SUCCESS;
+        source->bufferRef.sampleRate = clip->sampleRate;
+        dataSource = &source->bufferRef;
+    }
+    else
+    {
+        result = CreateStreamingVoice(engine, clip, &source->stream);
+        dataSource = source->stream;
+    }
+
+    // The mixer voice replaces the miniaudio resampler and spatializer.
+    ma_uint32 soundFlags = 0;
+    const uint32_t outputChannels = ma_engine_get_channels(&engine->handle);
+    if (result == MA_SUCCESS && clip->channels <= kMixerMaxChannels && outputChannels <= kMixerMaxChannels)
+    {
+        result = CreateMixerVoice(engine, dataSource, clip, &source->voice);
+        if (result == MA_SUCCESS)
+        {
+            dataSource = &source->voice->base;
+            soundFlags = MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_NO_SPATIALIZATION;
+        }
+    }
+
+    if (result == MA_SUCCESS)
+    {
+        source->handle = (ma_sound*)ma_malloc(sizeof(ma_sound), nullptr);
+        result = ma_sound_init_from_data_source(&engine->handle, dataSource, soundFlags, nullptr, source->handle);
+        if (result != MA_SUCCESS)
+        {
+            ma_free(source->handle, nullptr);
+            source->handle = nullptr;
+        }
+    }
+
     if (result != MA_SUCCESS)
     {
-        alimerLogError(LogCategory_Audio, "Failed to initialize audio source!");
-        ma_free(source->handle, nullptr);
-        delete source;
+        alimerLogError(LogCategory_Audio, "Failed to initialize audio source: %s", ma_result_description(result));
+        alimerAudioSourceRelease(source);
         return nullptr;
     }
 
+    source->volume = ma_sound_get_volume(source->handle);
+    source->pan = ma_sound_get_pan(source->handle);
+    source->pitch = ma_sound_get_pitch(source->handle);
+    source->position = ma_sound_get_position(source->handle);
+    source->direction = ma_sound_get_direction(source->handle);
+    source->velocity = ma_sound_get_velocity(source->handle);
+
+    if (source->voice)
+    {
+        source->voice->sound = source->handle;
+        source->Post(AudioCommandType::AttachVoice);
+    }
+
+    std::lock_guard<std::mutex> lock(engine->sourcesMutex);
+    engine->sources.push_back(source);
     return source;
 }
 
@@ -685,6 +3667,19 @@ uint32_t alimerAudioSourceRelease(AudioSource* source)
     uint32_t newCount = --source->refCount;
     if (newCount == 0)
     {
+        {
+            std::lock_guard<std::mutex> lock(source->engine->sourcesMutex);
+            std::vector<AudioSource*>& sources = source->engine->sources;
+            sources.erase(std::remove(sources.begin(), sources.end(), source), sources.end());
+        }
+
+        if (source->voice && source->handle)
+        {
+            source->Post(AudioCommandType::DetachVoice);
+        }
+
+        source->engine->WaitForCommands(source);
+
         if (source->handle)
         {
             ma_sound_uninit(source->handle);
@@ -692,6 +3687,31 @@ uint32_t alimerAudioSourceRelease(AudioSource* source)
             source->handle = nullptr;
         }
 
+        if (source->voice)
+        {
+            ma_data_source_uninit(&source->voice->base);
+            delete source->voice;
+        }
+
+        if (source->bus)
+        {
+            alimerAudioBusRelease(source->bus);
+        }
+
+        if (source->stream)
+        {
+            source->engine->streamer.Unregister(source->stream);
+            ma_decoder_uninit(&source->stream->decoder);
+            ma_data_source_uninit(&source->stream->base);
+            delete source->stream;
+        }
+
+        // Creation failures release the source before its data source is initialized.
+        if (source->bufferRefInitialized)
+        {
+            ma_audio_buffer_ref_uninit(&source->bufferRef);
+        }
+
         alimerAudioClipRelease(source->clip);
         delete source;
     }
@@ -700,52 +3720,42 @@ uint32_t alimerAudioSourceRelease(AudioSource* source)
 
 void alimerAudioSourcePlay(AudioSource* source)
 {
-    ma_result result = ma_sound_start(source->handle);
-    if (result != MA_SUCCESS)
-    {
-        alimerLogError(LogCategory_Audio, "ma_sound_start failed: %s", ma_result_description(result));
-    }
+    source->playRequested = true;
+    source->Post(AudioCommandType::Play);
 }
 
 void alimerAudioSourcePause(AudioSource* source)
 {
-    ma_result result = ma_sound_stop(source->handle);
-    if (result != MA_SUCCESS)
-    {
-        alimerLogError(LogCategory_Audio, "ma_sound_stop failed: %s", ma_result_description(result));
-    }
+    source->playRequested = false;
+    source->Post(AudioCommandType::Pause);
 }
 
 void alimerAudioSourceStop(AudioSource* source)
 {
-    ma_result result = ma_sound_stop(source->handle);
-    if (result != MA_SUCCESS)
-    {
-        alimerLogError(LogCategory_Audio, "ma_sound_stop failed: %s", ma_result_description(result));
-    }
-    ma_sound_seek_to_pcm_frame(source->handle, 0);
+    source->playRequested = false;
+    source->Post(AudioCommandType::Stop);
 }
 
 float alimerAudioSourceGetVolume(AudioSource* source, VolumeUnit unit)
 {
-    const float volume = ma_sound_get_volume(source->handle);
-    return (unit == VolumeUnit_Linear) ? volume : ma_volume_linear_to_db(volume);
+    return (unit == VolumeUnit_Linear) ? source->volume : ma_volume_linear_to_db(source->volume);
 }
 
 void alimerAudioSourceSetVolume(AudioSource* source, float value, VolumeUnit unit)
 {
-    const float volume = (unit == VolumeUnit_Linear) ? value : ma_volume_db_to_linear(value);
-    ma_sound_set_volume(source->handle, volume);
+    source->volume = (unit == VolumeUnit_Linear) ? value : ma_volume_db_to_linear(value);
+    source->Post(AudioCommandType::SetVolume, source->volume);
 }
 
 float alimerAudioSourceGetPan(const AudioSource* source)
 {
-    return ma_sound_get_pan(source->handle);
+    return source->pan;
 }
 
 void alimerAudioSourceSetPan(AudioSource* source, float value)
 {
-    ma_sound_set_pan(source->handle, value);
+    source->pan = value;
+    source->Post(AudioCommandType::SetPan, value);
 }
 
 AudioPanMode alimerAudioSourceGetPanMode(const AudioSource* source)
@@ -760,58 +3770,184 @@ void alimerAudioSourceSetPanMode(AudioSource* source, AudioPanMode value)
 
 float alimerAudioSourceGetPitch(const AudioSource* source)
 {
-    return ma_sound_get_pitch(source->handle);
+    return source->pitch;
 }
 
 void alimerAudioSourceSetPitch(AudioSource* source, float value)
 {
-    ma_sound_set_pitch(source->handle, value);
+    source->pitch = value;
+    source->Post(AudioCommandType::SetPitch, value);
+}
+
+AudioBus* alimerAudioSourceGetBus(const AudioSource* source)
+{
+    return source->bus;
+}
+
+void alimerAudioSourceSetBus(AudioSource* source, AudioBus* bus)
+{
+    if (source->bus == bus)
+        return;
+
+    if (bus)
+        alimerAudioBusAddRef(bus);
+
+    ma_node_attach_output_bus(source->handle, 0, bus ? (ma_node*)&bus->group : source->engine->endpointNode, 0);
+    if (source->bus)
+        alimerAudioBusRelease(source->bus);
+    source->bus = bus;
+}
+
+int32_t alimerAudioSourceGetPriority(const AudioSource* source)
+{
+    return source->priority;
+}
+
+void alimerAudioSourceSetPriority(AudioSource* source, int32_t value)
+{
+    source->priority = value;
+}
+
+bool alimerAudioSourceIsVirtual(const AudioSource* source)
+{
+    return source->virtualRequested;
+}
+
+uint64_t alimerAudioSourceGetProcessingTime(const AudioSource* source)
+{
+    return source->voice ? source->voice->processingTime.load(std::memory_order_relaxed) : 0;
 }
 
 bool alimerAudioSourceIsSpatializationEnabled(const AudioSource* source)
 {
+    if (source->voice)
+        return source->voice->spatialize.load(std::memory_order_relaxed);
+
     return ma_sound_is_spatialization_enabled(source->handle) == MA_TRUE;
 }
 
 void alimerAudioSourceSetSpatializationEnabled(AudioSource* source, bool enabled)
 {
+    if (source->voice)
+    {
+        source->voice->spatialize.store(enabled, std::memory_order_relaxed);
+        return;
+    }
+
     ma_sound_set_spatialization_enabled(source->handle, enabled ? MA_TRUE : MA_FALSE);
 }
 
 void alimerAudioSourceGetPosition(const AudioSource* source, Vector3* result)
 {
-    FromMiniaudio(ma_sound_get_position(source->handle), result);
+    FromMiniaudio(source->position, result);
 }
 
 void alimerAudioSourceSetPosition(AudioSource* source, const Vector3* value)
 {
     ALIMER_ASSERT(value);
 
-    ma_sound_set_position(source->handle, value->x, value->y, value->z);
+    source->position = ToMiniaudio(*value);
+    source->Post(AudioCommandType::SetPosition, source->position);
 }
 
 void alimerAudioSourceGetDirection(const AudioSource* source, Vector3* result)
 {
-    FromMiniaudio(ma_sound_get_direction(source->handle), result);
+    FromMiniaudio(source->direction, result);
 }
 
 void alimerAudioSourceSetDirection(AudioSource* source, const Vector3* value)
 {
     ALIMER_ASSERT(value);
 
-    ma_sound_set_direction(source->handle, value->x, value->y, value->z);
+    source->direction = ToMiniaudio(*value);
+    source->Post(AudioCommandType::SetDirection, source->direction);
 }
 
 void alimerAudioSourceGetVelocity(const AudioSource* source, Vector3* result)
 {
-    FromMiniaudio(ma_sound_get_velocity(source->handle), result);
+    FromMiniaudio(source->velocity, result);
 }
 
 void alimerAudioSourceSetVelocity(AudioSource* source, const Vector3* value)
 {
     ALIMER_ASSERT(value);
 
-    ma_sound_set_velocity(source->handle, value->x, value->y, value->z);
+    source->velocity = ToMiniaudio(*value);
+    source->Post(AudioCommandType::SetVelocity, source->velocity);
+}
+
+bool alimerAudioSourcesSetSpatialBatch(uint32_t count, AudioSource* const* sources, const Vector3* positions, const Vector3* velocities, const Vector3* directions)
+{
+    const uint32_t commandsPerSource = (positions != nullptr ? 1u : 0u) + (velocities != nullptr ? 1u : 0u) + (directions != nullptr ? 1u : 0u);
+
+    // Reject the whole call before touching any source, a batch is never split across callbacks.
+    uint32_t begin = 0;
+    while (begin < count)
+    {
+        uint32_t end = begin + 1;
+        while (end < count && sources[end]->engine == sources[begin]->engine)
+        {
+            ++end;
+        }
+
+        if (uint64_t(end - begin) * commandsPerSource > kAudioCommandQueueCapacity)
+        {
+            alimerLogError(LogCategory_Audio, "Spatial batch of %u sources exceeds %u commands per engine", end - begin, kAudioCommandQueueCapacity);
+            return false;
+        }
+        begin = end;
+    }
+
+    begin = 0;
+    while (begin < count)
+    {
+        // Sources of the same engine are posted together.
+        AudioEngine* engine = sources[begin]->engine;
+        uint32_t end = begin + 1;
+        while (end < count && sources[end]->engine == engine)
+        {
+            ++end;
+        }
+
+        std::lock_guard<std::mutex> lock(engine->commandMutex);
+        std::vector<AudioCommand>& batch = engine->batchCommands;
+        batch.clear();
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            AudioSource* source = sources[i];
+            AudioCommand command = {};
+            command.source = source;
+
+            if (positions != nullptr)
+            {
+                source->position = ToMiniaudio(positions[i]);
+                command.type = AudioCommandType::SetPosition;
+                command.vector = source->position;
+                batch.push_back(command);
+            }
+
+            if (velocities != nullptr)
+            {
+                source->velocity = ToMiniaudio(velocities[i]);
+                command.type = AudioCommandType::SetVelocity;
+                command.vector = source->velocity;
+                batch.push_back(command);
+            }
+
+            if (directions != nullptr)
+            {
+                source->direction = ToMiniaudio(directions[i]);
+                command.type = AudioCommandType::SetDirection;
+                command.vector = source->direction;
+                batch.push_back(command);
+            }
+        }
+
+        engine->PostCommands(batch.data(), (uint32_t)batch.size());
+        begin = end;
+    }
+
+    return true;
 }
 
 AudioAttenuationModel alimerAudioSourceGetAttenuationModel(const AudioSource* source)
@@ -915,6 +4051,13 @@ void alimerAudioSourceSetDopplerFactor(AudioSource* sound, float value)
 
 bool alimerAudioSourceIsPlaying(AudioSource* source)
 {
+    // Report the requested state until the audio thread has applied it.
+    if (source->pendingTransportCommands.load(std::memory_order_acquire) > 0)
+        return source->playRequested;
+
+    if (source->virtualPlayingShared.load(std::memory_order_acquire))
+        return ma_engine_get_time_in_pcm_frames(&source->engine->handle) < source->virtualEndTime.load(std::memory_order_relaxed);
+
     return ma_sound_is_playing(source->handle) == MA_TRUE;
 }
 
@@ -945,21 +4088,22 @@ bool alimerAudioSourceIsAtEnd(const AudioSource* source)
 
 void alimerAudioSourceSeekToPCMFrame(const AudioSource* source, uint64_t frameIndex)
 {
-    ma_result result = ma_sound_seek_to_pcm_frame(source->handle, frameIndex);
-    if (result != MA_SUCCESS)
-    {
-        alimerLogError(LogCategory_Audio, "ma_sound_seek_to_pcm_frame failed: %s", ma_result_description(result));
-    }
+    AudioCommand command = {};
+    command.type = AudioCommandType::SeekToPCMFrame;
+    command.source = const_cast<AudioSource*>(source);
+    command.frameIndex = frameIndex;
+    source->engine->PostCommand(command);
 }
 
 void alimerAudioSourceSeekToSecond(const AudioSource* source, float seekPointInSeconds)
 {
-    // ma_sound_get_data_format -> frameIndex = (ma_uint64)(seekPointInSeconds * sampleRate) -> ma_sound_seek_to_pcm_frame(frameIndex)
-    ma_result result = ma_sound_seek_to_second(source->handle, seekPointInSeconds);
-    if (result != MA_SUCCESS)
-    {
-        alimerLogError(LogCategory_Audio, "ma_sound_seek_to_second failed: %s", ma_result_description(result));
-    }
+    // Cursors are in clip frames, the sound itself reports the engine rate when mixed by a voice.
+    alimerAudioSourceSeekToPCMFrame(source, (uint64_t)(seekPointInSeconds * source->clip->sampleRate));
+}
+
+uint32_t alimerAudioSourceGetStreamUnderrunCount(const AudioSource* source)
+{
+    return source->stream ? source->stream->underrunCount.load(std::memory_order_relaxed) : 0;
 }
 
 uint64_t alimerAudioSourceGetCursorInPCMFrames(const AudioSource* source)
@@ -988,28 +4132,18 @@ uint64_t alimerAudioSourceGetLengthInPCMFrames(const AudioSource* source)
 
 float alimerAudioSourceGetCursorInSeconds(const AudioSource* source)
 {
-    float cursor = 0.0f;
-    ma_result result = ma_sound_get_cursor_in_seconds(source->handle, &cursor);
-    if (result != MA_SUCCESS)
-    {
-        alimerLogError(LogCategory_Audio, "ma_sound_get_cursor_in_seconds failed: %s", ma_result_description(result));
+    if (source->clip->sampleRate == 0)
         return 0.0f;
-    }
 
-    return cursor;
+    return (float)((double)alimerAudioSourceGetCursorInPCMFrames(source) / source->clip->sampleRate);
 }
 
 float alimerAudioSourceGetLengthInSeconds(const AudioSource* source)
 {
-    float length = 0.0f;
-    ma_result result = ma_sound_get_length_in_seconds(source->handle, &length);
-    if (result != MA_SUCCESS)
-    {
-        alimerLogError(LogCategory_Audio, "ma_sound_get_length_in_seconds failed: %s", ma_result_description(result));
+    if (source->clip->sampleRate == 0)
         return 0.0f;
-    }
 
-    return length;
+    return (float)((double)alimerAudioSourceGetLengthInPCMFrames(source) / source->clip->sampleRate);
 }
 
 #endif /* defined(ALIMER_AUDIO) */
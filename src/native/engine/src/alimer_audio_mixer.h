@@ -0,0 +1,604 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+#ifndef ALIMER_AUDIO_MIXER_H_
+#define ALIMER_AUDIO_MIXER_H_
+
+#include "alimer_internal.h"
+#include "alimer_audio.h"
+#include <math.h>
+
+#if defined(ALIMER_USE_SSE)
+#   include <xmmintrin.h>
+#elif defined(ALIMER_USE_NEON)
+#   include <arm_neon.h>
+#endif
+
+/* Mixer kernels of the audio engine. Samples are float32, voices are resampled and mixed in planar blocks. */
+namespace
+{
+    constexpr uint32_t kMixerMaxChannels = 8;
+    /// Voices whose spatial gains are computed together.
+    constexpr uint32_t kSpatialBatchSize = 64;
+
+    constexpr uint32_t kPolyphaseTaps = 16;
+    constexpr uint32_t kPolyphasePhaseBits = 7;
+    constexpr uint32_t kPolyphasePhases = 1u << kPolyphasePhaseBits;
+    /// Input frames read before and after the resampling position.
+    constexpr uint32_t kPolyphaseLookBehind = kPolyphaseTaps / 2 - 1;
+    constexpr uint32_t kPolyphaseLookAhead = kPolyphaseTaps / 2;
+    /// Filter cutoff relative to the input Nyquist frequency.
+    constexpr double kPolyphaseCutoff = 0.92;
+
+    /// Resampling positions are 32.32 fixed point frame indices.
+    constexpr uint32_t kMixerFractionBits = 32;
+    constexpr uint64_t kMixerFractionOne = 1ull << kMixerFractionBits;
+    constexpr uint64_t kMixerFractionMask = kMixerFractionOne - 1;
+
+#if defined(ALIMER_USE_SSE)
+    using Float4 = __m128;
+    using Float4Mask = __m128;
+
+    ALIMER_FORCE_INLINE Float4 Float4Load(const float* source) { return _mm_loadu_ps(source); }
+    ALIMER_FORCE_INLINE void Float4Store(float* destination, Float4 value) { _mm_storeu_ps(destination, value); }
+    ALIMER_FORCE_INLINE Float4 Float4Splat(float value) { return _mm_set1_ps(value); }
+    ALIMER_FORCE_INLINE Float4 Float4Set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+    ALIMER_FORCE_INLINE Float4 Float4Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+    ALIMER_FORCE_INLINE Float4Mask Float4Greater(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+    ALIMER_FORCE_INLINE Float4Mask Float4Equal(Float4 a, Float4 b) { return _mm_cmpeq_ps(a, b); }
+    ALIMER_FORCE_INLINE Float4Mask Float4And(Float4Mask a, Float4Mask b) { return _mm_and_ps(a, b); }
+    /// mask ? a : b
+    ALIMER_FORCE_INLINE Float4 Float4Select(Float4Mask mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+    /// a * b + c
+    ALIMER_FORCE_INLINE Float4 Float4MulAdd(Float4 a, Float4 b, Float4 c)
+    {
+#   if defined(ALIMER_USE_FMADD)
+        return _mm_fmadd_ps(a, b, c);
+#   else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#   endif
+    }
+
+    ALIMER_FORCE_INLINE float Float4Sum(Float4 value)
+    {
+        value = _mm_add_ps(value, _mm_movehl_ps(value, value));
+        value = _mm_add_ss(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 1, 1, 1)));
+        return _mm_cvtss_f32(value);
+    }
+
+    ALIMER_FORCE_INLINE void Float4Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+    {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+
+    /// {a0, b0, a1, b1} and {a2, b2, a3, b3}
+    ALIMER_FORCE_INLINE void Float4Zip(Float4 a, Float4 b, Float4& low, Float4& high)
+    {
+        low = _mm_unpacklo_ps(a, b);
+        high = _mm_unpackhi_ps(a, b);
+    }
+
+    /// {a0, a2, b0, b2} and {a1, a3, b1, b3}
+    ALIMER_FORCE_INLINE void Float4Unzip(Float4 a, Float4 b, Float4& even, Float4& odd)
+    {
+        even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    ALIMER_FORCE_INLINE void Float4StoreLow2(float* destination, Float4 value) { _mm_storel_pi((__m64*)destination, value); }
+    ALIMER_FORCE_INLINE void Float4StoreHigh2(float* destination, Float4 value) { _mm_storeh_pi((__m64*)destination, value); }
+#elif defined(ALIMER_USE_NEON)
+    using Float4 = float32x4_t;
+    using Float4Mask = uint32x4_t;
+
+    ALIMER_FORCE_INLINE Float4 Float4Load(const float* source) { return vld1q_f32(source); }
+    ALIMER_FORCE_INLINE void Float4Store(float* destination, Float4 value) { vst1q_f32(destination, value); }
+    ALIMER_FORCE_INLINE Float4 Float4Splat(float value) { return vdupq_n_f32(value); }
+    ALIMER_FORCE_INLINE Float4 Float4Set(float x, float y, float z, float w)
+    {
+        const float values[4] = { x, y, z, w };
+        return vld1q_f32(values);
+    }
+    ALIMER_FORCE_INLINE Float4 Float4Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4MulAdd(Float4 a, Float4 b, Float4 c) { return vmlaq_f32(c, a, b); }
+    ALIMER_FORCE_INLINE Float4Mask Float4Greater(Float4 a, Float4 b) { return vcgtq_f32(a, b); }
+    ALIMER_FORCE_INLINE Float4Mask Float4Equal(Float4 a, Float4 b) { return vceqq_f32(a, b); }
+    ALIMER_FORCE_INLINE Float4Mask Float4And(Float4Mask a, Float4Mask b) { return vandq_u32(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Select(Float4Mask mask, Float4 a, Float4 b) { return vbslq_f32(mask, a, b); }
+
+#   if defined(__aarch64__) || defined(_M_ARM64)
+    ALIMER_FORCE_INLINE Float4 Float4Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+    ALIMER_FORCE_INLINE Float4 Float4Sqrt(Float4 a) { return vsqrtq_f32(a); }
+    ALIMER_FORCE_INLINE float Float4Sum(Float4 value) { return vaddvq_f32(value); }
+#   else
+    ALIMER_FORCE_INLINE Float4 Float4Div(Float4 a, Float4 b)
+    {
+        // Two Newton-Raphson steps on the reciprocal estimate.
+        float32x4_t reciprocal = vrecpeq_f32(b);
+        reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+        reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+        return vmulq_f32(a, reciprocal);
+    }
+
+    ALIMER_FORCE_INLINE Float4 Float4Sqrt(Float4 a)
+    {
+        return Float4Set(sqrtf(vgetq_lane_f32(a, 0)), sqrtf(vgetq_lane_f32(a, 1)), sqrtf(vgetq_lane_f32(a, 2)), sqrtf(vgetq_lane_f32(a, 3)));
+    }
+
+    ALIMER_FORCE_INLINE float Float4Sum(Float4 value)
+    {
+        float32x2_t sum = vadd_f32(vget_low_f32(value), vget_high_f32(value));
+        return vget_lane_f32(vpadd_f32(sum, sum), 0);
+    }
+#   endif
+
+    ALIMER_FORCE_INLINE void Float4Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+    {
+        const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+    ALIMER_FORCE_INLINE void Float4Zip(Float4 a, Float4 b, Float4& low, Float4& high)
+    {
+        const float32x4x2_t zipped = vzipq_f32(a, b);
+        low = zipped.val[0];
+        high = zipped.val[1];
+    }
+
+    ALIMER_FORCE_INLINE void Float4Unzip(Float4 a, Float4 b, Float4& even, Float4& odd)
+    {
+        const float32x4x2_t unzipped = vuzpq_f32(a, b);
+        even = unzipped.val[0];
+        odd = unzipped.val[1];
+    }
+
+    ALIMER_FORCE_INLINE void Float4StoreLow2(float* destination, Float4 value) { vst1_f32(destination, vget_low_f32(value)); }
+    ALIMER_FORCE_INLINE void Float4StoreHigh2(float* destination, Float4 value) { vst1_f32(destination, vget_high_f32(value)); }
+#else
+    struct Float4 { float v[4]; };
+    struct Float4Mask { bool v[4]; };
+
+    ALIMER_FORCE_INLINE Float4 Float4Load(const float* source) { return { { source[0], source[1], source[2], source[3] } }; }
+    ALIMER_FORCE_INLINE void Float4Store(float* destination, Float4 value) { memcpy(destination, value.v, sizeof(value.v)); }
+    ALIMER_FORCE_INLINE Float4 Float4Splat(float value) { return { { value, value, value, value } }; }
+    ALIMER_FORCE_INLINE Float4 Float4Set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+
+#   define ALIMER_FLOAT4_OP(name, expression) \
+    ALIMER_FORCE_INLINE Float4 name(Float4 a, Float4 b) \
+    { \
+        Float4 result; \
+        for (int i = 0; i < 4; ++i) { const float x = a.v[i]; const float y = b.v[i]; result.v[i] = (expression); } \
+        return result; \
+    }
+    ALIMER_FLOAT4_OP(Float4Add, x + y)
+    ALIMER_FLOAT4_OP(Float4Sub, x - y)
+    ALIMER_FLOAT4_OP(Float4Mul, x * y)
+    ALIMER_FLOAT4_OP(Float4Div, x / y)
+    ALIMER_FLOAT4_OP(Float4Min, x < y ? x : y)
+    ALIMER_FLOAT4_OP(Float4Max, x > y ? x : y)
+#   undef ALIMER_FLOAT4_OP
+
+    ALIMER_FORCE_INLINE Float4 Float4MulAdd(Float4 a, Float4 b, Float4 c) { return Float4Add(Float4Mul(a, b), c); }
+    ALIMER_FORCE_INLINE Float4 Float4Sqrt(Float4 a) { return { { sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3]) } }; }
+    ALIMER_FORCE_INLINE Float4Mask Float4Greater(Float4 a, Float4 b) { return { { a.v[0] > b.v[0], a.v[1] > b.v[1], a.v[2] > b.v[2], a.v[3] > b.v[3] } }; }
+    ALIMER_FORCE_INLINE Float4Mask Float4Equal(Float4 a, Float4 b) { return { { a.v[0] == b.v[0], a.v[1] == b.v[1], a.v[2] == b.v[2], a.v[3] == b.v[3] } }; }
+    ALIMER_FORCE_INLINE Float4Mask Float4And(Float4Mask a, Float4Mask b) { return { { a.v[0] && b.v[0], a.v[1] && b.v[1], a.v[2] && b.v[2], a.v[3] && b.v[3] } }; }
+    ALIMER_FORCE_INLINE Float4 Float4Select(Float4Mask mask, Float4 a, Float4 b)
+    {
+        return { { mask.v[0] ? a.v[0] : b.v[0], mask.v[1] ? a.v[1] : b.v[1], mask.v[2] ? a.v[2] : b.v[2], mask.v[3] ? a.v[3] : b.v[3] } };
+    }
+    ALIMER_FORCE_INLINE float Float4Sum(Float4 value) { return (value.v[0] + value.v[1]) + (value.v[2] + value.v[3]); }
+
+    ALIMER_FORCE_INLINE void Float4Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+    {
+        const Float4 a = r0, b = r1, c = r2, d = r3;
+        r0 = { { a.v[0], b.v[0], c.v[0], d.v[0] } };
+        r1 = { { a.v[1], b.v[1], c.v[1], d.v[1] } };
+        r2 = { { a.v[2], b.v[2], c.v[2], d.v[2] } };
+        r3 = { { a.v[3], b.v[3], c.v[3], d.v[3] } };
+    }
+
+    ALIMER_FORCE_INLINE void Float4Zip(Float4 a, Float4 b, Float4& low, Float4& high)
+    {
+        low = { { a.v[0], b.v[0], a.v[1], b.v[1] } };
+        high = { { a.v[2], b.v[2], a.v[3], b.v[3] } };
+    }
+
+    ALIMER_FORCE_INLINE void Float4Unzip(Float4 a, Float4 b, Float4& even, Float4& odd)
+    {
+        even = { { a.v[0], a.v[2], b.v[0], b.v[2] } };
+        odd = { { a.v[1], a.v[3], b.v[1], b.v[3] } };
+    }
+
+    ALIMER_FORCE_INLINE void Float4StoreLow2(float* destination, Float4 value) { memcpy(destination, &value.v[0], sizeof(float) * 2); }
+    ALIMER_FORCE_INLINE void Float4StoreHigh2(float* destination, Float4 value) { memcpy(destination, &value.v[2], sizeof(float) * 2); }
+#endif
+
+    /// Split interleaved frames into planes, planes[c][0] receives the first frame.
+    inline void DeinterleaveFrames(const float* source, uint32_t channels, uint32_t frameCount, float* const* planes)
+    {
+        if (channels == 1)
+        {
+            memcpy(planes[0], source, frameCount * sizeof(float));
+            return;
+        }
+
+        uint32_t frame = 0;
+        if (channels == 2)
+        {
+            for (; frame + 4 <= frameCount; frame += 4)
+            {
+                Float4 left;
+                Float4 right;
+                Float4Unzip(Float4Load(source + frame * 2), Float4Load(source + frame * 2 + 4), left, right);
+                Float4Store(planes[0] + frame, left);
+                Float4Store(planes[1] + frame, right);
+            }
+        }
+
+        for (; frame < frameCount; ++frame)
+        {
+            for (uint32_t channel = 0; channel < channels; ++channel)
+            {
+                planes[channel][frame] = source[frame * channels + channel];
+            }
+        }
+    }
+
+    /// Linear interpolation at position + i * step, input planes must hold one frame after the last position.
+    inline void ResampleLinear(const float* const* input, float* const* output, uint32_t channels, uint64_t position, uint64_t step, uint32_t frameCount)
+    {
+        const float fractionScale = 1.0f / (float)kMixerFractionOne;
+
+        uint32_t frame = 0;
+        for (; frame + 4 <= frameCount; frame += 4)
+        {
+            const uint64_t p0 = position + frame * step;
+            const uint64_t p1 = p0 + step;
+            const uint64_t p2 = p1 + step;
+            const uint64_t p3 = p2 + step;
+            const uint32_t i0 = (uint32_t)(p0 >> kMixerFractionBits);
+            const uint32_t i1 = (uint32_t)(p1 >> kMixerFractionBits);
+            const uint32_t i2 = (uint32_t)(p2 >> kMixerFractionBits);
+            const uint32_t i3 = (uint32_t)(p3 >> kMixerFractionBits);
+            const Float4 t = Float4Mul(Float4Set((float)(uint32_t)p0, (float)(uint32_t)p1, (float)(uint32_t)p2, (float)(uint32_t)p3), Float4Splat(fractionScale));
+
+            for (uint32_t channel = 0; channel < channels; ++channel)
+            {
+                const float* x = input[channel];
+                const Float4 a = Float4Set(x[i0], x[i1], x[i2], x[i3]);
+                const Float4 b = Float4Set(x[i0 + 1], x[i1 + 1], x[i2 + 1], x[i3 + 1]);
+                Float4Store(output[channel] + frame, Float4MulAdd(Float4Sub(b, a), t, a));
+            }
+        }
+
+        for (; frame < frameCount; ++frame)
+        {
+            const uint64_t p = position + frame * step;
+            const uint32_t index = (uint32_t)(p >> kMixerFractionBits);
+            const float t = (float)(uint32_t)p * fractionScale;
+            for (uint32_t channel = 0; channel < channels; ++channel)
+            {
+                const float* x = input[channel];
+                output[channel][frame] = x[index] + (x[index + 1] - x[index]) * t;
+            }
+        }
+    }
+
+    /// Windowed sinc filter bank, kPolyphasePhases + 1 rows of kPolyphaseTaps coefficients.
+    inline void BuildPolyphaseFilter(float* filter)
+    {
+        const double pi = 3.14159265358979323846;
+        const double halfWidth = kPolyphaseTaps / 2;
+        for (uint32_t phase = 0; phase <= kPolyphasePhases; ++phase)
+        {
+            float* row = filter + phase * kPolyphaseTaps;
+            const double fraction = (double)phase / kPolyphasePhases;
+
+            double sum = 0.0;
+            double coefficients[kPolyphaseTaps];
+            for (uint32_t tap = 0; tap < kPolyphaseTaps; ++tap)
+            {
+                // Distance from the output position to the input frame read by this tap.
+                const double x = (double)tap - kPolyphaseLookBehind - fraction;
+                const double sinc = x == 0.0 ? 1.0 : sin(pi * kPolyphaseCutoff * x) / (pi * kPolyphaseCutoff * x);
+                const double window = fabs(x) >= halfWidth ? 0.0 : 0.42 + 0.5 * cos(pi * x / halfWidth) + 0.08 * cos(2.0 * pi * x / halfWidth);
+                coefficients[tap] = sinc * window;
+                sum += coefficients[tap];
+            }
+
+            // Unity gain at DC for every phase.
+            for (uint32_t tap = 0; tap < kPolyphaseTaps; ++tap)
+            {
+                row[tap] = (float)(coefficients[tap] / sum);
+            }
+        }
+    }
+
+    /// Polyphase FIR at position + i * step, input planes must hold kPolyphaseLookBehind frames before and kPolyphaseLookAhead after.
+    inline void ResamplePolyphase(const float* const* input, float* const* output, uint32_t channels, uint64_t position, uint64_t step, uint32_t frameCount, const float* filter)
+    {
+        static_assert(kPolyphaseTaps == 16, "The filter loop is unrolled for 16 taps");
+        constexpr uint32_t weightBits = kMixerFractionBits - kPolyphasePhaseBits;
+        const float weightScale = 1.0f / (float)(1u << weightBits);
+
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            const uint64_t p = position + frame * step;
+            const uint32_t index = (uint32_t)(p >> kMixerFractionBits) - kPolyphaseLookBehind;
+            const uint32_t fraction = (uint32_t)p;
+            const float* row = filter + (fraction >> weightBits) * kPolyphaseTaps;
+
+            // Interpolate between the two nearest phases.
+            const Float4 weight = Float4Splat((float)(fraction & ((1u << weightBits) - 1)) * weightScale);
+            Float4 c0 = Float4Load(row + 0);
+            Float4 c1 = Float4Load(row + 4);
+            Float4 c2 = Float4Load(row + 8);
+            Float4 c3 = Float4Load(row + 12);
+            c0 = Float4MulAdd(Float4Sub(Float4Load(row + kPolyphaseTaps + 0), c0), weight, c0);
+            c1 = Float4MulAdd(Float4Sub(Float4Load(row + kPolyphaseTaps + 4), c1), weight, c1);
+            c2 = Float4MulAdd(Float4Sub(Float4Load(row + kPolyphaseTaps + 8), c2), weight, c2);
+            c3 = Float4MulAdd(Float4Sub(Float4Load(row + kPolyphaseTaps + 12), c3), weight, c3);
+
+            for (uint32_t channel = 0; channel < channels; ++channel)
+            {
+                const float* x = input[channel] + index;
+                Float4 sum = Float4Mul(c0, Float4Load(x + 0));
+                sum = Float4MulAdd(c1, Float4Load(x + 4), sum);
+                sum = Float4MulAdd(c2, Float4Load(x + 8), sum);
+                sum = Float4MulAdd(c3, Float4Load(x + 12), sum);
+                output[channel][frame] = Float4Sum(sum);
+            }
+        }
+    }
+
+    /// destination += source * weight
+    inline void AccumulatePlane(float* destination, const float* source, float weight, uint32_t frameCount)
+    {
+        const Float4 weights = Float4Splat(weight);
+        uint32_t frame = 0;
+        for (; frame + 4 <= frameCount; frame += 4)
+        {
+            Float4Store(destination + frame, Float4MulAdd(Float4Load(source + frame), weights, Float4Load(destination + frame)));
+        }
+
+        for (; frame < frameCount; ++frame)
+        {
+            destination[frame] += source[frame] * weight;
+        }
+    }
+
+    /// Interleave planes into frames while ramping every channel from gainStart to gainEnd, the last frame uses gainEnd.
+    inline void InterleaveWithGains(const float* const* planes, uint32_t channels, uint32_t frameCount, const float* gainStart, const float* gainEnd, float* output)
+    {
+        if (frameCount == 0)
+            return;
+
+        float gainSteps[kMixerMaxChannels];
+        for (uint32_t channel = 0; channel < channels; ++channel)
+        {
+            gainSteps[channel] = (gainEnd[channel] - gainStart[channel]) / (float)frameCount;
+        }
+
+        uint32_t frame = 0;
+        for (; frame + 4 <= frameCount; frame += 4)
+        {
+            const Float4 ramp = Float4Set((float)(frame + 1), (float)(frame + 2), (float)(frame + 3), (float)(frame + 4));
+            float* frames = output + frame * channels;
+
+            uint32_t channel = 0;
+            for (; channel + 4 <= channels; channel += 4)
+            {
+                Float4 r0 = Float4Mul(Float4Load(planes[channel + 0] + frame), Float4MulAdd(ramp, Float4Splat(gainSteps[channel + 0]), Float4Splat(gainStart[channel + 0])));
+                Float4 r1 = Float4Mul(Float4Load(planes[channel + 1] + frame), Float4MulAdd(ramp, Float4Splat(gainSteps[channel + 1]), Float4Splat(gainStart[channel + 1])));
+                Float4 r2 = Float4Mul(Float4Load(planes[channel + 2] + frame), Float4MulAdd(ramp, Float4Splat(gainSteps[channel + 2]), Float4Splat(gainStart[channel + 2])));
+                Float4 r3 = Float4Mul(Float4Load(planes[channel + 3] + frame), Float4MulAdd(ramp, Float4Splat(gainSteps[channel + 3]), Float4Splat(gainStart[channel + 3])));
+                Float4Transpose(r0, r1, r2, r3);
+                Float4Store(frames + channel, r0);
+                Float4Store(frames + channels + channel, r1);
+                Float4Store(frames + channels * 2 + channel, r2);
+                Float4Store(frames + channels * 3 + channel, r3);
+            }
+
+            if (channel + 2 <= channels)
+            {
+                const Float4 a = Float4Mul(Float4Load(planes[channel + 0] + frame), Float4MulAdd(ramp, Float4Splat(gainSteps[channel + 0]), Float4Splat(gainStart[channel + 0])));
+                const Float4 b = Float4Mul(Float4Load(planes[channel + 1] + frame), Float4MulAdd(ramp, Float4Splat(gainSteps[channel + 1]), Float4Splat(gainStart[channel + 1])));
+                Float4 low;
+                Float4 high;
+                Float4Zip(a, b, low, high);
+                if (channels == 2)
+                {
+                    Float4Store(frames, low);
+                    Float4Store(frames + 4, high);
+                }
+                else
+                {
+                    Float4StoreLow2(frames + channel, low);
+                    Float4StoreHigh2(frames + channels + channel, low);
+                    Float4StoreLow2(frames + channels * 2 + channel, high);
+                    Float4StoreHigh2(frames + channels * 3 + channel, high);
+                }
+                channel += 2;
+            }
+
+            for (; channel < channels; ++channel)
+            {
+                float values[4];
+                Float4Store(values, Float4Mul(Float4Load(planes[channel] + frame), Float4MulAdd(ramp, Float4Splat(gainSteps[channel]), Float4Splat(gainStart[channel]))));
+                frames[channel] = values[0];
+                frames[channels + channel] = values[1];
+                frames[channels * 2 + channel] = values[2];
+                frames[channels * 3 + channel] = values[3];
+            }
+        }
+
+        for (; frame < frameCount; ++frame)
+        {
+            for (uint32_t channel = 0; channel < channels; ++channel)
+            {
+                output[frame * channels + channel] = planes[channel][frame] * (gainStart[channel] + gainSteps[channel] * (float)(frame + 1));
+            }
+        }
+    }
+
+    /// Spatialization inputs and results of up to kSpatialBatchSize voices (SoA), positions are relative to the listener.
+    struct SpatialBatch
+    {
+        uint32_t count;
+
+        float positionX[kSpatialBatchSize];
+        float positionY[kSpatialBatchSize];
+        float positionZ[kSpatialBatchSize];
+        float directionX[kSpatialBatchSize];
+        float directionY[kSpatialBatchSize];
+        float directionZ[kSpatialBatchSize];
+        /// Source to listener in world space, for the doppler shift.
+        float toListenerX[kSpatialBatchSize];
+        float toListenerY[kSpatialBatchSize];
+        float toListenerZ[kSpatialBatchSize];
+        float velocityX[kSpatialBatchSize];
+        float velocityY[kSpatialBatchSize];
+        float velocityZ[kSpatialBatchSize];
+        float listenerVelocityX[kSpatialBatchSize];
+        float listenerVelocityY[kSpatialBatchSize];
+        float listenerVelocityZ[kSpatialBatchSize];
+        float speedOfSound[kSpatialBatchSize];
+        float dopplerFactor[kSpatialBatchSize];
+
+        /// AudioAttenuationModel values.
+        float attenuationModel[kSpatialBatchSize];
+        float minDistance[kSpatialBatchSize];
+        float maxDistance[kSpatialBatchSize];
+        float rolloff[kSpatialBatchSize];
+        float minGain[kSpatialBatchSize];
+        float maxGain[kSpatialBatchSize];
+        /// Cosine of the half cone angles, coneInnerCos below -1 disables the cone.
+        float coneInnerCos[kSpatialBatchSize];
+        float coneOuterCos[kSpatialBatchSize];
+        float coneOuterGain[kSpatialBatchSize];
+        float directionalAttenuation[kSpatialBatchSize];
+        float minChannelGain[kSpatialBatchSize];
+
+        float channelGains[kMixerMaxChannels][kSpatialBatchSize];
+        float dopplerPitch[kSpatialBatchSize];
+    };
+
+    /// Distance, cone and directional attenuation plus doppler pitch for a whole batch, matching the miniaudio spatializer.
+    /// channelDirections is null for channels without a direction (LFE).
+    inline void ComputeSpatialGains(SpatialBatch& batch, uint32_t outputChannels, const float* const* channelDirections)
+    {
+        const Float4 zero = Float4Splat(0.0f);
+        const Float4 one = Float4Splat(1.0f);
+        const Float4 half = Float4Splat(0.5f);
+        const Float4 epsilon = Float4Splat(0.001f);
+        const Float4 modelNone = Float4Splat((float)AudioAttenuationModel_None);
+        const Float4 modelInverse = Float4Splat((float)AudioAttenuationModel_Inverse);
+        const Float4 modelLinear = Float4Splat((float)AudioAttenuationModel_Linear);
+
+        for (uint32_t i = 0; i < batch.count; i += 4)
+        {
+            const Float4 x = Float4Load(batch.positionX + i);
+            const Float4 y = Float4Load(batch.positionY + i);
+            const Float4 z = Float4Load(batch.positionZ + i);
+            const Float4 distance = Float4Sqrt(Float4MulAdd(x, x, Float4MulAdd(y, y, Float4Mul(z, z))));
+
+            // Distance attenuation.
+            const Float4 minDistance = Float4Load(batch.minDistance + i);
+            const Float4 maxDistance = Float4Load(batch.maxDistance + i);
+            const Float4 rolloff = Float4Load(batch.rolloff + i);
+            const Float4 model = Float4Load(batch.attenuationModel + i);
+            const Float4 offset = Float4Sub(Float4Min(Float4Max(distance, minDistance), maxDistance), minDistance);
+            const Float4 inverse = Float4Div(minDistance, Float4MulAdd(rolloff, offset, minDistance));
+            const Float4 linear = Float4Sub(one, Float4Div(Float4Mul(rolloff, offset), Float4Sub(maxDistance, minDistance)));
+            Float4 gain = Float4Select(Float4Equal(model, modelInverse), inverse, Float4Select(Float4Equal(model, modelLinear), linear, one));
+            if (batch.attenuationModel[i] == AudioAttenuationModel_Exponential || batch.attenuationModel[i + 1] == AudioAttenuationModel_Exponential
+                || batch.attenuationModel[i + 2] == AudioAttenuationModel_Exponential || batch.attenuationModel[i + 3] == AudioAttenuationModel_Exponential)
+            {
+                float distances[4];
+                float gains[4];
+                Float4Store(distances, Float4Add(offset, minDistance));
+                Float4Store(gains, gain);
+                for (uint32_t lane = 0; lane < 4; ++lane)
+                {
+                    if (batch.attenuationModel[i + lane] == AudioAttenuationModel_Exponential)
+                        gains[lane] = powf(distances[lane] / batch.minDistance[i + lane], -batch.rolloff[i + lane]);
+                }
+                gain = Float4Load(gains);
+            }
+            gain = Float4Select(Float4Greater(maxDistance, minDistance), gain, one);
+
+            // Unit vector from the listener to the source, zero when they overlap.
+            const Float4Mask apart = Float4Greater(distance, epsilon);
+            const Float4 inverseDistance = Float4Select(apart, Float4Div(one, distance), zero);
+            const Float4 unitX = Float4Mul(x, inverseDistance);
+            const Float4 unitY = Float4Mul(y, inverseDistance);
+            const Float4 unitZ = Float4Mul(z, inverseDistance);
+
+            // Cone attenuation of the source, facing the listener is inside the cone.
+            const Float4 facing = Float4Sub(zero, Float4MulAdd(Float4Load(batch.directionX + i), unitX, Float4MulAdd(Float4Load(batch.directionY + i), unitY, Float4Mul(Float4Load(batch.directionZ + i), unitZ))));
+            const Float4 coneInner = Float4Load(batch.coneInnerCos + i);
+            const Float4 coneOuter = Float4Load(batch.coneOuterCos + i);
+            const Float4 coneOuterGain = Float4Load(batch.coneOuterGain + i);
+            const Float4 coneBlend = Float4MulAdd(Float4Sub(one, coneOuterGain), Float4Div(Float4Sub(facing, coneOuter), Float4Sub(coneInner, coneOuter)), coneOuterGain);
+            Float4 coneGain = Float4Select(Float4Greater(facing, coneOuter), coneBlend, coneOuterGain);
+            coneGain = Float4Select(Float4Greater(facing, coneInner), one, coneGain);
+            gain = Float4Mul(gain, Float4Select(apart, coneGain, one));
+            gain = Float4Min(Float4Max(gain, Float4Load(batch.minGain + i)), Float4Load(batch.maxGain + i));
+
+            // Without attenuation miniaudio doesn't spatialize at all.
+            const Float4Mask spatialized = Float4Greater(Float4Sub(model, modelNone), zero);
+            gain = Float4Select(spatialized, gain, one);
+
+            // Directional panning per output channel.
+            const Float4 directional = Float4Load(batch.directionalAttenuation + i);
+            const Float4 minChannelGain = Float4Load(batch.minChannelGain + i);
+            const Float4Mask panned = Float4And(spatialized, apart);
+            for (uint32_t channel = 0; channel < outputChannels; ++channel)
+            {
+                Float4 channelGain = gain;
+                if (channelDirections[channel] != nullptr)
+                {
+                    const float* channelDirection = channelDirections[channel];
+                    const Float4 dot = Float4MulAdd(unitX, Float4Splat(channelDirection[0]), Float4MulAdd(unitY, Float4Splat(channelDirection[1]), Float4Mul(unitZ, Float4Splat(channelDirection[2]))));
+                    Float4 factor = Float4MulAdd(directional, Float4Sub(dot, one), one);
+                    factor = Float4Max(Float4Mul(Float4Add(factor, one), half), minChannelGain);
+                    channelGain = Float4Select(panned, Float4Mul(gain, factor), gain);
+                }
+                Float4Store(batch.channelGains[channel] + i, channelGain);
+            }
+
+            // Doppler shift along the source to listener axis.
+            const Float4 toListenerX = Float4Load(batch.toListenerX + i);
+            const Float4 toListenerY = Float4Load(batch.toListenerY + i);
+            const Float4 toListenerZ = Float4Load(batch.toListenerZ + i);
+            const Float4 toListenerLength = Float4Sqrt(Float4MulAdd(toListenerX, toListenerX, Float4MulAdd(toListenerY, toListenerY, Float4Mul(toListenerZ, toListenerZ))));
+            const Float4 speedOfSound = Float4Load(batch.speedOfSound + i);
+            const Float4 dopplerFactor = Float4Load(batch.dopplerFactor + i);
+            const Float4Mask moving = Float4And(Float4Greater(toListenerLength, zero), Float4Greater(dopplerFactor, zero));
+            const Float4 inverseLength = Float4Select(moving, Float4Div(one, toListenerLength), zero);
+            const Float4 maxSpeed = Float4Select(moving, Float4Div(speedOfSound, dopplerFactor), zero);
+            const Float4 listenerSpeed = Float4Min(Float4Mul(Float4MulAdd(toListenerX, Float4Load(batch.listenerVelocityX + i), Float4MulAdd(toListenerY, Float4Load(batch.listenerVelocityY + i), Float4Mul(toListenerZ, Float4Load(batch.listenerVelocityZ + i)))), inverseLength), maxSpeed);
+            const Float4 sourceSpeed = Float4Min(Float4Mul(Float4MulAdd(toListenerX, Float4Load(batch.velocityX + i), Float4MulAdd(toListenerY, Float4Load(batch.velocityY + i), Float4Mul(toListenerZ, Float4Load(batch.velocityZ + i)))), inverseLength), maxSpeed);
+            const Float4 doppler = Float4Div(Float4Sub(speedOfSound, Float4Mul(dopplerFactor, listenerSpeed)), Float4Sub(speedOfSound, Float4Mul(dopplerFactor, sourceSpeed)));
+            Float4Store(batch.dopplerPitch + i, Float4Select(Float4And(moving, spatialized), doppler, one));
+        }
+    }
+}
+
+#endif /* ALIMER_AUDIO_MIXER_H_ */
@@ -0,0 +1,615 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+#include "alimer_internal.h"
+#include "alimer_math.h"
+#include "alimer_scene.h"
+#include <float.h>
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t kBinCount = 16;
+    constexpr uint32_t kMaxLeafSize = 8;
+    /// Subtrees with more primitives than this are built on worker threads.
+    constexpr uint32_t kParallelBuildThreshold = 16 * 1024;
+    /// Deeper nodes become leaves, which bounds the traversal stacks.
+    constexpr uint32_t kMaxTreeDepth = 62;
+    constexpr uint32_t kMaxTraversalDepth = 64;
+
+    /// Interior nodes store the index of their first child (the second one follows it) and a zero count,
+    /// leaves store their first primitive and the primitive count.
+    struct BVHNode
+    {
+        Vector3 boundsMin;
+        uint32_t leftOrFirst;
+        Vector3 boundsMax;
+        uint32_t count;
+    };
+
+    static_assert(sizeof(BVHNode) == 32);
+
+    struct Bounds
+    {
+        Vector3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+        Vector3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+        void Grow(const Vector3& point)
+        {
+            min = { std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) };
+            max = { std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) };
+        }
+
+        void Grow(const Bounds& other)
+        {
+            if (other.min.x > other.max.x)
+                return;
+
+            Grow(other.min);
+            Grow(other.max);
+        }
+
+        float Area() const
+        {
+            const Vector3 extent = { max.x - min.x, max.y - min.y, max.z - min.z };
+            if (extent.x < 0.0f)
+                return 0.0f;
+            return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+        }
+    };
+
+    inline float GetAxis(const Vector3& value, uint32_t axis)
+    {
+        return (&value.x)[axis];
+    }
+
+    inline bool IsEmpty(const Vector3& boundsMin, const Vector3& boundsMax)
+    {
+        return boundsMin.x > boundsMax.x || boundsMin.y > boundsMax.y || boundsMin.z > boundsMax.z;
+    }
+
+    /// Slab test, returns the entry distance or FLT_MAX when the box is missed.
+    inline float IntersectBounds(const Vector3& origin, const Vector3& invDirection, float maxDistance, const Vector3& boundsMin, const Vector3& boundsMax)
+    {
+        const float tx1 = (boundsMin.x - origin.x) * invDirection.x;
+        const float tx2 = (boundsMax.x - origin.x) * invDirection.x;
+        float tmin = std::min(tx1, tx2);
+        float tmax = std::max(tx1, tx2);
+        const float ty1 = (boundsMin.y - origin.y) * invDirection.y;
+        const float ty2 = (boundsMax.y - origin.y) * invDirection.y;
+        tmin = std::max(tmin, std::min(ty1, ty2));
+        tmax = std::min(tmax, std::max(ty1, ty2));
+        const float tz1 = (boundsMin.z - origin.z) * invDirection.z;
+        const float tz2 = (boundsMax.z - origin.z) * invDirection.z;
+        tmin = std::max(tmin, std::min(tz1, tz2));
+        tmax = std::min(tmax, std::max(tz1, tz2));
+
+        if (tmax >= tmin && tmax >= 0.0f && tmin < maxDistance)
+            return tmin > 0.0f ? tmin : 0.0f;
+        return FLT_MAX;
+    }
+
+    /// Moller-Trumbore ray/triangle test.
+    inline bool IntersectTriangle(const Vector3& origin, const Vector3& direction, const Vector3* triangle, float& distance, float& u, float& v)
+    {
+        const Vector3 edge1 = { triangle[1].x - triangle[0].x, triangle[1].y - triangle[0].y, triangle[1].z - triangle[0].z };
+        const Vector3 edge2 = { triangle[2].x - triangle[0].x, triangle[2].y - triangle[0].y, triangle[2].z - triangle[0].z };
+        const Vector3 h = { direction.y * edge2.z - direction.z * edge2.y, direction.z * edge2.x - direction.x * edge2.z, direction.x * edge2.y - direction.y * edge2.x };
+        const float a = edge1.x * h.x + edge1.y * h.y + edge1.z * h.z;
+        if (a > -1e-12f && a < 1e-12f)
+            return false;
+
+        const float f = 1.0f / a;
+        const Vector3 s = { origin.x - triangle[0].x, origin.y - triangle[0].y, origin.z - triangle[0].z };
+        u = f * (s.x * h.x + s.y * h.y + s.z * h.z);
+        if (u < 0.0f || u > 1.0f)
+            return false;
+
+        const Vector3 q = { s.y * edge1.z - s.z * edge1.y, s.z * edge1.x - s.x * edge1.z, s.x * edge1.y - s.y * edge1.x };
+        v = f * (direction.x * q.x + direction.y * q.y + direction.z * q.z);
+        if (v < 0.0f || u + v > 1.0f)
+            return false;
+
+        distance = f * (edge2.x * q.x + edge2.y * q.y + edge2.z * q.z);
+        return distance > 0.0f;
+    }
+
+    inline bool BoundsOutsidePlane(const Vector4& plane, const Vector3& boundsMin, const Vector3& boundsMax)
+    {
+        // Corner furthest along the plane normal.
+        const float x = plane.x >= 0.0f ? boundsMax.x : boundsMin.x;
+        const float y = plane.y >= 0.0f ? boundsMax.y : boundsMin.y;
+        const float z = plane.z >= 0.0f ? boundsMax.z : boundsMin.z;
+        return plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f;
+    }
+
+    inline bool BoundsInsidePlane(const Vector4& plane, const Vector3& boundsMin, const Vector3& boundsMax)
+    {
+        const float x = plane.x >= 0.0f ? boundsMin.x : boundsMax.x;
+        const float y = plane.y >= 0.0f ? boundsMin.y : boundsMax.y;
+        const float z = plane.z >= 0.0f ? boundsMin.z : boundsMax.z;
+        return plane.x * x + plane.y * y + plane.z * z + plane.w >= 0.0f;
+    }
+
+    inline bool BoundsOverlap(const Vector3& aMin, const Vector3& aMax, const Vector3& bMin, const Vector3& bMax)
+    {
+        return aMin.x <= bMax.x && aMax.x >= bMin.x
+            && aMin.y <= bMax.y && aMax.y >= bMin.y
+            && aMin.z <= bMax.z && aMax.z >= bMin.z;
+    }
+}
+
+struct SceneBVH final
+{
+    std::vector<BVHNode> nodes;
+    /// Primitive index of every leaf slot.
+    std::vector<uint32_t> primitives;
+    /// Per leaf slot data: three vertices for mesh BVH, min/max pairs for bounds BVH.
+    std::vector<Vector3> triangles;
+    std::vector<Vector3> bounds;
+
+    bool IsMesh() const { return !triangles.empty(); }
+
+    void AddResult(uint32_t slot, uint32_t* results, uint32_t maxResults, uint32_t& count) const
+    {
+        if (count < maxResults)
+            results[count] = primitives[slot];
+        ++count;
+    }
+
+    void AddSubtree(uint32_t nodeIndex, uint32_t* results, uint32_t maxResults, uint32_t& count) const
+    {
+        uint32_t stack[kMaxTraversalDepth];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = nodeIndex;
+        while (stackSize > 0)
+        {
+            const BVHNode& node = nodes[stack[--stackSize]];
+            if (node.count > 0)
+            {
+                for (uint32_t i = 0; i < node.count; ++i)
+                    AddResult(node.leftOrFirst + i, results, maxResults, count);
+                continue;
+            }
+
+            stack[stackSize++] = node.leftOrFirst;
+            stack[stackSize++] = node.leftOrFirst + 1;
+        }
+    }
+};
+
+namespace
+{
+    struct BVHBuilder final
+    {
+        SceneBVH* bvh;
+        std::vector<Bounds> primitiveBounds;
+        std::vector<Vector3> centroids;
+        std::atomic<uint32_t> nodeCount{ 1 };
+        jobs::Context context;
+
+        void Build()
+        {
+            const uint32_t count = (uint32_t)bvh->primitives.size();
+            bvh->nodes.resize(std::max(count * 2, 1u));
+            Subdivide(0, 0, count, 0);
+            jobs::Wait(context);
+            bvh->nodes.resize(nodeCount.load());
+        }
+
+        void Subdivide(uint32_t nodeIndex, uint32_t first, uint32_t count, uint32_t depth)
+        {
+            Bounds bounds;
+            Bounds centroidBounds;
+            for (uint32_t i = first; i < first + count; ++i)
+            {
+                const uint32_t primitive = bvh->primitives[i];
+                bounds.Grow(primitiveBounds[primitive]);
+                centroidBounds.Grow(centroids[primitive]);
+            }
+
+            BVHNode& node = bvh->nodes[nodeIndex];
+            node.boundsMin = bounds.min;
+            node.boundsMax = bounds.max;
+            node.leftOrFirst = first;
+            node.count = count;
+
+            if (count <= 2 || depth >= kMaxTreeDepth)
+                return;
+
+            // Binned SAH over the centroid bounds.
+            uint32_t bestAxis = 0;
+            uint32_t bestSplit = 0;
+            float bestCost = FLT_MAX;
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                const float axisMin = GetAxis(centroidBounds.min, axis);
+                const float axisMax = GetAxis(centroidBounds.max, axis);
+                if (axisMax <= axisMin)
+                    continue;
+
+                Bounds binBounds[kBinCount];
+                uint32_t binCounts[kBinCount] = {};
+                const float scale = kBinCount / (axisMax - axisMin);
+                for (uint32_t i = first; i < first + count; ++i)
+                {
+                    const uint32_t primitive = bvh->primitives[i];
+                    const uint32_t bin = std::min(kBinCount - 1, (uint32_t)((GetAxis(centroids[primitive], axis) - axisMin) * scale));
+                    binBounds[bin].Grow(primitiveBounds[primitive]);
+                    binCounts[bin]++;
+                }
+
+                float leftArea[kBinCount - 1];
+                uint32_t leftCount[kBinCount - 1];
+                Bounds leftBounds;
+                uint32_t leftSum = 0;
+                for (uint32_t i = 0; i < kBinCount - 1; ++i)
+                {
+                    leftBounds.Grow(binBounds[i]);
+                    leftSum += binCounts[i];
+                    leftArea[i] = leftBounds.Area();
+                    leftCount[i] = leftSum;
+                }
+
+                Bounds rightBounds;
+                uint32_t rightSum = 0;
+                for (uint32_t i = kBinCount - 1; i > 0; --i)
+                {
+                    rightBounds.Grow(binBounds[i]);
+                    rightSum += binCounts[i];
+                    const float cost = leftCount[i - 1] * leftArea[i - 1] + rightSum * rightBounds.Area();
+                    if (leftCount[i - 1] > 0 && rightSum > 0 && cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = i;
+                    }
+                }
+            }
+
+            const float leafCost = count * bounds.Area();
+            if (bestCost == FLT_MAX || (bestCost >= leafCost && count <= kMaxLeafSize))
+                return;
+
+            const float axisMin = GetAxis(centroidBounds.min, bestAxis);
+            const float scale = kBinCount / (GetAxis(centroidBounds.max, bestAxis) - axisMin);
+            uint32_t* begin = bvh->primitives.data() + first;
+            uint32_t* middle = std::partition(begin, begin + count, [&](uint32_t primitive)
+                {
+                    const uint32_t bin = std::min(kBinCount - 1, (uint32_t)((GetAxis(centroids[primitive], bestAxis) - axisMin) * scale));
+                    return bin < bestSplit;
+                });
+
+            const uint32_t leftCount = (uint32_t)(middle - begin);
+            const uint32_t rightCount = count - leftCount;
+            const uint32_t leftChild = nodeCount.fetch_add(2);
+            node.leftOrFirst = leftChild;
+            node.count = 0;
+
+            if (count >= kParallelBuildThreshold)
+            {
+                jobs::Execute(context, [this, leftChild, first, leftCount, depth] { Subdivide(leftChild, first, leftCount, depth + 1); });
+                Subdivide(leftChild + 1, first + leftCount, rightCount, depth + 1);
+            }
+            else
+            {
+                Subdivide(leftChild, first, leftCount, depth + 1);
+                Subdivide(leftChild + 1, first + leftCount, rightCount, depth + 1);
+            }
+        }
+    };
+}
+
+SceneBVH* alimerSceneBVHCreate(uint32_t count, const Vector3* boundsMin, const Vector3* boundsMax)
+{
+    ALIMER_ASSERT(boundsMin && boundsMax);
+
+    SceneBVH* bvh = new SceneBVH();
+    BVHBuilder builder;
+    builder.bvh = bvh;
+    builder.primitiveBounds.resize(count);
+    builder.centroids.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (IsEmpty(boundsMin[i], boundsMax[i]))
+            continue;
+
+        builder.primitiveBounds[i].min = boundsMin[i];
+        builder.primitiveBounds[i].max = boundsMax[i];
+        builder.centroids[i] = { (boundsMin[i].x + boundsMax[i].x) * 0.5f, (boundsMin[i].y + boundsMax[i].y) * 0.5f, (boundsMin[i].z + boundsMax[i].z) * 0.5f };
+        bvh->primitives.push_back(i);
+    }
+    builder.Build();
+
+    bvh->bounds.resize(bvh->primitives.size() * 2);
+    for (size_t i = 0; i < bvh->primitives.size(); ++i)
+    {
+        bvh->bounds[i * 2 + 0] = boundsMin[bvh->primitives[i]];
+        bvh->bounds[i * 2 + 1] = boundsMax[bvh->primitives[i]];
+    }
+
+    return bvh;
+}
+
+SceneBVH* alimerSceneBVHCreateFromMesh(const SceneMesh* mesh)
+{
+    ALIMER_ASSERT(mesh);
+
+    const uint32_t triangleCount = mesh->indexCount / 3;
+    SceneBVH* bvh = new SceneBVH();
+    BVHBuilder builder;
+    builder.bvh = bvh;
+    builder.primitiveBounds.resize(triangleCount);
+    builder.centroids.resize(triangleCount);
+    bvh->primitives.reserve(triangleCount);
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        Bounds& bounds = builder.primitiveBounds[i];
+        for (uint32_t corner = 0; corner < 3; ++corner)
+        {
+            const uint32_t index = mesh->indices[i * 3 + corner];
+            if (index < mesh->vertexCount)
+                bounds.Grow(mesh->positions[index]);
+        }
+
+        if (IsEmpty(bounds.min, bounds.max))
+            continue;
+
+        builder.centroids[i] = { (bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f };
+        bvh->primitives.push_back(i);
+    }
+    builder.Build();
+
+    // Store the triangles in leaf order so that leaf tests read contiguous memory.
+    bvh->triangles.resize(bvh->primitives.size() * 3);
+    for (size_t i = 0; i < bvh->primitives.size(); ++i)
+    {
+        for (uint32_t corner = 0; corner < 3; ++corner)
+        {
+            const uint32_t index = mesh->indices[bvh->primitives[i] * 3 + corner];
+            bvh->triangles[i * 3 + corner] = index < mesh->vertexCount ? mesh->positions[index] : mesh->positions[0];
+        }
+    }
+
+    return bvh;
+}
+
+void alimerSceneBVHDestroy(SceneBVH* bvh)
+{
+    delete bvh;
+}
+
+uint32_t alimerSceneBVHGetNodeCount(const SceneBVH* bvh)
+{
+    return (uint32_t)bvh->nodes.size();
+}
+
+bool alimerSceneBVHRaycast(const SceneBVH* bvh, const Vector3* origin, const Vector3* direction, float maxDistance, SceneRayHit* hit)
+{
+    ALIMER_ASSERT(origin && direction && hit);
+
+    if (bvh->primitives.empty())
+        return false;
+
+    const Vector3 invDirection = {
+        direction->x != 0.0f ? 1.0f / direction->x : FLT_MAX,
+        direction->y != 0.0f ? 1.0f / direction->y : FLT_MAX,
+        direction->z != 0.0f ? 1.0f / direction->z : FLT_MAX
+    };
+
+    const bool isMesh = bvh->IsMesh();
+    float closest = maxDistance;
+    bool found = false;
+
+    uint32_t stack[kMaxTraversalDepth];
+    uint32_t stackSize = 0;
+    if (IntersectBounds(*origin, invDirection, closest, bvh->nodes[0].boundsMin, bvh->nodes[0].boundsMax) != FLT_MAX)
+        stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const BVHNode& node = bvh->nodes[stack[--stackSize]];
+        if (node.count > 0)
+        {
+            for (uint32_t slot = node.leftOrFirst; slot < node.leftOrFirst + node.count; ++slot)
+            {
+                float distance;
+                float u = 0.0f;
+                float v = 0.0f;
+                if (isMesh)
+                {
+                    if (!IntersectTriangle(*origin, *direction, &bvh->triangles[slot * 3], distance, u, v))
+                        continue;
+                }
+                else
+                {
+                    distance = IntersectBounds(*origin, invDirection, closest, bvh->bounds[slot * 2], bvh->bounds[slot * 2 + 1]);
+                }
+
+                if (distance < closest)
+                {
+                    closest = distance;
+                    hit->primitiveIndex = bvh->primitives[slot];
+                    hit->distance = distance;
+                    hit->u = u;
+                    hit->v = v;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearest child first, the other one is pushed below it.
+        uint32_t nearChild = node.leftOrFirst;
+        uint32_t farChild = node.leftOrFirst + 1;
+        float nearDistance = IntersectBounds(*origin, invDirection, closest, bvh->nodes[nearChild].boundsMin, bvh->nodes[nearChild].boundsMax);
+        float farDistance = IntersectBounds(*origin, invDirection, closest, bvh->nodes[farChild].boundsMin, bvh->nodes[farChild].boundsMax);
+        if (farDistance < nearDistance)
+        {
+            std::swap(nearChild, farChild);
+            std::swap(nearDistance, farDistance);
+        }
+
+        if (farDistance != FLT_MAX)
+            stack[stackSize++] = farChild;
+        if (nearDistance != FLT_MAX)
+            stack[stackSize++] = nearChild;
+    }
+
+    return found;
+}
+
+uint32_t alimerSceneBVHQueryFrustum(const SceneBVH* bvh, const Vector4 planes[6], uint32_t* results, uint32_t maxResults)
+{
+    ALIMER_ASSERT(planes);
+
+    uint32_t count = 0;
+    if (bvh->primitives.empty())
+        return 0;
+
+    uint32_t stack[kMaxTraversalDepth];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const uint32_t nodeIndex = stack[--stackSize];
+        const BVHNode& node = bvh->nodes[nodeIndex];
+
+        bool inside = true;
+        bool outside = false;
+        for (uint32_t i = 0; i < 6 && !outside; ++i)
+        {
+            outside = BoundsOutsidePlane(planes[i], node.boundsMin, node.boundsMax);
+            inside = inside && BoundsInsidePlane(planes[i], node.boundsMin, node.boundsMax);
+        }
+
+        if (outside)
+            continue;
+
+        // Fully visible subtrees are collected without further plane tests.
+        if (inside)
+        {
+            bvh->AddSubtree(nodeIndex, results, maxResults, count);
+            continue;
+        }
+
+        if (node.count > 0)
+        {
+            for (uint32_t slot = node.leftOrFirst; slot < node.leftOrFirst + node.count; ++slot)
+            {
+                Bounds bounds;
+                if (bvh->IsMesh())
+                {
+                    bounds.Grow(bvh->triangles[slot * 3 + 0]);
+                    bounds.Grow(bvh->triangles[slot * 3 + 1]);
+                    bounds.Grow(bvh->triangles[slot * 3 + 2]);
+                }
+                else
+                {
+                    bounds.min = bvh->bounds[slot * 2];
+                    bounds.max = bvh->bounds[slot * 2 + 1];
+                }
+
+                bool visible = true;
+                for (uint32_t i = 0; i < 6 && visible; ++i)
+                {
+                    visible = !BoundsOutsidePlane(planes[i], bounds.min, bounds.max);
+                }
+
+                if (visible)
+                    bvh->AddResult(slot, results, maxResults, count);
+            }
+            continue;
+        }
+
+        stack[stackSize++] = node.leftOrFirst;
+        stack[stackSize++] = node.leftOrFirst + 1;
+    }
+
+    return count;
+}
+
+uint32_t alimerSceneBVHQueryBounds(const SceneBVH* bvh, const Vector3* boundsMin, const Vector3* boundsMax, uint32_t* results, uint32_t maxResults)
+{
+    ALIMER_ASSERT(boundsMin && boundsMax);
+
+    uint32_t count = 0;
+    if (bvh->primitives.empty())
+        return 0;
+
+    uint32_t stack[kMaxTraversalDepth];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const BVHNode& node = bvh->nodes[stack[--stackSize]];
+        if (!BoundsOverlap(node.boundsMin, node.boundsMax, *boundsMin, *boundsMax))
+            continue;
+
+        if (node.count > 0)
+        {
+            for (uint32_t slot = node.leftOrFirst; slot < node.leftOrFirst + node.count; ++slot)
+            {
+                Bounds bounds;
+                if (bvh->IsMesh())
+                {
+                    bounds.Grow(bvh->triangles[slot * 3 + 0]);
+                    bounds.Grow(bvh->triangles[slot * 3 + 1]);
+                    bounds.Grow(bvh->triangles[slot * 3 + 2]);
+                }
+                else
+                {
+                    bounds.min = bvh->bounds[slot * 2];
+                    bounds.max = bvh->bounds[slot * 2 + 1];
+                }
+
+                if (BoundsOverlap(bounds.min, bounds.max, *boundsMin, *boundsMax))
+                    bvh->AddResult(slot, results, maxResults, count);
+            }
+            continue;
+        }
+
+        stack[stackSize++] = node.leftOrFirst;
+        stack[stackSize++] = node.leftOrFirst + 1;
+    }
+
+    return count;
+}
+
+void alimerSceneComputeNodeBounds(const Scene* scene, const TransformHierarchy* hierarchy, Vector3* boundsMin, Vector3* boundsMax)
+{
+    ALIMER_ASSERT(scene && hierarchy);
+    ALIMER_ASSERT(alimerTransformHierarchyGetNodeCount(hierarchy) == scene->nodeCount);
+
+    const Matrix4x4* worldMatrices = alimerTransformHierarchyGetWorldMatrices(hierarchy);
+    for (uint32_t i = 0; i < scene->nodeCount; ++i)
+    {
+        const int32_t meshIndex = scene->nodes[i].meshIndex;
+        if (meshIndex < 0 || scene->meshes[meshIndex].vertexCount == 0)
+        {
+            boundsMin[i] = { FLT_MAX, FLT_MAX, FLT_MAX };
+            boundsMax[i] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+            continue;
+        }
+
+        // Transform the local box by its center and extent (Arvo).
+        const SceneMesh& mesh = scene->meshes[meshIndex];
+        const Matrix4x4& m = worldMatrices[i];
+        const Vector3 center = { (mesh.boundsMin.x + mesh.boundsMax.x) * 0.5f, (mesh.boundsMin.y + mesh.boundsMax.y) * 0.5f, (mesh.boundsMin.z + mesh.boundsMax.z) * 0.5f };
+        const Vector3 extent = { (mesh.boundsMax.x - mesh.boundsMin.x) * 0.5f, (mesh.boundsMax.y - mesh.boundsMin.y) * 0.5f, (mesh.boundsMax.z - mesh.boundsMin.z) * 0.5f };
+        const Vector3 worldCenter = {
+            center.x * m.m11 + center.y * m.m21 + center.z * m.m31 + m.m41,
+            center.x * m.m12 + center.y * m.m22 + center.z * m.m32 + m.m42,
+            center.x * m.m13 + center.y * m.m23 + center.z * m.m33 + m.m43
+        };
+        const Vector3 worldExtent = {
+            extent.x * fabsf(m.m11) + extent.y * fabsf(m.m21) + extent.z * fabsf(m.m31),
+            extent.x * fabsf(m.m12) + extent.y * fabsf(m.m22) + extent.z * fabsf(m.m32),
+            extent.x * fabsf(m.m13) + extent.y * fabsf(m.m23) + extent.z * fabsf(m.m33)
+        };
+
+        boundsMin[i] = { worldCenter.x - worldExtent.x, worldCenter.y - worldExtent.y, worldCenter.z - worldExtent.z };
+        boundsMax[i] = { worldCenter.x + worldExtent.x, worldCenter.y + worldExtent.y, worldCenter.z + worldExtent.z };
+    }
+}
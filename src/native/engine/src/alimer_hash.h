@@ -0,0 +1,54 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+#ifndef ALIMER_HASH_H_
+#define ALIMER_HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/// @brief 64-bit hash of a memory block (MurmurHash64A), used for content hashes.
+inline uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0)
+{
+    constexpr uint64_t m = 0xc6a4a7935bd1e995ULL;
+    constexpr int r = 47;
+
+    uint64_t h = seed ^ (size * m);
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const uint8_t* end = bytes + (size & ~size_t(7));
+    while (bytes != end)
+    {
+        uint64_t k;
+        memcpy(&k, bytes, sizeof(k));
+        bytes += sizeof(k);
+
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    switch (size & 7)
+    {
+        case 7: h ^= uint64_t(bytes[6]) << 48; [[fallthrough]];
+        case 6: h ^= uint64_t(bytes[5]) << 40; [[fallthrough]];
+        case 5: h ^= uint64_t(bytes[4]) << 32; [[fallthrough]];
+        case 4: h ^= uint64_t(bytes[3]) << 24; [[fallthrough]];
+        case 3: h ^= uint64_t(bytes[2]) << 16; [[fallthrough]];
+        case 2: h ^= uint64_t(bytes[1]) << 8; [[fallthrough]];
+        case 1: h ^= uint64_t(bytes[0]);
+            h *= m;
+            break;
+        default:
+            break;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+#endif /* ALIMER_HASH_H_ */
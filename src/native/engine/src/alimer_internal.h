@@ -386,8 +386,23 @@ _ALIMER_EXTERN char* Win32_CreateUTF8FromWideString(const WCHAR* source);
 #define ALIMER_ALLOCN(type, n)      ((type*)alimerCalloc(n, sizeof(type)))
 _ALIMER_EXTERN char* _alimer_strdup(const char* source);
 
+/* Read-only memory mapping of a whole file */
+typedef struct FileMapping {
+    const void* data;
+    size_t size;
+    void* handle;
+} FileMapping;
+
+_ALIMER_EXTERN bool _alimer_map_file(const char* path, FileMapping* mapping);
+_ALIMER_EXTERN void _alimer_unmap_file(FileMapping* mapping);
+/// Atomically replace target with source (a temporary file next to it), existing mappings of target stay valid.
+_ALIMER_EXTERN bool _alimer_replace_file(const char* source, const char* target);
+/// Size and modification time (nanoseconds since an arbitrary epoch) of a file on disk.
+_ALIMER_EXTERN bool _alimer_stat_file(const char* path, uint64_t* size, uint64_t* modifiedTime);
+
 #ifdef __cplusplus
 #include <functional>
+#include "alimer_hash.h"
 
 namespace
 {
@@ -424,6 +439,30 @@ namespace
     }
 }
 
+#include <atomic>
+
+/* Worker thread pool shared by the engine systems (scene, audio streaming). */
+namespace jobs
+{
+    /// Tracks completion of a group of jobs, must outlive every job executed with it.
+    struct Context
+    {
+        std::atomic<uint32_t> pending{ 0 };
+    };
+
+    /// Number of threads that execute jobs, including the calling thread.
+    uint32_t GetThreadCount();
+    /// Queue a single job.
+    void Execute(Context& context, std::function<void()> job);
+    /// Split [0, count) into groups of groupSize items and queue one job per group.
+    void Dispatch(Context& context, uint32_t count, uint32_t groupSize, const std::function<void(uint32_t begin, uint32_t end)>& job);
+    bool IsBusy(const Context& context);
+    /// Wait until every job of the context completed, the calling thread helps executing queued jobs.
+    void Wait(Context& context);
+    /// Finish the queued jobs and join the workers, later jobs run on the calling thread.
+    void Shutdown();
+}
+
 namespace string
 {
     inline void copy_safe(char* dst, size_t dstSize, const char* src)
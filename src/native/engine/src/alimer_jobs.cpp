@@ -0,0 +1,210 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+#include "alimer_internal.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#   define ALIMER_JOBS_SINGLE_THREADED
+#endif
+
+namespace
+{
+    struct Job
+    {
+        jobs::Context* context;
+        std::function<void()> task;
+    };
+
+    struct JobSystem final
+    {
+        uint32_t workerCount = 0;
+        std::mutex queueMutex;
+        /// Signaled when jobs are queued or on shutdown, workers sleep on it.
+        std::condition_variable wakeCondition;
+        /// Signaled when jobs are queued or a context completes, waiting threads sleep on it.
+        std::condition_variable doneCondition;
+        std::deque<Job> queue;
+        std::vector<std::thread> workers;
+        uint32_t waiterCount = 0;
+        bool shutdown = false;
+
+        JobSystem()
+        {
+#if !defined(ALIMER_JOBS_SINGLE_THREADED)
+            // Keep one core for the calling thread, which helps while waiting.
+            const uint32_t coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+            workerCount = coreCount - 1;
+
+            workers.reserve(workerCount);
+            for (uint32_t i = 0; i < workerCount; ++i)
+            {
+                workers.emplace_back([this] { WorkerLoop(); });
+            }
+#endif
+        }
+
+        /// Workers finish the queued jobs before they are joined.
+        void Shutdown()
+        {
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                if (shutdown)
+                    return;
+
+                shutdown = true;
+            }
+            wakeCondition.notify_all();
+
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+
+            workers.clear();
+            workerCount = 0;
+        }
+
+        /// Caller holds queueMutex.
+        void NotifyQueued(uint32_t count)
+        {
+            if (count == 1)
+                wakeCondition.notify_one();
+            else
+                wakeCondition.notify_all();
+
+            if (waiterCount > 0)
+                doneCondition.notify_all();
+        }
+
+        void Run(Job& job)
+        {
+            job.task();
+            if (job.context->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                // Notify under the lock so that a waiter can't miss it between its check and its wait.
+                std::lock_guard<std::mutex> lock(queueMutex);
+                if (waiterCount > 0)
+                    doneCondition.notify_all();
+            }
+        }
+
+        void WorkerLoop()
+        {
+            for (;;)
+            {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(queueMutex);
+                    wakeCondition.wait(lock, [this] { return shutdown || !queue.empty(); });
+                    if (queue.empty())
+                        return;
+
+                    job = std::move(queue.front());
+                    queue.pop_front();
+                }
+
+                Run(job);
+            }
+        }
+    };
+
+    JobSystem& GetJobSystem()
+    {
+        // Never destroyed, joining on exit can deadlock when the library is unloaded under the loader lock
+        // and destroying the conditions under sleeping workers blocks. alimerShutdown joins the workers.
+        static JobSystem* jobSystem = new JobSystem();
+        return *jobSystem;
+    }
+}
+
+namespace jobs
+{
+    uint32_t GetThreadCount()
+    {
+        return GetJobSystem().workerCount + 1;
+    }
+
+    void Execute(Context& context, std::function<void()> job)
+    {
+        JobSystem& system = GetJobSystem();
+        context.pending.fetch_add(1, std::memory_order_relaxed);
+
+        if (system.workerCount == 0)
+        {
+            Job inlineJob = { &context, std::move(job) };
+            system.Run(inlineJob);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(system.queueMutex);
+        system.queue.push_back({ &context, std::move(job) });
+        system.NotifyQueued(1);
+    }
+
+    void Dispatch(Context& context, uint32_t count, uint32_t groupSize, const std::function<void(uint32_t begin, uint32_t end)>& job)
+    {
+        if (count == 0)
+            return;
+
+        groupSize = std::max(groupSize, 1u);
+        const uint32_t groupCount = (count + groupSize - 1) / groupSize;
+
+        JobSystem& system = GetJobSystem();
+        context.pending.fetch_add(groupCount, std::memory_order_relaxed);
+
+        if (system.workerCount == 0)
+        {
+            job(0, count);
+            context.pending.fetch_sub(groupCount, std::memory_order_acq_rel);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(system.queueMutex);
+        for (uint32_t group = 0; group < groupCount; ++group)
+        {
+            const uint32_t begin = group * groupSize;
+            const uint32_t end = std::min(begin + groupSize, count);
+            system.queue.push_back({ &context, [job, begin, end] { job(begin, end); } });
+        }
+        system.NotifyQueued(groupCount);
+    }
+
+    bool IsBusy(const Context& context)
+    {
+        return context.pending.load(std::memory_order_acquire) > 0;
+    }
+
+    void Wait(Context& context)
+    {
+        JobSystem& system = GetJobSystem();
+        while (IsBusy(context))
+        {
+            // Help with queued jobs, sleep while only jobs already running remain.
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(system.queueMutex);
+                system.waiterCount++;
+                system.doneCondition.wait(lock, [&] { return !IsBusy(context) || !system.queue.empty(); });
+                system.waiterCount--;
+                if (system.queue.empty())
+                    return;
+
+                job = std::move(system.queue.front());
+                system.queue.pop_front();
+            }
+
+            system.Run(job);
+        }
+    }
+
+    void Shutdown()
+    {
+        GetJobSystem().Shutdown();
+    }
+}
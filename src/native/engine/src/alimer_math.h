@@ -0,0 +1,240 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+#ifndef ALIMER_MATH_H_
+#define ALIMER_MATH_H_
+
+#include "alimer_internal.h"
+#include <math.h>
+
+#if defined(ALIMER_USE_SSE)
+#   include <xmmintrin.h>
+#   if defined(ALIMER_USE_FMADD)
+#       include <immintrin.h>
+#   endif
+#elif defined(ALIMER_USE_NEON)
+#   include <arm_neon.h>
+#endif
+
+/* Math helpers shared by the scene systems, matrices follow the Matrix4x4 (row vector) convention. */
+namespace
+{
+    inline Matrix4x4 MatrixIdentity()
+    {
+        Matrix4x4 result = {};
+        result.m11 = result.m22 = result.m33 = result.m44 = 1.0f;
+        return result;
+    }
+
+    /// result = a * b, result may alias a or b.
+    ALIMER_FORCE_INLINE void MatrixMultiply(const Matrix4x4& a, const Matrix4x4& b, Matrix4x4& result)
+    {
+        const float* lhs = &a.m11;
+        const float* rhs = &b.m11;
+        float* dst = &result.m11;
+
+#if defined(ALIMER_USE_SSE)
+        const __m128 b0 = _mm_loadu_ps(rhs + 0);
+        const __m128 b1 = _mm_loadu_ps(rhs + 4);
+        const __m128 b2 = _mm_loadu_ps(rhs + 8);
+        const __m128 b3 = _mm_loadu_ps(rhs + 12);
+
+        __m128 rows[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            const float* row = lhs + i * 4;
+#   if defined(ALIMER_USE_FMADD)
+            __m128 r = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+            r = _mm_fmadd_ps(_mm_set1_ps(row[1]), b1, r);
+            r = _mm_fmadd_ps(_mm_set1_ps(row[2]), b2, r);
+            r = _mm_fmadd_ps(_mm_set1_ps(row[3]), b3, r);
+#   else
+            __m128 r = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+#   endif
+            rows[i] = r;
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            _mm_storeu_ps(dst + i * 4, rows[i]);
+        }
+#elif defined(ALIMER_USE_NEON)
+        const float32x4_t b0 = vld1q_f32(rhs + 0);
+        const float32x4_t b1 = vld1q_f32(rhs + 4);
+        const float32x4_t b2 = vld1q_f32(rhs + 8);
+        const float32x4_t b3 = vld1q_f32(rhs + 12);
+
+        float32x4_t rows[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            const float32x4_t row = vld1q_f32(lhs + i * 4);
+            float32x4_t r = vmulq_lane_f32(b0, vget_low_f32(row), 0);
+            r = vmlaq_lane_f32(r, b1, vget_low_f32(row), 1);
+            r = vmlaq_lane_f32(r, b2, vget_high_f32(row), 0);
+            r = vmlaq_lane_f32(r, b3, vget_high_f32(row), 1);
+            rows[i] = r;
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            vst1q_f32(dst + i * 4, rows[i]);
+        }
+#else
+        float rows[16];
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                rows[i * 4 + j] = lhs[i * 4 + 0] * rhs[0 * 4 + j]
+                    + lhs[i * 4 + 1] * rhs[1 * 4 + j]
+                    + lhs[i * 4 + 2] * rhs[2 * 4 + j]
+                    + lhs[i * 4 + 3] * rhs[3 * 4 + j];
+            }
+        }
+        memcpy(dst, rows, sizeof(rows));
+#endif
+    }
+
+    /// a * weightA + b * weightB, normalized when normalize is set.
+    ALIMER_FORCE_INLINE Vector4 QuaternionBlend(const Vector4& a, float weightA, const Vector4& b, float weightB, bool normalize)
+    {
+        Vector4 result;
+#if defined(ALIMER_USE_SSE)
+        __m128 r = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&a.x), _mm_set1_ps(weightA)), _mm_mul_ps(_mm_loadu_ps(&b.x), _mm_set1_ps(weightB)));
+        if (normalize)
+        {
+            __m128 dot = _mm_mul_ps(r, r);
+            dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(2, 3, 0, 1)));
+            dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+            r = _mm_div_ps(r, _mm_sqrt_ps(dot));
+        }
+        _mm_storeu_ps(&result.x, r);
+#elif defined(ALIMER_USE_NEON)
+        float32x4_t r = vmlaq_n_f32(vmulq_n_f32(vld1q_f32(&a.x), weightA), vld1q_f32(&b.x), weightB);
+        if (normalize)
+        {
+            float32x4_t dot = vmulq_f32(r, r);
+            float32x2_t sum = vadd_f32(vget_low_f32(dot), vget_high_f32(dot));
+            sum = vpadd_f32(sum, sum);
+            r = vmulq_n_f32(r, 1.0f / sqrtf(vget_lane_f32(sum, 0)));
+        }
+        vst1q_f32(&result.x, r);
+#else
+        result = { a.x * weightA + b.x * weightB, a.y * weightA + b.y * weightB, a.z * weightA + b.z * weightB, a.w * weightA + b.w * weightB };
+        if (normalize)
+        {
+            const float invLength = 1.0f / sqrtf(result.x * result.x + result.y * result.y + result.z * result.z + result.w * result.w);
+            result = { result.x * invLength, result.y * invLength, result.z * invLength, result.w * invLength };
+        }
+#endif
+        return result;
+    }
+
+    /// Shortest path spherical interpolation, falls back to nlerp for nearly parallel quaternions.
+    inline Vector4 QuaternionSlerp(const Vector4& a, const Vector4& b, float t)
+    {
+        float cosTheta = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+        float sign = 1.0f;
+        if (cosTheta < 0.0f)
+        {
+            cosTheta = -cosTheta;
+            sign = -1.0f;
+        }
+
+        if (cosTheta > 0.9995f)
+        {
+            return QuaternionBlend(a, 1.0f - t, b, t * sign, true);
+        }
+
+        const float theta = acosf(cosTheta);
+        const float invSinTheta = 1.0f / sinf(theta);
+        return QuaternionBlend(a, sinf((1.0f - t) * theta) * invSinTheta, b, sinf(t * theta) * invSinTheta * sign, false);
+    }
+
+    /// Scale * Rotation * Translation, rotation is a unit quaternion (x, y, z, w).
+    inline void MatrixFromTRS(const Vector3& translation, const Vector4& rotation, const Vector3& scale, Matrix4x4& result)
+    {
+        const float xx = rotation.x * rotation.x;
+        const float yy = rotation.y * rotation.y;
+        const float zz = rotation.z * rotation.z;
+        const float xy = rotation.x * rotation.y;
+        const float wz = rotation.z * rotation.w;
+        const float xz = rotation.z * rotation.x;
+        const float wy = rotation.y * rotation.w;
+        const float yz = rotation.y * rotation.z;
+        const float wx = rotation.x * rotation.w;
+
+        result.m11 = (1.0f - 2.0f * (yy + zz)) * scale.x;
+        result.m12 = 2.0f * (xy + wz) * scale.x;
+        result.m13 = 2.0f * (xz - wy) * scale.x;
+        result.m14 = 0.0f;
+        result.m21 = 2.0f * (xy - wz) * scale.y;
+        result.m22 = (1.0f - 2.0f * (zz + xx)) * scale.y;
+        result.m23 = 2.0f * (yz + wx) * scale.y;
+        result.m24 = 0.0f;
+        result.m31 = 2.0f * (xz + wy) * scale.z;
+        result.m32 = 2.0f * (yz - wx) * scale.z;
+        result.m33 = (1.0f - 2.0f * (yy + xx)) * scale.z;
+        result.m34 = 0.0f;
+        result.m41 = translation.x;
+        result.m42 = translation.y;
+        result.m43 = translation.z;
+        result.m44 = 1.0f;
+    }
+
+    /// Decompose an affine matrix without shear, the inverse of MatrixFromTRS.
+    inline void MatrixDecompose(const Matrix4x4& matrix, Vector3& translation, Vector4& rotation, Vector3& scale)
+    {
+        translation = { matrix.m41, matrix.m42, matrix.m43 };
+        scale.x = sqrtf(matrix.m11 * matrix.m11 + matrix.m12 * matrix.m12 + matrix.m13 * matrix.m13);
+        scale.y = sqrtf(matrix.m21 * matrix.m21 + matrix.m22 * matrix.m22 + matrix.m23 * matrix.m23);
+        scale.z = sqrtf(matrix.m31 * matrix.m31 + matrix.m32 * matrix.m32 + matrix.m33 * matrix.m33);
+
+        const float determinant = matrix.m11 * (matrix.m22 * matrix.m33 - matrix.m23 * matrix.m32)
+            - matrix.m12 * (matrix.m21 * matrix.m33 - matrix.m23 * matrix.m31)
+            + matrix.m13 * (matrix.m21 * matrix.m32 - matrix.m22 * matrix.m31);
+        if (determinant < 0.0f)
+            scale.x = -scale.x;
+
+        if (scale.x == 0.0f || scale.y == 0.0f || scale.z == 0.0f)
+        {
+            rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+            return;
+        }
+
+        const float m11 = matrix.m11 / scale.x, m12 = matrix.m12 / scale.x, m13 = matrix.m13 / scale.x;
+        const float m21 = matrix.m21 / scale.y, m22 = matrix.m22 / scale.y, m23 = matrix.m23 / scale.y;
+        const float m31 = matrix.m31 / scale.z, m32 = matrix.m32 / scale.z, m33 = matrix.m33 / scale.z;
+
+        const float trace = m11 + m22 + m33;
+        if (trace > 0.0f)
+        {
+            const float s = sqrtf(trace + 1.0f);
+            const float invS = 0.5f / s;
+            rotation = { (m23 - m32) * invS, (m31 - m13) * invS, (m12 - m21) * invS, s * 0.5f };
+        }
+        else if (m11 >= m22 && m11 >= m33)
+        {
+            const float s = sqrtf(1.0f + m11 - m22 - m33);
+            const float invS = 0.5f / s;
+            rotation = { 0.5f * s, (m12 + m21) * invS, (m13 + m31) * invS, (m23 - m32) * invS };
+        }
+        else if (m22 > m33)
+        {
+            const float s = sqrtf(1.0f + m22 - m11 - m33);
+            const float invS = 0.5f / s;
+            rotation = { (m21 + m12) * invS, 0.5f * s, (m32 + m23) * invS, (m31 - m13) * invS };
+        }
+        else
+        {
+            const float s = sqrtf(1.0f + m33 - m11 - m22);
+            const float invS = 0.5f / s;
+            rotation = { (m31 + m13) * invS, (m32 + m23) * invS, 0.5f * s, (m12 - m21) * invS };
+        }
+    }
+}
+
+#endif /* ALIMER_MATH_H_ */
@@ -2,7 +2,11 @@
 // Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
 
 #include "alimer_internal.h"
+#include "alimer_math.h"
 #include "alimer_scene.h"
+#include <stdio.h>
+#include <float.h>
+#include <vector>
 
 ALIMER_DISABLE_WARNINGS()
 #define CGLTF_IMPLEMENTATION
@@ -11,10 +15,722 @@ ALIMER_DISABLE_WARNINGS()
 //#include "third_party/cgltf_write.h"
 ALIMER_ENABLE_WARNINGS()
 
-static Scene* tryLoadGltfFromMemory(const void* pData, size_t dataSize)
+namespace
+{
+    /* Binary scene cache layout, all offsets are relative to the start of the file and 0 means "not present". */
+    constexpr uint32_t kSceneCacheMagic = 0x4E435341; // "ASCN"
+    constexpr uint32_t kSceneCacheVersion = 4;
+    constexpr uint64_t kSceneCacheAlignment = 16;
+
+    struct SceneCacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t contentHash;
+        uint64_t fileSize;
+        uint32_t meshCount;
+        uint32_t materialCount;
+        uint32_t nodeCount;
+        uint32_t skinCount;
+        uint32_t animationCount;
+        uint32_t imageCount;
+        uint64_t meshesOffset;
+        uint64_t materialsOffset;
+        uint64_t nodesOffset;
+        uint64_t skinsOffset;
+        uint64_t animationsOffset;
+        uint64_t imagesOffset;
+    };
+
+    struct SceneCacheMesh
+    {
+        uint64_t nameOffset;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t subMeshCount;
+        uint32_t reserved;
+        Vector3 boundsMin;
+        Vector3 boundsMax;
+        uint64_t positionsOffset;
+        uint64_t normalsOffset;
+        uint64_t tangentsOffset;
+        uint64_t texcoordsOffset;
+        uint64_t jointsOffset;
+        uint64_t weightsOffset;
+        uint64_t indicesOffset;
+        uint64_t subMeshesOffset;
+    };
+
+    struct SceneCacheMaterial
+    {
+        uint64_t nameOffset;
+        int32_t baseColorImage;
+        int32_t metallicRoughnessImage;
+        int32_t normalImage;
+        int32_t occlusionImage;
+        int32_t emissiveImage;
+        Vector4 baseColorFactor;
+        Vector3 emissiveFactor;
+        float metallicFactor;
+        float roughnessFactor;
+        float alphaCutoff;
+        uint32_t alphaMode;
+        uint32_t doubleSided;
+        uint32_t reserved;
+    };
+
+    struct SceneCacheImage
+    {
+        uint64_t nameOffset;
+        uint64_t uriOffset;
+        uint64_t mimeTypeOffset;
+        uint64_t dataOffset;
+        uint64_t dataSize;
+        uint64_t reserved;
+    };
+
+    struct SceneCacheNode
+    {
+        uint64_t nameOffset;
+        int32_t meshIndex;
+        int32_t parentIndex;
+        Vector3 translation;
+        Vector4 rotation;
+        Vector3 scale;
+        int32_t skinIndex;
+        uint32_t reserved;
+    };
+
+    struct SceneCacheSkin
+    {
+        uint64_t nameOffset;
+        uint32_t jointCount;
+        int32_t skeletonIndex;
+        uint64_t jointsOffset;
+        uint64_t inverseBindMatricesOffset;
+    };
+
+    struct SceneCacheAnimation
+    {
+        uint64_t nameOffset;
+        float duration;
+        uint32_t channelCount;
+        /// SceneCacheAnimationChannel records.
+        uint64_t channelsOffset;
+        uint64_t reserved;
+    };
+
+    struct SceneCacheAnimationChannel
+    {
+        uint32_t nodeIndex;
+        uint32_t path;
+        uint32_t interpolation;
+        uint32_t keyCount;
+        uint64_t timesOffset;
+        uint64_t valuesOffset;
+    };
+
+    static_assert(sizeof(SceneCacheHeader) % kSceneCacheAlignment == 0);
+    static_assert(sizeof(SceneCacheMesh) % kSceneCacheAlignment == 0);
+    static_assert(sizeof(SceneCacheMaterial) % kSceneCacheAlignment == 0);
+    static_assert(sizeof(SceneCacheNode) % kSceneCacheAlignment == 0);
+    static_assert(sizeof(SceneCacheSkin) % kSceneCacheAlignment == 0);
+    static_assert(sizeof(SceneCacheAnimation) % kSceneCacheAlignment == 0);
+    static_assert(sizeof(SceneCacheAnimationChannel) % kSceneCacheAlignment == 0);
+    static_assert(sizeof(SceneCacheImage) % kSceneCacheAlignment == 0);
+}
+
+/// Backing storage of a Scene, the scene data either lives in heap allocations (imported) or in a file mapping (cache).
+struct SceneStorage final
+{
+    Scene scene;
+    FileMapping mapping;
+};
+
+static_assert(offsetof(SceneStorage, scene) == 0);
+
+static uint32_t GetChannelValueCount(SceneAnimationPath path, SceneAnimationInterpolation interpolation, uint32_t keyCount)
+{
+    const uint32_t componentCount = path == SceneAnimationPath_Rotation ? 4u : 3u;
+    const uint32_t valuesPerKey = interpolation == SceneAnimationInterpolation_CubicSpline ? 3u : 1u;
+    return keyCount * valuesPerKey * componentCount;
+}
+
+static SceneStorage* GetStorage(Scene* scene)
+{
+    return reinterpret_cast<SceneStorage*>(scene);
+}
+
+static char* DuplicateName(const char* name)
+{
+    return name ? _alimer_strdup(name) : nullptr;
+}
+
+static int32_t GetImageIndex(const cgltf_data* data, const cgltf_texture_view& view)
+{
+    return view.texture && view.texture->image ? (int32_t)cgltf_image_index(data, view.texture->image) : -1;
+}
+
+static void ImportMaterial(const cgltf_data* data, const cgltf_material& source, SceneMaterial& material)
+{
+    material.name = DuplicateName(source.name);
+    material.baseColorImage = -1;
+    material.metallicRoughnessImage = -1;
+    material.normalImage = GetImageIndex(data, source.normal_texture);
+    material.occlusionImage = GetImageIndex(data, source.occlusion_texture);
+    material.emissiveImage = GetImageIndex(data, source.emissive_texture);
+    material.baseColorFactor = { 1.0f, 1.0f, 1.0f, 1.0f };
+    material.metallicFactor = 1.0f;
+    material.roughnessFactor = 1.0f;
+
+    if (source.has_pbr_metallic_roughness)
+    {
+        const cgltf_pbr_metallic_roughness& pbr = source.pbr_metallic_roughness;
+        material.baseColorFactor = { pbr.base_color_factor[0], pbr.base_color_factor[1], pbr.base_color_factor[2], pbr.base_color_factor[3] };
+        material.metallicFactor = pbr.metallic_factor;
+        material.roughnessFactor = pbr.roughness_factor;
+        material.baseColorImage = GetImageIndex(data, pbr.base_color_texture);
+        material.metallicRoughnessImage = GetImageIndex(data, pbr.metallic_roughness_texture);
+    }
+
+    material.emissiveFactor = { source.emissive_factor[0], source.emissive_factor[1], source.emissive_factor[2] };
+    material.alphaCutoff = source.alpha_cutoff;
+    switch (source.alpha_mode)
+    {
+        case cgltf_alpha_mode_mask:     material.alphaMode = SceneAlphaMode_Mask; break;
+        case cgltf_alpha_mode_blend:    material.alphaMode = SceneAlphaMode_Blend; break;
+        default:                        material.alphaMode = SceneAlphaMode_Opaque; break;
+    }
+    material.doubleSided = source.double_sided ? 1u : 0u;
+}
+
+static const cgltf_accessor* FindAttribute(const cgltf_primitive& primitive, cgltf_attribute_type type, cgltf_int index = 0)
+{
+    for (cgltf_size i = 0; i < primitive.attributes_count; ++i)
+    {
+        const cgltf_attribute& attribute = primitive.attributes[i];
+        if (attribute.type == type && attribute.index == index)
+            return attribute.data;
+    }
+
+    return nullptr;
+}
+
+static bool IsImportablePrimitive(const cgltf_primitive& primitive)
+{
+    return primitive.type == cgltf_primitive_type_triangles
+        && FindAttribute(primitive, cgltf_attribute_type_position) != nullptr;
+}
+
+static void ImportMesh(const cgltf_data* data, const cgltf_mesh& source, SceneMesh& mesh)
+{
+    mesh.name = DuplicateName(source.name);
+
+    // Primitives are merged into a single vertex/index stream, each one becomes a sub mesh.
+    bool hasNormals = false;
+    bool hasTangents = false;
+    bool hasTexcoords = false;
+    bool hasSkinning = false;
+    for (cgltf_size i = 0; i < source.primitives_count; ++i)
+    {
+        const cgltf_primitive& primitive = source.primitives[i];
+        if (!IsImportablePrimitive(primitive))
+            continue;
+
+        const cgltf_accessor* positions = FindAttribute(primitive, cgltf_attribute_type_position);
+        mesh.vertexCount += (uint32_t)positions->count;
+        mesh.indexCount += (uint32_t)(primitive.indices ? primitive.indices->count : positions->count);
+        mesh.subMeshCount++;
+
+        hasNormals |= FindAttribute(primitive, cgltf_attribute_type_normal) != nullptr;
+        hasTangents |= FindAttribute(primitive, cgltf_attribute_type_tangent) != nullptr;
+        hasTexcoords |= FindAttribute(primitive, cgltf_attribute_type_texcoord) != nullptr;
+        hasSkinning |= FindAttribute(primitive, cgltf_attribute_type_joints) != nullptr
+            && FindAttribute(primitive, cgltf_attribute_type_weights) != nullptr;
+    }
+
+    if (mesh.subMeshCount == 0)
+        return;
+
+    mesh.positions = ALIMER_ALLOCN(Vector3, mesh.vertexCount);
+    mesh.normals = hasNormals ? ALIMER_ALLOCN(Vector3, mesh.vertexCount) : nullptr;
+    mesh.tangents = hasTangents ? ALIMER_ALLOCN(Vector4, mesh.vertexCount) : nullptr;
+    mesh.texcoords = hasTexcoords ? ALIMER_ALLOCN(Vector2, mesh.vertexCount) : nullptr;
+    mesh.joints = hasSkinning ? ALIMER_ALLOCN(uint16_t, mesh.vertexCount * 4) : nullptr;
+    mesh.weights = hasSkinning ? ALIMER_ALLOCN(Vector4, mesh.vertexCount) : nullptr;
+    mesh.indices = ALIMER_ALLOCN(uint32_t, mesh.indexCount);
+    mesh.subMeshes = ALIMER_ALLOCN(SceneSubMesh, mesh.subMeshCount);
+
+    uint32_t vertexOffset = 0;
+    uint32_t indexOffset = 0;
+    uint32_t subMeshIndex = 0;
+    for (cgltf_size i = 0; i < source.primitives_count; ++i)
+    {
+        const cgltf_primitive& primitive = source.primitives[i];
+        if (!IsImportablePrimitive(primitive))
+            continue;
+
+        const cgltf_accessor* positions = FindAttribute(primitive, cgltf_attribute_type_position);
+        const cgltf_accessor* normals = FindAttribute(primitive, cgltf_attribute_type_normal);
+        const cgltf_accessor* tangents = FindAttribute(primitive, cgltf_attribute_type_tangent);
+        const cgltf_accessor* texcoords = FindAttribute(primitive, cgltf_attribute_type_texcoord);
+        const cgltf_accessor* joints = FindAttribute(primitive, cgltf_attribute_type_joints);
+        const cgltf_accessor* weights = FindAttribute(primitive, cgltf_attribute_type_weights);
+        const uint32_t vertexCount = (uint32_t)positions->count;
+
+        cgltf_accessor_unpack_floats(positions, &mesh.positions[vertexOffset].x, vertexCount * 3);
+        if (normals && normals->count == positions->count)
+            cgltf_accessor_unpack_floats(normals, &mesh.normals[vertexOffset].x, vertexCount * 3);
+        if (tangents && tangents->count == positions->count)
+            cgltf_accessor_unpack_floats(tangents, &mesh.tangents[vertexOffset].x, vertexCount * 4);
+        if (texcoords && texcoords->count == positions->count)
+            cgltf_accessor_unpack_floats(texcoords, &mesh.texcoords[vertexOffset].x, vertexCount * 2);
+        if (joints && weights && joints->count == positions->count && weights->count == positions->count)
+        {
+            for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                cgltf_uint values[4] = {};
+                cgltf_accessor_read_uint(joints, vertex, values, 4);
+                uint16_t* dst = &mesh.joints[(vertexOffset + vertex) * 4];
+                dst[0] = (uint16_t)values[0];
+                dst[1] = (uint16_t)values[1];
+                dst[2] = (uint16_t)values[2];
+                dst[3] = (uint16_t)values[3];
+            }
+            cgltf_accessor_unpack_floats(weights, &mesh.weights[vertexOffset].x, vertexCount * 4);
+        }
+
+        uint32_t* indices = mesh.indices + indexOffset;
+        uint32_t indexCount = vertexCount;
+        if (primitive.indices)
+        {
+            indexCount = (uint32_t)primitive.indices->count;
+            if (cgltf_accessor_unpack_indices(primitive.indices, indices, sizeof(uint32_t), indexCount) != indexCount)
+            {
+                // Sparse or otherwise unsupported by the fast path.
+                for (uint32_t index = 0; index < indexCount; ++index)
+                {
+                    indices[index] = (uint32_t)cgltf_accessor_read_index(primitive.indices, index);
+                }
+            }
+
+            for (uint32_t index = 0; index < indexCount; ++index)
+            {
+                indices[index] += vertexOffset;
+            }
+        }
+        else
+        {
+            for (uint32_t index = 0; index < indexCount; ++index)
+            {
+                indices[index] = vertexOffset + index;
+            }
+        }
+
+        SceneSubMesh& subMesh = mesh.subMeshes[subMeshIndex++];
+        subMesh.indexOffset = indexOffset;
+        subMesh.indexCount = indexCount;
+        subMesh.materialIndex = primitive.material ? (int32_t)cgltf_material_index(data, primitive.material) : -1;
+
+        vertexOffset += vertexCount;
+        indexOffset += indexCount;
+    }
+
+    mesh.boundsMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+    mesh.boundsMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (uint32_t i = 0; i < mesh.vertexCount; ++i)
+    {
+        const Vector3& position = mesh.positions[i];
+        mesh.boundsMin.x = position.x < mesh.boundsMin.x ? position.x : mesh.boundsMin.x;
+        mesh.boundsMin.y = position.y < mesh.boundsMin.y ? position.y : mesh.boundsMin.y;
+        mesh.boundsMin.z = position.z < mesh.boundsMin.z ? position.z : mesh.boundsMin.z;
+        mesh.boundsMax.x = position.x > mesh.boundsMax.x ? position.x : mesh.boundsMax.x;
+        mesh.boundsMax.y = position.y > mesh.boundsMax.y ? position.y : mesh.boundsMax.y;
+        mesh.boundsMax.z = position.z > mesh.boundsMax.z ? position.z : mesh.boundsMax.z;
+    }
+}
+
+static void ImportNode(const cgltf_data* data, const cgltf_node& source, int32_t parentIndex, SceneNode& node)
+{
+    node.name = DuplicateName(source.name);
+    node.meshIndex = source.mesh ? (int32_t)cgltf_mesh_index(data, source.mesh) : -1;
+    node.parentIndex = parentIndex;
+    node.skinIndex = source.skin ? (int32_t)cgltf_skin_index(data, source.skin) : -1;
+
+    if (source.has_matrix)
+    {
+        // Column-major column vector matrices have the same memory layout as Matrix4x4.
+        Matrix4x4 matrix;
+        memcpy(&matrix, source.matrix, sizeof(matrix));
+        MatrixDecompose(matrix, node.translation, node.rotation, node.scale);
+        return;
+    }
+
+    node.translation = source.has_translation ? Vector3{ source.translation[0], source.translation[1], source.translation[2] } : Vector3{ 0.0f, 0.0f, 0.0f };
+    node.rotation = source.has_rotation ? Vector4{ source.rotation[0], source.rotation[1], source.rotation[2], source.rotation[3] } : Vector4{ 0.0f, 0.0f, 0.0f, 1.0f };
+    node.scale = source.has_scale ? Vector3{ source.scale[0], source.scale[1], source.scale[2] } : Vector3{ 1.0f, 1.0f, 1.0f };
+}
+
+/// Returns the breadth-first index of every source node, -1 for nodes unreachable from a root.
+static std::vector<int32_t> ImportNodes(const cgltf_data* data, Scene* scene)
+{
+    // Sort nodes breadth-first so hierarchy updates can process one depth level at a time.
+    std::vector<const cgltf_node*> order;
+    order.reserve(data->nodes_count);
+    for (cgltf_size i = 0; i < data->nodes_count; ++i)
+    {
+        if (data->nodes[i].parent == nullptr)
+            order.push_back(&data->nodes[i]);
+    }
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const cgltf_node* node = order[i];
+        for (cgltf_size child = 0; child < node->children_count; ++child)
+        {
+            // Skip invalid files listing a node as child of several parents.
+            if (node->children[child]->parent == node)
+                order.push_back(node->children[child]);
+        }
+    }
+
+    std::vector<int32_t> remap(data->nodes_count, -1);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        remap[cgltf_node_index(data, order[i])] = (int32_t)i;
+    }
+
+    scene->nodeCount = (uint32_t)order.size();
+    scene->nodes = ALIMER_ALLOCN(SceneNode, scene->nodeCount);
+    for (uint32_t i = 0; i < scene->nodeCount; ++i)
+    {
+        const cgltf_node& source = *order[i];
+        const int32_t parentIndex = source.parent ? remap[cgltf_node_index(data, source.parent)] : -1;
+        ImportNode(data, source, parentIndex, scene->nodes[i]);
+    }
+
+    return remap;
+}
+
+static void ImportSkin(const cgltf_data* data, const cgltf_skin& source, const std::vector<int32_t>& nodeRemap, SceneSkin& skin)
+{
+    skin.name = DuplicateName(source.name);
+    skin.jointCount = (uint32_t)source.joints_count;
+    skin.skeletonIndex = source.skeleton ? nodeRemap[cgltf_node_index(data, source.skeleton)] : -1;
+    if (skin.jointCount == 0)
+        return;
+
+    skin.joints = ALIMER_ALLOCN(uint32_t, skin.jointCount);
+    skin.inverseBindMatrices = ALIMER_ALLOCN(Matrix4x4, skin.jointCount);
+    for (uint32_t i = 0; i < skin.jointCount; ++i)
+    {
+        const int32_t nodeIndex = nodeRemap[cgltf_node_index(data, source.joints[i])];
+        skin.joints[i] = nodeIndex >= 0 ? (uint32_t)nodeIndex : 0;
+        skin.inverseBindMatrices[i] = MatrixIdentity();
+    }
+
+    // Column-major column vector matrices have the same memory layout as Matrix4x4.
+    if (source.inverse_bind_matrices && source.inverse_bind_matrices->count >= skin.jointCount)
+    {
+        cgltf_accessor_unpack_floats(source.inverse_bind_matrices, &skin.inverseBindMatrices[0].m11, skin.jointCount * 16);
+    }
+}
+
+static void ImportAnimation(const cgltf_data* data, const cgltf_animation& source, const std::vector<int32_t>& nodeRemap, SceneAnimation& animation)
+{
+    animation.name = DuplicateName(source.name);
+    animation.channels = ALIMER_ALLOCN(SceneAnimationChannel, source.channels_count);
+
+    for (cgltf_size i = 0; i < source.channels_count; ++i)
+    {
+        const cgltf_animation_channel& sourceChannel = source.channels[i];
+        const cgltf_animation_sampler* sampler = sourceChannel.sampler;
+        if (!sourceChannel.target_node || !sampler || !sampler->input || !sampler->output)
+            continue;
+
+        const int32_t nodeIndex = nodeRemap[cgltf_node_index(data, sourceChannel.target_node)];
+        if (nodeIndex < 0)
+            continue;
+
+        SceneAnimationPath path;
+        switch (sourceChannel.target_path)
+        {
+            case cgltf_animation_path_type_translation: path = SceneAnimationPath_Translation; break;
+            case cgltf_animation_path_type_rotation:    path = SceneAnimationPath_Rotation; break;
+            case cgltf_animation_path_type_scale:       path = SceneAnimationPath_Scale; break;
+            default:
+                // Morph target weights are not supported yet.
+                continue;
+        }
+
+        SceneAnimationInterpolation interpolation;
+        switch (sampler->interpolation)
+        {
+            case cgltf_interpolation_type_step:         interpolation = SceneAnimationInterpolation_Step; break;
+            case cgltf_interpolation_type_cubic_spline: interpolation = SceneAnimationInterpolation_CubicSpline; break;
+            default:                                    interpolation = SceneAnimationInterpolation_Linear; break;
+        }
+
+        const uint32_t keyCount = (uint32_t)sampler->input->count;
+        const uint32_t valuesPerKey = interpolation == SceneAnimationInterpolation_CubicSpline ? 3u : 1u;
+        if (keyCount == 0 || sampler->output->count != (cgltf_size)keyCount * valuesPerKey)
+            continue;
+
+        SceneAnimationChannel& channel = animation.channels[animation.channelCount++];
+        channel.nodeIndex = (uint32_t)nodeIndex;
+        channel.path = path;
+        channel.interpolation = interpolation;
+        channel.keyCount = keyCount;
+        channel.times = ALIMER_ALLOCN(float, keyCount);
+        const uint32_t valueCount = GetChannelValueCount(path, interpolation, keyCount);
+        channel.values = ALIMER_ALLOCN(float, valueCount);
+        cgltf_accessor_unpack_floats(sampler->input, channel.times, keyCount);
+        cgltf_accessor_unpack_floats(sampler->output, channel.values, valueCount);
+
+        animation.duration = channel.times[keyCount - 1] > animation.duration ? channel.times[keyCount - 1] : animation.duration;
+    }
+}
+
+/* cgltf allocations and file access are routed through the engine allocator and the import options. */
+static void* SceneAlloc(void* /*userData*/, cgltf_size size)
+{
+    return alimerMalloc(size);
+}
+
+static void SceneFree(void* /*userData*/, void* ptr)
+{
+    alimerFree(ptr);
+}
+
+static cgltf_result SceneFileRead(const cgltf_memory_options* /*memoryOptions*/, const cgltf_file_options* fileOptions, const char* path, cgltf_size* size, void** data)
+{
+    const SceneImportOptions* importOptions = static_cast<const SceneImportOptions*>(fileOptions->user_data);
+
+    size_t dataSize = 0;
+    if (!importOptions->fileRead(path, data, &dataSize, importOptions->fileUserData))
+        return cgltf_result_file_not_found;
+
+    // Buffers pass their declared size, everything else reads the whole file.
+    if (size && *size > dataSize)
+    {
+        if (importOptions->fileRelease)
+            importOptions->fileRelease(*data, dataSize, importOptions->fileUserData);
+        *data = nullptr;
+        return cgltf_result_data_too_short;
+    }
+
+    if (size)
+        *size = dataSize;
+    return cgltf_result_success;
+}
+
+static void SceneFileRelease(const cgltf_memory_options* /*memoryOptions*/, const cgltf_file_options* fileOptions, void* data, cgltf_size size)
+{
+    const SceneImportOptions* importOptions = static_cast<const SceneImportOptions*>(fileOptions->user_data);
+    if (data && importOptions->fileRelease)
+        importOptions->fileRelease(data, size, importOptions->fileUserData);
+}
+
+static cgltf_options GetGltfOptions(const SceneImportOptions* importOptions)
 {
-    // Setup cgltf options
     cgltf_options options = {};
+    options.memory.alloc_func = SceneAlloc;
+    options.memory.free_func = SceneFree;
+    if (importOptions && importOptions->fileRead)
+    {
+        options.file.read = SceneFileRead;
+        options.file.release = SceneFileRelease;
+        options.file.user_data = const_cast<SceneImportOptions*>(importOptions);
+    }
+    return options;
+}
+
+static void ImportImage(const cgltf_options& options, const cgltf_image& source, SceneImage& image)
+{
+    image.name = DuplicateName(source.name);
+    image.mimeType = DuplicateName(source.mime_type);
+
+    if (source.buffer_view)
+    {
+        const cgltf_buffer_view* view = source.buffer_view;
+        const uint8_t* bytes = cgltf_buffer_view_data(view);
+        if (!bytes)
+            return;
+
+        // The GLB binary chunk is not owned by cgltf, it lives in the caller data and can be referenced directly.
+        if (view->buffer->data_free_method == cgltf_data_free_method_none)
+        {
+            image.data = alimerBlobCreateView(bytes, view->size, nullptr);
+        }
+        else
+        {
+            void* copy = alimerMalloc(view->size);
+            memcpy(copy, bytes, view->size);
+            image.data = alimerBlobCreate(copy, view->size, nullptr);
+        }
+    }
+    else if (source.uri && strncmp(source.uri, "data:", 5) == 0)
+    {
+        const char* comma = strchr(source.uri, ',');
+        if (!comma || comma - source.uri < 7 || strncmp(comma - 7, ";base64", 7) != 0)
+            return;
+
+        const char* base64 = comma + 1;
+        const size_t length = strlen(base64);
+        size_t padding = 0;
+        while (padding < length && padding < 2 && base64[length - 1 - padding] == '=')
+            ++padding;
+
+        const size_t size = (length / 4) * 3 - padding;
+        void* decoded = nullptr;
+        if (size > 0 && cgltf_load_buffer_base64(&options, size, base64, &decoded) == cgltf_result_success)
+        {
+            image.data = alimerBlobCreate(decoded, size, nullptr);
+        }
+    }
+    else if (source.uri)
+    {
+        image.uri = _alimer_strdup(source.uri);
+        cgltf_decode_uri(image.uri);
+    }
+}
+
+static void DecodeImage(SceneImage& image, const void* data, size_t dataSize)
+{
+    if (data)
+    {
+        image.image = alimerImageCreateFromMemory(static_cast<const uint8_t*>(data), dataSize);
+    }
+
+    if (!image.image)
+    {
+        alimerLogWarn(LogCategory_System, "Failed to decode scene image '%s'", image.uri ? image.uri : (image.name ? image.name : "<embedded>"));
+    }
+}
+
+namespace
+{
+    /// Decodes scene images on worker threads. External files are read by Start and released by Finish on the
+    /// calling thread, the import file callbacks are never called concurrently.
+    struct SceneImageDecoder final
+    {
+        const cgltf_options* options = nullptr;
+        jobs::Context context;
+        std::vector<void*> fileData;
+        std::vector<cgltf_size> fileSizes;
+
+        /// The options must stay alive until Finish.
+        void Start(const cgltf_options& options_, Scene* scene)
+        {
+            options = &options_;
+            fileData.assign(scene->imageCount, nullptr);
+            fileSizes.assign(scene->imageCount, 0);
+
+            auto fileRead = options->file.read ? options->file.read : cgltf_default_file_read;
+            for (uint32_t i = 0; i < scene->imageCount; ++i)
+            {
+                SceneImage* image = &scene->images[i];
+                const void* data = nullptr;
+                size_t dataSize = 0;
+                if (image->data)
+                {
+                    data = image->data->data;
+                    dataSize = image->data->size;
+                }
+                else if (image->uri && fileRead(&options->memory, &options->file, image->uri, &fileSizes[i], &fileData[i]) == cgltf_result_success)
+                {
+                    data = fileData[i];
+                    dataSize = fileSizes[i];
+                }
+
+                jobs::Execute(context, [image, data, dataSize] { DecodeImage(*image, data, dataSize); });
+            }
+        }
+
+        void Finish()
+        {
+            jobs::Wait(context);
+
+            for (size_t i = 0; i < fileData.size(); ++i)
+            {
+                if (fileData[i])
+                {
+                    auto fileRelease = options->file.release ? options->file.release : cgltf_default_file_release;
+                    fileRelease(&options->memory, &options->file, fileData[i], fileSizes[i]);
+                }
+            }
+            fileData.clear();
+            fileSizes.clear();
+        }
+    };
+}
+
+/// Fold the size and modification time of an external file into the hash, embedded data is covered by the scene data hash.
+static uint64_t HashExternalFile(const cgltf_options& options, const SceneImportOptions* importOptions, const char* uri, uint64_t hash)
+{
+    if (!uri || strncmp(uri, "data:", 5) == 0)
+        return hash;
+
+    char* path = _alimer_strdup(uri);
+    cgltf_decode_uri(path);
+    hash = Hash64(path, strlen(path), hash);
+
+    uint64_t stamp[2] = {};
+    if (importOptions && importOptions->fileStat)
+    {
+        importOptions->fileStat(path, &stamp[0], &stamp[1], importOptions->fileUserData);
+    }
+    else if (!importOptions || !importOptions->fileRead)
+    {
+        _alimer_stat_file(path, &stamp[0], &stamp[1]);
+    }
+    else
+    {
+        // Custom resolver without a stat callback, the contents are the only way to detect edits.
+        cgltf_size size = 0;
+        void* data = nullptr;
+        if (options.file.read(&options.memory, &options.file, path, &size, &data) == cgltf_result_success)
+        {
+            stamp[0] = size;
+            stamp[1] = Hash64(data, size);
+            options.file.release(&options.memory, &options.file, data, size);
+        }
+    }
+    alimerFree(path);
+
+    return Hash64(stamp, sizeof(stamp), hash);
+}
+
+/// Content hash of the scene data and of every external buffer and image it references, only computed for caches.
+static uint64_t ComputeContentHash(const void* pData, size_t dataSize, const SceneImportOptions* importOptions)
+{
+    const cgltf_options options = GetGltfOptions(importOptions);
+
+    cgltf_data* data = nullptr;
+    if (cgltf_parse(&options, pData, (cgltf_size)dataSize, &data) != cgltf_result_success)
+        return Hash64(pData, dataSize);
+
+    uint64_t hash = Hash64(pData, dataSize);
+    for (cgltf_size i = 0; i < data->buffers_count; ++i)
+    {
+        hash = HashExternalFile(options, importOptions, data->buffers[i].uri, hash);
+    }
+
+    for (cgltf_size i = 0; i < data->images_count; ++i)
+    {
+        if (!data->images[i].buffer_view)
+        {
+            hash = HashExternalFile(options, importOptions, data->images[i].uri, hash);
+        }
+    }
+
+    cgltf_free(data);
+    return hash;
+}
+
+static Scene* tryLoadGltfFromMemory(const void* pData, size_t dataSize, const SceneImportOptions* importOptions)
+{
+    cgltf_options options = GetGltfOptions(importOptions);
 
     cgltf_data* data = nullptr;
     cgltf_result result = cgltf_parse(&options, pData, (cgltf_size)dataSize, &data);
@@ -23,10 +739,11 @@ static Scene* tryLoadGltfFromMemory(const void* pData, size_t dataSize)
         return nullptr;
     }
 
-    // Load buffer data (for external .bin references; GLB has embedded buffers).
-    cgltf_result loadResult = cgltf_load_buffers(&options, data, nullptr);
+    // Load buffer data (for external .bin references; GLB has embedded buffers), URIs stay relative to the scene.
+    cgltf_result loadResult = cgltf_load_buffers(&options, data, "");
     if (loadResult != cgltf_result_success)
     {
+        cgltf_free(data);
         return nullptr;
     }
 
@@ -37,8 +754,27 @@ static Scene* tryLoadGltfFromMemory(const void* pData, size_t dataSize)
         // Continue anyway - validation failures might not be critical
     }
 
-    Scene* scene = ALIMER_ALLOC(Scene);
-    ALIMER_ASSERT(scene);
+    SceneStorage* storage = ALIMER_ALLOC(SceneStorage);
+    ALIMER_ASSERT(storage);
+    Scene* scene = &storage->scene;
+
+    // Images decode on worker threads while the geometry is imported.
+    SceneImageDecoder imageDecoder;
+    if (data->images_count > 0)
+    {
+        scene->imageCount = (uint32_t)data->images_count;
+        scene->images = ALIMER_ALLOCN(SceneImage, scene->imageCount);
+
+        for (cgltf_size i = 0; i < data->images_count; ++i)
+        {
+            ImportImage(options, data->images[i], scene->images[i]);
+        }
+
+        if (importOptions && importOptions->decodeImages)
+        {
+            imageDecoder.Start(options, scene);
+        }
+    }
 
     if (data->materials_count > 0)
     {
@@ -47,41 +783,66 @@ static Scene* tryLoadGltfFromMemory(const void* pData, size_t dataSize)
 
         for (cgltf_size i = 0; i < data->materials_count; ++i)
         {
-            const cgltf_material* gltfMaterial = &data->materials[i];
+            ImportMaterial(data, data->materials[i], scene->materials[i]);
         }
     }
 
-    // Process scene nodes or all nodes if no scene is specified
-    const cgltf_scene* gltf_scene = data->scene ? data->scene : (data->scenes_count > 0 ? &data->scenes[0] : nullptr);
-    if (gltf_scene)
+    if (data->meshes_count > 0)
     {
-        scene->nodeCount = (uint32_t)gltf_scene->nodes_count;
-        scene->nodes = ALIMER_ALLOCN(SceneNode, scene->materialCount);
+        scene->meshCount = (uint32_t)data->meshes_count;
+        scene->meshes = ALIMER_ALLOCN(SceneMesh, scene->meshCount);
 
-        for (cgltf_size i = 0; i < gltf_scene->nodes_count; ++i)
+        for (cgltf_size i = 0; i < data->meshes_count; ++i)
         {
-            const cgltf_node* node = gltf_scene->nodes[i];
+            ImportMesh(data, data->meshes[i], scene->meshes[i]);
         }
     }
-    else
+
+    // Import every node so that children of the scene roots are not lost.
+    std::vector<int32_t> nodeRemap;
+    if (data->nodes_count > 0)
     {
-        // Process all nodes
-        for (cgltf_size i = 0; i < data->nodes_count; ++i)
+        nodeRemap = ImportNodes(data, scene);
+    }
+
+    if (data->skins_count > 0)
+    {
+        scene->skinCount = (uint32_t)data->skins_count;
+        scene->skins = ALIMER_ALLOCN(SceneSkin, scene->skinCount);
+
+        for (cgltf_size i = 0; i < data->skins_count; ++i)
+        {
+            ImportSkin(data, data->skins[i], nodeRemap, scene->skins[i]);
+        }
+    }
+
+    if (data->animations_count > 0)
+    {
+        scene->animationCount = (uint32_t)data->animations_count;
+        scene->animations = ALIMER_ALLOCN(SceneAnimation, scene->animationCount);
+
+        for (cgltf_size i = 0; i < data->animations_count; ++i)
         {
-            const cgltf_node* node = &data->nodes[i];
+            ImportAnimation(data, data->animations[i], nodeRemap, scene->animations[i]);
         }
     }
 
+    imageDecoder.Finish();
     cgltf_free(data);
 
     return scene;
 }
 
 Scene* alimerSceneCreateFromMemory(const void* pData, size_t dataSize)
+{
+    return alimerSceneCreateFromMemoryWithOptions(pData, dataSize, nullptr);
+}
+
+Scene* alimerSceneCreateFromMemoryWithOptions(const void* pData, size_t dataSize, const SceneImportOptions* options)
 {
     Scene* scene = nullptr;
 
-    if ((scene = tryLoadGltfFromMemory(pData, dataSize)) != NULL)
+    if ((scene = tryLoadGltfFromMemory(pData, dataSize, options)) != NULL)
         return scene;
 
     return scene;
@@ -89,21 +850,672 @@ Scene* alimerSceneCreateFromMemory(const void* pData, size_t dataSize)
 
 void alimerSceneDestroy(Scene* scene)
 {
-    // TODO: Free scene data
-    if (scene->meshCount)
+    if (!scene)
+        return;
+
+    SceneStorage* storage = GetStorage(scene);
+
+    // Data of a cached scene lives in the file mapping, only the tables are heap allocated.
+    const bool ownsData = storage->mapping.data == nullptr;
+
+    for (uint32_t i = 0; i < scene->meshCount && ownsData; ++i)
+    {
+        SceneMesh& mesh = scene->meshes[i];
+        alimerFree(mesh.name);
+        alimerFree(mesh.positions);
+        alimerFree(mesh.normals);
+        alimerFree(mesh.tangents);
+        alimerFree(mesh.texcoords);
+        alimerFree(mesh.joints);
+        alimerFree(mesh.weights);
+        alimerFree(mesh.indices);
+        alimerFree(mesh.subMeshes);
+    }
+
+    for (uint32_t i = 0; i < scene->materialCount && ownsData; ++i)
+    {
+        alimerFree(scene->materials[i].name);
+    }
+
+    for (uint32_t i = 0; i < scene->nodeCount && ownsData; ++i)
+    {
+        alimerFree(scene->nodes[i].name);
+    }
+
+    for (uint32_t i = 0; i < scene->skinCount && ownsData; ++i)
+    {
+        alimerFree(scene->skins[i].name);
+        alimerFree(scene->skins[i].joints);
+        alimerFree(scene->skins[i].inverseBindMatrices);
+    }
+
+    for (uint32_t i = 0; i < scene->animationCount; ++i)
+    {
+        SceneAnimation& animation = scene->animations[i];
+        for (uint32_t channel = 0; channel < animation.channelCount && ownsData; ++channel)
+        {
+            alimerFree(animation.channels[channel].times);
+            alimerFree(animation.channels[channel].values);
+        }
+
+        if (ownsData)
+            alimerFree(animation.name);
+        alimerFree(animation.channels);
+    }
+
+    alimerFree(scene->meshes);
+    alimerFree(scene->materials);
+    alimerFree(scene->nodes);
+    for (uint32_t i = 0; i < scene->imageCount; ++i)
+    {
+        SceneImage& image = scene->images[i];
+        if (ownsData)
+        {
+            alimerFree(image.name);
+            alimerFree(image.uri);
+            alimerFree(image.mimeType);
+        }
+
+        if (image.data)
+            alimerBlobDestroy(image.data);
+        alimerImageDestroy(image.image);
+    }
+
+    alimerFree(scene->skins);
+    alimerFree(scene->animations);
+    alimerFree(scene->images);
+
+    _alimer_unmap_file(&storage->mapping);
+    alimerFree(storage);
+}
+
+/* Scene cache */
+namespace
+{
+    /// Appends 16-byte aligned blocks to a cache file, keeping track of the current offset.
+    struct SceneCacheWriter final
+    {
+        FILE* file = nullptr;
+        uint64_t offset = 0;
+        bool failed = false;
+
+        void Pad()
+        {
+            static const uint8_t kZeros[kSceneCacheAlignment] = {};
+            const uint64_t padding = ((offset + kSceneCacheAlignment - 1) & ~(kSceneCacheAlignment - 1)) - offset;
+            if (padding > 0)
+                Write(kZeros, padding);
+        }
+
+        void Write(const void* data, uint64_t size)
+        {
+            if (failed || size == 0)
+                return;
+
+            if (fwrite(data, 1, (size_t)size, file) != (size_t)size)
+                failed = true;
+            offset += size;
+        }
+
+        uint64_t WriteBlock(const void* data, uint64_t size)
+        {
+            if (!data || size == 0)
+                return 0;
+
+            Pad();
+            const uint64_t blockOffset = offset;
+            Write(data, size);
+            return blockOffset;
+        }
+
+        uint64_t WriteString(const char* value)
+        {
+            return value ? WriteBlock(value, strlen(value) + 1) : 0;
+        }
+    };
+
+    /// Bounds checked view over a mapped cache file.
+    struct SceneCacheReader final
+    {
+        const uint8_t* data;
+        uint64_t size;
+
+        template <typename T>
+        bool Get(uint64_t offset, uint64_t count, T** result) const
+        {
+            *result = nullptr;
+            if (offset == 0 || count == 0)
+                return true;
+
+            if ((offset % alignof(T)) != 0 || offset > size || count > (size - offset) / sizeof(T))
+                return false;
+
+            *result = reinterpret_cast<T*>(const_cast<uint8_t*>(data + offset));
+            return true;
+        }
+
+        bool GetString(uint64_t offset, char** result) const
+        {
+            *result = nullptr;
+            if (offset == 0)
+                return true;
+
+            if (offset >= size || memchr(data + offset, 0, (size_t)(size - offset)) == nullptr)
+                return false;
+
+            *result = reinterpret_cast<char*>(const_cast<uint8_t*>(data + offset));
+            return true;
+        }
+    };
+}
+
+bool alimerSceneSave(const Scene* scene, const char* path)
+{
+    ALIMER_ASSERT(scene);
+    ALIMER_ASSERT(path);
+
+    // Write next to the cache and rename it over once complete, live scenes may still map the old file.
+    const size_t pathLength = strlen(path);
+    char* tempPath = (char*)alimerCalloc(pathLength + 5, 1);
+    memcpy(tempPath, path, pathLength);
+    memcpy(tempPath + pathLength, ".tmp", 5);
+
+    SceneCacheWriter writer;
+    writer.file = fopen(tempPath, "wb");
+    if (!writer.file)
+    {
+        alimerLogError(LogCategory_System, "Failed to open scene cache '%s' for writing", tempPath);
+        alimerFree(tempPath);
+        return false;
+    }
+
+    SceneCacheHeader header = {};
+    header.magic = kSceneCacheMagic;
+    header.version = kSceneCacheVersion;
+    header.contentHash = scene->contentHash;
+    header.meshCount = scene->meshCount;
+    header.materialCount = scene->materialCount;
+    header.nodeCount = scene->nodeCount;
+    header.skinCount = scene->skinCount;
+    header.animationCount = scene->animationCount;
+    header.imageCount = scene->imageCount;
+
+    // Tables follow the header, their records are patched once all data blocks are written.
+    uint64_t tableOffset = sizeof(SceneCacheHeader);
+    header.meshesOffset = scene->meshCount ? tableOffset : 0;
+    tableOffset += sizeof(SceneCacheMesh) * scene->meshCount;
+    header.materialsOffset = scene->materialCount ? tableOffset : 0;
+    tableOffset += sizeof(SceneCacheMaterial) * scene->materialCount;
+    header.nodesOffset = scene->nodeCount ? tableOffset : 0;
+    tableOffset += sizeof(SceneCacheNode) * scene->nodeCount;
+    header.skinsOffset = scene->skinCount ? tableOffset : 0;
+    tableOffset += sizeof(SceneCacheSkin) * scene->skinCount;
+    header.animationsOffset = scene->animationCount ? tableOffset : 0;
+    tableOffset += sizeof(SceneCacheAnimation) * scene->animationCount;
+    header.imagesOffset = scene->imageCount ? tableOffset : 0;
+    tableOffset += sizeof(SceneCacheImage) * scene->imageCount;
+
+    SceneCacheMesh* meshes = ALIMER_ALLOCN(SceneCacheMesh, scene->meshCount);
+    SceneCacheMaterial* materials = ALIMER_ALLOCN(SceneCacheMaterial, scene->materialCount);
+    SceneCacheNode* nodes = ALIMER_ALLOCN(SceneCacheNode, scene->nodeCount);
+    SceneCacheSkin* skins = ALIMER_ALLOCN(SceneCacheSkin, scene->skinCount);
+    SceneCacheAnimation* animations = ALIMER_ALLOCN(SceneCacheAnimation, scene->animationCount);
+    SceneCacheImage* images = ALIMER_ALLOCN(SceneCacheImage, scene->imageCount);
+
+    if (fseek(writer.file, (long)tableOffset, SEEK_SET) != 0)
+        writer.failed = true;
+    writer.offset = tableOffset;
+
+    for (uint32_t i = 0; i < scene->meshCount; ++i)
+    {
+        const SceneMesh& mesh = scene->meshes[i];
+        SceneCacheMesh& record = meshes[i];
+        record.nameOffset = writer.WriteString(mesh.name);
+        record.vertexCount = mesh.vertexCount;
+        record.indexCount = mesh.indexCount;
+        record.subMeshCount = mesh.subMeshCount;
+        record.boundsMin = mesh.boundsMin;
+        record.boundsMax = mesh.boundsMax;
+        record.positionsOffset = writer.WriteBlock(mesh.positions, sizeof(Vector3) * mesh.vertexCount);
+        record.normalsOffset = writer.WriteBlock(mesh.normals, sizeof(Vector3) * mesh.vertexCount);
+        record.tangentsOffset = writer.WriteBlock(mesh.tangents, sizeof(Vector4) * mesh.vertexCount);
+        record.texcoordsOffset = writer.WriteBlock(mesh.texcoords, sizeof(Vector2) * mesh.vertexCount);
+        record.jointsOffset = writer.WriteBlock(mesh.joints, sizeof(uint16_t) * 4 * mesh.vertexCount);
+        record.weightsOffset = writer.WriteBlock(mesh.weights, sizeof(Vector4) * mesh.vertexCount);
+        record.indicesOffset = writer.WriteBlock(mesh.indices, sizeof(uint32_t) * mesh.indexCount);
+        record.subMeshesOffset = writer.WriteBlock(mesh.subMeshes, sizeof(SceneSubMesh) * mesh.subMeshCount);
+    }
+
+    for (uint32_t i = 0; i < scene->materialCount; ++i)
+    {
+        const SceneMaterial& material = scene->materials[i];
+        SceneCacheMaterial& record = materials[i];
+        record.nameOffset = writer.WriteString(material.name);
+        record.baseColorImage = material.baseColorImage;
+        record.metallicRoughnessImage = material.metallicRoughnessImage;
+        record.normalImage = material.normalImage;
+        record.occlusionImage = material.occlusionImage;
+        record.emissiveImage = material.emissiveImage;
+        record.baseColorFactor = material.baseColorFactor;
+        record.emissiveFactor = material.emissiveFactor;
+        record.metallicFactor = material.metallicFactor;
+        record.roughnessFactor = material.roughnessFactor;
+        record.alphaCutoff = material.alphaCutoff;
+        record.alphaMode = (uint32_t)material.alphaMode;
+        record.doubleSided = material.doubleSided;
+    }
+
+    for (uint32_t i = 0; i < scene->nodeCount; ++i)
+    {
+        nodes[i].nameOffset = writer.WriteString(scene->nodes[i].name);
+        nodes[i].meshIndex = scene->nodes[i].meshIndex;
+        nodes[i].parentIndex = scene->nodes[i].parentIndex;
+        nodes[i].translation = scene->nodes[i].translation;
+        nodes[i].rotation = scene->nodes[i].rotation;
+        nodes[i].scale = scene->nodes[i].scale;
+        nodes[i].skinIndex = scene->nodes[i].skinIndex;
+    }
+
+    for (uint32_t i = 0; i < scene->skinCount; ++i)
+    {
+        const SceneSkin& skin = scene->skins[i];
+        SceneCacheSkin& record = skins[i];
+        record.nameOffset = writer.WriteString(skin.name);
+        record.jointCount = skin.jointCount;
+        record.skeletonIndex = skin.skeletonIndex;
+        record.jointsOffset = writer.WriteBlock(skin.joints, sizeof(uint32_t) * skin.jointCount);
+        record.inverseBindMatricesOffset = writer.WriteBlock(skin.inverseBindMatrices, sizeof(Matrix4x4) * skin.jointCount);
+    }
+
+    for (uint32_t i = 0; i < scene->animationCount; ++i)
+    {
+        const SceneAnimation& animation = scene->animations[i];
+        SceneCacheAnimation& record = animations[i];
+        record.nameOffset = writer.WriteString(animation.name);
+        record.duration = animation.duration;
+        record.channelCount = animation.channelCount;
+
+        SceneCacheAnimationChannel* channels = ALIMER_ALLOCN(SceneCacheAnimationChannel, animation.channelCount);
+        for (uint32_t channelIndex = 0; channelIndex < animation.channelCount; ++channelIndex)
+        {
+            const SceneAnimationChannel& channel = animation.channels[channelIndex];
+            const uint32_t valueCount = GetChannelValueCount(channel.path, channel.interpolation, channel.keyCount);
+            channels[channelIndex].nodeIndex = channel.nodeIndex;
+            channels[channelIndex].path = (uint32_t)channel.path;
+            channels[channelIndex].interpolation = (uint32_t)channel.interpolation;
+            channels[channelIndex].keyCount = channel.keyCount;
+            channels[channelIndex].timesOffset = writer.WriteBlock(channel.times, sizeof(float) * channel.keyCount);
+            channels[channelIndex].valuesOffset = writer.WriteBlock(channel.values, sizeof(float) * valueCount);
+        }
+        record.channelsOffset = writer.WriteBlock(channels, sizeof(SceneCacheAnimationChannel) * animation.channelCount);
+        alimerFree(channels);
+    }
+
+    for (uint32_t i = 0; i < scene->imageCount; ++i)
+    {
+        const SceneImage& image = scene->images[i];
+        SceneCacheImage& record = images[i];
+        record.nameOffset = writer.WriteString(image.name);
+        record.uriOffset = writer.WriteString(image.uri);
+        record.mimeTypeOffset = writer.WriteString(image.mimeType);
+        if (image.data)
+        {
+            record.dataOffset = writer.WriteBlock(image.data->data, image.data->size);
+            record.dataSize = image.data->size;
+        }
+    }
+
+    writer.Pad();
+    header.fileSize = writer.offset;
+
+    if (fseek(writer.file, 0, SEEK_SET) != 0)
+        writer.failed = true;
+    writer.Write(&header, sizeof(header));
+    writer.Write(meshes, sizeof(SceneCacheMesh) * scene->meshCount);
+    writer.Write(materials, sizeof(SceneCacheMaterial) * scene->materialCount);
+    writer.Write(nodes, sizeof(SceneCacheNode) * scene->nodeCount);
+    writer.Write(skins, sizeof(SceneCacheSkin) * scene->skinCount);
+    writer.Write(animations, sizeof(SceneCacheAnimation) * scene->animationCount);
+    writer.Write(images, sizeof(SceneCacheImage) * scene->imageCount);
+
+    alimerFree(meshes);
+    alimerFree(materials);
+    alimerFree(nodes);
+    alimerFree(skins);
+    alimerFree(animations);
+    alimerFree(images);
+
+    if (fflush(writer.file) != 0)
+        writer.failed = true;
+    if (fclose(writer.file) != 0)
+        writer.failed = true;
+
+    if (writer.failed)
+    {
+        alimerLogError(LogCategory_System, "Failed to write scene cache '%s'", tempPath);
+        remove(tempPath);
+        alimerFree(tempPath);
+        return false;
+    }
+
+    if (!_alimer_replace_file(tempPath, path))
+    {
+        alimerLogError(LogCategory_System, "Failed to replace scene cache '%s'", path);
+        remove(tempPath);
+        alimerFree(tempPath);
+        return false;
+    }
+
+    alimerFree(tempPath);
+    return true;
+}
+
+/// Index into a table of count entries, or -1 for none.
+static bool IsOptionalIndex(int32_t index, uint32_t count)
+{
+    return index >= -1 && (index < 0 || (uint32_t)index < count);
+}
+
+static Scene* tryLoadSceneCache(const char* path, const uint64_t* expectedContentHash, const SceneImportOptions* importOptions)
+{
+    FileMapping mapping;
+    if (!_alimer_map_file(path, &mapping))
+        return nullptr;
+
+    if (mapping.size < sizeof(SceneCacheHeader))
+    {
+        _alimer_unmap_file(&mapping);
+        return nullptr;
+    }
+
+    // Mappings are page aligned, so every 16-byte aligned offset is aligned in memory as well.
+    const SceneCacheReader reader = { static_cast<const uint8_t*>(mapping.data), mapping.size };
+    const SceneCacheHeader* header = static_cast<const SceneCacheHeader*>(mapping.data);
+    if (header->magic != kSceneCacheMagic
+        || header->version != kSceneCacheVersion
+        || header->fileSize != mapping.size
+        || (expectedContentHash && header->contentHash != *expectedContentHash))
+    {
+        _alimer_unmap_file(&mapping);
+        return nullptr;
+    }
+
+    const SceneCacheMesh* meshRecords = nullptr;
+    const SceneCacheMaterial* materialRecords = nullptr;
+    const SceneCacheNode* nodeRecords = nullptr;
+    const SceneCacheSkin* skinRecords = nullptr;
+    const SceneCacheAnimation* animationRecords = nullptr;
+    const SceneCacheImage* imageRecords = nullptr;
+    if (!reader.Get(header->meshesOffset, header->meshCount, &meshRecords)
+        || !reader.Get(header->materialsOffset, header->materialCount, &materialRecords)
+        || !reader.Get(header->nodesOffset, header->nodeCount, &nodeRecords)
+        || !reader.Get(header->skinsOffset, header->skinCount, &skinRecords)
+        || !reader.Get(header->animationsOffset, header->animationCount, &animationRecords)
+        || !reader.Get(header->imagesOffset, header->imageCount, &imageRecords)
+        || (header->meshCount && !meshRecords)
+        || (header->materialCount && !materialRecords)
+        || (header->nodeCount && !nodeRecords)
+        || (header->skinCount && !skinRecords)
+        || (header->animationCount && !animationRecords)
+        || (header->imageCount && !imageRecords))
+    {
+        _alimer_unmap_file(&mapping);
+        return nullptr;
+    }
+
+    SceneStorage* storage = ALIMER_ALLOC(SceneStorage);
+    storage->mapping = mapping;
+    Scene* scene = &storage->scene;
+    scene->contentHash = header->contentHash;
+    scene->meshCount = header->meshCount;
+    scene->materialCount = header->materialCount;
+    scene->nodeCount = header->nodeCount;
+    scene->skinCount = header->skinCount;
+    scene->animationCount = header->animationCount;
+    scene->imageCount = header->imageCount;
+    scene->meshes = ALIMER_ALLOCN(SceneMesh, scene->meshCount);
+    scene->materials = ALIMER_ALLOCN(SceneMaterial, scene->materialCount);
+    scene->nodes = ALIMER_ALLOCN(SceneNode, scene->nodeCount);
+    scene->skins = ALIMER_ALLOCN(SceneSkin, scene->skinCount);
+    scene->animations = ALIMER_ALLOCN(SceneAnimation, scene->animationCount);
+    scene->images = ALIMER_ALLOCN(SceneImage, scene->imageCount);
+
+    bool valid = true;
+    for (uint32_t i = 0; i < scene->meshCount && valid; ++i)
+    {
+        const SceneCacheMesh& record = meshRecords[i];
+        SceneMesh& mesh = scene->meshes[i];
+        mesh.vertexCount = record.vertexCount;
+        mesh.indexCount = record.indexCount;
+        mesh.subMeshCount = record.subMeshCount;
+        mesh.boundsMin = record.boundsMin;
+        mesh.boundsMax = record.boundsMax;
+
+        valid = reader.GetString(record.nameOffset, &mesh.name)
+            && reader.Get(record.positionsOffset, record.vertexCount, &mesh.positions)
+            && reader.Get(record.normalsOffset, record.vertexCount, &mesh.normals)
+            && reader.Get(record.tangentsOffset, record.vertexCount, &mesh.tangents)
+            && reader.Get(record.texcoordsOffset, record.vertexCount, &mesh.texcoords)
+            && reader.Get(record.jointsOffset, (uint64_t)record.vertexCount * 4, &mesh.joints)
+            && reader.Get(record.weightsOffset, record.vertexCount, &mesh.weights)
+            && reader.Get(record.indicesOffset, record.indexCount, &mesh.indices)
+            && reader.Get(record.subMeshesOffset, record.subMeshCount, &mesh.subMeshes)
+            && (record.vertexCount == 0 || mesh.positions)
+            && (record.indexCount == 0 || mesh.indices)
+            && (record.subMeshCount == 0 || mesh.subMeshes);
+
+        for (uint32_t subMeshIndex = 0; subMeshIndex < mesh.subMeshCount && valid; ++subMeshIndex)
+        {
+            const SceneSubMesh& subMesh = mesh.subMeshes[subMeshIndex];
+            valid = (uint64_t)subMesh.indexOffset + subMesh.indexCount <= record.indexCount
+                && IsOptionalIndex(subMesh.materialIndex, header->materialCount);
+        }
+
+        // The BVH and skinning read vertices through the indices.
+        for (uint32_t index = 0; index < mesh.indexCount && valid; ++index)
+        {
+            valid = mesh.indices[index] < mesh.vertexCount;
+        }
+    }
+
+    for (uint32_t i = 0; i < scene->materialCount && valid; ++i)
+    {
+        const SceneCacheMaterial& record = materialRecords[i];
+        SceneMaterial& material = scene->materials[i];
+        material.baseColorFactor = record.baseColorFactor;
+        material.emissiveFactor = record.emissiveFactor;
+        material.metallicFactor = record.metallicFactor;
+        material.roughnessFactor = record.roughnessFactor;
+        material.alphaCutoff = record.alphaCutoff;
+        material.alphaMode = (SceneAlphaMode)record.alphaMode;
+        material.doubleSided = record.doubleSided;
+        material.baseColorImage = record.baseColorImage;
+        material.metallicRoughnessImage = record.metallicRoughnessImage;
+        material.normalImage = record.normalImage;
+        material.occlusionImage = record.occlusionImage;
+        material.emissiveImage = record.emissiveImage;
+
+        valid = reader.GetString(record.nameOffset, &material.name)
+            && IsOptionalIndex(record.baseColorImage, header->imageCount)
+            && IsOptionalIndex(record.metallicRoughnessImage, header->imageCount)
+            && IsOptionalIndex(record.normalImage, header->imageCount)
+            && IsOptionalIndex(record.occlusionImage, header->imageCount)
+            && IsOptionalIndex(record.emissiveImage, header->imageCount);
+    }
+
+    for (uint32_t i = 0; i < scene->nodeCount && valid; ++i)
+    {
+        const SceneCacheNode& record = nodeRecords[i];
+        SceneNode& node = scene->nodes[i];
+        node.meshIndex = record.meshIndex;
+        node.parentIndex = record.parentIndex;
+        node.translation = record.translation;
+        node.rotation = record.rotation;
+        node.scale = record.scale;
+        node.skinIndex = record.skinIndex;
+        valid = IsOptionalIndex(record.parentIndex, i)
+            && IsOptionalIndex(record.meshIndex, header->meshCount)
+            && IsOptionalIndex(record.skinIndex, header->skinCount)
+            && reader.GetString(record.nameOffset, &node.name);
+    }
+
+    for (uint32_t i = 0; i < scene->skinCount && valid; ++i)
+    {
+        const SceneCacheSkin& record = skinRecords[i];
+        SceneSkin& skin = scene->skins[i];
+        skin.jointCount = record.jointCount;
+        skin.skeletonIndex = record.skeletonIndex;
+
+        valid = reader.GetString(record.nameOffset, &skin.name)
+            && reader.Get(record.jointsOffset, record.jointCount, &skin.joints)
+            && reader.Get(record.inverseBindMatricesOffset, record.jointCount, &skin.inverseBindMatrices)
+            && (record.jointCount == 0 || (skin.joints && skin.inverseBindMatrices))
+            && IsOptionalIndex(record.skeletonIndex, header->nodeCount);
+
+        for (uint32_t joint = 0; joint < skin.jointCount && valid; ++joint)
+        {
+            valid = skin.joints[joint] < scene->nodeCount;
+        }
+    }
+
+    // Vertex joints index the palette of the skin the mesh is drawn with.
+    for (uint32_t i = 0; i < scene->nodeCount && valid; ++i)
+    {
+        const SceneNode& node = scene->nodes[i];
+        if (node.meshIndex < 0 || node.skinIndex < 0)
+            continue;
+
+        const SceneMesh& mesh = scene->meshes[node.meshIndex];
+        const uint32_t jointCount = scene->skins[node.skinIndex].jointCount;
+        for (uint64_t joint = 0; mesh.joints && joint < (uint64_t)mesh.vertexCount * 4 && valid; ++joint)
+        {
+            valid = mesh.joints[joint] < jointCount;
+        }
+    }
+
+    for (uint32_t i = 0; i < scene->animationCount && valid; ++i)
+    {
+        const SceneCacheAnimation& record = animationRecords[i];
+        SceneAnimation& animation = scene->animations[i];
+        animation.duration = record.duration;
+
+        const SceneCacheAnimationChannel* channelRecords = nullptr;
+        valid = reader.GetString(record.nameOffset, &animation.name)
+            && reader.Get(record.channelsOffset, record.channelCount, &channelRecords);
+        if (!valid)
+            break;
+
+        animation.channelCount = record.channelCount;
+        animation.channels = ALIMER_ALLOCN(SceneAnimationChannel, animation.channelCount);
+        for (uint32_t channelIndex = 0; channelIndex < animation.channelCount && valid; ++channelIndex)
+        {
+            const SceneCacheAnimationChannel& channelRecord = channelRecords[channelIndex];
+            SceneAnimationChannel& channel = animation.channels[channelIndex];
+            channel.nodeIndex = channelRecord.nodeIndex;
+            channel.path = (SceneAnimationPath)channelRecord.path;
+            channel.interpolation = (SceneAnimationInterpolation)channelRecord.interpolation;
+            channel.keyCount = channelRecord.keyCount;
+
+            valid = channelRecord.nodeIndex < scene->nodeCount
+                && channelRecord.path < _SceneAnimationPath_Count
+                && channelRecord.interpolation < _SceneAnimationInterpolation_Count
+                && channelRecord.keyCount > 0
+                && reader.Get(channelRecord.timesOffset, channelRecord.keyCount, &channel.times)
+                && reader.Get(channelRecord.valuesOffset, GetChannelValueCount(channel.path, channel.interpolation, channel.keyCount), &channel.values)
+                && channel.times && channel.values;
+        }
+    }
+
+    for (uint32_t i = 0; i < scene->imageCount && valid; ++i)
+    {
+        const SceneCacheImage& record = imageRecords[i];
+        SceneImage& image = scene->images[i];
+
+        const uint8_t* bytes = nullptr;
+        valid = reader.GetString(record.nameOffset, &image.name)
+            && reader.GetString(record.uriOffset, &image.uri)
+            && reader.GetString(record.mimeTypeOffset, &image.mimeType)
+            && reader.Get(record.dataOffset, record.dataSize, &bytes);
+        if (valid && bytes)
+        {
+            image.data = alimerBlobCreateView(bytes, (size_t)record.dataSize, nullptr);
+        }
+    }
+
+    if (!valid)
+    {
+        alimerLogWarn(LogCategory_System, "Scene cache '%s' is corrupted", path);
+        alimerSceneDestroy(scene);
+        return nullptr;
+    }
+
+    if (importOptions && importOptions->decodeImages && scene->imageCount > 0)
+    {
+        const cgltf_options options = GetGltfOptions(importOptions);
+        SceneImageDecoder imageDecoder;
+        imageDecoder.Start(options, scene);
+        imageDecoder.Finish();
+    }
+
+    return scene;
+}
+
+Scene* alimerSceneLoadCached(const char* cachePath, const void* pSourceData, size_t sourceDataSize, const SceneImportOptions* options)
+{
+    ALIMER_ASSERT(cachePath);
+
+    if (!pSourceData || sourceDataSize == 0)
+        return tryLoadSceneCache(cachePath, nullptr, options);
+
+    // External buffers and images are part of the content, editing a .bin or texture invalidates the cache.
+    const uint64_t contentHash = ComputeContentHash(pSourceData, sourceDataSize, options);
+    Scene* scene = tryLoadSceneCache(cachePath, &contentHash, options);
+    if (scene)
+        return scene;
+
+    // Missing or stale cache, rebuild it from the source data, images are decoded once the scene is final.
+    SceneImportOptions importOptions = options ? *options : SceneImportOptions{};
+    const bool decodeImages = importOptions.decodeImages;
+    importOptions.decodeImages = false;
+
+    scene = alimerSceneCreateFromMemoryWithOptions(pSourceData, sourceDataSize, &importOptions);
+    if (!scene)
+        return nullptr;
+    scene->contentHash = contentHash;
+
+    if (alimerSceneSave(scene, cachePath))
     {
-        alimerFree(scene->meshes);
+        // Reload from the mapping so embedded images don't reference the source data.
+        Scene* cachedScene = tryLoadSceneCache(cachePath, &contentHash, options);
+        if (cachedScene)
+        {
+            alimerSceneDestroy(scene);
+            return cachedScene;
+        }
     }
 
-    if (scene->materialCount)
+    alimerLogWarn(LogCategory_System, "Failed to rebuild scene cache '%s'", cachePath);
+
+    for (uint32_t i = 0; i < scene->imageCount; ++i)
     {
-        alimerFree(scene->materials);
+        Blob* view = scene->images[i].data;
+        if (view && !view->ownsData)
+        {
+            void* copy = alimerMalloc(view->size);
+            memcpy(copy, view->data, view->size);
+            scene->images[i].data = alimerBlobCreate(copy, view->size, nullptr);
+            alimerBlobDestroy(view);
+        }
     }
 
-    if (scene->nodeCount)
+    if (decodeImages && scene->imageCount > 0)
     {
-        alimerFree(scene->nodes);
+        importOptions.decodeImages = true;
+        const cgltf_options gltfOptions = GetGltfOptions(&importOptions);
+        SceneImageDecoder imageDecoder;
+        imageDecoder.Start(gltfOptions, scene);
+        imageDecoder.Finish();
     }
 
-    alimerFree(scene);
+    return scene;
 }
@@ -0,0 +1,269 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+#include "alimer_internal.h"
+#include "alimer_math.h"
+#include "alimer_scene.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    /// Levels narrower than this are updated on the calling thread.
+    constexpr uint32_t kParallelLevelThreshold = 4096;
+    constexpr uint32_t kParallelGroupSize = 1024;
+}
+
+struct TransformHierarchy final
+{
+    uint32_t nodeCount = 0;
+    std::vector<int32_t> parents;
+    /// Nodes of level i are in [levelOffsets[i], levelOffsets[i + 1]).
+    std::vector<uint32_t> levelOffsets;
+
+    /* Local transform (SoA) */
+    std::vector<Vector3> translations;
+    std::vector<Vector4> rotations;
+    std::vector<Vector3> scales;
+
+    std::vector<Matrix4x4> localMatrices;
+    std::vector<Matrix4x4> worldMatrices;
+
+    /// Local transform changed since the last update.
+    std::vector<uint8_t> localDirty;
+    /// World matrix was recomputed by the current update, read by the next level.
+    std::vector<uint8_t> worldChanged;
+    std::vector<uint8_t> levelDirty;
+    bool dirty = true;
+
+    jobs::Context jobContext;
+
+    uint32_t GetLevel(uint32_t nodeIndex) const
+    {
+        return (uint32_t)(std::upper_bound(levelOffsets.begin(), levelOffsets.end(), nodeIndex) - levelOffsets.begin()) - 1;
+    }
+
+    void MarkDirty(uint32_t nodeIndex)
+    {
+        localDirty[nodeIndex] = 1;
+        levelDirty[GetLevel(nodeIndex)] = 1;
+        dirty = true;
+    }
+
+    /// Returns true when any world matrix in [begin, end) was recomputed.
+    bool UpdateRange(uint32_t begin, uint32_t end, bool parentLevelChanged)
+    {
+        bool changed = false;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            uint8_t nodeChanged = localDirty[i];
+            if (nodeChanged)
+            {
+                MatrixFromTRS(translations[i], rotations[i], scales[i], localMatrices[i]);
+                localDirty[i] = 0;
+            }
+
+            const int32_t parent = parents[i];
+            if (parent >= 0 && parentLevelChanged)
+            {
+                nodeChanged |= worldChanged[parent];
+            }
+
+            if (nodeChanged)
+            {
+                if (parent >= 0)
+                {
+                    MatrixMultiply(localMatrices[i], worldMatrices[parent], worldMatrices[i]);
+                }
+                else
+                {
+                    worldMatrices[i] = localMatrices[i];
+                }
+            }
+
+            worldChanged[i] = nodeChanged;
+            changed |= nodeChanged != 0;
+        }
+
+        return changed;
+    }
+};
+
+static TransformHierarchy* CreateHierarchy(uint32_t nodeCount, const int32_t* parentIndices)
+{
+    // Validate the breadth-first order and find the level boundaries.
+    std::vector<uint32_t> depths(nodeCount);
+    std::vector<uint32_t> levelOffsets;
+    for (uint32_t i = 0; i < nodeCount; ++i)
+    {
+        const int32_t parent = parentIndices[i];
+        if (parent >= (int32_t)i || parent < -1)
+        {
+            alimerLogError(LogCategory_System, "TransformHierarchy: node %u must come after its parent %d", i, parent);
+            return nullptr;
+        }
+
+        depths[i] = parent < 0 ? 0 : depths[parent] + 1;
+        if (i > 0 && depths[i] < depths[i - 1])
+        {
+            alimerLogError(LogCategory_System, "TransformHierarchy: nodes are not sorted breadth-first (node %u)", i);
+            return nullptr;
+        }
+
+        if (i == 0 || depths[i] != depths[i - 1])
+        {
+            levelOffsets.push_back(i);
+        }
+    }
+    levelOffsets.push_back(nodeCount);
+
+    TransformHierarchy* hierarchy = new TransformHierarchy();
+    hierarchy->nodeCount = nodeCount;
+    hierarchy->parents.assign(parentIndices, parentIndices + nodeCount);
+    hierarchy->levelOffsets = std::move(levelOffsets);
+    hierarchy->translations.assign(nodeCount, Vector3{ 0.0f, 0.0f, 0.0f });
+    hierarchy->rotations.assign(nodeCount, Vector4{ 0.0f, 0.0f, 0.0f, 1.0f });
+    hierarchy->scales.assign(nodeCount, Vector3{ 1.0f, 1.0f, 1.0f });
+    hierarchy->localMatrices.assign(nodeCount, MatrixIdentity());
+    hierarchy->worldMatrices.assign(nodeCount, MatrixIdentity());
+    hierarchy->localDirty.assign(nodeCount, 1);
+    hierarchy->worldChanged.assign(nodeCount, 0);
+    hierarchy->levelDirty.assign(hierarchy->levelOffsets.size() - 1, 1);
+    return hierarchy;
+}
+
+TransformHierarchy* alimerTransformHierarchyCreate(uint32_t nodeCount, const int32_t* parentIndices)
+{
+    ALIMER_ASSERT(parentIndices || nodeCount == 0);
+
+    return CreateHierarchy(nodeCount, parentIndices);
+}
+
+TransformHierarchy* alimerTransformHierarchyCreateFromScene(const Scene* scene)
+{
+    ALIMER_ASSERT(scene);
+
+    std::vector<int32_t> parentIndices(scene->nodeCount);
+    for (uint32_t i = 0; i < scene->nodeCount; ++i)
+    {
+        parentIndices[i] = scene->nodes[i].parentIndex;
+    }
+
+    TransformHierarchy* hierarchy = CreateHierarchy(scene->nodeCount, parentIndices.data());
+    if (!hierarchy)
+        return nullptr;
+
+    for (uint32_t i = 0; i < scene->nodeCount; ++i)
+    {
+        hierarchy->translations[i] = scene->nodes[i].translation;
+        hierarchy->rotations[i] = scene->nodes[i].rotation;
+        hierarchy->scales[i] = scene->nodes[i].scale;
+    }
+
+    return hierarchy;
+}
+
+void alimerTransformHierarchyDestroy(TransformHierarchy* hierarchy)
+{
+    if (!hierarchy)
+        return;
+
+    jobs::Wait(hierarchy->jobContext);
+    delete hierarchy;
+}
+
+uint32_t alimerTransformHierarchyGetNodeCount(const TransformHierarchy* hierarchy)
+{
+    return hierarchy->nodeCount;
+}
+
+void alimerTransformHierarchySetLocal(TransformHierarchy* hierarchy, uint32_t nodeIndex, const Vector3* translation, const Vector4* rotation, const Vector3* scale)
+{
+    ALIMER_ASSERT(nodeIndex < hierarchy->nodeCount);
+
+    if (translation)
+        hierarchy->translations[nodeIndex] = *translation;
+    if (rotation)
+        hierarchy->rotations[nodeIndex] = *rotation;
+    if (scale)
+        hierarchy->scales[nodeIndex] = *scale;
+
+    hierarchy->MarkDirty(nodeIndex);
+}
+
+void alimerTransformHierarchyGetLocal(const TransformHierarchy* hierarchy, uint32_t nodeIndex, Vector3* translation, Vector4* rotation, Vector3* scale)
+{
+    ALIMER_ASSERT(nodeIndex < hierarchy->nodeCount);
+
+    if (translation)
+        *translation = hierarchy->translations[nodeIndex];
+    if (rotation)
+        *rotation = hierarchy->rotations[nodeIndex];
+    if (scale)
+        *scale = hierarchy->scales[nodeIndex];
+}
+
+void alimerTransformHierarchySetLocalBatch(TransformHierarchy* hierarchy, uint32_t count, const uint32_t* nodeIndices, const Vector3* translations, const Vector4* rotations, const Vector3* scales)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t nodeIndex = nodeIndices[i];
+        ALIMER_ASSERT(nodeIndex < hierarchy->nodeCount);
+
+        if (translations)
+            hierarchy->translations[nodeIndex] = translations[i];
+        if (rotations)
+            hierarchy->rotations[nodeIndex] = rotations[i];
+        if (scales)
+            hierarchy->scales[nodeIndex] = scales[i];
+
+        hierarchy->MarkDirty(nodeIndex);
+    }
+}
+
+void alimerTransformHierarchyUpdate(TransformHierarchy* hierarchy)
+{
+    if (!hierarchy->dirty)
+        return;
+
+    const bool parallel = jobs::GetThreadCount() > 1;
+    const uint32_t levelCount = (uint32_t)hierarchy->levelDirty.size();
+
+    bool previousLevelChanged = false;
+    for (uint32_t level = 0; level < levelCount; ++level)
+    {
+        // Levels without local changes below an unchanged level are skipped entirely.
+        if (!hierarchy->levelDirty[level] && !previousLevelChanged)
+            continue;
+
+        const uint32_t begin = hierarchy->levelOffsets[level];
+        const uint32_t end = hierarchy->levelOffsets[level + 1];
+        const bool parentLevelChanged = previousLevelChanged;
+
+        if (parallel && end - begin >= kParallelLevelThreshold)
+        {
+            std::atomic<bool> levelChanged{ false };
+            jobs::Dispatch(hierarchy->jobContext, end - begin, kParallelGroupSize,
+                [hierarchy, begin, parentLevelChanged, &levelChanged](uint32_t groupBegin, uint32_t groupEnd)
+                {
+                    if (hierarchy->UpdateRange(begin + groupBegin, begin + groupEnd, parentLevelChanged))
+                        levelChanged.store(true, std::memory_order_relaxed);
+                });
+            jobs::Wait(hierarchy->jobContext);
+            previousLevelChanged = levelChanged.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            previousLevelChanged = hierarchy->UpdateRange(begin, end, parentLevelChanged);
+        }
+
+        hierarchy->levelDirty[level] = 0;
+    }
+
+    hierarchy->dirty = false;
+}
+
+const Matrix4x4* alimerTransformHierarchyGetWorldMatrices(const TransformHierarchy* hierarchy)
+{
+    return hierarchy->worldMatrices.data();
+}
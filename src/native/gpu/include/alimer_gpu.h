@@ -55,6 +55,7 @@ typedef struct GPUCommandQueueImpl*         GPUCommandQueue;
 typedef struct GPUCommandBufferImpl*        GPUCommandBuffer;
 typedef struct GPUComputePassEncoderImpl*   GPUComputePassEncoder;
 typedef struct GPURenderPassEncoderImpl*    GPURenderPassEncoder;
+typedef struct GPUCopyPassEncoderImpl*      GPUCopyPassEncoder;
 typedef struct GPUBufferImpl*               GPUBuffer;
 typedef struct GPUTextureImpl*              GPUTexture;
 typedef struct GPUSamplerImpl*              GPUSampler;
@@ -69,12 +70,15 @@ typedef struct GPURenderPipelineImpl*       GPURenderPipeline;
 /* Types */
 typedef uint32_t GPUBool;
 typedef uint64_t GPUDeviceAddress;
+/// Identifies a batch of queued uploads, 0 is always complete.
+typedef uint64_t GPUUploadTicket;
 typedef int32_t GPUBindlessIndex;
 
 /* Constants */
 #define GPU_MAX_ADAPTER_NAME_SIZE  (256u)
 #define GPU_MAX_COLOR_ATTACHMENTS (8u)
 #define GPU_MAX_VERTEX_BUFFER_BINDINGS (8u)
+#define GPU_MAX_BIND_GROUPS (4u)
 #define GPU_WHOLE_SIZE (UINT64_MAX)
 #define GPU_LOD_CLAMP_NONE (1000.0F)
 #define GPU_INVALID_BINDLESS_INDEX (-1)
@@ -104,6 +108,45 @@ typedef enum GPUMemoryType {
     _GPUMemoryType_Force32 = 0x7FFFFFFF
 } GPUMemoryType;
 
+typedef enum GPUMapMode {
+    /// Map readback memory for CPU reads
+    GPUMapMode_Read = 0,
+    /// Map upload memory for CPU writes
+    GPUMapMode_Write = 1,
+
+    _GPUMapMode_Count,
+    _GPUMapMode_Force32 = 0x7FFFFFFF
+} GPUMapMode;
+
+typedef enum GPUMapAsyncStatus {
+    GPUMapAsyncStatus_Success = 0,
+    GPUMapAsyncStatus_Error = 1,
+    /// Buffer was unmapped or the device was destroyed before the request resolved
+    GPUMapAsyncStatus_Aborted = 2,
+
+    _GPUMapAsyncStatus_Count,
+    _GPUMapAsyncStatus_Force32 = 0x7FFFFFFF
+} GPUMapAsyncStatus;
+
+typedef enum GPUBufferMapState {
+    GPUBufferMapState_Unmapped = 0,
+    GPUBufferMapState_Pending = 1,
+    GPUBufferMapState_Mapped = 2,
+
+    _GPUBufferMapState_Count,
+    _GPUBufferMapState_Force32 = 0x7FFFFFFF
+} GPUBufferMapState;
+
+typedef enum GPUPipelineStatus {
+    GPUPipelineStatus_Ready = 0,
+    /// Still compiling on a background thread, binding it uses the fallback pipeline (or waits when there is none)
+    GPUPipelineStatus_Pending = 1,
+    GPUPipelineStatus_Error = 2,
+
+    _GPUPipelineStatus_Count,
+    _GPUPipelineStatus_Force32 = 0x7FFFFFFF
+} GPUPipelineStatus;
+
 typedef enum GPUTextureAspect {
     GPUTextureAspect_All = 0,
     GPUTextureAspect_DepthOnly = 1,
@@ -483,6 +526,25 @@ typedef enum GPUShaderStage {
     _GPUShaderStage_Force32 = 0x7FFFFFFF
 } GPUShaderStage;
 
+typedef enum GPUBindingType {
+    GPUBindingType_Undefined = 0,
+    /// Constant buffer (HLSL register b)
+    GPUBindingType_ConstantBuffer,
+    /// Read-only structured or byte address buffer (HLSL register t)
+    GPUBindingType_ReadOnlyStorageBuffer,
+    /// Read-write structured or byte address buffer (HLSL register u)
+    GPUBindingType_StorageBuffer,
+    /// Sampled texture (HLSL register t)
+    GPUBindingType_SampledTexture,
+    /// Read-write texture (HLSL register u)
+    GPUBindingType_StorageTexture,
+    /// Sampler (HLSL register s)
+    GPUBindingType_Sampler,
+
+    _GPUBindingType_Count,
+    _GPUBindingType_Force32 = 0x7FFFFFFF
+} GPUBindingType;
+
 typedef enum GPUVertexStepMode {
     GPUVertexStepMode_Vertex = 0,
     GPUVertexStepMode_Instance = 1,
@@ -709,6 +771,7 @@ typedef enum GPUFeature {
     GPUFeature_Predication,
     GPUFeature_DepthResolveMinMax,
     GPUFeature_StencilResolveMinMax,
+    GPUFeature_Bindless,
 
     _GPUFeature_Force32 = 0x7FFFFFFF
 } GPUFeature;
@@ -786,6 +849,18 @@ typedef struct GPUColor {
     float a;
 } GPUColor;
 
+typedef struct GPUOrigin3D {
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+} GPUOrigin3D;
+
+typedef struct GPUExtent3D {
+    uint32_t width;
+    uint32_t height;
+    uint32_t depthOrArrayLayers;
+} GPUExtent3D;
+
 typedef struct GPUCommandBufferDesc {
     const char* label;
 } GPUCommandBufferDesc;
@@ -829,17 +904,49 @@ typedef struct GPUSamplerDesc {
     float                   lodMaxClamp DEFAULT_INITIALIZER(GPU_LOD_CLAMP_NONE);
 } GPUSamplerDesc;
 
+typedef struct GPUBindGroupLayoutEntry {
+    /// Register index inside the register class of the binding type
+    uint32_t binding DEFAULT_INITIALIZER(0);
+    GPUBindingType type DEFAULT_INITIALIZER(GPUBindingType_Undefined);
+    /// Array size, 0 is treated as 1
+    uint32_t count DEFAULT_INITIALIZER(1);
+} GPUBindGroupLayoutEntry;
+
 typedef struct GPUBindGroupLayoutDesc {
     const char* label DEFAULT_INITIALIZER(nullptr);
+    uint32_t entryCount DEFAULT_INITIALIZER(0);
+    const GPUBindGroupLayoutEntry* entries DEFAULT_INITIALIZER(nullptr);
 } GPUBindGroupLayoutDesc;
 
+typedef struct GPUBindGroupEntry {
+    /// Binding and type identify the layout entry being written
+    uint32_t binding DEFAULT_INITIALIZER(0);
+    GPUBindingType type DEFAULT_INITIALIZER(GPUBindingType_Undefined);
+    uint32_t arrayElement DEFAULT_INITIALIZER(0);
+    GPUBuffer buffer DEFAULT_INITIALIZER(nullptr);
+    uint64_t offset DEFAULT_INITIALIZER(0);
+    uint64_t size DEFAULT_INITIALIZER(GPU_WHOLE_SIZE);
+    GPUTexture texture DEFAULT_INITIALIZER(nullptr);
+    GPUSampler sampler DEFAULT_INITIALIZER(nullptr);
+} GPUBindGroupEntry;
+
+typedef struct GPUBindGroupDesc {
+    const char* label DEFAULT_INITIALIZER(nullptr);
+    GPUBindGroupLayout layout DEFAULT_INITIALIZER(nullptr);
+    uint32_t entryCount DEFAULT_INITIALIZER(0);
+    const GPUBindGroupEntry* entries DEFAULT_INITIALIZER(nullptr);
+} GPUBindGroupDesc;
+
 typedef struct GPUPushConstantRange {
     uint32_t binding;
     uint32_t size;
 } GPUPushConstantRange;
 
+/// With GPUFeature_Bindless, layouts using at most one bind group get the bindless heaps at sets 1-4 (see AlimerBindless.hlsli)
 typedef struct GPUPipelineLayoutDesc {
     const char* label DEFAULT_INITIALIZER(nullptr);
+    uint32_t bindGroupLayoutCount DEFAULT_INITIALIZER(0);
+    const GPUBindGroupLayout* bindGroupLayouts DEFAULT_INITIALIZER(nullptr);
     uint32_t pushConstantRangeCount DEFAULT_INITIALIZER(0);
     const GPUPushConstantRange* pushConstantRanges DEFAULT_INITIALIZER(nullptr);
 } GPUPipelineLayoutDesc;
@@ -951,6 +1058,27 @@ typedef struct GPUComputePassDesc {
     const char* label;
 } GPUComputePassDesc;
 
+typedef struct GPUCopyPassDesc {
+    const char* label;
+} GPUCopyPassDesc;
+
+typedef struct GPUTexelCopyBufferInfo {
+    GPUBuffer buffer;
+    uint64_t offset;
+    /// Row pitch in bytes, 0 for tightly packed rows.
+    uint32_t bytesPerRow;
+    /// Rows per image slice, 0 for tightly packed slices.
+    uint32_t rowsPerImage;
+} GPUTexelCopyBufferInfo;
+
+typedef struct GPUTexelCopyTextureInfo {
+    GPUTexture texture;
+    uint32_t mipLevel;
+    /// z is the array layer for array textures and the depth slice for 3D textures.
+    GPUOrigin3D origin;
+    GPUTextureAspect aspect;
+} GPUTexelCopyTextureInfo;
+
 typedef struct GPURenderPassColorAttachment {
     GPUTexture      texture DEFAULT_INITIALIZER(nullptr);
     uint32_t        mipLevel DEFAULT_INITIALIZER(0);
@@ -983,6 +1111,11 @@ typedef struct GPURenderPassDesc {
 typedef struct GPUDeviceDesc {
     const char* label DEFAULT_INITIALIZER(nullptr);
     uint32_t maxFramesInFlight DEFAULT_INITIALIZER(2);
+    /// Pipeline cache from agpuDeviceGetPipelineCacheData, ignored when produced by a different device or driver
+    const void* pipelineCacheData DEFAULT_INITIALIZER(nullptr);
+    size_t pipelineCacheDataSize DEFAULT_INITIALIZER(0);
+    /// Pipeline cache file, loaded when pipelineCacheData is not provided and saved when the device is destroyed
+    const char* pipelineCachePath DEFAULT_INITIALIZER(nullptr);
 } GPUDeviceDesc;
 
 typedef struct GPUAdapterInfo {
@@ -1089,6 +1222,7 @@ typedef struct GPUDrawIndirectCommand {
 } GPUDrawIndirectCommand;
 
 typedef void (*GPULogCallback)(GPULogLevel level, const char* message, void* userData);
+typedef void (*GPUBufferMapCallback)(GPUMapAsyncStatus status, void* userData);
 ALIMER_GPU_API GPULogLevel agpuGetLogLevel(void);
 ALIMER_GPU_API void agpuSetLogLevel(GPULogLevel level);
 ALIMER_GPU_API void agpuSetLogCallback(GPULogCallback func, void* userData);
@@ -1130,9 +1264,19 @@ ALIMER_GPU_API bool agpuDeviceHasFeature(GPUDevice device, GPUFeature feature);
 ALIMER_GPU_API GPUCommandQueue agpuDeviceGetCommandQueue(GPUDevice device, GPUCommandQueueType type);
 ALIMER_GPU_API void agpuDeviceWaitIdle(GPUDevice device);
 ALIMER_GPU_API uint64_t agpuDeviceGetTimestampFrequency(GPUDevice device);
+/// Serialize the pipeline cache, returns the required size when data is null otherwise the number of bytes written
+ALIMER_GPU_API size_t agpuDeviceGetPipelineCacheData(GPUDevice device, void* data, size_t dataSize);
 
 /// Commit the current frame and advance to next frame
 ALIMER_GPU_API uint64_t agpuDeviceCommitFrame(GPUDevice device);
+/// Resolve buffer map requests whose submissions completed, callbacks run on the calling thread (also done by CommitFrame)
+ALIMER_GPU_API void agpuDeviceProcessEvents(GPUDevice device);
+
+/* Device uploads */
+/// Submit pending queue writes and return the ticket of the last submitted upload batch
+ALIMER_GPU_API GPUUploadTicket agpuDeviceFlushUploads(GPUDevice device);
+ALIMER_GPU_API bool agpuDeviceIsUploadComplete(GPUDevice device, GPUUploadTicket ticket);
+ALIMER_GPU_API void agpuDeviceWaitUpload(GPUDevice device, GPUUploadTicket ticket);
 
 /* Device resource creation methods */
 ALIMER_GPU_API GPUBuffer agpuDeviceCreateBuffer(GPUDevice device, const GPUBufferDesc* desc, const void* pInitialData);
@@ -1144,6 +1288,12 @@ ALIMER_GPU_API GPUCommandQueueType agpuCommandQueueGetType(GPUCommandQueue queue
 ALIMER_GPU_API void agpuCommandQueueWaitIdle(GPUCommandQueue queue);
 ALIMER_GPU_API GPUCommandBuffer agpuCommandQueueAcquireCommandBuffer(GPUCommandQueue queue, const GPUCommandBufferDesc* desc);
 ALIMER_GPU_API void agpuCommandQueueSubmit(GPUCommandQueue queue, uint32_t numCommandBuffers, GPUCommandBuffer* commandBuffers);
+/// Stage data into the device upload batch, visible to later submissions on the queue or after waiting on the returned ticket.
+/// The copy waits for work already submitted on this queue. Destinations last used on another queue must be synchronized by the caller,
+/// and must not be used by command buffers still being recorded.
+/// D3D12 writes upload memory buffers immediately, the GPU must not be reading the range; other memory types and Vulkan always stage.
+ALIMER_GPU_API GPUUploadTicket agpuCommandQueueWriteBuffer(GPUCommandQueue queue, GPUBuffer buffer, uint64_t bufferOffset, const void* data, uint64_t size);
+ALIMER_GPU_API GPUUploadTicket agpuCommandQueueWriteTexture(GPUCommandQueue queue, GPUTexture texture, uint32_t mipLevel, uint32_t arrayLayer, const GPUTextureData* data);
 
 /* CommandBuffer */
 ALIMER_GPU_API void agpuCommandBufferPushDebugGroup(GPUCommandBuffer commandBuffer, const char* groupLabel);
@@ -1152,10 +1302,14 @@ ALIMER_GPU_API void agpuCommandBufferInsertDebugMarker(GPUCommandBuffer commandB
 ALIMER_GPU_API GPUAcquireSurfaceResult agpuCommandBufferAcquireSurfaceTexture(GPUCommandBuffer commandBuffer, GPUSurface surface, GPUTexture* surfaceTexture);
 ALIMER_GPU_API GPUComputePassEncoder agpuCommandBufferBeginComputePass(GPUCommandBuffer commandBuffer, const GPUComputePassDesc* desc);
 ALIMER_GPU_API GPURenderPassEncoder agpuCommandBufferBeginRenderPass(GPUCommandBuffer commandBuffer, const GPURenderPassDesc* desc);
+ALIMER_GPU_API GPUCopyPassEncoder agpuCommandBufferBeginCopyPass(GPUCommandBuffer commandBuffer, const GPUCopyPassDesc* desc);
+/// GPU side wait for an upload ticket before executing the command buffer
+ALIMER_GPU_API void agpuCommandBufferWaitUpload(GPUCommandBuffer commandBuffer, GPUUploadTicket ticket);
 
 /* ComputePassEncoder */
 ALIMER_GPU_API void agpuComputePassEncoderSetPipeline(GPUComputePassEncoder computePassEncoder, GPUComputePipeline pipeline);
 ALIMER_GPU_API void agpuComputePassEncoderSetPushConstants(GPUComputePassEncoder computePassEncoder, uint32_t pushConstantIndex, const void* data, uint32_t size);
+ALIMER_GPU_API void agpuComputePassEncoderSetBindGroup(GPUComputePassEncoder computePassEncoder, uint32_t groupIndex, GPUBindGroup bindGroup);
 ALIMER_GPU_API void agpuComputePassEncoderDispatch(GPUComputePassEncoder computePassEncoder, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
 ALIMER_GPU_API void agpuComputePassEncoderDispatchIndirect(GPUComputePassEncoder computePassEncoder, GPUBuffer indirectBuffer, uint64_t indirectBufferOffset);
 ALIMER_GPU_API void agpuComputePassEncoderEnd(GPUComputePassEncoder computePassEncoder);
@@ -1174,6 +1328,7 @@ ALIMER_GPU_API void agpuRenderPassEncoderSetVertexBuffer(GPURenderPassEncoder re
 ALIMER_GPU_API void agpuRenderPassEncoderSetIndexBuffer(GPURenderPassEncoder renderPassEncoder, GPUBuffer buffer, GPUIndexType type, uint64_t offset);
 ALIMER_GPU_API void agpuRenderPassEncoderSetPipeline(GPURenderPassEncoder renderPassEncoder, GPURenderPipeline pipeline);
 ALIMER_GPU_API void agpuRenderPassEncoderSetPushConstants(GPURenderPassEncoder renderPassEncoder, uint32_t pushConstantIndex, const void* data, uint32_t size);
+ALIMER_GPU_API void agpuRenderPassEncoderSetBindGroup(GPURenderPassEncoder renderPassEncoder, uint32_t groupIndex, GPUBindGroup bindGroup);
 ALIMER_GPU_API void agpuRenderPassEncoderDraw(GPURenderPassEncoder renderPassEncoder, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
 ALIMER_GPU_API void agpuRenderPassEncoderDrawIndexed(GPURenderPassEncoder renderPassEncoder, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance);
 ALIMER_GPU_API void agpuRenderPassEncoderDrawIndirect(GPURenderPassEncoder renderPassEncoder, GPUBuffer indirectBuffer, uint64_t indirectBufferOffset);
@@ -1186,12 +1341,33 @@ ALIMER_GPU_API void agpuRenderPassEncoderPushDebugGroup(GPURenderPassEncoder ren
 ALIMER_GPU_API void agpuRenderPassEncoderPopDebugGroup(GPURenderPassEncoder renderPassEncoder);
 ALIMER_GPU_API void agpuRenderPassEncoderInsertDebugMarker(GPURenderPassEncoder renderPassEncoder, const char* markerLabel);
 
+/* CopyPassEncoder */
+ALIMER_GPU_API void agpuCopyPassEncoderCopyBufferToBuffer(GPUCopyPassEncoder copyPassEncoder, GPUBuffer source, uint64_t sourceOffset, GPUBuffer destination, uint64_t destinationOffset, uint64_t size);
+ALIMER_GPU_API void agpuCopyPassEncoderCopyBufferToTexture(GPUCopyPassEncoder copyPassEncoder, const GPUTexelCopyBufferInfo* source, const GPUTexelCopyTextureInfo* destination, const GPUExtent3D* copySize);
+ALIMER_GPU_API void agpuCopyPassEncoderCopyTextureToBuffer(GPUCopyPassEncoder copyPassEncoder, const GPUTexelCopyTextureInfo* source, const GPUTexelCopyBufferInfo* destination, const GPUExtent3D* copySize);
+ALIMER_GPU_API void agpuCopyPassEncoderCopyTextureToTexture(GPUCopyPassEncoder copyPassEncoder, const GPUTexelCopyTextureInfo* source, const GPUTexelCopyTextureInfo* destination, const GPUExtent3D* copySize);
+/// Fill the buffer range with a repeated 32-bit value, offset and size must be multiple of 4 (size can be GPU_WHOLE_SIZE)
+ALIMER_GPU_API void agpuCopyPassEncoderFillBuffer(GPUCopyPassEncoder copyPassEncoder, GPUBuffer buffer, uint64_t offset, uint64_t size, uint32_t value);
+ALIMER_GPU_API void agpuCopyPassEncoderClearBuffer(GPUCopyPassEncoder copyPassEncoder, GPUBuffer buffer, uint64_t offset, uint64_t size);
+ALIMER_GPU_API void agpuCopyPassEncoderEnd(GPUCopyPassEncoder copyPassEncoder);
+ALIMER_GPU_API void agpuCopyPassEncoderPushDebugGroup(GPUCopyPassEncoder copyPassEncoder, const char* groupLabel);
+ALIMER_GPU_API void agpuCopyPassEncoderPopDebugGroup(GPUCopyPassEncoder copyPassEncoder);
+ALIMER_GPU_API void agpuCopyPassEncoderInsertDebugMarker(GPUCopyPassEncoder copyPassEncoder, const char* markerLabel);
+
 /* Buffer */
 ALIMER_GPU_API void agpuBufferSetLabel(GPUBuffer buffer, const char* label);
 ALIMER_GPU_API uint32_t agpuBufferAddRef(GPUBuffer buffer);
 ALIMER_GPU_API uint32_t agpuBufferRelease(GPUBuffer buffer);
 ALIMER_GPU_API uint64_t agpuBufferGetSize(GPUBuffer buffer);
 ALIMER_GPU_API GPUDeviceAddress agpuBufferGetDeviceAddress(GPUBuffer buffer);
+/// Index into the bindless storage buffer heap, GPU_INVALID_BINDLESS_INDEX unless created with ShaderRead or ShaderWrite usage
+ALIMER_GPU_API GPUBindlessIndex agpuBufferGetBindlessIndex(GPUBuffer buffer);
+/// Map a Readback (read) or Upload (write) buffer once all work submitted before this call completed, offset must be multiple of 8 and size multiple of 4 (size can be GPU_WHOLE_SIZE)
+ALIMER_GPU_API void agpuBufferMapAsync(GPUBuffer buffer, GPUMapMode mode, uint64_t offset, uint64_t size, GPUBufferMapCallback callback, void* userData);
+ALIMER_GPU_API GPUBufferMapState agpuBufferGetMapState(GPUBuffer buffer);
+ALIMER_GPU_API void* agpuBufferGetMappedRange(GPUBuffer buffer, uint64_t offset, uint64_t size);
+ALIMER_GPU_API const void* agpuBufferGetConstMappedRange(GPUBuffer buffer, uint64_t offset, uint64_t size);
+ALIMER_GPU_API void agpuBufferUnmap(GPUBuffer buffer);
 
 /* Texture */
 ALIMER_GPU_API void agpuTextureSetLabel(GPUTexture texture, const char* label);
@@ -1205,6 +1381,10 @@ ALIMER_GPU_API uint32_t agpuTextureGetMipLevelCount(GPUTexture texture);
 ALIMER_GPU_API uint32_t agpuTextureGetSampleCount(GPUTexture texture);
 ALIMER_GPU_API uint32_t agpuTextureGetLevelWidth(GPUTexture texture, uint32_t mipLevel);
 ALIMER_GPU_API uint32_t agpuTextureGetLevelHeight(GPUTexture texture, uint32_t mipLevel);
+/// Index into the bindless sampled texture heap, GPU_INVALID_BINDLESS_INDEX unless created with ShaderRead usage
+ALIMER_GPU_API GPUBindlessIndex agpuTextureGetBindlessIndex(GPUTexture texture);
+/// Index of mip level 0 into the bindless storage texture heap, GPU_INVALID_BINDLESS_INDEX unless created with ShaderWrite usage
+ALIMER_GPU_API GPUBindlessIndex agpuTextureGetBindlessStorageIndex(GPUTexture texture);
 ALIMER_GPU_API uint32_t agpuTextureAddRef(GPUTexture texture);
 ALIMER_GPU_API uint32_t agpuTextureRelease(GPUTexture texture);
 
@@ -1212,6 +1392,20 @@ ALIMER_GPU_API uint32_t agpuTextureRelease(GPUTexture texture);
 ALIMER_GPU_API void agpuSamplerSetLabel(GPUSampler sampler, const char* label);
 ALIMER_GPU_API uint32_t agpuSamplerAddRef(GPUSampler sampler);
 ALIMER_GPU_API uint32_t agpuSamplerRelease(GPUSampler sampler);
+ALIMER_GPU_API GPUBindlessIndex agpuSamplerGetBindlessIndex(GPUSampler sampler);
+
+/* BindGroupLayout */
+/// Identical layouts are deduplicated, the same handle (with an added reference) can be returned
+ALIMER_GPU_API GPUBindGroupLayout agpuCreateBindGroupLayout(GPUDevice device, const GPUBindGroupLayoutDesc* desc);
+ALIMER_GPU_API void agpuBindGroupLayoutSetLabel(GPUBindGroupLayout bindGroupLayout, const char* label);
+ALIMER_GPU_API uint32_t agpuBindGroupLayoutAddRef(GPUBindGroupLayout bindGroupLayout);
+ALIMER_GPU_API uint32_t agpuBindGroupLayoutRelease(GPUBindGroupLayout bindGroupLayout);
+
+/* BindGroup */
+ALIMER_GPU_API GPUBindGroup agpuCreateBindGroup(GPUDevice device, const GPUBindGroupDesc* desc);
+ALIMER_GPU_API void agpuBindGroupSetLabel(GPUBindGroup bindGroup, const char* label);
+ALIMER_GPU_API uint32_t agpuBindGroupAddRef(GPUBindGroup bindGroup);
+ALIMER_GPU_API uint32_t agpuBindGroupRelease(GPUBindGroup bindGroup);
 
 /* PipelineLayout */
 ALIMER_GPU_API GPUPipelineLayout agpuCreatePipelineLayout(GPUDevice device, const GPUPipelineLayoutDesc* desc);
@@ -1227,12 +1421,18 @@ ALIMER_GPU_API uint32_t agpuShaderModuleRelease(GPUShaderModule shaderModule);
 
 /* ComputePipeline */
 ALIMER_GPU_API GPUComputePipeline agpuCreateComputePipeline(GPUDevice device, const GPUComputePipelineDesc* desc);
+/// Returns immediately and compiles the pipeline on a background thread, fallback (optional) is bound in its place until it is ready.
+ALIMER_GPU_API GPUComputePipeline agpuCreateComputePipelineAsync(GPUDevice device, const GPUComputePipelineDesc* desc, GPUComputePipeline fallback);
+ALIMER_GPU_API GPUPipelineStatus agpuComputePipelineGetStatus(GPUComputePipeline computePipeline);
 ALIMER_GPU_API void agpuComputePipelineSetLabel(GPUComputePipeline computePipeline, const char* label);
 ALIMER_GPU_API uint32_t agpuComputePipelineAddRef(GPUComputePipeline computePipeline);
 ALIMER_GPU_API uint32_t agpuComputePipelineRelease(GPUComputePipeline computePipeline);
 
 /* RenderPipeline */
 ALIMER_GPU_API GPURenderPipeline agpuCreateRenderPipeline(GPUDevice device, const GPURenderPipelineDesc* desc);
+/// Returns immediately and compiles the pipeline on a background thread, fallback (optional) is bound in its place until it is ready.
+ALIMER_GPU_API GPURenderPipeline agpuCreateRenderPipelineAsync(GPUDevice device, const GPURenderPipelineDesc* desc, GPURenderPipeline fallback);
+ALIMER_GPU_API GPUPipelineStatus agpuRenderPipelineGetStatus(GPURenderPipeline renderPipeline);
 ALIMER_GPU_API void agpuRenderPipelineSetLabel(GPURenderPipeline renderPipeline, const char* label);
 ALIMER_GPU_API uint32_t agpuRenderPipelineAddRef(GPURenderPipeline renderPipeline);
 ALIMER_GPU_API uint32_t agpuRenderPipelineRelease(GPURenderPipeline renderPipeline);
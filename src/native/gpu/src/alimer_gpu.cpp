@@ -512,6 +512,97 @@ uint32_t agpuSurfaceRelease(GPUSurface surface)
     return surface->Release();
 }
 
+/* ObjectCache */
+GPUCachedResource::~GPUCachedResource()
+{
+    if (cache != nullptr)
+    {
+        cache->Remove(this);
+    }
+}
+
+GPUCachedResource* GPUObjectCache::Find(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = objects.find(key);
+
+    // An object whose last reference is being released is treated as missing, its destructor removes it
+    if (it != objects.end() && it->second->TryAddRef())
+        return it->second;
+
+    return nullptr;
+}
+
+GPUCachedResource* GPUObjectCache::Insert(std::string&& key, GPUCachedResource* object)
+{
+    GPUCachedResource* existing = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = objects.find(key);
+        if (it == objects.end() || !it->second->TryAddRef())
+        {
+            object->cache = this;
+            object->cacheKey = key;
+            objects[std::move(key)] = object;
+            return object;
+        }
+
+        existing = it->second;
+    }
+
+    object->Release();
+    return existing;
+}
+
+void GPUObjectCache::Remove(GPUCachedResource* object)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = objects.find(object->cacheKey);
+    if (it != objects.end() && it->second == object)
+    {
+        objects.erase(it);
+    }
+}
+
+/// Cache keys are the raw bytes of the descriptor content, labels excluded. Structs are only appended whole when they have no padding.
+template<typename T>
+static void AppendCacheKey(std::string& key, const T& value)
+{
+    key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void AppendCacheKey(std::string& key, const std::string& value)
+{
+    AppendCacheKey(key, value.size());
+    key.append(value);
+}
+
+static void AppendObjectCacheKey(std::string& key, const GPUCachedResource* object)
+{
+    AppendCacheKey(key, object != nullptr ? object->cacheKey : std::string());
+}
+
+/// Async pipelines are cached apart from the sync ones under a key naming their fallback:
+/// a sync create never returns a pending pipeline and an async hit always uses the caller fallback.
+static void AppendAsyncPipelineCacheKey(std::string& key, const GPUCachedResource* fallback)
+{
+    AppendCacheKey(key, std::string("async"));
+    AppendObjectCacheKey(key, fallback);
+}
+
+template<typename T, typename CreateFunc>
+static T GetOrCreateCached(GPUDevice device, std::string&& key, CreateFunc&& create)
+{
+    if (GPUCachedResource* cached = device->objectCache.Find(key))
+        return static_cast<T>(cached);
+
+    T object = create();
+    if (object == nullptr)
+        return nullptr;
+
+    return static_cast<T>(device->objectCache.Insert(std::move(key), object));
+}
+
 /* Device */
 void agpuDeviceSetLabel(GPUDevice device, const char* label)
 {
@@ -556,11 +647,42 @@ uint64_t agpuDeviceGetTimestampFrequency(GPUDevice device)
     return device->GetTimestampFrequency();
 }
 
+size_t agpuDeviceGetPipelineCacheData(GPUDevice device, void* data, size_t dataSize)
+{
+    return device->GetPipelineCacheData(data, dataSize);
+}
+
 uint64_t agpuDeviceCommitFrame(GPUDevice device)
 {
     return device->CommitFrame();
 }
 
+void agpuDeviceProcessEvents(GPUDevice device)
+{
+    device->ProcessEvents();
+}
+
+GPUUploadTicket agpuDeviceFlushUploads(GPUDevice device)
+{
+    return device->FlushUploads();
+}
+
+bool agpuDeviceIsUploadComplete(GPUDevice device, GPUUploadTicket ticket)
+{
+    if (ticket == 0)
+        return true;
+
+    return device->IsUploadComplete(ticket);
+}
+
+void agpuDeviceWaitUpload(GPUDevice device, GPUUploadTicket ticket)
+{
+    if (ticket == 0)
+        return;
+
+    device->WaitUpload(ticket);
+}
+
 static GPUBufferDesc _GPUBufferDesc_Defaults(const GPUBufferDesc* desc)
 {
     GPUBufferDesc def = *desc;
@@ -650,7 +772,20 @@ static GPUSamplerDesc _GPUSamplerDesc_Defaults(const GPUSamplerDesc* desc)
 GPUSampler agpuDeviceCreateSampler(GPUDevice device, const GPUSamplerDesc* desc)
 {
     GPUSamplerDesc descDef = _GPUSamplerDesc_Defaults(desc);
-    return device->CreateSampler(descDef);
+
+    std::string key;
+    AppendCacheKey(key, descDef.minFilter);
+    AppendCacheKey(key, descDef.magFilter);
+    AppendCacheKey(key, descDef.mipFilter);
+    AppendCacheKey(key, descDef.addressModeU);
+    AppendCacheKey(key, descDef.addressModeV);
+    AppendCacheKey(key, descDef.addressModeW);
+    AppendCacheKey(key, descDef.maxAnisotropy);
+    AppendCacheKey(key, descDef.compareFunction);
+    AppendCacheKey(key, descDef.lodMinClamp);
+    AppendCacheKey(key, descDef.lodMaxClamp);
+
+    return GetOrCreateCached<GPUSampler>(device, std::move(key), [&] { return device->CreateSampler(descDef); });
 }
 
 /* CommandQueue */
@@ -674,6 +809,41 @@ void agpuCommandQueueSubmit(GPUCommandQueue queue, uint32_t numCommandBuffers, G
     queue->Submit(numCommandBuffers, commandBuffers);
 }
 
+GPUUploadTicket agpuCommandQueueWriteBuffer(GPUCommandQueue queue, GPUBuffer buffer, uint64_t bufferOffset, const void* data, uint64_t size)
+{
+    if (!buffer || !data || size == 0)
+        return 0;
+
+    if (bufferOffset + size > buffer->desc.size)
+    {
+        agpuLogError("WriteBuffer range (offset: %llu, size: %llu) exceeds buffer size %llu",
+            (unsigned long long)bufferOffset, (unsigned long long)size, (unsigned long long)buffer->desc.size);
+        return 0;
+    }
+
+    return queue->WriteBuffer(buffer, bufferOffset, data, size);
+}
+
+GPUUploadTicket agpuCommandQueueWriteTexture(GPUCommandQueue queue, GPUTexture texture, uint32_t mipLevel, uint32_t arrayLayer, const GPUTextureData* data)
+{
+    if (!texture || !data || !data->pData)
+        return 0;
+
+    uint32_t arrayLayers = texture->desc.depthOrArrayLayers;
+    if (texture->desc.dimension == GPUTextureDimension_3D)
+        arrayLayers = 1u;
+    else if (texture->desc.dimension == GPUTextureDimension_Cube)
+        arrayLayers *= 6u;
+
+    if (mipLevel >= texture->desc.mipLevelCount || arrayLayer >= arrayLayers)
+    {
+        agpuLogError("WriteTexture subresource (mip: %u, layer: %u) out of range", mipLevel, arrayLayer);
+        return 0;
+    }
+
+    return queue->WriteTexture(texture, mipLevel, arrayLayer, *data);
+}
+
 /* CommandBuffer */
 void agpuCommandBufferPushDebugGroup(GPUCommandBuffer commandBuffer, const char* groupLabel)
 {
@@ -715,6 +885,23 @@ GPURenderPassEncoder agpuCommandBufferBeginRenderPass(GPUCommandBuffer commandBu
     return commandBuffer->BeginRenderPass(*desc);
 }
 
+GPUCopyPassEncoder agpuCommandBufferBeginCopyPass(GPUCommandBuffer commandBuffer, const GPUCopyPassDesc* desc)
+{
+    GPUCopyPassDesc descDef = {};
+    if (desc)
+        descDef = *desc;
+
+    return commandBuffer->BeginCopyPass(descDef);
+}
+
+void agpuCommandBufferWaitUpload(GPUCommandBuffer commandBuffer, GPUUploadTicket ticket)
+{
+    if (ticket == 0)
+        return;
+
+    commandBuffer->WaitUpload(ticket);
+}
+
 /* ComputePassEncoder */
 void agpuComputePassEncoderSetPipeline(GPUComputePassEncoder computePassEncoder, GPUComputePipeline pipeline)
 {
@@ -726,6 +913,17 @@ void agpuComputePassEncoderSetPushConstants(GPUComputePassEncoder computePassEnc
     computePassEncoder->SetPushConstants(pushConstantIndex, data, size);
 }
 
+void agpuComputePassEncoderSetBindGroup(GPUComputePassEncoder computePassEncoder, uint32_t groupIndex, GPUBindGroup bindGroup)
+{
+    if (groupIndex >= GPU_MAX_BIND_GROUPS)
+    {
+        agpuLogError("SetBindGroup: group index %u exceeds GPU_MAX_BIND_GROUPS", groupIndex);
+        return;
+    }
+
+    computePassEncoder->SetBindGroup(groupIndex, bindGroup);
+}
+
 void agpuComputePassEncoderDispatch(GPUComputePassEncoder computePassEncoder, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
 {
     computePassEncoder->Dispatch(groupCountX, groupCountY, groupCountZ);
@@ -817,6 +1015,17 @@ void agpuRenderPassEncoderSetPushConstants(GPURenderPassEncoder renderPassEncode
     renderPassEncoder->SetPushConstants(pushConstantIndex, data, size);
 }
 
+void agpuRenderPassEncoderSetBindGroup(GPURenderPassEncoder renderPassEncoder, uint32_t groupIndex, GPUBindGroup bindGroup)
+{
+    if (groupIndex >= GPU_MAX_BIND_GROUPS)
+    {
+        agpuLogError("SetBindGroup: group index %u exceeds GPU_MAX_BIND_GROUPS", groupIndex);
+        return;
+    }
+
+    renderPassEncoder->SetBindGroup(groupIndex, bindGroup);
+}
+
 void agpuRenderPassEncoderDraw(GPURenderPassEncoder renderPassEncoder, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
 {
     renderPassEncoder->Draw(vertexCount, instanceCount, firstVertex, firstInstance);
@@ -872,6 +1081,127 @@ void agpuRenderPassEncoderInsertDebugMarker(GPURenderPassEncoder renderPassEncod
     renderPassEncoder->InsertDebugMarker(markerLabel);
 }
 
+/* CopyPassEncoder */
+static bool ValidateTexelCopyTexture(const GPUTexelCopyTextureInfo& info, const GPUExtent3D& copySize)
+{
+    const GPUTextureDesc& desc = info.texture->desc;
+    if (info.mipLevel >= desc.mipLevelCount)
+    {
+        agpuLogError("Texture copy mip level %u out of range", info.mipLevel);
+        return false;
+    }
+
+    const uint32_t levelWidth = std::max(1u, desc.width >> info.mipLevel);
+    const uint32_t levelHeight = std::max(1u, desc.height >> info.mipLevel);
+    uint32_t levelDepthOrArrayLayers = desc.depthOrArrayLayers;
+    if (desc.dimension == GPUTextureDimension_3D)
+        levelDepthOrArrayLayers = std::max(1u, desc.depthOrArrayLayers >> info.mipLevel);
+    else if (desc.dimension == GPUTextureDimension_Cube)
+        levelDepthOrArrayLayers *= 6u;
+
+    if (info.origin.x + copySize.width > levelWidth ||
+        info.origin.y + copySize.height > levelHeight ||
+        info.origin.z + copySize.depthOrArrayLayers > levelDepthOrArrayLayers)
+    {
+        agpuLogError("Texture copy region exceeds the texture subresource");
+        return false;
+    }
+
+    return true;
+}
+
+void agpuCopyPassEncoderCopyBufferToBuffer(GPUCopyPassEncoder copyPassEncoder, GPUBuffer source, uint64_t sourceOffset, GPUBuffer destination, uint64_t destinationOffset, uint64_t size)
+{
+    if (!source || !destination || size == 0)
+        return;
+
+    if (sourceOffset + size > source->desc.size || destinationOffset + size > destination->desc.size)
+    {
+        agpuLogError("CopyBufferToBuffer range exceeds buffer size");
+        return;
+    }
+
+    copyPassEncoder->CopyBufferToBuffer(source, sourceOffset, destination, destinationOffset, size);
+}
+
+void agpuCopyPassEncoderCopyBufferToTexture(GPUCopyPassEncoder copyPassEncoder, const GPUTexelCopyBufferInfo* source, const GPUTexelCopyTextureInfo* destination, const GPUExtent3D* copySize)
+{
+    ALIMER_ASSERT(source != nullptr && destination != nullptr && copySize != nullptr);
+
+    if (!ValidateTexelCopyTexture(*destination, *copySize))
+        return;
+
+    copyPassEncoder->CopyBufferToTexture(*source, *destination, *copySize);
+}
+
+void agpuCopyPassEncoderCopyTextureToBuffer(GPUCopyPassEncoder copyPassEncoder, const GPUTexelCopyTextureInfo* source, const GPUTexelCopyBufferInfo* destination, const GPUExtent3D* copySize)
+{
+    ALIMER_ASSERT(source != nullptr && destination != nullptr && copySize != nullptr);
+
+    if (!ValidateTexelCopyTexture(*source, *copySize))
+        return;
+
+    copyPassEncoder->CopyTextureToBuffer(*source, *destination, *copySize);
+}
+
+void agpuCopyPassEncoderCopyTextureToTexture(GPUCopyPassEncoder copyPassEncoder, const GPUTexelCopyTextureInfo* source, const GPUTexelCopyTextureInfo* destination, const GPUExtent3D* copySize)
+{
+    ALIMER_ASSERT(source != nullptr && destination != nullptr && copySize != nullptr);
+
+    if (!ValidateTexelCopyTexture(*source, *copySize) ||
+        !ValidateTexelCopyTexture(*destination, *copySize))
+    {
+        return;
+    }
+
+    copyPassEncoder->CopyTextureToTexture(*source, *destination, *copySize);
+}
+
+void agpuCopyPassEncoderFillBuffer(GPUCopyPassEncoder copyPassEncoder, GPUBuffer buffer, uint64_t offset, uint64_t size, uint32_t value)
+{
+    if (!buffer)
+        return;
+
+    if (size == GPU_WHOLE_SIZE)
+        size = buffer->desc.size - offset;
+
+    if ((offset % 4) != 0 || (size % 4) != 0 || offset + size > buffer->desc.size)
+    {
+        agpuLogError("FillBuffer offset and size must be multiple of 4 and within the buffer");
+        return;
+    }
+
+    if (size == 0)
+        return;
+
+    copyPassEncoder->FillBuffer(buffer, offset, size, value);
+}
+
+void agpuCopyPassEncoderClearBuffer(GPUCopyPassEncoder copyPassEncoder, GPUBuffer buffer, uint64_t offset, uint64_t size)
+{
+    agpuCopyPassEncoderFillBuffer(copyPassEncoder, buffer, offset, size, 0u);
+}
+
+void agpuCopyPassEncoderEnd(GPUCopyPassEncoder copyPassEncoder)
+{
+    copyPassEncoder->EndEncoding();
+}
+
+void agpuCopyPassEncoderPushDebugGroup(GPUCopyPassEncoder copyPassEncoder, const char* groupLabel)
+{
+    copyPassEncoder->PushDebugGroup(groupLabel);
+}
+
+void agpuCopyPassEncoderPopDebugGroup(GPUCopyPassEncoder copyPassEncoder)
+{
+    copyPassEncoder->PopDebugGroup();
+}
+
+void agpuCopyPassEncoderInsertDebugMarker(GPUCopyPassEncoder copyPassEncoder, const char* markerLabel)
+{
+    copyPassEncoder->InsertDebugMarker(markerLabel);
+}
+
 /* Buffer */
 void agpuBufferSetLabel(GPUBuffer buffer, const char* label)
 {
@@ -898,6 +1228,93 @@ GPUDeviceAddress agpuBufferGetDeviceAddress(GPUBuffer buffer)
     return buffer->GetDeviceAddress();
 }
 
+GPUBindlessIndex agpuBufferGetBindlessIndex(GPUBuffer buffer)
+{
+    return buffer->bindlessIndex;
+}
+
+void agpuBufferMapAsync(GPUBuffer buffer, GPUMapMode mode, uint64_t offset, uint64_t size, GPUBufferMapCallback callback, void* userData)
+{
+    if (size == GPU_WHOLE_SIZE)
+        size = (offset < buffer->desc.size) ? buffer->desc.size - offset : 0;
+
+    const char* error = nullptr;
+    if (buffer->mapState != GPUBufferMapState_Unmapped)
+        error = "MapAsync: buffer is already mapped or has a pending map request";
+    else if (mode == GPUMapMode_Read && buffer->desc.memoryType != GPUMemoryType_Readback)
+        error = "MapAsync: read mapping requires a GPUMemoryType_Readback buffer";
+    else if (mode == GPUMapMode_Write && buffer->desc.memoryType != GPUMemoryType_Upload)
+        error = "MapAsync: write mapping requires a GPUMemoryType_Upload buffer";
+    else if ((offset % 8) != 0 || (size % 4) != 0 || offset + size > buffer->desc.size)
+        error = "MapAsync: offset must be multiple of 8, size multiple of 4 and the range within the buffer";
+
+    if (error)
+    {
+        agpuLogError("%s", error);
+        if (callback)
+            callback(GPUMapAsyncStatus_Error, userData);
+        return;
+    }
+
+    buffer->mapState = GPUBufferMapState_Pending;
+    buffer->mapMode = mode;
+    buffer->mapOffset = offset;
+    buffer->mapSize = size;
+    buffer->mapSerial++;
+    buffer->MapAsync(callback, userData);
+}
+
+GPUBufferMapState agpuBufferGetMapState(GPUBuffer buffer)
+{
+    return buffer->mapState;
+}
+
+static uint8_t* GetBufferMappedRange(GPUBuffer buffer, uint64_t offset, uint64_t size)
+{
+    if (buffer->mapState != GPUBufferMapState_Mapped)
+        return nullptr;
+
+    if (size == GPU_WHOLE_SIZE)
+        size = (offset < buffer->mapOffset + buffer->mapSize) ? buffer->mapOffset + buffer->mapSize - offset : 0;
+
+    if (offset < buffer->mapOffset || offset + size > buffer->mapOffset + buffer->mapSize)
+    {
+        agpuLogError("GetMappedRange: range is outside of the mapped range");
+        return nullptr;
+    }
+
+    uint8_t* mappedData = static_cast<uint8_t*>(buffer->GetMappedData());
+    return mappedData ? mappedData + offset : nullptr;
+}
+
+void* agpuBufferGetMappedRange(GPUBuffer buffer, uint64_t offset, uint64_t size)
+{
+    if (buffer->mapState == GPUBufferMapState_Mapped && buffer->mapMode != GPUMapMode_Write)
+    {
+        agpuLogError("GetMappedRange: buffer is mapped for reading, use GetConstMappedRange");
+        return nullptr;
+    }
+
+    return GetBufferMappedRange(buffer, offset, size);
+}
+
+const void* agpuBufferGetConstMappedRange(GPUBuffer buffer, uint64_t offset, uint64_t size)
+{
+    return GetBufferMappedRange(buffer, offset, size);
+}
+
+void agpuBufferUnmap(GPUBuffer buffer)
+{
+    if (buffer->mapState == GPUBufferMapState_Unmapped)
+        return;
+
+    if (buffer->mapState == GPUBufferMapState_Mapped)
+        buffer->Unmap();
+
+    buffer->mapState = GPUBufferMapState_Unmapped;
+    buffer->mapSerial++;
+}
+
 /* Texture */
 void agpuTextureSetLabel(GPUTexture texture, const char* label)
 {
@@ -954,6 +1371,16 @@ uint32_t agpuTextureGetLevelHeight(GPUTexture texture, uint32_t mipLevel)
     return std::max(texture->desc.height >> mipLevel, 1u);
 }
 
+GPUBindlessIndex agpuTextureGetBindlessIndex(GPUTexture texture)
+{
+    return texture->bindlessIndex;
+}
+
+GPUBindlessIndex agpuTextureGetBindlessStorageIndex(GPUTexture texture)
+{
+    return texture->bindlessStorageIndex;
+}
+
 uint32_t agpuTextureAddRef(GPUTexture texture)
 {
     return texture->AddRef();
@@ -980,6 +1407,162 @@ uint32_t agpuSamplerRelease(GPUSampler sampler)
     return sampler->Release();
 }
 
+GPUBindlessIndex agpuSamplerGetBindlessIndex(GPUSampler sampler)
+{
+    return sampler->bindlessIndex;
+}
+
+/* BindGroupLayout */
+static bool IsBufferBindingType(GPUBindingType type)
+{
+    return type == GPUBindingType_ConstantBuffer
+        || type == GPUBindingType_ReadOnlyStorageBuffer
+        || type == GPUBindingType_StorageBuffer;
+}
+
+static bool IsTextureBindingType(GPUBindingType type)
+{
+    return type == GPUBindingType_SampledTexture
+        || type == GPUBindingType_StorageTexture;
+}
+
+GPUBindGroupLayout agpuCreateBindGroupLayout(GPUDevice device, const GPUBindGroupLayoutDesc* desc)
+{
+    if (!desc)
+        return nullptr;
+
+    if (desc->entryCount > 0 && desc->entries == nullptr)
+    {
+        agpuLogError("CreateBindGroupLayout: entries are null");
+        return nullptr;
+    }
+
+    std::vector<GPUBindGroupLayoutEntry> entries(desc->entries, desc->entries + desc->entryCount);
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        GPUBindGroupLayoutEntry& entry = entries[i];
+        if (entry.type == GPUBindingType_Undefined || entry.type >= _GPUBindingType_Count)
+        {
+            agpuLogError("CreateBindGroupLayout: entry %u has invalid binding type", (uint32_t)i);
+            return nullptr;
+        }
+
+        if (entry.count == 0)
+            entry.count = 1;
+
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (entries[j].binding == entry.binding && entries[j].type == entry.type)
+            {
+                agpuLogError("CreateBindGroupLayout: binding %u is declared more than once", entry.binding);
+                return nullptr;
+            }
+        }
+    }
+
+    // Sorted entries make identical layouts compare equal regardless of declaration order.
+    std::sort(entries.begin(), entries.end(), [](const GPUBindGroupLayoutEntry& lhs, const GPUBindGroupLayoutEntry& rhs) {
+        return lhs.type != rhs.type ? lhs.type < rhs.type : lhs.binding < rhs.binding;
+        });
+
+    GPUBindGroupLayoutDesc descDef = *desc;
+    descDef.entryCount = (uint32_t)entries.size();
+    descDef.entries = entries.data();
+    return device->CreateBindGroupLayout(descDef);
+}
+
+void agpuBindGroupLayoutSetLabel(GPUBindGroupLayout bindGroupLayout, const char* label)
+{
+    bindGroupLayout->SetLabel(label);
+}
+
+uint32_t agpuBindGroupLayoutAddRef(GPUBindGroupLayout bindGroupLayout)
+{
+    return bindGroupLayout->AddRef();
+}
+
+uint32_t agpuBindGroupLayoutRelease(GPUBindGroupLayout bindGroupLayout)
+{
+    return bindGroupLayout->Release();
+}
+
+/* BindGroup */
+GPUBindGroup agpuCreateBindGroup(GPUDevice device, const GPUBindGroupDesc* desc)
+{
+    if (!desc || !desc->layout)
+        return nullptr;
+
+    if (desc->entryCount > 0 && desc->entries == nullptr)
+    {
+        agpuLogError("CreateBindGroup: entries are null");
+        return nullptr;
+    }
+
+    std::vector<GPUBindGroupEntry> entries(desc->entries, desc->entries + desc->entryCount);
+    for (GPUBindGroupEntry& entry : entries)
+    {
+        const GPUBindGroupLayoutEntry* layoutEntry = desc->layout->FindEntry(entry.binding, entry.type);
+        if (!layoutEntry)
+        {
+            agpuLogError("CreateBindGroup: binding %u does not exist in the layout", entry.binding);
+            return nullptr;
+        }
+
+        if (entry.arrayElement >= layoutEntry->count)
+        {
+            agpuLogError("CreateBindGroup: binding %u array element %u out of range", entry.binding, entry.arrayElement);
+            return nullptr;
+        }
+
+        if (IsBufferBindingType(entry.type))
+        {
+            if (!entry.buffer)
+            {
+                agpuLogError("CreateBindGroup: binding %u requires a buffer", entry.binding);
+                return nullptr;
+            }
+
+            if (entry.size == GPU_WHOLE_SIZE)
+                entry.size = (entry.offset < entry.buffer->desc.size) ? entry.buffer->desc.size - entry.offset : 0;
+
+            if (entry.size == 0 || entry.offset + entry.size > entry.buffer->desc.size)
+            {
+                agpuLogError("CreateBindGroup: binding %u buffer range exceeds buffer size", entry.binding);
+                return nullptr;
+            }
+        }
+        else if (IsTextureBindingType(entry.type) && !entry.texture)
+        {
+            agpuLogError("CreateBindGroup: binding %u requires a texture", entry.binding);
+            return nullptr;
+        }
+        else if (entry.type == GPUBindingType_Sampler && !entry.sampler)
+        {
+            agpuLogError("CreateBindGroup: binding %u requires a sampler", entry.binding);
+            return nullptr;
+        }
+    }
+
+    GPUBindGroupDesc descDef = *desc;
+    descDef.entries = entries.data();
+    return device->CreateBindGroup(descDef);
+}
+
+void agpuBindGroupSetLabel(GPUBindGroup bindGroup, const char* label)
+{
+    bindGroup->SetLabel(label);
+}
+
+uint32_t agpuBindGroupAddRef(GPUBindGroup bindGroup)
+{
+    return bindGroup->AddRef();
+}
+
+uint32_t agpuBindGroupRelease(GPUBindGroup bindGroup)
+{
+    return bindGroup->Release();
+}
+
 /* PipelineLayout */
 static GPUPipelineLayoutDesc _GPUPipelineLayoutDesc_Defaults(const GPUPipelineLayoutDesc* desc) {
     GPUPipelineLayoutDesc def = *desc;
@@ -991,8 +1574,35 @@ GPUPipelineLayout agpuCreatePipelineLayout(GPUDevice device, const GPUPipelineLa
     if (!desc)
         return nullptr;
 
+    if (desc->bindGroupLayoutCount > GPU_MAX_BIND_GROUPS)
+    {
+        agpuLogError("CreatePipelineLayout: bind group layout count exceeds GPU_MAX_BIND_GROUPS");
+        return nullptr;
+    }
+
+    for (uint32_t i = 0; i < desc->bindGroupLayoutCount; ++i)
+    {
+        if (desc->bindGroupLayouts[i] == nullptr)
+        {
+            agpuLogError("CreatePipelineLayout: bind group layout %u is null", i);
+            return nullptr;
+        }
+    }
+
     GPUPipelineLayoutDesc descDef = _GPUPipelineLayoutDesc_Defaults(desc);
-    return device->CreatePipelineLayout(descDef);
+
+    std::string key;
+    AppendCacheKey(key, descDef.bindGroupLayoutCount);
+    for (uint32_t i = 0; i < descDef.bindGroupLayoutCount; ++i)
+    {
+        const std::vector<GPUBindGroupLayoutEntry>& entries = descDef.bindGroupLayouts[i]->entries;
+        AppendCacheKey(key, entries.size());
+        key.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(GPUBindGroupLayoutEntry));
+    }
+    AppendCacheKey(key, descDef.pushConstantRangeCount);
+    key.append(reinterpret_cast<const char*>(descDef.pushConstantRanges), descDef.pushConstantRangeCount * sizeof(GPUPushConstantRange));
+
+    return GetOrCreateCached<GPUPipelineLayout>(device, std::move(key), [&] { return device->CreatePipelineLayout(descDef); });
 }
 
 void agpuPipelineLayoutSetLabel(GPUPipelineLayout pipelineLayout, const char* label)
@@ -1036,7 +1646,14 @@ GPUShaderModule agpuCreateShaderModule(GPUDevice device, const GPUShaderModuleDe
         return nullptr;
     }
 
-    return device->CreateShaderModule(desc);
+    // Byte code is keyed by its hash, pipeline keys embed this key
+    std::string key;
+    AppendCacheKey(key, desc->stage);
+    AppendCacheKey(key, std::string(desc->entryPoint));
+    AppendCacheKey(key, desc->byteCodeSize);
+    AppendCacheKey(key, Hash64(desc->byteCode, desc->byteCodeSize));
+
+    return GetOrCreateCached<GPUShaderModule>(device, std::move(key), [&] { return device->CreateShaderModule(desc); });
 }
 
 void agpuShaderModuleSetLabel(GPUShaderModule shaderModule, const char* label)
@@ -1060,6 +1677,14 @@ static GPUComputePipelineDesc _GPUComputePipelineDesc_Defaults(const GPUComputeP
     return def;
 }
 
+static std::string GetComputePipelineCacheKey(const GPUComputePipelineDesc& desc)
+{
+    std::string key;
+    AppendObjectCacheKey(key, desc.layout);
+    AppendObjectCacheKey(key, desc.shader);
+    return key;
+}
+
 GPUComputePipeline agpuCreateComputePipeline(GPUDevice device, const GPUComputePipelineDesc* desc)
 {
     if (!desc)
@@ -1074,7 +1699,34 @@ GPUComputePipeline agpuCreateComputePipeline(GPUDevice device, const GPUComputeP
     // ArgumentException.ThrowIfFalse(descriptor.ComputeShader.Stage == ShaderStages.Compute, nameof(ComputePipelineDescriptor.ComputeShader));
 
     GPUComputePipelineDesc descDef = _GPUComputePipelineDesc_Defaults(desc);
-    return device->CreateComputePipeline(descDef);
+    return GetOrCreateCached<GPUComputePipeline>(device, GetComputePipelineCacheKey(descDef), [&] { return device->CreateComputePipeline(descDef); });
+}
+
+GPUComputePipeline agpuCreateComputePipelineAsync(GPUDevice device, const GPUComputePipelineDesc* desc, GPUComputePipeline fallback)
+{
+    if (!desc)
+        return nullptr;
+
+    if (!desc->shader)
+    {
+        agpuLogError("CreateComputePipelineAsync: Invalid shader module");
+        return nullptr;
+    }
+
+    GPUComputePipelineDesc descDef = _GPUComputePipelineDesc_Defaults(desc);
+    std::string key = GetComputePipelineCacheKey(descDef);
+
+    // Pipelines created synchronously are always ready and need no fallback.
+    if (GPUCachedResource* cached = device->objectCache.Find(key))
+        return static_cast<GPUComputePipeline>(cached);
+
+    AppendAsyncPipelineCacheKey(key, fallback);
+    return GetOrCreateCached<GPUComputePipeline>(device, std::move(key), [&] { return device->CreateComputePipelineAsync(descDef, fallback); });
+}
+
+GPUPipelineStatus agpuComputePipelineGetStatus(GPUComputePipeline computePipeline)
+{
+    return computePipeline->status.load(std::memory_order_acquire);
 }
 
 void agpuComputePipelineSetLabel(GPUComputePipeline computePipeline, const char* label)
@@ -1136,13 +1788,78 @@ static GPURenderPipelineDesc _GPURenderPipelineDesc_Defaults(const GPURenderPipe
     return def;
 }
 
+static std::string GetRenderPipelineCacheKey(const GPURenderPipelineDesc& desc)
+{
+    std::string key;
+    AppendObjectCacheKey(key, desc.layout);
+    AppendObjectCacheKey(key, desc.vertexShader);
+    AppendObjectCacheKey(key, desc.fragmentShader);
+    AppendObjectCacheKey(key, desc.meshShader);
+    AppendObjectCacheKey(key, desc.amplificationShader);
+
+    AppendCacheKey(key, desc.vertexBufferLayoutCount);
+    for (uint32_t i = 0; i < desc.vertexBufferLayoutCount; ++i)
+    {
+        const GPUVertexBufferLayout& layout = desc.vertexBufferLayouts[i];
+        AppendCacheKey(key, layout.stride);
+        AppendCacheKey(key, layout.stepMode);
+        AppendCacheKey(key, layout.attributeCount);
+        key.append(reinterpret_cast<const char*>(layout.attributes), layout.attributeCount * sizeof(GPUVertexAttribute));
+    }
+
+    AppendCacheKey(key, desc.rasterizerState);
+
+    const GPUDepthStencilState& depthStencilState = desc.depthStencilState;
+    AppendCacheKey(key, depthStencilState.depthWriteEnabled);
+    AppendCacheKey(key, depthStencilState.depthCompareFunction);
+    AppendCacheKey(key, depthStencilState.stencilReadMask);
+    AppendCacheKey(key, depthStencilState.stencilWriteMask);
+    AppendCacheKey(key, depthStencilState.frontFace);
+    AppendCacheKey(key, depthStencilState.backFace);
+    AppendCacheKey(key, depthStencilState.depthBoundsTestEnable);
+
+    AppendCacheKey(key, desc.primitiveTopology);
+    AppendCacheKey(key, desc.multisample);
+    for (uint32_t i = 0; i < desc.colorAttachmentCount; ++i)
+    {
+        if (desc.colorAttachments[i].format == GPUPixelFormat_Undefined)
+            break;
+
+        AppendCacheKey(key, desc.colorAttachments[i]);
+    }
+    AppendCacheKey(key, GPUPixelFormat_Undefined);
+    AppendCacheKey(key, desc.depthStencilAttachmentFormat);
+    return key;
+}
+
 GPURenderPipeline agpuCreateRenderPipeline(GPUDevice device, const GPURenderPipelineDesc* desc)
 {
     if (!desc)
         return nullptr;
 
     GPURenderPipelineDesc descDef = _GPURenderPipelineDesc_Defaults(desc);
-    return device->CreateRenderPipeline(descDef);
+    return GetOrCreateCached<GPURenderPipeline>(device, GetRenderPipelineCacheKey(descDef), [&] { return device->CreateRenderPipeline(descDef); });
+}
+
+GPURenderPipeline agpuCreateRenderPipelineAsync(GPUDevice device, const GPURenderPipelineDesc* desc, GPURenderPipeline fallback)
+{
+    if (!desc)
+        return nullptr;
+
+    GPURenderPipelineDesc descDef = _GPURenderPipelineDesc_Defaults(desc);
+    std::string key = GetRenderPipelineCacheKey(descDef);
+
+    // Pipelines created synchronously are always ready and need no fallback.
+    if (GPUCachedResource* cached = device->objectCache.Find(key))
+        return static_cast<GPURenderPipeline>(cached);
+
+    AppendAsyncPipelineCacheKey(key, fallback);
+    return GetOrCreateCached<GPURenderPipeline>(device, std::move(key), [&] { return device->CreateRenderPipelineAsync(descDef, fallback); });
+}
+
+GPUPipelineStatus agpuRenderPipelineGetStatus(GPURenderPipeline renderPipeline)
+{
+    return renderPipeline->status.load(std::memory_order_acquire);
 }
 
 void agpuRenderPipelineSetLabel(GPURenderPipeline renderPipeline, const char* label)
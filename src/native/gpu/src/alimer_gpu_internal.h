@@ -10,6 +10,10 @@
 #include <algorithm>
 #include <atomic>
 #include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #if defined(_WIN32)
 #ifndef UNICODE
@@ -157,6 +161,18 @@ public:
         return newCount;
     }
 
+    /// Takes a reference unless the object is already being destroyed.
+    bool TryAddRef()
+    {
+        uint32_t count = refCount.load(std::memory_order_relaxed);
+        while (count != 0)
+        {
+            if (refCount.compare_exchange_weak(count, count + 1))
+                return true;
+        }
+        return false;
+    }
+
     virtual void SetLabel([[maybe_unused]] const char* label)
     {}
 
@@ -164,20 +180,61 @@ private:
     std::atomic_uint32_t refCount = 1;
 };
 
+class GPUObjectCache;
+
+/// Object shared by identical descriptors through the device object cache.
+class GPUCachedResource : public GPUResource
+{
+protected:
+    ~GPUCachedResource() override;
+
+public:
+    GPUObjectCache* cache = nullptr;
+    std::string cacheKey;
+};
+
+/// Maps descriptor content keys to live objects, entries hold no reference and are removed when the object is destroyed.
+class GPUObjectCache final
+{
+public:
+    /// Returns a new reference to the cached object, nullptr when there is none.
+    GPUCachedResource* Find(const std::string& key);
+    /// Caches object, when an identical one was inserted meanwhile object is released and the cached one returned.
+    GPUCachedResource* Insert(std::string&& key, GPUCachedResource* object);
+    void Remove(GPUCachedResource* object);
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, GPUCachedResource*> objects;
+};
+
 struct GPUBufferImpl : public GPUResource
 {
     GPUBufferDesc desc;
+    GPUBufferMapState mapState = GPUBufferMapState_Unmapped;
+    GPUMapMode mapMode = GPUMapMode_Read;
+    uint64_t mapOffset = 0;
+    uint64_t mapSize = 0;
+    /// Bumped by every map request and unmap, pending requests with an older serial resolve as aborted.
+    uint32_t mapSerial = 0;
+    GPUBindlessIndex bindlessIndex = GPU_INVALID_BINDLESS_INDEX;
+
     virtual GPUDeviceAddress GetDeviceAddress() const = 0;
+    virtual void* GetMappedData() const = 0;
+    virtual void MapAsync(GPUBufferMapCallback callback, void* userData) = 0;
+    virtual void Unmap() = 0;
 };
 
 struct GPUTextureImpl : public GPUResource
 {
     GPUTextureDesc desc;
+    GPUBindlessIndex bindlessIndex = GPU_INVALID_BINDLESS_INDEX;
+    GPUBindlessIndex bindlessStorageIndex = GPU_INVALID_BINDLESS_INDEX;
 };
 
-struct GPUSamplerImpl : public GPUResource
+struct GPUSamplerImpl : public GPUCachedResource
 {
-
+    GPUBindlessIndex bindlessIndex = GPU_INVALID_BINDLESS_INDEX;
 };
 
 struct GPUQueryHeapImpl : public GPUResource
@@ -187,7 +244,18 @@ struct GPUQueryHeapImpl : public GPUResource
 
 struct GPUBindGroupLayoutImpl : public GPUResource
 {
+    std::vector<GPUBindGroupLayoutEntry> entries;
 
+    const GPUBindGroupLayoutEntry* FindEntry(uint32_t binding, GPUBindingType type) const
+    {
+        for (const GPUBindGroupLayoutEntry& entry : entries)
+        {
+            if (entry.binding == binding && entry.type == type)
+                return &entry;
+        }
+
+        return nullptr;
+    }
 };
 
 struct GPUBindGroupImpl : public GPUResource
@@ -195,24 +263,24 @@ struct GPUBindGroupImpl : public GPUResource
 
 };
 
-struct GPUPipelineLayoutImpl : public GPUResource
+struct GPUPipelineLayoutImpl : public GPUCachedResource
 {
 
 };
 
-struct GPUShaderModuleImpl : public GPUResource
+struct GPUShaderModuleImpl : public GPUCachedResource
 {
 
 };
 
-struct GPUComputePipelineImpl : public GPUResource
+struct GPUComputePipelineImpl : public GPUCachedResource
 {
-
+    std::atomic<GPUPipelineStatus> status{ GPUPipelineStatus_Ready };
 };
 
-struct GPURenderPipelineImpl : public GPUResource
+struct GPURenderPipelineImpl : public GPUCachedResource
 {
-
+    std::atomic<GPUPipelineStatus> status{ GPUPipelineStatus_Ready };
 };
 
 struct GPUCommandEncoder : public GPUResource
@@ -227,6 +295,7 @@ struct GPUComputePassEncoderImpl : public GPUCommandEncoder
 {
     virtual void SetPipeline(GPUComputePipeline pipeline) = 0;
     virtual void SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size) = 0;
+    virtual void SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup) = 0;
 
     virtual void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) = 0;
     virtual void DispatchIndirect(GPUBuffer indirectBuffer, uint64_t indirectBufferOffset) = 0;
@@ -245,6 +314,7 @@ struct GPURenderPassEncoderImpl : public GPUCommandEncoder
     virtual void SetIndexBuffer(GPUBuffer buffer, GPUIndexType type, uint64_t offset) = 0;
     virtual void SetPipeline(GPURenderPipeline pipeline) = 0;
     virtual void SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size) = 0;
+    virtual void SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup) = 0;
 
     virtual void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) = 0;
     virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance) = 0;
@@ -257,6 +327,15 @@ struct GPURenderPassEncoderImpl : public GPUCommandEncoder
     virtual void SetShadingRate(GPUShadingRate rate) = 0;
 };
 
+struct GPUCopyPassEncoderImpl : public GPUCommandEncoder
+{
+    virtual void CopyBufferToBuffer(GPUBuffer source, uint64_t sourceOffset, GPUBuffer destination, uint64_t destinationOffset, uint64_t size) = 0;
+    virtual void CopyBufferToTexture(const GPUTexelCopyBufferInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize) = 0;
+    virtual void CopyTextureToBuffer(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyBufferInfo& destination, const GPUExtent3D& copySize) = 0;
+    virtual void CopyTextureToTexture(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize) = 0;
+    virtual void FillBuffer(GPUBuffer buffer, uint64_t offset, uint64_t size, uint32_t value) = 0;
+};
+
 struct GPUCommandBufferImpl : public GPUResource
 {
     virtual void PushDebugGroup(const char* groupLabel) const = 0;
@@ -266,6 +345,8 @@ struct GPUCommandBufferImpl : public GPUResource
     virtual GPUAcquireSurfaceResult AcquireSurfaceTexture(GPUSurface surface, GPUTexture* surfaceTexture) = 0;
     virtual GPUComputePassEncoder BeginComputePass(const GPUComputePassDesc& desc) = 0;
     virtual GPURenderPassEncoder BeginRenderPass(const GPURenderPassDesc& desc) = 0;
+    virtual GPUCopyPassEncoder BeginCopyPass(const GPUCopyPassDesc& desc) = 0;
+    virtual void WaitUpload(GPUUploadTicket ticket) = 0;
 };
 
 struct GPUCommandQueueImpl : public GPUResource
@@ -275,28 +356,41 @@ struct GPUCommandQueueImpl : public GPUResource
     virtual void WaitIdle() = 0;
     virtual GPUCommandBuffer AcquireCommandBuffer(const GPUCommandBufferDesc* desc) = 0;
     virtual void Submit(uint32_t numCommandBuffers, GPUCommandBuffer* commandBuffers) = 0;
+    virtual GPUUploadTicket WriteBuffer(GPUBuffer buffer, uint64_t bufferOffset, const void* data, uint64_t size) = 0;
+    virtual GPUUploadTicket WriteTexture(GPUTexture texture, uint32_t mipLevel, uint32_t arrayLayer, const GPUTextureData& data) = 0;
 };
 
 struct GPUDeviceImpl : public GPUResource
 {
+    GPUObjectCache objectCache;
+
     virtual void GetLimits(GPUDeviceLimits* limits) const = 0;
     virtual bool HasFeature(GPUFeature feature) const = 0;
     virtual GPUCommandQueue GetQueue(GPUCommandQueueType type) = 0;
     virtual void WaitIdle() = 0;
     virtual uint64_t CommitFrame() = 0;
+    virtual void ProcessEvents() = 0;
+
+    virtual GPUUploadTicket FlushUploads() = 0;
+    virtual bool IsUploadComplete(GPUUploadTicket ticket) = 0;
+    virtual void WaitUpload(GPUUploadTicket ticket) = 0;
 
     virtual uint64_t GetTimestampFrequency() const = 0;
+    virtual size_t GetPipelineCacheData(void* data, size_t dataSize) = 0;
 
     /* Resource creation */
     virtual GPUBuffer CreateBuffer(const GPUBufferDesc& desc, const void* pInitialData) = 0;
     virtual GPUTexture CreateTexture(const GPUTextureDesc& desc, const GPUTextureData* pInitialData) = 0;
     virtual GPUSampler CreateSampler(const GPUSamplerDesc& desc) = 0;
     virtual GPUBindGroupLayout CreateBindGroupLayout(const GPUBindGroupLayoutDesc& desc) = 0;
+    virtual GPUBindGroup CreateBindGroup(const GPUBindGroupDesc& desc) = 0;
     virtual GPUPipelineLayout CreatePipelineLayout(const GPUPipelineLayoutDesc& desc) = 0;
 
     virtual GPUShaderModule CreateShaderModule(const GPUShaderModuleDesc* desc) = 0;
     virtual GPUComputePipeline CreateComputePipeline(const GPUComputePipelineDesc& desc) = 0;
     virtual GPURenderPipeline CreateRenderPipeline(const GPURenderPipelineDesc& desc) = 0;
+    virtual GPUComputePipeline CreateComputePipelineAsync(const GPUComputePipelineDesc& desc, GPUComputePipeline fallback) = 0;
+    virtual GPURenderPipeline CreateRenderPipelineAsync(const GPURenderPipelineDesc& desc, GPURenderPipeline fallback) = 0;
     virtual GPUQueryHeap CreateQueryHeap(const GPUQueryHeapDesc& desc) = 0;
 
 };
@@ -391,6 +485,50 @@ typedef struct GPUPixelFormatInfo {
 
 _ALIMER_EXTERN GPUPixelFormatInfo agpuPixelFormatGetInfo(GPUPixelFormat format);
 
+/// @brief 64-bit hash of a memory block (MurmurHash64A), used for content hashes.
+/// Identical to the engine copy in alimer_hash.h, the gpu library builds without the engine sources.
+inline uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0)
+{
+    constexpr uint64_t m = 0xc6a4a7935bd1e995ULL;
+    constexpr int r = 47;
+
+    uint64_t h = seed ^ (size * m);
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const uint8_t* end = bytes + (size & ~size_t(7));
+    while (bytes != end)
+    {
+        uint64_t k;
+        memcpy(&k, bytes, sizeof(k));
+        bytes += sizeof(k);
+
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    switch (size & 7)
+    {
+        case 7: h ^= uint64_t(bytes[6]) << 48; [[fallthrough]];
+        case 6: h ^= uint64_t(bytes[5]) << 40; [[fallthrough]];
+        case 5: h ^= uint64_t(bytes[4]) << 32; [[fallthrough]];
+        case 4: h ^= uint64_t(bytes[3]) << 24; [[fallthrough]];
+        case 3: h ^= uint64_t(bytes[2]) << 16; [[fallthrough]];
+        case 2: h ^= uint64_t(bytes[1]) << 8; [[fallthrough]];
+        case 1: h ^= uint64_t(bytes[0]);
+            h *= m;
+            break;
+        default:
+            break;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
 namespace
 {
     template <typename T>
@@ -24,8 +24,12 @@ private:
 struct NullBuffer final : public GPUBufferImpl
 {
     GPUDeviceAddress deviceAddress = 0;
+    std::vector<uint8_t> hostData;
 
     GPUDeviceAddress GetDeviceAddress() const override { return deviceAddress; }
+    void* GetMappedData() const override { return hostData.empty() ? nullptr : const_cast<uint8_t*>(hostData.data()); }
+    void MapAsync(GPUBufferMapCallback callback, void* userData) override;
+    void Unmap() override {}
 };
 
 struct NullTexture final : public GPUTextureImpl
@@ -37,6 +41,9 @@ struct NullSampler final : public GPUSamplerImpl
 struct NullBindGroupLayout final : public GPUBindGroupLayoutImpl
 {};
 
+struct NullBindGroup final : public GPUBindGroupImpl
+{};
+
 struct NullPipelineLayout final : public GPUPipelineLayoutImpl
 {};
 
@@ -65,6 +72,7 @@ struct NullComputePassEncoder final : public GPUComputePassEncoderImpl
 
     void SetPipeline(GPUComputePipeline pipeline) override;
     void SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size) override;
+    void SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup) override;
     void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
     void DispatchIndirect(GPUBuffer indirectBuffer, uint64_t indirectBufferOffset) override;
 };
@@ -89,6 +97,7 @@ struct NullRenderPassEncoder final : public GPURenderPassEncoderImpl
     void SetIndexBuffer(GPUBuffer buffer, GPUIndexType type, uint64_t offset) override;
     void SetPipeline(GPURenderPipeline pipeline) override;
     void SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size) override;
+    void SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup) override;
 
     void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
     void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance) override;
@@ -101,6 +110,22 @@ struct NullRenderPassEncoder final : public GPURenderPassEncoderImpl
     void SetShadingRate(GPUShadingRate rate) override;
 };
 
+struct NullCopyPassEncoder final : public GPUCopyPassEncoderImpl
+{
+    NullCommandBuffer* commandBuffer = nullptr;
+
+    void EndEncoding() override;
+    void PushDebugGroup(const char* groupLabel) const override;
+    void PopDebugGroup() const override;
+    void InsertDebugMarker(const char* markerLabel) const override;
+
+    void CopyBufferToBuffer(GPUBuffer source, uint64_t sourceOffset, GPUBuffer destination, uint64_t destinationOffset, uint64_t size) override;
+    void CopyBufferToTexture(const GPUTexelCopyBufferInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize) override;
+    void CopyTextureToBuffer(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyBufferInfo& destination, const GPUExtent3D& copySize) override;
+    void CopyTextureToTexture(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize) override;
+    void FillBuffer(GPUBuffer buffer, uint64_t offset, uint64_t size, uint32_t value) override;
+};
+
 struct NullCommandBuffer final : public GPUCommandBufferImpl
 {
     static constexpr uint32_t kMaxBarrierCount = 16;
@@ -110,6 +135,7 @@ struct NullCommandBuffer final : public GPUCommandBufferImpl
     bool encoderActive = false;
     NullComputePassEncoder* computePassEncoder = nullptr;
     NullRenderPassEncoder* renderPassEncoder = nullptr;
+    NullCopyPassEncoder* copyPassEncoder = nullptr;
 
     GPUAcquireSurfaceResult AcquireSurfaceTexture(GPUSurface surface, GPUTexture* surfaceTexture) override;
     void PushDebugGroup(const char* groupLabel) const override;
@@ -118,6 +144,8 @@ struct NullCommandBuffer final : public GPUCommandBufferImpl
 
     GPUComputePassEncoder BeginComputePass(const GPUComputePassDesc& desc) override;
     GPURenderPassEncoder BeginRenderPass(const GPURenderPassDesc& desc) override;
+    GPUCopyPassEncoder BeginCopyPass(const GPUCopyPassDesc& desc) override;
+    void WaitUpload(GPUUploadTicket ticket) override;
 };
 
 struct NullCommandQueue final : public GPUCommandQueueImpl
@@ -128,6 +156,8 @@ struct NullCommandQueue final : public GPUCommandQueueImpl
     GPUCommandBuffer AcquireCommandBuffer(const GPUCommandBufferDesc* desc) override;
     void WaitIdle() override;
     void Submit(uint32_t numCommandBuffers, GPUCommandBuffer* commandBuffers) override;
+    GPUUploadTicket WriteBuffer(GPUBuffer buffer, uint64_t bufferOffset, const void* data, uint64_t size) override;
+    GPUUploadTicket WriteTexture(GPUTexture texture, uint32_t mipLevel, uint32_t arrayLayer, const GPUTextureData& data) override;
 };
 
 struct NullDevice final : public GPUDeviceImpl
@@ -145,18 +175,27 @@ struct NullDevice final : public GPUDeviceImpl
     GPUCommandQueue GetQueue(GPUCommandQueueType type) override;
     void WaitIdle() override;
     uint64_t CommitFrame() override;
+    void ProcessEvents() override {}
+
+    GPUUploadTicket FlushUploads() override { return 0; }
+    bool IsUploadComplete(GPUUploadTicket ticket) override { ALIMER_UNUSED(ticket); return true; }
+    void WaitUpload(GPUUploadTicket ticket) override { ALIMER_UNUSED(ticket); }
 
     uint64_t GetTimestampFrequency() const override { return timestampFrequency; }
+    size_t GetPipelineCacheData(void*, size_t) override { return 0; }
 
     /* Resource creation */
     GPUBuffer CreateBuffer(const GPUBufferDesc& desc, const void* pInitialData) override;
     GPUTexture CreateTexture(const GPUTextureDesc& desc, const GPUTextureData* pInitialData) override;
     GPUSampler CreateSampler(const GPUSamplerDesc& desc) override;
     GPUBindGroupLayout CreateBindGroupLayout(const GPUBindGroupLayoutDesc& desc) override;
+    GPUBindGroup CreateBindGroup(const GPUBindGroupDesc& desc) override;
     GPUPipelineLayout CreatePipelineLayout(const GPUPipelineLayoutDesc& desc) override;
     GPUShaderModule CreateShaderModule(const GPUShaderModuleDesc* desc) override;
     GPUComputePipeline CreateComputePipeline(const GPUComputePipelineDesc& desc) override;
     GPURenderPipeline CreateRenderPipeline(const GPURenderPipelineDesc& desc) override;
+    GPUComputePipeline CreateComputePipelineAsync(const GPUComputePipelineDesc& desc, GPUComputePipeline fallback) override;
+    GPURenderPipeline CreateRenderPipelineAsync(const GPURenderPipelineDesc& desc, GPURenderPipeline fallback) override;
     GPUQueryHeap CreateQueryHeap(const GPUQueryHeapDesc& desc) override;
 };
 
@@ -213,6 +252,12 @@ void NullComputePassEncoder::SetPushConstants(uint32_t pushConstantIndex, const
     ALIMER_UNUSED(size);
 }
 
+void NullComputePassEncoder::SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup)
+{
+    ALIMER_UNUSED(groupIndex);
+    ALIMER_UNUSED(bindGroup);
+}
+
 void NullComputePassEncoder::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
 {
     ALIMER_UNUSED(groupCountX);
@@ -226,6 +271,72 @@ void NullComputePassEncoder::DispatchIndirect(GPUBuffer indirectBuffer, uint64_t
     ALIMER_UNUSED(indirectBufferOffset);
 }
 
+/* NullBuffer */
+void NullBuffer::MapAsync(GPUBufferMapCallback callback, void* userData)
+{
+    // There is no GPU work to wait for.
+    mapState = GPUBufferMapState_Mapped;
+    if (callback)
+        callback(GPUMapAsyncStatus_Success, userData);
+}
+
+/* NullCopyPassEncoder */
+void NullCopyPassEncoder::EndEncoding()
+{
+    commandBuffer->encoderActive = false;
+}
+
+void NullCopyPassEncoder::PushDebugGroup(const char* groupLabel) const
+{
+    ALIMER_UNUSED(groupLabel);
+}
+
+void NullCopyPassEncoder::PopDebugGroup() const
+{}
+
+void NullCopyPassEncoder::InsertDebugMarker(const char* markerLabel) const
+{
+    ALIMER_UNUSED(markerLabel);
+}
+
+void NullCopyPassEncoder::CopyBufferToBuffer(GPUBuffer source, uint64_t sourceOffset, GPUBuffer destination, uint64_t destinationOffset, uint64_t size)
+{
+    ALIMER_UNUSED(source);
+    ALIMER_UNUSED(sourceOffset);
+    ALIMER_UNUSED(destination);
+    ALIMER_UNUSED(destinationOffset);
+    ALIMER_UNUSED(size);
+}
+
+void NullCopyPassEncoder::CopyBufferToTexture(const GPUTexelCopyBufferInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize)
+{
+    ALIMER_UNUSED(source);
+    ALIMER_UNUSED(destination);
+    ALIMER_UNUSED(copySize);
+}
+
+void NullCopyPassEncoder::CopyTextureToBuffer(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyBufferInfo& destination, const GPUExtent3D& copySize)
+{
+    ALIMER_UNUSED(source);
+    ALIMER_UNUSED(destination);
+    ALIMER_UNUSED(copySize);
+}
+
+void NullCopyPassEncoder::CopyTextureToTexture(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize)
+{
+    ALIMER_UNUSED(source);
+    ALIMER_UNUSED(destination);
+    ALIMER_UNUSED(copySize);
+}
+
+void NullCopyPassEncoder::FillBuffer(GPUBuffer buffer, uint64_t offset, uint64_t size, uint32_t value)
+{
+    ALIMER_UNUSED(buffer);
+    ALIMER_UNUSED(offset);
+    ALIMER_UNUSED(size);
+    ALIMER_UNUSED(value);
+}
+
 /* NullRenderPassEncoder */
 void NullRenderPassEncoder::EndEncoding()
 {
@@ -304,6 +415,12 @@ void NullRenderPassEncoder::SetPushConstants(uint32_t pushConstantIndex, const v
     ALIMER_UNUSED(size);
 }
 
+void NullRenderPassEncoder::SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup)
+{
+    ALIMER_UNUSED(groupIndex);
+    ALIMER_UNUSED(bindGroup);
+}
+
 void NullRenderPassEncoder::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
 {
     ALIMER_UNUSED(vertexCount);
@@ -406,6 +523,25 @@ GPURenderPassEncoder NullCommandBuffer::BeginRenderPass(const GPURenderPassDesc&
     return renderPassEncoder;
 }
 
+GPUCopyPassEncoder NullCommandBuffer::BeginCopyPass(const GPUCopyPassDesc& desc)
+{
+    ALIMER_UNUSED(desc);
+
+    if (encoderActive)
+    {
+        agpuLogError("CommandEncoder already active");
+        return nullptr;
+    }
+
+    encoderActive = true;
+    return copyPassEncoder;
+}
+
+void NullCommandBuffer::WaitUpload(GPUUploadTicket ticket)
+{
+    ALIMER_UNUSED(ticket);
+}
+
 /* D3D12Queue */
 GPUCommandBuffer NullCommandQueue::AcquireCommandBuffer(const GPUCommandBufferDesc* desc)
 {
@@ -422,6 +558,24 @@ void NullCommandQueue::Submit(uint32_t numCommandBuffers, GPUCommandBuffer* comm
     ALIMER_UNUSED(commandBuffers);
 }
 
+GPUUploadTicket NullCommandQueue::WriteBuffer(GPUBuffer buffer, uint64_t bufferOffset, const void* data, uint64_t size)
+{
+    ALIMER_UNUSED(buffer);
+    ALIMER_UNUSED(bufferOffset);
+    ALIMER_UNUSED(data);
+    ALIMER_UNUSED(size);
+    return 0;
+}
+
+GPUUploadTicket NullCommandQueue::WriteTexture(GPUTexture texture, uint32_t mipLevel, uint32_t arrayLayer, const GPUTextureData& data)
+{
+    ALIMER_UNUSED(texture);
+    ALIMER_UNUSED(mipLevel);
+    ALIMER_UNUSED(arrayLayer);
+    ALIMER_UNUSED(data);
+    return 0;
+}
+
 /* NullDevice */
 void NullDevice::GetLimits(GPUDeviceLimits* limits) const
 {
@@ -454,6 +608,12 @@ GPUBuffer NullDevice::CreateBuffer(const GPUBufferDesc& desc, const void* pIniti
 {
     NullBuffer* buffer = new NullBuffer();
     buffer->desc = desc;
+    if (desc.memoryType != GPUMemoryType_Private)
+    {
+        buffer->hostData.resize(desc.size);
+        if (pInitialData)
+            memcpy(buffer->hostData.data(), pInitialData, desc.size);
+    }
 
     return buffer;
 }
@@ -477,9 +637,18 @@ GPUSampler NullDevice::CreateSampler(const GPUSamplerDesc& desc)
 GPUBindGroupLayout NullDevice::CreateBindGroupLayout(const GPUBindGroupLayoutDesc& desc)
 {
     NullBindGroupLayout* layout = new NullBindGroupLayout();
+    layout->entries.assign(desc.entries, desc.entries + desc.entryCount);
     return layout;
 }
 
+GPUBindGroup NullDevice::CreateBindGroup(const GPUBindGroupDesc& desc)
+{
+    ALIMER_UNUSED(desc);
+
+    NullBindGroup* bindGroup = new NullBindGroup();
+    return bindGroup;
+}
+
 GPUPipelineLayout NullDevice::CreatePipelineLayout(const GPUPipelineLayoutDesc& desc)
 {
     NullPipelineLayout* layout = new NullPipelineLayout();
@@ -510,6 +679,20 @@ GPURenderPipeline NullDevice::CreateRenderPipeline(const GPURenderPipelineDesc&
     return pipeline;
 }
 
+GPUComputePipeline NullDevice::CreateComputePipelineAsync(const GPUComputePipelineDesc& desc, GPUComputePipeline fallback)
+{
+    ALIMER_UNUSED(fallback);
+
+    return CreateComputePipeline(desc);
+}
+
+GPURenderPipeline NullDevice::CreateRenderPipelineAsync(const GPURenderPipelineDesc& desc, GPURenderPipeline fallback)
+{
+    ALIMER_UNUSED(fallback);
+
+    return CreateRenderPipeline(desc);
+}
+
 GPUQueryHeap NullDevice::CreateQueryHeap(const GPUQueryHeapDesc& desc)
 {
     ALIMER_UNUSED(desc);
@@ -1125,6 +1125,9 @@ struct D3D12Buffer final : public GPUBufferImpl, public D3D12Resource
     ~D3D12Buffer() override;
     void SetLabel(const char* label) override;
     GPUDeviceAddress GetDeviceAddress() const override { return deviceAddress; }
+    void* GetMappedData() const override { return pMappedData; }
+    void MapAsync(GPUBufferMapCallback callback, void* userData) override;
+    void Unmap() override {}
 };
 
 struct D3D12Texture final : public GPUTextureImpl, public D3D12Resource
@@ -1158,6 +1161,15 @@ struct D3D12BindGroupLayout final : public GPUBindGroupLayoutImpl
     ~D3D12BindGroupLayout() override;
 };
 
+struct D3D12BindGroup final : public GPUBindGroupImpl
+{
+    D3D12Device* device = nullptr;
+    D3D12BindGroupLayout* layout = nullptr;
+    std::vector<GPUResource*> resources;
+
+    ~D3D12BindGroup() override;
+};
+
 struct D3D12PipelineLayout final : public GPUPipelineLayoutImpl
 {
     D3D12Device* device = nullptr;
@@ -1225,6 +1237,7 @@ struct D3D12ComputePassEncoder final : public GPUComputePassEncoderImpl
 
     void SetPipeline(GPUComputePipeline pipeline) override;
     void SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size) override;
+    void SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup) override;
     void PrepareDispatch();
     void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
     void DispatchIndirect(GPUBuffer indirectBuffer, uint64_t indirectBufferOffset) override;
@@ -1260,6 +1273,7 @@ struct D3D12RenderPassEncoder final : public GPURenderPassEncoderImpl
     void SetIndexBuffer(GPUBuffer buffer, GPUIndexType type, uint64_t offset) override;
     void SetPipeline(GPURenderPipeline pipeline) override;
     void SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size) override;
+    void SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup) override;
 
     void PrepareDraw();
     void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
@@ -1273,6 +1287,31 @@ struct D3D12RenderPassEncoder final : public GPURenderPassEncoderImpl
     void SetShadingRate(GPUShadingRate rate) override;
 };
 
+struct D3D12CopyPassEncoder final : public GPUCopyPassEncoderImpl
+{
+    D3D12CommandBuffer* commandBuffer = nullptr;
+    bool hasLabel = false;
+    bool hasBufferWrites = false;
+    std::vector<std::pair<const D3D12Texture*, TextureLayout>> textureTransitions;
+
+    void Clear();
+    void Begin(const GPUCopyPassDesc& desc);
+    void EndEncoding() override;
+    void PushDebugGroup(const char* groupLabel) const override;
+    void PopDebugGroup() const override;
+    void InsertDebugMarker(const char* markerLabel) const override;
+
+    void TransitionTexture(const D3D12Texture* texture, TextureLayout newLayout);
+    D3D12_TEXTURE_COPY_LOCATION GetTextureLocation(const GPUTexelCopyTextureInfo& info, uint32_t arrayLayer) const;
+    D3D12_TEXTURE_COPY_LOCATION GetBufferLocation(const GPUTexelCopyBufferInfo& info, const D3D12Texture* texture, const GPUExtent3D& copySize, uint32_t layerIndex) const;
+
+    void CopyBufferToBuffer(GPUBuffer source, uint64_t sourceOffset, GPUBuffer destination, uint64_t destinationOffset, uint64_t size) override;
+    void CopyBufferToTexture(const GPUTexelCopyBufferInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize) override;
+    void CopyTextureToBuffer(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyBufferInfo& destination, const GPUExtent3D& copySize) override;
+    void CopyTextureToTexture(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize) override;
+    void FillBuffer(GPUBuffer buffer, uint64_t offset, uint64_t size, uint32_t value) override;
+};
+
 struct D3D12CommandBuffer final : public GPUCommandBufferImpl
 {
     static constexpr uint32_t kMaxBarrierCount = 16;
@@ -1284,6 +1323,7 @@ struct D3D12CommandBuffer final : public GPUCommandBufferImpl
     bool encoderActive = false;
     D3D12ComputePassEncoder* computePassEncoder = nullptr;
     D3D12RenderPassEncoder* renderPassEncoder = nullptr;
+    D3D12CopyPassEncoder* copyPassEncoder = nullptr;
 
     std::vector<ID3D12CommandAllocator*> commandAllocators = {};
     ID3D12GraphicsCommandList6* commandList = nullptr;
@@ -1316,6 +1356,8 @@ struct D3D12CommandBuffer final : public GPUCommandBufferImpl
 
     GPUComputePassEncoder BeginComputePass(const GPUComputePassDesc& desc) override;
     GPURenderPassEncoder BeginRenderPass(const GPURenderPassDesc& desc) override;
+    GPUCopyPassEncoder BeginCopyPass(const GPUCopyPassDesc& desc) override;
+    void WaitUpload(GPUUploadTicket ticket) override;
     void FlushBindGroups(bool graphics);
 };
 
@@ -1342,6 +1384,8 @@ struct D3D12Queue final : public GPUCommandQueueImpl
     void WaitForFenceValue(uint64_t fenceValue);
     void WaitIdle() override;
     void Submit(uint32_t numCommandBuffers, GPUCommandBuffer* commandBuffers) override;
+    GPUUploadTicket WriteBuffer(GPUBuffer buffer, uint64_t bufferOffset, const void* data, uint64_t size) override;
+    GPUUploadTicket WriteTexture(GPUTexture texture, uint32_t mipLevel, uint32_t arrayLayer, const GPUTextureData& data) override;
 };
 
 struct D3D12UploadContext final
@@ -1365,11 +1409,14 @@ struct D3D12CopyAllocator final
     ID3D12CommandQueue* queue = nullptr;
     std::mutex locker;
     std::vector<D3D12UploadContext> freeList;
+    // Signaled after every submit, values are the upload tickets.
+    ID3D12Fence* uploadFence = nullptr;
+    uint64_t uploadFenceValue = 0;
 
     void Init(D3D12Device* device);
     void Shutdown();
     D3D12UploadContext Allocate(uint64_t size);
-    void Submit(D3D12UploadContext context);
+    uint64_t Submit(D3D12UploadContext context);
 };
 
 class D3D12DescriptorAllocator final
@@ -1606,6 +1653,19 @@ struct D3D12Device final : public GPUDeviceImpl
     uint32_t maxFramesInFlight = 0;
     uint64_t frameCount = 0;
     uint32_t frameIndex = 0;
+
+    /// Buffer map request, resolved once every queue fence reached the value submitted at request time.
+    struct MapRequest
+    {
+        D3D12Buffer* buffer;
+        uint32_t mapSerial;
+        uint64_t fenceValues[_GPUCommandQueueType_Count];
+        GPUBufferMapCallback callback;
+        void* userData;
+    };
+    std::mutex mapRequestsMutex;
+    std::vector<MapRequest> mapRequests;
+
     // Deletion queue objects
     std::mutex destroyMutex;
     std::deque<std::pair<D3D12MA::Allocation*, uint64_t>> deferredAllocations;
@@ -1623,6 +1683,12 @@ struct D3D12Device final : public GPUDeviceImpl
     GPUCommandQueue GetQueue(GPUCommandQueueType type) override;
     void WaitIdle() override;
     uint64_t CommitFrame() override;
+    void ProcessEvents() override;
+    void ResolveMapRequest(const MapRequest& request, bool aborted);
+
+    GPUUploadTicket FlushUploads() override;
+    bool IsUploadComplete(GPUUploadTicket ticket) override;
+    void WaitUpload(GPUUploadTicket ticket) override;
 
     ID3D12CommandSignature* CreateCommandSignature(D3D12_INDIRECT_ARGUMENT_TYPE type, uint32_t stride);
     void WriteShadingRateValue(GPUShadingRate rate, void* dest) const;
@@ -1630,16 +1696,21 @@ struct D3D12Device final : public GPUDeviceImpl
     void ProcessDeletionQueue(bool force);
 
     uint64_t GetTimestampFrequency() const override { return timestampFrequency; }
+    // TODO: Serialize through ID3D12PipelineLibrary
+    size_t GetPipelineCacheData(void*, size_t) override { return 0; }
 
     /* Resource creation */
     GPUBuffer CreateBuffer(const GPUBufferDesc& desc, const void* pInitialData) override;
     GPUTexture CreateTexture(const GPUTextureDesc& desc, const GPUTextureData* pInitialData) override;
     GPUSampler CreateSampler(const GPUSamplerDesc& desc) override;
     GPUBindGroupLayout CreateBindGroupLayout(const GPUBindGroupLayoutDesc& desc) override;
+    GPUBindGroup CreateBindGroup(const GPUBindGroupDesc& desc) override;
     GPUPipelineLayout CreatePipelineLayout(const GPUPipelineLayoutDesc& desc) override;
     GPUShaderModule CreateShaderModule(const GPUShaderModuleDesc* desc) override;
     GPUComputePipeline CreateComputePipeline(const GPUComputePipelineDesc& desc) override;
     GPURenderPipeline CreateRenderPipeline(const GPURenderPipelineDesc& desc) override;
+    GPUComputePipeline CreateComputePipelineAsync(const GPUComputePipelineDesc& desc, GPUComputePipeline fallback) override;
+    GPURenderPipeline CreateRenderPipelineAsync(const GPURenderPipelineDesc& desc, GPURenderPipeline fallback) override;
     GPUQueryHeap CreateQueryHeap(const GPUQueryHeapDesc& desc) override;
 };
 
@@ -1734,6 +1805,24 @@ void D3D12Buffer::SetLabel(const char* label)
     }
 }
 
+void D3D12Buffer::MapAsync(GPUBufferMapCallback callback, void* userData)
+{
+    D3D12Device::MapRequest request = {};
+    request.buffer = this;
+    request.mapSerial = mapSerial;
+    request.callback = callback;
+    request.userData = userData;
+    for (uint32_t i = 0; i < _GPUCommandQueueType_Count; ++i)
+    {
+        const D3D12Queue& queue = device->queues[i];
+        request.fenceValues[i] = queue.handle ? queue.nextFenceValue - 1 : 0;
+    }
+
+    AddRef();
+    std::scoped_lock lock(device->mapRequestsMutex);
+    device->mapRequests.push_back(request);
+}
+
 /* D3D12Texture */
 D3D12Texture::~D3D12Texture()
 {
@@ -1960,6 +2049,17 @@ D3D12BindGroupLayout::~D3D12BindGroupLayout()
 
 }
 
+/* D3D12BindGroup */
+D3D12BindGroup::~D3D12BindGroup()
+{
+    for (GPUResource* resource : resources)
+    {
+        resource->Release();
+    }
+    resources.clear();
+    SafeRelease(layout);
+}
+
 /* D3D12PipelineLayout */
 D3D12PipelineLayout::~D3D12PipelineLayout()
 {
@@ -2032,6 +2132,210 @@ void D3D12QueryHeap::SetLabel(const char* label)
     }
 }
 
+/* D3D12CopyPassEncoder */
+void D3D12CopyPassEncoder::Clear()
+{
+    hasBufferWrites = false;
+    textureTransitions.clear();
+}
+
+void D3D12CopyPassEncoder::Begin(const GPUCopyPassDesc& desc)
+{
+    if (desc.label)
+    {
+        PushDebugGroup(desc.label);
+        hasLabel = true;
+    }
+}
+
+void D3D12CopyPassEncoder::EndEncoding()
+{
+    if (hasBufferWrites && commandBuffer->device->features.EnhancedBarriersSupported())
+    {
+        D3D12_GLOBAL_BARRIER& barrier = commandBuffer->globalBarriers.emplace_back();
+        barrier.SyncBefore = D3D12_BARRIER_SYNC_COPY;
+        barrier.SyncAfter = D3D12_BARRIER_SYNC_ALL;
+        barrier.AccessBefore = D3D12_BARRIER_ACCESS_COPY_DEST;
+        barrier.AccessAfter = D3D12_BARRIER_ACCESS_COMMON;
+    }
+
+    for (auto it = textureTransitions.rbegin(); it != textureTransitions.rend(); ++it)
+    {
+        if (it->second == TextureLayout::Undefined)
+            continue;
+
+        commandBuffer->TextureBarrier(it->first, it->second);
+    }
+    commandBuffer->CommitBarriers();
+
+    if (hasLabel)
+    {
+        PopDebugGroup();
+    }
+
+    commandBuffer->encoderActive = false;
+    hasLabel = false;
+    Clear();
+}
+
+void D3D12CopyPassEncoder::PushDebugGroup(const char* groupLabel) const
+{
+    commandBuffer->PushDebugGroup(groupLabel);
+}
+
+void D3D12CopyPassEncoder::PopDebugGroup() const
+{
+    commandBuffer->PopDebugGroup();
+}
+
+void D3D12CopyPassEncoder::InsertDebugMarker(const char* markerLabel) const
+{
+    commandBuffer->InsertDebugMarker(markerLabel);
+}
+
+void D3D12CopyPassEncoder::TransitionTexture(const D3D12Texture* texture, TextureLayout newLayout)
+{
+    const TextureLayout previousLayout = texture->subResourcesStates[0];
+    if (previousLayout == newLayout)
+        return;
+
+    textureTransitions.push_back({ texture, previousLayout });
+    commandBuffer->TextureBarrier(texture, newLayout);
+}
+
+D3D12_TEXTURE_COPY_LOCATION D3D12CopyPassEncoder::GetTextureLocation(const GPUTexelCopyTextureInfo& info, uint32_t arrayLayer) const
+{
+    const D3D12Texture* texture = static_cast<const D3D12Texture*>(info.texture);
+    const uint32_t mipLevelCount = texture->desc.mipLevelCount;
+    const uint32_t arraySize = texture->numSubResources / mipLevelCount;
+    const uint32_t planeSlice = GetPlaneSlice(texture->dxgiFormat, info.aspect);
+
+    D3D12_TEXTURE_COPY_LOCATION location = {};
+    location.pResource = texture->handle;
+    location.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    location.SubresourceIndex = info.mipLevel + arrayLayer * mipLevelCount + planeSlice * mipLevelCount * arraySize;
+    return location;
+}
+
+D3D12_TEXTURE_COPY_LOCATION D3D12CopyPassEncoder::GetBufferLocation(const GPUTexelCopyBufferInfo& info, const D3D12Texture* texture, const GPUExtent3D& copySize, uint32_t layerIndex) const
+{
+    const GPUPixelFormatInfo formatInfo = agpuPixelFormatGetInfo(texture->desc.format);
+    const bool is3D = texture->desc.dimension == GPUTextureDimension_3D;
+    const uint32_t blockCountX = (copySize.width + formatInfo.blockWidth - 1) / formatInfo.blockWidth;
+    const uint32_t blockCountY = (copySize.height + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
+    const uint32_t rowPitch = info.bytesPerRow ? info.bytesPerRow : AlignUp(blockCountX * formatInfo.bytesPerBlock, (uint32_t)D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+    const uint32_t rowsPerImage = info.rowsPerImage ? info.rowsPerImage : blockCountY;
+
+    D3D12_TEXTURE_COPY_LOCATION location = {};
+    location.pResource = static_cast<D3D12Buffer*>(info.buffer)->handle;
+    location.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    location.PlacedFootprint.Offset = info.offset + uint64_t(layerIndex) * rowPitch * rowsPerImage;
+    location.PlacedFootprint.Footprint.Format = texture->dxgiFormat;
+    location.PlacedFootprint.Footprint.Width = copySize.width;
+    location.PlacedFootprint.Footprint.Height = rowsPerImage * formatInfo.blockHeight;
+    location.PlacedFootprint.Footprint.Depth = is3D ? copySize.depthOrArrayLayers : 1u;
+    location.PlacedFootprint.Footprint.RowPitch = rowPitch;
+    return location;
+}
+
+void D3D12CopyPassEncoder::CopyBufferToBuffer(GPUBuffer source, uint64_t sourceOffset, GPUBuffer destination, uint64_t destinationOffset, uint64_t size)
+{
+    D3D12Buffer* backendSource = static_cast<D3D12Buffer*>(source);
+    D3D12Buffer* backendDestination = static_cast<D3D12Buffer*>(destination);
+
+    commandBuffer->commandList->CopyBufferRegion(backendDestination->handle, destinationOffset, backendSource->handle, sourceOffset, size);
+    hasBufferWrites = true;
+}
+
+void D3D12CopyPassEncoder::CopyBufferToTexture(const GPUTexelCopyBufferInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize)
+{
+    const D3D12Texture* texture = static_cast<const D3D12Texture*>(destination.texture);
+    const bool is3D = texture->desc.dimension == GPUTextureDimension_3D;
+    TransitionTexture(texture, TextureLayout::CopyDest);
+    commandBuffer->CommitBarriers();
+
+    const uint32_t layerCount = is3D ? 1u : copySize.depthOrArrayLayers;
+    for (uint32_t layerIndex = 0; layerIndex < layerCount; ++layerIndex)
+    {
+        const D3D12_TEXTURE_COPY_LOCATION dst = GetTextureLocation(destination, is3D ? 0 : destination.origin.z + layerIndex);
+        const D3D12_TEXTURE_COPY_LOCATION src = GetBufferLocation(source, texture, copySize, layerIndex);
+        commandBuffer->commandList->CopyTextureRegion(&dst, destination.origin.x, destination.origin.y, is3D ? destination.origin.z : 0, &src, nullptr);
+    }
+}
+
+void D3D12CopyPassEncoder::CopyTextureToBuffer(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyBufferInfo& destination, const GPUExtent3D& copySize)
+{
+    const D3D12Texture* texture = static_cast<const D3D12Texture*>(source.texture);
+    const bool is3D = texture->desc.dimension == GPUTextureDimension_3D;
+    TransitionTexture(texture, TextureLayout::CopySource);
+    commandBuffer->CommitBarriers();
+
+    const uint32_t layerCount = is3D ? 1u : copySize.depthOrArrayLayers;
+    for (uint32_t layerIndex = 0; layerIndex < layerCount; ++layerIndex)
+    {
+        const D3D12_TEXTURE_COPY_LOCATION src = GetTextureLocation(source, is3D ? 0 : source.origin.z + layerIndex);
+        const D3D12_TEXTURE_COPY_LOCATION dst = GetBufferLocation(destination, texture, copySize, layerIndex);
+
+        D3D12_BOX box = {};
+        box.left = source.origin.x;
+        box.top = source.origin.y;
+        box.front = is3D ? source.origin.z : 0;
+        box.right = source.origin.x + copySize.width;
+        box.bottom = source.origin.y + copySize.height;
+        box.back = box.front + (is3D ? copySize.depthOrArrayLayers : 1u);
+        commandBuffer->commandList->CopyTextureRegion(&dst, 0, 0, 0, &src, &box);
+    }
+    hasBufferWrites = true;
+}
+
+void D3D12CopyPassEncoder::CopyTextureToTexture(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize)
+{
+    const D3D12Texture* backendSource = static_cast<const D3D12Texture*>(source.texture);
+    const D3D12Texture* backendDestination = static_cast<const D3D12Texture*>(destination.texture);
+    const bool srcIs3D = backendSource->desc.dimension == GPUTextureDimension_3D;
+    const bool dstIs3D = backendDestination->desc.dimension == GPUTextureDimension_3D;
+    TransitionTexture(backendSource, TextureLayout::CopySource);
+    TransitionTexture(backendDestination, TextureLayout::CopyDest);
+    commandBuffer->CommitBarriers();
+
+    const uint32_t layerCount = (srcIs3D || dstIs3D) ? 1u : copySize.depthOrArrayLayers;
+    for (uint32_t layerIndex = 0; layerIndex < layerCount; ++layerIndex)
+    {
+        const D3D12_TEXTURE_COPY_LOCATION src = GetTextureLocation(source, srcIs3D ? 0 : source.origin.z + layerIndex);
+        const D3D12_TEXTURE_COPY_LOCATION dst = GetTextureLocation(destination, dstIs3D ? 0 : destination.origin.z + layerIndex);
+
+        D3D12_BOX box = {};
+        box.left = source.origin.x;
+        box.top = source.origin.y;
+        box.front = srcIs3D ? source.origin.z : 0;
+        box.right = source.origin.x + copySize.width;
+        box.bottom = source.origin.y + copySize.height;
+        box.back = box.front + (srcIs3D ? copySize.depthOrArrayLayers : 1u);
+        commandBuffer->commandList->CopyTextureRegion(&dst, destination.origin.x, destination.origin.y, dstIs3D ? destination.origin.z : 0, &src, &box);
+    }
+}
+
+void D3D12CopyPassEncoder::FillBuffer(GPUBuffer buffer, uint64_t offset, uint64_t size, uint32_t value)
+{
+    // D3D12 has no transfer fill command; WriteBufferImmediate writes 32-bit values directly from the command list.
+    D3D12Buffer* backendBuffer = static_cast<D3D12Buffer*>(buffer);
+
+    constexpr uint32_t kMaxParamsPerCall = 64;
+    D3D12_WRITEBUFFERIMMEDIATE_PARAMETER params[kMaxParamsPerCall];
+    const uint64_t valueCount = size / sizeof(uint32_t);
+    for (uint64_t valueIndex = 0; valueIndex < valueCount; valueIndex += kMaxParamsPerCall)
+    {
+        const uint32_t count = (uint32_t)std::min<uint64_t>(kMaxParamsPerCall, valueCount - valueIndex);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            params[i].Dest = backendBuffer->deviceAddress + offset + (valueIndex + i) * sizeof(uint32_t);
+            params[i].Value = value;
+        }
+        commandBuffer->commandList->WriteBufferImmediate(count, params, nullptr);
+    }
+    hasBufferWrites = true;
+}
+
 /* D3D12ComputePassEncoder */
 void D3D12ComputePassEncoder::Clear()
 {
@@ -2087,6 +2391,13 @@ void D3D12ComputePassEncoder::SetPipeline(GPUComputePipeline pipeline)
     currentPipeline->AddRef();
 }
 
+void D3D12ComputePassEncoder::SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup)
+{
+    // TODO: Descriptor tables once root signatures are built from bind group layouts.
+    ALIMER_UNUSED(groupIndex);
+    ALIMER_UNUSED(bindGroup);
+}
+
 void D3D12ComputePassEncoder::SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size)
 {
     D3D12PipelineLayout* pipelineLayout = currentPipeline->layout;
@@ -2443,6 +2754,13 @@ void D3D12RenderPassEncoder::SetPipeline(GPURenderPipeline pipeline)
     currentPipeline->AddRef();
 }
 
+void D3D12RenderPassEncoder::SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup)
+{
+    // TODO: Descriptor tables once root signatures are built from bind group layouts.
+    ALIMER_UNUSED(groupIndex);
+    ALIMER_UNUSED(bindGroup);
+}
+
 void D3D12RenderPassEncoder::SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size)
 {
     D3D12PipelineLayout* pipelineLayout = currentPipeline->layout;
@@ -2585,6 +2903,7 @@ D3D12CommandBuffer::~D3D12CommandBuffer()
 
     delete computePassEncoder;
     delete renderPassEncoder;
+    delete copyPassEncoder;
 }
 
 void D3D12CommandBuffer::Clear()
@@ -2616,6 +2935,7 @@ void D3D12CommandBuffer::Begin(uint32_t frameIndex, const GPUCommandBufferDesc*
     //frameAllocators[frameIndex].Reset();
     computePassEncoder->Clear();
     renderPassEncoder->Clear();
+    copyPassEncoder->Clear();
     Clear();
 
     // Start the command list in a default state:
@@ -2960,6 +3280,25 @@ GPURenderPassEncoder D3D12CommandBuffer::BeginRenderPass(const GPURenderPassDesc
     return renderPassEncoder;
 }
 
+GPUCopyPassEncoder D3D12CommandBuffer::BeginCopyPass(const GPUCopyPassDesc& desc)
+{
+    if (encoderActive)
+    {
+        agpuLogError("CommandEncoder already active");
+        return nullptr;
+    }
+
+    copyPassEncoder->Begin(desc);
+    encoderActive = true;
+    return copyPassEncoder;
+}
+
+void D3D12CommandBuffer::WaitUpload(GPUUploadTicket ticket)
+{
+    // Every upload submit already makes all queues wait on the copy allocator queue.
+    ALIMER_UNUSED(ticket);
+}
+
 void D3D12CommandBuffer::FlushBindGroups(bool graphics)
 {
 
@@ -2980,6 +3319,8 @@ GPUCommandBuffer D3D12Queue::AcquireCommandBuffer(const GPUCommandBufferDesc* de
         commandBuffer->computePassEncoder->commandBuffer = commandBuffer;
         commandBuffer->renderPassEncoder = new D3D12RenderPassEncoder();
         commandBuffer->renderPassEncoder->commandBuffer = commandBuffer;
+        commandBuffer->copyPassEncoder = new D3D12CopyPassEncoder();
+        commandBuffer->copyPassEncoder->commandBuffer = commandBuffer;
         commandBuffer->commandAllocators.resize(device->maxFramesInFlight);
 
         D3D12_COMMAND_LIST_TYPE d3dCommandListType = ToD3D12(queueType);
@@ -3071,6 +3412,45 @@ void D3D12Queue::Submit(uint32_t numCommandBuffers, GPUCommandBuffer* commandBuf
     }
 }
 
+GPUUploadTicket D3D12Queue::WriteBuffer(GPUBuffer buffer, uint64_t bufferOffset, const void* data, uint64_t size)
+{
+    D3D12Buffer* backendBuffer = static_cast<D3D12Buffer*>(buffer);
+    if (backendBuffer->desc.memoryType == GPUMemoryType_Upload)
+    {
+        // Upload heap resources can't be copy destinations, the write is immediate and the caller
+        // guarantees the GPU no longer reads the range. Already visible once the latest upload completes.
+        memcpy(static_cast<uint8_t*>(backendBuffer->pMappedData) + bufferOffset, data, size);
+
+        std::scoped_lock lock(device->copyAllocator.locker);
+        return device->copyAllocator.uploadFenceValue;
+    }
+
+    D3D12UploadContext context = device->copyAllocator.Allocate(size);
+    memcpy(context.uploadBufferData, data, size);
+
+    context.commandList->CopyBufferRegion(
+        backendBuffer->handle,
+        bufferOffset,
+        context.uploadBuffer,
+        0,
+        size
+    );
+
+    return device->copyAllocator.Submit(context);
+}
+
+GPUUploadTicket D3D12Queue::WriteTexture(GPUTexture texture, uint32_t mipLevel, uint32_t arrayLayer, const GPUTextureData& data)
+{
+    ALIMER_UNUSED(texture);
+    ALIMER_UNUSED(mipLevel);
+    ALIMER_UNUSED(arrayLayer);
+    ALIMER_UNUSED(data);
+
+    // TODO: Texture uploads (initial data included) are not implemented yet.
+    agpuLogError("D3D12: WriteTexture is not implemented");
+    return 0;
+}
+
 /* D3D12CopyAllocator */
 void D3D12CopyAllocator::Init(D3D12Device* device_)
 {
@@ -3083,6 +3463,7 @@ void D3D12CopyAllocator::Init(D3D12Device* device_)
     queueDesc.NodeMask = 0;
     VHR(device->handle->CreateCommandQueue(&queueDesc, PPV_ARGS(queue)));
     VHR(queue->SetName(L"CopyAllocator"));
+    VHR(device->handle->CreateFence(0, D3D12_FENCE_FLAG_NONE, PPV_ARGS(uploadFence)));
 }
 
 void D3D12CopyAllocator::Shutdown()
@@ -3097,6 +3478,7 @@ void D3D12CopyAllocator::Shutdown()
         context.uploadBufferData = nullptr;
     }
 
+    SafeRelease(uploadFence);
     SafeRelease(queue);
 }
 
@@ -3170,20 +3552,21 @@ D3D12UploadContext D3D12CopyAllocator::Allocate(uint64_t size)
     return context;
 }
 
-void D3D12CopyAllocator::Submit(D3D12UploadContext context)
+uint64_t D3D12CopyAllocator::Submit(D3D12UploadContext context)
 {
-    locker.lock();
-    context.fenceValueSignaled++;
-    freeList.push_back(context);
-    locker.unlock();
-
     VHR(context.commandList->Close());
     ID3D12CommandList* commandLists[] = {
         context.commandList
     };
 
+    locker.lock();
+    context.fenceValueSignaled++;
     queue->ExecuteCommandLists(1, commandLists);
     VHR(queue->Signal(context.fence, context.fenceValueSignaled));
+    const uint64_t ticket = ++uploadFenceValue;
+    VHR(queue->Signal(uploadFence, ticket));
+    freeList.push_back(context);
+    locker.unlock();
 
     VHR(device->queues[GPUCommandQueueType_Graphics].handle->Wait(context.fence, context.fenceValueSignaled));
     VHR(device->queues[GPUCommandQueueType_Compute].handle->Wait(context.fence, context.fenceValueSignaled));
@@ -3192,6 +3575,8 @@ void D3D12CopyAllocator::Submit(D3D12UploadContext context)
     //{
     //    VHR(device->queues[GPUCommandQueueType_VideoDecode].handle->Wait(context.fence, context.fenceValueSignaled));
     //}
+
+    return ticket;
 }
 
 /* D3D12Device */
@@ -3203,6 +3588,13 @@ D3D12Device::~D3D12Device()
     // Shutdown copy allocator
     copyAllocator.Shutdown();
 
+    // Requests still pending never resolve, release the buffers before the deletion queue is flushed.
+    for (const MapRequest& request : mapRequests)
+    {
+        ResolveMapRequest(request, true);
+    }
+    mapRequests.clear();
+
     // Shutdown descriptor heap allocators
     renderTargetViewHeap.Shutdown();
     depthStencilViewHeap.Shutdown();
@@ -3336,6 +3728,27 @@ void D3D12Device::WaitIdle()
     ProcessDeletionQueue(true);
 }
 
+GPUUploadTicket D3D12Device::FlushUploads()
+{
+    // Uploads are submitted immediately, nothing is batched.
+    std::scoped_lock lock(copyAllocator.locker);
+    return copyAllocator.uploadFenceValue;
+}
+
+bool D3D12Device::IsUploadComplete(GPUUploadTicket ticket)
+{
+    return copyAllocator.uploadFence->GetCompletedValue() >= ticket;
+}
+
+void D3D12Device::WaitUpload(GPUUploadTicket ticket)
+{
+    if (ticket <= copyAllocator.uploadFenceValue &&
+        copyAllocator.uploadFence->GetCompletedValue() < ticket)
+    {
+        VHR(copyAllocator.uploadFence->SetEventOnCompletion(ticket, nullptr));
+    }
+}
+
 uint64_t D3D12Device::CommitFrame()
 {
     // Mark the completion of queues for this frame:
@@ -3373,10 +3786,56 @@ uint64_t D3D12Device::CommitFrame()
     }
 
     ProcessDeletionQueue(false);
+    ProcessEvents();
 
     return frameCount;
 }
 
+void D3D12Device::ProcessEvents()
+{
+    std::vector<MapRequest> completedRequests;
+    {
+        std::scoped_lock lock(mapRequestsMutex);
+        if (mapRequests.empty())
+            return;
+
+        auto it = std::partition(mapRequests.begin(), mapRequests.end(), [&](const MapRequest& request) {
+            for (uint32_t i = 0; i < _GPUCommandQueueType_Count; ++i)
+            {
+                if (queues[i].handle && !queues[i].IsFenceComplete(request.fenceValues[i]))
+                    return true;
+            }
+            return false;
+            });
+        completedRequests.assign(it, mapRequests.end());
+        mapRequests.erase(it, mapRequests.end());
+    }
+
+    // Callbacks run outside the lock so they can issue new map requests.
+    for (const MapRequest& request : completedRequests)
+    {
+        ResolveMapRequest(request, false);
+    }
+}
+
+void D3D12Device::ResolveMapRequest(const MapRequest& request, bool aborted)
+{
+    // Readback and upload heaps are persistently mapped and coherent, only the state changes.
+    D3D12Buffer* buffer = request.buffer;
+    GPUMapAsyncStatus status = GPUMapAsyncStatus_Aborted;
+    if (buffer->mapSerial == request.mapSerial && buffer->mapState == GPUBufferMapState_Pending)
+    {
+        buffer->mapState = aborted ? GPUBufferMapState_Unmapped : GPUBufferMapState_Mapped;
+        status = aborted ? GPUMapAsyncStatus_Aborted : GPUMapAsyncStatus_Success;
+    }
+
+    if (request.callback)
+    {
+        request.callback(status, request.userData);
+    }
+    buffer->Release();
+}
+
 ID3D12CommandSignature* D3D12Device::CreateCommandSignature(D3D12_INDIRECT_ARGUMENT_TYPE type, uint32_t stride)
 {
     D3D12_INDIRECT_ARGUMENT_DESC argumentDesc{};
@@ -3820,10 +4279,39 @@ GPUBindGroupLayout D3D12Device::CreateBindGroupLayout(const GPUBindGroupLayoutDe
 {
     D3D12BindGroupLayout* layout = new D3D12BindGroupLayout();
     layout->device = this;
+    layout->entries.assign(desc.entries, desc.entries + desc.entryCount);
 
     return layout;
 }
 
+GPUBindGroup D3D12Device::CreateBindGroup(const GPUBindGroupDesc& desc)
+{
+    D3D12BindGroup* bindGroup = new D3D12BindGroup();
+    bindGroup->device = this;
+    bindGroup->layout = static_cast<D3D12BindGroupLayout*>(desc.layout);
+    bindGroup->layout->AddRef();
+
+    for (uint32_t i = 0; i < desc.entryCount; ++i)
+    {
+        const GPUBindGroupEntry& entry = desc.entries[i];
+        GPUResource* resource = nullptr;
+        if (entry.buffer != nullptr)
+            resource = entry.buffer;
+        else if (entry.texture != nullptr)
+            resource = entry.texture;
+        else if (entry.sampler != nullptr)
+            resource = entry.sampler;
+
+        if (resource != nullptr)
+        {
+            resource->AddRef();
+            bindGroup->resources.push_back(resource);
+        }
+    }
+
+    return bindGroup;
+}
+
 GPUPipelineLayout D3D12Device::CreatePipelineLayout(const GPUPipelineLayoutDesc& desc)
 {
     D3D12PipelineLayout* layout = new D3D12PipelineLayout();
@@ -4210,6 +4698,22 @@ GPURenderPipeline D3D12Device::CreateRenderPipeline(const GPURenderPipelineDesc&
     return pipeline;
 }
 
+GPUComputePipeline D3D12Device::CreateComputePipelineAsync(const GPUComputePipelineDesc& desc, GPUComputePipeline fallback)
+{
+    // TODO: Compile on a worker thread, for now the pipeline is created synchronously and is always ready
+    ALIMER_UNUSED(fallback);
+
+    return CreateComputePipeline(desc);
+}
+
+GPURenderPipeline D3D12Device::CreateRenderPipelineAsync(const GPURenderPipelineDesc& desc, GPURenderPipeline fallback)
+{
+    // TODO: Compile on a worker thread, for now the pipeline is created synchronously and is always ready
+    ALIMER_UNUSED(fallback);
+
+    return CreateRenderPipeline(desc);
+}
+
 GPUQueryHeap D3D12Device::CreateQueryHeap(const GPUQueryHeapDesc& desc)
 {
     D3D12_QUERY_HEAP_DESC d3dDesc = {};
@@ -25,6 +25,8 @@ ALIMER_ENABLE_WARNINGS()
 #include <vector>
 #include <deque>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #if defined(_DEBUG)
 /// Helper macro to test the result of Vulkan calls which can return an error.
@@ -873,6 +875,48 @@ namespace
         }
     }
 
+    [[nodiscard]] constexpr VkDescriptorType ToVkDescriptorType(GPUBindingType type)
+    {
+        switch (type)
+        {
+            case GPUBindingType_ConstantBuffer:
+                return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            case GPUBindingType_ReadOnlyStorageBuffer:
+            case GPUBindingType_StorageBuffer:
+                return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            case GPUBindingType_SampledTexture:
+                return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            case GPUBindingType_StorageTexture:
+                return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            case GPUBindingType_Sampler:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+
+            default:
+                ALIMER_UNREACHABLE();
+        }
+    }
+
+    /// Binding shift per HLSL register class, must match the -fvk-{b,t,u,s}-shift values used by the shader compiler (VulkanRegisterShift).
+    [[nodiscard]] constexpr uint32_t GetVkBindingShift(GPUBindingType type)
+    {
+        switch (type)
+        {
+            case GPUBindingType_ConstantBuffer:
+                return 0;
+            case GPUBindingType_ReadOnlyStorageBuffer:
+            case GPUBindingType_SampledTexture:
+                return 1000;
+            case GPUBindingType_StorageBuffer:
+            case GPUBindingType_StorageTexture:
+                return 2000;
+            case GPUBindingType_Sampler:
+                return 3000;
+
+            default:
+                ALIMER_UNREACHABLE();
+        }
+    }
+
     struct VkImageLayoutMapping final
     {
         VkImageLayout layout;
@@ -999,6 +1043,69 @@ namespace
                 ALIMER_UNREACHABLE();
         }
     }
+
+    /// Cache data from another vendor, device or driver build (pipelineCacheUUID) is rejected up front instead of relying on the driver.
+    bool IsPipelineCacheCompatible(const void* data, size_t dataSize, const VkPhysicalDeviceProperties& properties)
+    {
+        if (data == nullptr || dataSize < sizeof(VkPipelineCacheHeaderVersionOne))
+            return false;
+
+        VkPipelineCacheHeaderVersionOne header;
+        memcpy(&header, data, sizeof(header));
+        return header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne)
+            && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && header.vendorID == properties.vendorID
+            && header.deviceID == properties.deviceID
+            && memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+    std::vector<uint8_t> ReadPipelineCacheFile(const char* path)
+    {
+        std::vector<uint8_t> data;
+        FILE* file = fopen(path, "rb");
+        if (file == nullptr)
+            return data;
+
+        if (fseek(file, 0, SEEK_END) == 0)
+        {
+            const long size = ftell(file);
+            if (size > 0 && fseek(file, 0, SEEK_SET) == 0)
+            {
+                data.resize(static_cast<size_t>(size));
+                if (fread(data.data(), 1, data.size(), file) != data.size())
+                    data.clear();
+            }
+        }
+
+        fclose(file);
+        return data;
+    }
+
+    /// Pipeline library keys are the raw bytes of the state each part consumes, values are appended field by field to avoid struct padding.
+    template<typename T>
+    void AppendPipelineLibraryKey(std::string& key, const T& value)
+    {
+        key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    constexpr VkGraphicsPipelineLibraryFlagsEXT GetDynamicStateLibraryParts(VkDynamicState state)
+    {
+        switch (state)
+        {
+            case VK_DYNAMIC_STATE_VIEWPORT:
+            case VK_DYNAMIC_STATE_SCISSOR:
+                return VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+            case VK_DYNAMIC_STATE_STENCIL_REFERENCE:
+            case VK_DYNAMIC_STATE_DEPTH_BOUNDS:
+                return VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+            case VK_DYNAMIC_STATE_BLEND_CONSTANTS:
+                return VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+            case VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR:
+                return VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+            default:
+                return 0;
+        }
+    }
 }
 
 // Declare function pointers
@@ -1068,6 +1175,7 @@ struct VulkanPhysicalDeviceExtensions final
     bool unifiedImageLayouts;
     bool mutableDescriptorType;
     bool descriptorHeap;
+    bool graphicsPipelineLibrary;
 
     struct
     {
@@ -1128,6 +1236,9 @@ struct VulkanBuffer final : public GPUBufferImpl
     ~VulkanBuffer() override;
     void SetLabel(const char* label) override;
     GPUDeviceAddress GetDeviceAddress() const override { return deviceAddress; }
+    void* GetMappedData() const override { return pMappedData; }
+    void MapAsync(GPUBufferMapCallback callback, void* userData) override;
+    void Unmap() override;
 };
 
 struct VulkanTexture final : public GPUTextureImpl
@@ -1138,11 +1249,27 @@ struct VulkanTexture final : public GPUTextureImpl
     VmaAllocation allocation = nullptr;
     uint32_t numSubResources = 0;
     mutable std::vector<TextureLayout> imageLayouts;
+    /// Views are created on first use, bind groups may request them from any thread.
+    mutable std::mutex viewsMutex;
     mutable std::unordered_map<size_t, VkImageView> views;
+#if defined(_DEBUG)
+    /// Layout changes recorded by command buffers which have not been submitted yet.
+    mutable std::atomic<uint32_t> unsubmittedLayoutChanges{ 0 };
+#endif
 
     ~VulkanTexture() override;
     void SetLabel(const char* label) override;
-    VkImageView GetView(uint32_t mipLevel) const;
+    /// Storage views cover a single mip level and expose cube faces as a 2D array.
+    VkImageView GetView(uint32_t mipLevel, bool storage = false) const;
+    /// Image array layers: one for 3D textures, six faces per cube.
+    uint32_t GetArrayLayerCount() const
+    {
+        if (desc.dimension == GPUTextureDimension_3D)
+            return 1u;
+        if (desc.dimension == GPUTextureDimension_Cube)
+            return desc.depthOrArrayLayers * 6u;
+        return desc.depthOrArrayLayers;
+    }
 };
 
 struct VulkanSampler final : public GPUSamplerImpl
@@ -1158,16 +1285,34 @@ struct VulkanBindGroupLayout final : public GPUBindGroupLayoutImpl
 {
     VulkanDevice* device = nullptr;
     VkDescriptorSetLayout handle = VK_NULL_HANDLE;
+    size_t hash = 0;
 
     ~VulkanBindGroupLayout() override;
     void SetLabel(const char* label) override;
 };
 
+struct VulkanBindGroup final : public GPUBindGroupImpl
+{
+    VulkanDevice* device = nullptr;
+    VulkanBindGroupLayout* layout = nullptr;
+    std::vector<VkDescriptorBufferInfo> bufferInfos;
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    /// Descriptor writes with dstSet left empty, patched when a set is allocated at bind time.
+    std::vector<VkWriteDescriptorSet> writes;
+    std::vector<std::pair<VulkanTexture*, TextureLayout>> textures;
+    std::vector<GPUResource*> resources;
+
+    ~VulkanBindGroup() override;
+};
+
 struct VulkanPipelineLayout final : public GPUPipelineLayoutImpl
 {
     VulkanDevice* device = nullptr;
+    uint64_t uniqueId = 0;
     VkPipelineLayout handle = VK_NULL_HANDLE;
+    std::vector<VulkanBindGroupLayout*> bindGroupLayouts;
     std::vector<VkPushConstantRange> pushConstantRanges;
+    bool bindless = false;
 
     ~VulkanPipelineLayout() override;
     void SetLabel(const char* label) override;
@@ -1176,6 +1321,8 @@ struct VulkanPipelineLayout final : public GPUPipelineLayoutImpl
 struct VulkanShaderModule final : public GPUShaderModuleImpl
 {
     VulkanDevice* device = nullptr;
+    /// Never reused unlike the handle, identifies the module in pipeline library keys.
+    uint64_t uniqueId = 0;
     std::string entryPoint;
     VkPipelineShaderStageCreateInfo stageInfo = {};
 
@@ -1188,6 +1335,8 @@ struct VulkanComputePipeline final : public GPUComputePipelineImpl
     VulkanDevice* device = nullptr;
     VulkanPipelineLayout* layout = nullptr;
     VkPipeline handle = VK_NULL_HANDLE;
+    /// Bound in place of this pipeline while it is compiled asynchronously
+    VulkanComputePipeline* fallback = nullptr;
 
     ~VulkanComputePipeline() override;
     void SetLabel(const char* label) override;
@@ -1198,9 +1347,44 @@ struct VulkanRenderPipeline final : public GPURenderPipelineImpl
     VulkanDevice* device = nullptr;
     VulkanPipelineLayout* layout = nullptr;
     VkPipeline handle = VK_NULL_HANDLE;
+    /// Bound in place of this pipeline while it is compiled asynchronously
+    VulkanRenderPipeline* fallback = nullptr;
+    /// Link time optimized version of a fast-linked pipeline, built in the background
+    VkPipeline optimizedHandle = VK_NULL_HANDLE;
+    std::atomic<bool> optimized{ false };
 
     ~VulkanRenderPipeline() override;
     void SetLabel(const char* label) override;
+    VkPipeline GetHandle() const { return optimized.load(std::memory_order_acquire) ? optimizedHandle : handle; }
+};
+
+/// Graphics pipeline state translated from GPURenderPipelineDesc, owns everything createInfo points to so the pipeline can be created on another thread.
+struct VulkanRenderPipelineState final
+{
+    std::vector<VulkanShaderModule*> shaderModules;
+    std::vector<VkPipelineShaderStageCreateInfo> stages;
+    std::vector<VkVertexInputBindingDescription> vertexBindings;
+    std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+    VkPipelineVertexInputStateCreateInfo vertexInputState = {};
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {};
+    VkPipelineViewportStateCreateInfo viewportState = {};
+    VkPipelineRasterizationStateCreateInfo rasterizationState = {};
+    VkPipelineRasterizationDepthClipStateCreateInfoEXT depthClipStateInfo = {};
+    VkPipelineRasterizationConservativeStateCreateInfoEXT rasterizationConservativeState = {};
+    VkPipelineMultisampleStateCreateInfo multisampleState = {};
+    VkPipelineDepthStencilStateCreateInfo depthStencilState = {};
+    VkPipelineRenderingCreateInfo renderingInfo = {};
+    VkFormat colorAttachmentFormats[GPU_MAX_COLOR_ATTACHMENTS] = {};
+    VkPipelineColorBlendStateCreateInfo blendState = {};
+    VkPipelineColorBlendAttachmentState blendAttachmentStates[GPU_MAX_COLOR_ATTACHMENTS] = {};
+    VkGraphicsPipelineCreateInfo createInfo = {};
+
+    VulkanRenderPipelineState() = default;
+    VulkanRenderPipelineState(const VulkanRenderPipelineState&) = delete;
+    VulkanRenderPipelineState& operator=(const VulkanRenderPipelineState&) = delete;
+    ~VulkanRenderPipelineState();
+
+    void Init(VulkanDevice* device, const GPURenderPipelineDesc& desc, VkPipelineLayout layout);
 };
 
 struct VulkanQueryHeap final : public GPUQueryHeapImpl
@@ -1228,6 +1412,7 @@ struct VulkanComputePassEncoder final : public GPUComputePassEncoderImpl
 
     void SetPipeline(GPUComputePipeline pipeline) override;
     void SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size) override;
+    void SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup) override;
     void PrepareDispatch();
     void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
     void DispatchIndirect(GPUBuffer indirectBuffer, uint64_t indirectBufferOffset) override;
@@ -1258,6 +1443,7 @@ struct VulkanRenderPassEncoder final : public GPURenderPassEncoderImpl
     void SetIndexBuffer(GPUBuffer buffer, GPUIndexType type, uint64_t offset) override;
     void SetPipeline(GPURenderPipeline pipeline) override;
     void SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size) override;
+    void SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup) override;
 
     void PrepareDraw();
     void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
@@ -1271,10 +1457,66 @@ struct VulkanRenderPassEncoder final : public GPURenderPassEncoderImpl
     void SetShadingRate(GPUShadingRate rate) override;
 };
 
+struct VulkanCopyPassEncoder final : public GPUCopyPassEncoderImpl
+{
+    struct TextureTransition
+    {
+        const VulkanTexture* texture;
+        uint32_t mipLevel;
+        uint32_t baseArrayLayer;
+        uint32_t layerCount;
+        GPUTextureAspect aspect;
+        TextureLayout previousLayout;
+    };
+
+    VulkanCommandBuffer* commandBuffer = nullptr;
+    bool hasLabel = false;
+    bool hasBufferWrites = false;
+    std::vector<TextureTransition> textureTransitions;
+
+    void Clear();
+    void Begin(const GPUCopyPassDesc& desc);
+    void EndEncoding() override;
+    void PushDebugGroup(const char* groupLabel) const override;
+    void PopDebugGroup() const override;
+    void InsertDebugMarker(const char* markerLabel) const override;
+
+    void TransitionTexture(const GPUTexelCopyTextureInfo& info, uint32_t depthOrArrayLayers, TextureLayout newLayout, VkImageSubresourceLayers& subresource);
+    VkBufferImageCopy GetBufferImageCopy(const GPUTexelCopyBufferInfo& bufferInfo, const GPUTexelCopyTextureInfo& textureInfo, const GPUExtent3D& copySize, const VkImageSubresourceLayers& subresource) const;
+
+    void CopyBufferToBuffer(GPUBuffer source, uint64_t sourceOffset, GPUBuffer destination, uint64_t destinationOffset, uint64_t size) override;
+    void CopyBufferToTexture(const GPUTexelCopyBufferInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize) override;
+    void CopyTextureToBuffer(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyBufferInfo& destination, const GPUExtent3D& copySize) override;
+    void CopyTextureToTexture(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize) override;
+    void FillBuffer(GPUBuffer buffer, uint64_t offset, uint64_t size, uint32_t value) override;
+};
+
+/// Per-frame descriptor pools of a command buffer, sets are never freed one by one but reset in bulk when the frame slot is reused.
+struct VulkanDescriptorAllocator final
+{
+    static constexpr uint32_t kMaxSetsPerPool = 256;
+
+    VulkanDevice* device = nullptr;
+    std::vector<VkDescriptorPool> pools;
+    uint32_t currentPool = 0;
+
+    void Shutdown();
+    void Reset();
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+};
+
 struct VulkanCommandBuffer final : public GPUCommandBufferImpl
 {
     static constexpr uint32_t kMaxBarrierCount = 16;
 
+    struct PassTexture
+    {
+        const VulkanTexture* texture;
+        uint32_t baseMipLevel;
+        uint32_t levelCount;
+        uint32_t layerCount;
+    };
+
     VulkanDevice* device = nullptr;
     VulkanQueue* queue = nullptr;
     uint32_t index = 0;
@@ -1282,16 +1524,30 @@ struct VulkanCommandBuffer final : public GPUCommandBufferImpl
     bool encoderActive = false;
     VulkanComputePassEncoder* computePassEncoder = nullptr;
     VulkanRenderPassEncoder* renderPassEncoder = nullptr;
+    VulkanCopyPassEncoder* copyPassEncoder = nullptr;
 
     std::vector<VkCommandPool> commandPools = {};
     std::vector<VkCommandBuffer> commandBuffers = {};
+    std::vector<VulkanDescriptorAllocator> descriptorAllocators = {};
+    uint32_t frameIndex = 0;
     VkCommandBuffer handle = VK_NULL_HANDLE;
     uint32_t numBarriersToCommit = 0;
     std::vector<VkMemoryBarrier2> memoryBarriers;
     std::vector<VkImageMemoryBarrier2> imageBarriers;
     std::vector<VkBufferMemoryBarrier2> bufferBarriers;
     VulkanPipelineLayout* currentPipelineLayout = nullptr;
+    VulkanBindGroup* bindGroups[GPU_MAX_BIND_GROUPS] = {};
+    uint32_t dirtyBindGroups = 0;
+    /// Descriptor sets written during this recording, a bind group bound again reuses its set.
+    std::unordered_map<VulkanBindGroup*, VkDescriptorSet> descriptorSets;
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
     std::vector<VulkanSurface*> presentSurfaces;
+    uint64_t uploadWaitValue = 0;
+    /// Subresources the current render or compute pass moved out of ShaderResource, restored by RestorePassTextures.
+    std::vector<PassTexture> passTextures;
+#if defined(_DEBUG)
+    std::vector<const VulkanTexture*> layoutChangedTextures;
+#endif
 
     ~VulkanCommandBuffer() override;
     void Clear();
@@ -1299,9 +1555,16 @@ struct VulkanCommandBuffer final : public GPUCommandBufferImpl
     VkCommandBuffer End();
 
     void TextureBarrier(const VulkanTexture* texture, TextureLayout newLayout, uint32_t baseMiplevel, uint32_t levelCount, uint32_t baseArrayLayer, uint32_t layerCount, GPUTextureAspect aspect = GPUTextureAspect_All);
+    void GlobalBarrier(VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
     void CommitBarriers();
-    void SetPipelineLayout(VulkanPipelineLayout* newPipelineLayout);
+    void SetPipelineLayout(VulkanPipelineLayout* newPipelineLayout, VkPipelineBindPoint bindPoint);
     void SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size);
+    void SetBindGroup(uint32_t groupIndex, VulkanBindGroup* bindGroup);
+    void ResetBindGroups();
+    void FlushBindGroups(VkPipelineBindPoint bindPoint);
+    VkDescriptorSet GetDescriptorSet(VulkanBindGroup* bindGroup);
+    void PassTextureBarrier(const VulkanTexture* texture, TextureLayout newLayout, uint32_t baseMiplevel, uint32_t levelCount, uint32_t layerCount);
+    void RestorePassTextures();
 
     GPUAcquireSurfaceResult AcquireSurfaceTexture(GPUSurface surface, GPUTexture* surfaceTexture) override;
     void PushDebugGroup(const char* groupLabel) const override;
@@ -1310,6 +1573,8 @@ struct VulkanCommandBuffer final : public GPUCommandBufferImpl
 
     GPUComputePassEncoder BeginComputePass(const GPUComputePassDesc& desc) override;
     GPURenderPassEncoder BeginRenderPass(const GPURenderPassDesc& desc) override;
+    GPUCopyPassEncoder BeginCopyPass(const GPUCopyPassDesc& desc) override;
+    void WaitUpload(GPUUploadTicket ticket) override;
 };
 
 struct VulkanQueue final : public GPUCommandQueueImpl
@@ -1319,6 +1584,10 @@ struct VulkanQueue final : public GPUCommandQueueImpl
     VkQueue handle = VK_NULL_HANDLE;
     std::vector<VkFence> frameFences = {};
     std::mutex mutex;
+    /// Timeline signaled by every command buffer submit, submitValue is the last signaled value.
+    /// Submissions and submitValue increments happen under mutex, readers may load it without the lock.
+    VkSemaphore submitSemaphore = VK_NULL_HANDLE;
+    std::atomic<uint64_t> submitValue{ 0 };
 
     std::vector<VulkanCommandBuffer*> commandBuffers;
     uint32_t cmdBuffersCount = 0;
@@ -1330,42 +1599,147 @@ struct VulkanQueue final : public GPUCommandQueueImpl
     GPUCommandBuffer AcquireCommandBuffer(const GPUCommandBufferDesc* desc) override;
     void Submit(uint32_t numCommandBuffers, GPUCommandBuffer* commandBuffers) override;
     void Submit(VkFence fence);
+    GPUUploadTicket WriteBuffer(GPUBuffer buffer, uint64_t bufferOffset, const void* data, uint64_t size) override;
+    GPUUploadTicket WriteTexture(GPUTexture texture, uint32_t mipLevel, uint32_t arrayLayer, const GPUTextureData& data) override;
 };
 
 struct VulkanUploadContext final
 {
-    VkCommandPool transferCommandPool = VK_NULL_HANDLE;
     VkCommandBuffer transferCommandBuffer = VK_NULL_HANDLE;
-    VkCommandPool transitionCommandPool = VK_NULL_HANDLE;
     VkCommandBuffer transitionCommandBuffer = VK_NULL_HANDLE;
-    VkFence fence = VK_NULL_HANDLE;
-    VkSemaphore semaphores[3] = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE }; // graphics, compute, video
     VulkanBuffer* uploadBuffer = nullptr;
+    uint64_t uploadBufferOffset = 0;
     void* uploadBufferData = nullptr;
-    uint64_t uploadBufferSize = 0;
 
     inline bool IsValid() const { return transferCommandBuffer != VK_NULL_HANDLE; }
 };
 
+/// Uploads recorded between two flushes, retired once the timeline semaphore reaches timelineValue.
+struct VulkanUploadBatch final
+{
+    VkCommandPool transferCommandPool = VK_NULL_HANDLE;
+    VkCommandBuffer transferCommandBuffer = VK_NULL_HANDLE;
+    VkCommandPool transitionCommandPool = VK_NULL_HANDLE;
+    VkCommandBuffer transitionCommandBuffer = VK_NULL_HANDLE;
+    uint64_t timelineValue = 0;
+    uint64_t ringEnd = 0;
+    bool hasTransitions = false;
+    /// Submit value of each queue the copies must wait for, zero when the batch does not depend on the queue.
+    uint64_t queueWaitValues[_GPUCommandQueueType_Count] = {};
+    std::vector<VulkanBuffer*> stagingBuffers;
+};
+
+/// Persistent mapped upload ring, linearly suballocated and batched into one copy queue submission per flush.
 struct VulkanCopyAllocator final
 {
+    static constexpr uint64_t kRingSize = 64u * 1024u * 1024u;
+    static constexpr uint64_t kMaxRingAllocationSize = kRingSize / 4;
+
     VulkanDevice* device = nullptr;
     std::mutex locker;
-    std::vector<VulkanUploadContext> freeList;
+    VulkanBuffer* ringBuffer = nullptr;
+    uint8_t* ringData = nullptr;
+    uint64_t ringHead = 0;
+    uint64_t ringTail = 0;
+    VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+    uint64_t submittedValue = 0;
+    bool lastBatchHasTransitions = false;
+    VulkanUploadBatch* currentBatch = nullptr;
+    std::deque<VulkanUploadBatch*> pendingBatches;
+    std::vector<VulkanUploadBatch*> freeBatches;
 
     void Init(VulkanDevice* device);
     void Shutdown();
-    VulkanUploadContext Allocate(uint64_t size);
-    void Submit(VulkanUploadContext context);
+    /// Reserves staging memory and returns with the allocator locked, Submit must follow.
+    /// Without transitions the batch may complete on the copy queue alone.
+    /// The copies wait for the work already submitted to dependency, which may still use the destination.
+    VulkanUploadContext Allocate(uint64_t size, uint64_t alignment = 16, bool transitions = true, const VulkanQueue* dependency = nullptr);
+    /// Returns the timeline value signaled once the batch holding the context completes.
+    uint64_t Submit(VulkanUploadContext context);
+    /// Submits recorded uploads and returns the last timeline value signaled by an upload batch.
+    uint64_t Flush();
+    bool IsComplete(uint64_t value);
+    void Wait(uint64_t value);
+
+private:
+    VulkanQueue* GetTransferQueue() const;
+    VulkanUploadBatch* AcquireBatch();
+    void Retire(bool wait);
+    uint64_t FlushLocked();
+};
+
+/// Global descriptor array of one type, slots are handed out from a lock-free free list.
+struct VulkanBindlessHeap final
+{
+    static constexpr uint32_t kEndOfList = ~0u;
+
+    VulkanDevice* device = nullptr;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+    uint32_t capacity = 0;
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    /// vkUpdateDescriptorSets requires external synchronization of the set.
+    std::mutex updateMutex;
+    /// Free slots form a linked stack, the head keeps an ABA tag in its upper 32 bits.
+    std::vector<std::atomic<uint32_t>> next;
+    std::atomic<uint64_t> freeHead{ kEndOfList };
+
+    bool Init(VulkanDevice* device, VkDescriptorType type, uint32_t capacity);
+    void Shutdown();
+    GPUBindlessIndex Allocate();
+    /// Returns the slot to the free list, callers defer this until frames referencing it completed.
+    void Free(GPUBindlessIndex index);
+    void Write(GPUBindlessIndex index, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo);
 };
 
 struct VulkanBindlessManager final
 {
+    /// Descriptor set numbers, must match AlimerBindless.hlsli
+    static constexpr uint32_t kSamplerSet = 1;
+    static constexpr uint32_t kSampledImageSet = 2;
+    static constexpr uint32_t kStorageImageSet = 3;
+    static constexpr uint32_t kStorageBufferSet = 4;
+    static constexpr uint32_t kSetCount = 4;
+    static constexpr uint32_t kMaxSamplers = 2048;
+    static constexpr uint32_t kMaxSampledImages = 65536;
+    static constexpr uint32_t kMaxStorageImages = 16384;
+    static constexpr uint32_t kMaxStorageBuffers = 65536;
+
     VulkanDevice* device = nullptr;
     bool mutableDescriptorType = false;
+    bool supported = false;
+    /// Fills set 0 of pipeline layouts without bind groups.
+    VkDescriptorSetLayout emptySetLayout = VK_NULL_HANDLE;
+    VulkanBindlessHeap samplers;
+    VulkanBindlessHeap sampledImages;
+    VulkanBindlessHeap storageImages;
+    VulkanBindlessHeap storageBuffers;
 
     void Init(VulkanDevice* device);
     void Shutdown();
+    void FillSetLayouts(VkDescriptorSetLayout* setLayouts) const;
+    void Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout) const;
+    void Release(VulkanBindlessHeap& heap, GPUBindlessIndex& index);
+};
+
+/// Worker threads compiling pipelines created with agpuCreate*PipelineAsync, they share the device VkPipelineCache.
+struct VulkanPipelineCompiler final
+{
+    std::mutex mutex;
+    std::condition_variable jobCondition;
+    std::condition_variable completedCondition;
+    std::deque<std::function<void(bool cancelled)>> jobs;
+    std::vector<std::thread> threads;
+    bool shutdown = false;
+
+    /// Threads are started with the first job, devices never compiling asynchronously don't pay for them.
+    void Submit(std::function<void(bool cancelled)>&& job);
+    void Complete(std::atomic<GPUPipelineStatus>& status, GPUPipelineStatus result);
+    GPUPipelineStatus Wait(const std::atomic<GPUPipelineStatus>& status);
+    /// Joins the threads, jobs still queued are cancelled and only release what they own.
+    void Shutdown();
+    void WorkerLoop();
 };
 
 struct VulkanDevice final : public GPUDeviceImpl
@@ -1375,10 +1749,18 @@ struct VulkanDevice final : public GPUDeviceImpl
     VkDevice handle = VK_NULL_HANDLE;
     VulkanQueue queues[_GPUCommandQueueType_Count];
     VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    std::string pipelineCachePath;
     VmaAllocator allocator = nullptr;
     VmaAllocator externalAllocator = nullptr;
     VulkanCopyAllocator copyAllocator;
     VulkanBindlessManager bindlessManager;
+    VulkanPipelineCompiler pipelineCompiler;
+    std::atomic<uint64_t> nextObjectId{ 1 };
+
+    /// VK_EXT_graphics_pipeline_library parts, created once per distinct state and kept until the device is destroyed.
+    bool graphicsPipelineLibrary = false;
+    std::mutex pipelineLibraryMutex;
+    std::unordered_map<std::string, VkPipeline> pipelineLibraries;
 
     std::vector<VkDynamicState> psoDynamicStates;
     VkPipelineDynamicStateCreateInfo dynamicStateInfo = {};
@@ -1387,6 +1769,22 @@ struct VulkanDevice final : public GPUDeviceImpl
     uint64_t frameCount = 0;
     uint32_t frameIndex = 0;
 
+    /// Buffer map request, resolved once every queue reached the submit value recorded at request time.
+    struct BufferMapRequest
+    {
+        VulkanBuffer* buffer;
+        uint32_t mapSerial;
+        uint64_t submitValues[_GPUCommandQueueType_Count];
+        GPUBufferMapCallback callback;
+        void* userData;
+    };
+    std::mutex bufferMapRequestsMutex;
+    std::vector<BufferMapRequest> bufferMapRequests;
+
+    /// Identical bind group layouts share one VkDescriptorSetLayout, the cache holds a reference to each.
+    std::mutex bindGroupLayoutCacheMutex;
+    std::unordered_map<size_t, std::vector<VulkanBindGroupLayout*>> bindGroupLayoutCache;
+
     // Deletion queue objects
     std::mutex destroyMutex;
     std::deque<std::pair<VmaAllocation, uint64_t>> destroyedAllocations;
@@ -1403,6 +1801,7 @@ struct VulkanDevice final : public GPUDeviceImpl
     std::deque<std::pair<VkSemaphore, uint64_t>> destroyedSemaphores;
     std::deque<std::pair<VkSwapchainKHR, uint64_t>> destroyedSwapchains;
     std::deque<std::pair<VkSurfaceKHR, uint64_t>> destroyedSurfaces;
+    std::deque<std::pair<std::pair<VulkanBindlessHeap*, GPUBindlessIndex>, uint64_t>> destroyedBindlessIndices;
 
 #define VULKAN_DEVICE_FUNCTION(func) PFN_##func func = nullptr;
 #include "alimer_gpu_vulkan_funcs.h"
@@ -1417,19 +1816,34 @@ struct VulkanDevice final : public GPUDeviceImpl
     GPUCommandQueue GetQueue(GPUCommandQueueType type) override;
     void WaitIdle() override;
     uint64_t CommitFrame() override;
+    void ProcessEvents() override;
+    void ResolveBufferMapRequest(const BufferMapRequest& request, bool aborted);
     void ProcessDeletionQueue(bool force);
 
+    GPUUploadTicket FlushUploads() override { return copyAllocator.Flush(); }
+    bool IsUploadComplete(GPUUploadTicket ticket) override { return copyAllocator.IsComplete(ticket); }
+    void WaitUpload(GPUUploadTicket ticket) override { copyAllocator.Wait(ticket); }
+
     uint64_t GetTimestampFrequency() const override;
+    size_t GetPipelineCacheData(void* data, size_t dataSize) override;
+    void SavePipelineCache();
 
     /* Resource creation */
     GPUBuffer CreateBuffer(const GPUBufferDesc& desc, const void* pInitialData) override;
     GPUTexture CreateTexture(const GPUTextureDesc& desc, const GPUTextureData* pInitialData) override;
     GPUSampler CreateSampler(const GPUSamplerDesc& desc) override;
     GPUBindGroupLayout CreateBindGroupLayout(const GPUBindGroupLayoutDesc& desc) override;
+    GPUBindGroup CreateBindGroup(const GPUBindGroupDesc& desc) override;
     GPUPipelineLayout CreatePipelineLayout(const GPUPipelineLayoutDesc& desc) override;
     GPUShaderModule CreateShaderModule(const GPUShaderModuleDesc* desc) override;
     GPUComputePipeline CreateComputePipeline(const GPUComputePipelineDesc& desc) override;
     GPURenderPipeline CreateRenderPipeline(const GPURenderPipelineDesc& desc) override;
+    GPUComputePipeline CreateComputePipelineAsync(const GPUComputePipelineDesc& desc, GPUComputePipeline fallback) override;
+    GPURenderPipeline CreateRenderPipelineAsync(const GPURenderPipelineDesc& desc, GPURenderPipeline fallback) override;
+    /// Creates pipeline->handle from pipeline library parts when supported. Unless optimize is set and when the driver
+    /// links fast, the parts are fast-linked and relinked with link time optimization in the background.
+    VkResult CompileRenderPipeline(VulkanRenderPipeline* pipeline, const VulkanRenderPipelineState& state, bool optimize);
+    VkPipeline GetPipelineLibrary(std::string&& key, VkGraphicsPipelineLibraryFlagsEXT part, VkGraphicsPipelineCreateInfo& createInfo);
     GPUQueryHeap CreateQueryHeap(const GPUQueryHeapDesc& desc) override;
 
     void SetObjectName(VkObjectType type, uint64_t handle_, const char* label) const;
@@ -1510,6 +1924,7 @@ struct VulkanAdapter final : public GPUAdapterImpl
     VkPhysicalDeviceUnifiedImageLayoutsFeaturesKHR unifiedImageLayoutsFeatures{};
     VkPhysicalDeviceMutableDescriptorTypeFeaturesEXT mutableDescriptorTypeFeaturesEXT{};
     VkPhysicalDeviceDescriptorHeapFeaturesEXT descriptorHeapFeaturesEXT{};
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{};
 
     // Properties
     VkPhysicalDeviceProperties2 properties2 = {};
@@ -1526,6 +1941,7 @@ struct VulkanAdapter final : public GPUAdapterImpl
     VkPhysicalDeviceMeshShaderPropertiesEXT meshShaderProperties = {};
     VkPhysicalDeviceMemoryProperties2 memoryProperties2 = {};
     VkPhysicalDeviceDescriptorHeapPropertiesEXT descriptorHeapPropertiesEXT = {};
+    VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT graphicsPipelineLibraryProperties = {};
 
     bool Init(VkPhysicalDevice handle_);
 
@@ -1569,6 +1985,8 @@ VulkanBuffer::~VulkanBuffer()
 {
     const uint64_t frameCount = device->frameCount;
 
+    device->bindlessManager.Release(device->bindlessManager.storageBuffers, bindlessIndex);
+
     device->destroyMutex.lock();
     if (handle != VK_NULL_HANDLE)
     {
@@ -1590,10 +2008,39 @@ void VulkanBuffer::SetLabel(const char* label)
     device->SetObjectName(VK_OBJECT_TYPE_BUFFER, reinterpret_cast<uint64_t>(handle), label);
 }
 
+void VulkanBuffer::MapAsync(GPUBufferMapCallback callback, void* userData)
+{
+    VulkanDevice::BufferMapRequest request = {};
+    request.buffer = this;
+    request.mapSerial = mapSerial;
+    request.callback = callback;
+    request.userData = userData;
+    for (uint32_t i = 0; i < _GPUCommandQueueType_Count; ++i)
+    {
+        request.submitValues[i] = device->queues[i].submitValue.load(std::memory_order_acquire);
+    }
+
+    AddRef();
+    std::scoped_lock lock(device->bufferMapRequestsMutex);
+    device->bufferMapRequests.push_back(request);
+}
+
+void VulkanBuffer::Unmap()
+{
+    if (mapMode == GPUMapMode_Write)
+    {
+        VK_CHECK(vmaFlushAllocation(device->allocator, allocation, mapOffset, mapSize));
+    }
+}
+
 /* VulkanTexture */
 VulkanTexture::~VulkanTexture()
 {
     const uint64_t frameCount = device->frameCount;
+
+    device->bindlessManager.Release(device->bindlessManager.sampledImages, bindlessIndex);
+    device->bindlessManager.Release(device->bindlessManager.storageImages, bindlessStorageIndex);
+
     device->destroyMutex.lock();
 
     for (auto& it : views)
@@ -1629,11 +2076,13 @@ void VulkanTexture::SetLabel(const char* label)
     device->SetObjectName(VK_OBJECT_TYPE_IMAGE, reinterpret_cast<uint64_t>(handle), label);
 }
 
-VkImageView VulkanTexture::GetView(uint32_t mipLevel) const
+VkImageView VulkanTexture::GetView(uint32_t mipLevel, bool storage) const
 {
     size_t hash = 0;
     HashCombine(hash, mipLevel);
+    HashCombine(hash, storage);
 
+    std::lock_guard<std::mutex> lock(viewsMutex);
     auto it = views.find(hash);
     if (it == views.end())
     {
@@ -1655,7 +2104,10 @@ VkImageView VulkanTexture::GetView(uint32_t mipLevel) const
                 createInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
                 break;
             case GPUTextureDimension_Cube:
-                createInfo.viewType = isArray ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+                if (storage)
+                    createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+                else
+                    createInfo.viewType = isArray ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
                 break;
             default:
                 createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
@@ -1666,9 +2118,9 @@ VkImageView VulkanTexture::GetView(uint32_t mipLevel) const
         createInfo.components = { VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY };
         createInfo.subresourceRange.aspectMask = GetImageAspectFlags(createInfo.format, GPUTextureAspect_All);
         createInfo.subresourceRange.baseMipLevel = mipLevel;
-        createInfo.subresourceRange.levelCount = desc.mipLevelCount;
+        createInfo.subresourceRange.levelCount = storage ? 1 : desc.mipLevelCount - mipLevel;
         createInfo.subresourceRange.baseArrayLayer = 0;
-        createInfo.subresourceRange.layerCount = desc.depthOrArrayLayers;
+        createInfo.subresourceRange.layerCount = GetArrayLayerCount();
 
         VkImageView newView = VK_NULL_HANDLE;
         const VkResult result = device->vkCreateImageView(
@@ -1693,6 +2145,9 @@ VkImageView VulkanTexture::GetView(uint32_t mipLevel) const
 VulkanSampler::~VulkanSampler()
 {
     const uint64_t frameCount = device->frameCount;
+
+    device->bindlessManager.Release(device->bindlessManager.samplers, bindlessIndex);
+
     device->destroyMutex.lock();
     if (handle != VK_NULL_HANDLE)
     {
@@ -1725,9 +2180,26 @@ void VulkanBindGroupLayout::SetLabel(const char* label)
     device->SetObjectName(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, reinterpret_cast<uint64_t>(handle), label);
 }
 
+/* VulkanBindGroup */
+VulkanBindGroup::~VulkanBindGroup()
+{
+    for (GPUResource* resource : resources)
+    {
+        resource->Release();
+    }
+    resources.clear();
+    SafeRelease(layout);
+}
+
 /* VulkanPipelineLayout */
 VulkanPipelineLayout::~VulkanPipelineLayout()
 {
+    for (VulkanBindGroupLayout* bindGroupLayout : bindGroupLayouts)
+    {
+        bindGroupLayout->Release();
+    }
+    bindGroupLayouts.clear();
+
     const uint64_t frameCount = device->frameCount;
     device->destroyMutex.lock();
     if (handle != VK_NULL_HANDLE)
@@ -1761,10 +2233,34 @@ void VulkanShaderModule::SetLabel(const char* label)
     device->SetObjectName(VK_OBJECT_TYPE_SHADER_MODULE, reinterpret_cast<uint64_t>(stageInfo.module), label);
 }
 
+/// Returns the pipeline to bind: itself when compiled, its fallback while compiling or waits for it when there is none.
+template<typename Pipeline>
+static Pipeline* ResolvePipeline(Pipeline* pipeline)
+{
+    GPUPipelineStatus status = pipeline->status.load(std::memory_order_acquire);
+    if (status == GPUPipelineStatus_Ready)
+        return pipeline;
+
+    const bool fallbackReady = pipeline->fallback != nullptr
+        && pipeline->fallback->status.load(std::memory_order_acquire) == GPUPipelineStatus_Ready;
+    if (fallbackReady)
+        return pipeline->fallback;
+
+    if (status == GPUPipelineStatus_Pending)
+    {
+        status = pipeline->device->pipelineCompiler.Wait(pipeline->status);
+        if (status == GPUPipelineStatus_Ready)
+            return pipeline;
+    }
+
+    return nullptr;
+}
+
 /* VulkanComputePipeline */
 VulkanComputePipeline::~VulkanComputePipeline()
 {
     SafeRelease(layout);
+    SafeRelease(fallback);
 
     const uint64_t frameCount = device->frameCount;
     device->destroyMutex.lock();
@@ -1778,6 +2274,10 @@ VulkanComputePipeline::~VulkanComputePipeline()
 
 void VulkanComputePipeline::SetLabel(const char* label)
 {
+    // The handle is written by the compiler thread, pending pipelines get the label from their desc
+    if (status.load(std::memory_order_acquire) != GPUPipelineStatus_Ready)
+        return;
+
     device->SetObjectName(VK_OBJECT_TYPE_PIPELINE, reinterpret_cast<uint64_t>(handle), label);
 }
 
@@ -1785,6 +2285,7 @@ void VulkanComputePipeline::SetLabel(const char* label)
 VulkanRenderPipeline::~VulkanRenderPipeline()
 {
     SafeRelease(layout);
+    SafeRelease(fallback);
 
     const uint64_t frameCount = device->frameCount;
     device->destroyMutex.lock();
@@ -1793,110 +2294,570 @@ VulkanRenderPipeline::~VulkanRenderPipeline()
         device->destroyedPipelines.push_back(std::make_pair(handle, frameCount));
         handle = VK_NULL_HANDLE;
     }
+    if (optimizedHandle != VK_NULL_HANDLE)
+    {
+        device->destroyedPipelines.push_back(std::make_pair(optimizedHandle, frameCount));
+        optimizedHandle = VK_NULL_HANDLE;
+    }
     device->destroyMutex.unlock();
 }
 
 void VulkanRenderPipeline::SetLabel(const char* label)
 {
+    // The handle is written by the compiler thread, pending pipelines get the label from their desc
+    if (status.load(std::memory_order_acquire) != GPUPipelineStatus_Ready)
+        return;
+
     device->SetObjectName(VK_OBJECT_TYPE_PIPELINE, reinterpret_cast<uint64_t>(handle), label);
 }
 
-/* VulkanQueryHeap */
-VulkanQueryHeap::~VulkanQueryHeap()
+/* VulkanRenderPipelineState */
+VulkanRenderPipelineState::~VulkanRenderPipelineState()
 {
-    const uint64_t frameCount = device->frameCount;
-    device->destroyMutex.lock();
-    if (handle != VK_NULL_HANDLE)
+    for (VulkanShaderModule* shaderModule : shaderModules)
     {
-        device->destroyedQueryPools.push_back(std::make_pair(handle, frameCount));
-        handle = VK_NULL_HANDLE;
+        shaderModule->Release();
     }
-    device->destroyMutex.unlock();
-}
-
-void VulkanQueryHeap::SetLabel(const char* label)
-{
-    device->SetObjectName(VK_OBJECT_TYPE_QUERY_POOL, reinterpret_cast<uint64_t>(handle), label);
 }
 
-/* VulkanComputePassEncoder */
-void VulkanComputePassEncoder::Clear()
+void VulkanRenderPipelineState::Init(VulkanDevice* device, const GPURenderPipelineDesc& desc, VkPipelineLayout layout)
 {
-    SafeRelease(currentPipeline);
-}
+    // ShaderStages, referenced until the pipeline is created
+    if (desc.meshShader != nullptr)
+    {
+        shaderModules.push_back(static_cast<VulkanShaderModule*>(desc.meshShader));
 
-void VulkanComputePassEncoder::Begin(const GPUComputePassDesc& desc)
-{
-    if (desc.label)
+        if (desc.amplificationShader != nullptr)
+        {
+            shaderModules.push_back(static_cast<VulkanShaderModule*>(desc.amplificationShader));
+        }
+    }
+    else
     {
-        PushDebugGroup(desc.label);
-        hasLabel = true;
+        shaderModules.push_back(static_cast<VulkanShaderModule*>(desc.vertexShader));
     }
-}
 
-void VulkanComputePassEncoder::EndEncoding()
-{
-    if (hasLabel)
+    if (desc.fragmentShader != nullptr)
     {
-        PopDebugGroup();
+        shaderModules.push_back(static_cast<VulkanShaderModule*>(desc.fragmentShader));
     }
 
-    commandBuffer->encoderActive = false;
-    hasLabel = false;
-    Clear();
-}
+    for (VulkanShaderModule* shaderModule : shaderModules)
+    {
+        shaderModule->AddRef();
+        stages.push_back(shaderModule->stageInfo);
+    }
 
-void VulkanComputePassEncoder::PushDebugGroup(const char* groupLabel) const
-{
-    commandBuffer->PushDebugGroup(groupLabel);
-}
+    // VertexInputState (need always be specified when using VertexShader)
+    vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    uint32_t attributeLocation = 0;
+    if (desc.vertexBufferLayoutCount > 0)
+    {
+        vertexBindings.resize(desc.vertexBufferLayoutCount);
 
-void VulkanComputePassEncoder::PopDebugGroup() const
-{
-    commandBuffer->PopDebugGroup();
-}
+        for (uint32_t bufferIndex = 0; bufferIndex < desc.vertexBufferLayoutCount; ++bufferIndex)
+        {
+            const GPUVertexBufferLayout& layout = desc.vertexBufferLayouts[bufferIndex];
+            vertexBindings[bufferIndex].binding = bufferIndex;
+            vertexBindings[bufferIndex].stride = layout.stride;
+            vertexBindings[bufferIndex].inputRate = ToVk(layout.stepMode);
 
-void VulkanComputePassEncoder::InsertDebugMarker(const char* markerLabel) const
-{
-    commandBuffer->InsertDebugMarker(markerLabel);
-}
+            // Compute stride from attributes
+            if (vertexBindings[bufferIndex].stride == 0)
+            {
+                for (uint32_t attributeIndex = 0; attributeIndex < layout.attributeCount; ++attributeIndex)
+                {
+                    const GPUVertexAttribute& attribute = layout.attributes[attributeIndex];
+                    vertexBindings[bufferIndex].stride += agpuGetVertexFormatByteSize(attribute.format);
+                }
+            }
 
-void VulkanComputePassEncoder::SetPipeline(GPUComputePipeline pipeline)
-{
-    if (currentPipeline == pipeline)
-        return;
+            for (uint32_t attributeIndex = 0; attributeIndex < layout.attributeCount; ++attributeIndex)
+            {
+                const GPUVertexAttribute& attribute = layout.attributes[attributeIndex];
 
-    VulkanComputePipeline* backendPipeline = static_cast<VulkanComputePipeline*>(pipeline);
-    commandBuffer->SetPipelineLayout(backendPipeline->layout);
+                VkVertexInputAttributeDescription& vertexAttribute = vertexAttributes.emplace_back();
+                vertexAttribute.location = attributeLocation;
+                vertexAttribute.binding = bufferIndex;
+                vertexAttribute.format = ToVkVertexFormat(attribute.format);
+                vertexAttribute.offset = attribute.offset;
 
-    commandBuffer->device->vkCmdBindPipeline(commandBuffer->handle, VK_PIPELINE_BIND_POINT_COMPUTE, backendPipeline->handle);
-    currentPipeline = backendPipeline;
-    currentPipeline->AddRef();
-}
+                attributeLocation++;
+            }
+        }
+
+        vertexInputState.vertexBindingDescriptionCount = (uint32_t)vertexBindings.size();
+        vertexInputState.pVertexBindingDescriptions = vertexBindings.data();
+        vertexInputState.vertexAttributeDescriptionCount = (uint32_t)vertexAttributes.size();
+        vertexInputState.pVertexAttributeDescriptions = vertexAttributes.data();
+    }
+
+    // InputAssemblyState
+    inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssemblyState.topology = ToVk(desc.primitiveTopology);
+    switch (desc.primitiveTopology)
+    {
+        case GPUPrimitiveTopology_LineStrip:
+        case GPUPrimitiveTopology_TriangleStrip:
+            inputAssemblyState.primitiveRestartEnable = VK_TRUE;
+            break;
+        default:
+            inputAssemblyState.primitiveRestartEnable = VK_FALSE;
+            break;
+    }
+
+    // ViewportState
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    // RasterizationState
+    rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+
+    // DepthClip
+    PNEXTCHAIN_DECLARE(rasterizationState.pNext);
+    if (device->adapter->depthClipEnableFeatures.depthClipEnable == VK_TRUE)
+    {
+        depthClipStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_DEPTH_CLIP_STATE_CREATE_INFO_EXT;
+        depthClipStateInfo.depthClipEnable = (desc.rasterizerState.depthClipMode == GPUDepthClipMode_Clip) ? VK_TRUE : VK_FALSE;
+
+        rasterizationState.depthClampEnable = VK_TRUE;
+        rasterizationState.pNext = &depthClipStateInfo;
+
+        PNEXTCHAIN_APPEND_STRUCT(depthClipStateInfo);
+    }
+
+    if (desc.rasterizerState.conservativeRasterEnable)
+    {
+        rasterizationConservativeState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_CONSERVATIVE_STATE_CREATE_INFO_EXT;
+        rasterizationConservativeState.conservativeRasterizationMode = VK_CONSERVATIVE_RASTERIZATION_MODE_OVERESTIMATE_EXT;
+        rasterizationConservativeState.extraPrimitiveOverestimationSize = 0.0f;
+
+        PNEXTCHAIN_APPEND_STRUCT(rasterizationConservativeState);
+    }
+
+    rasterizationState.rasterizerDiscardEnable = VK_FALSE;
+    rasterizationState.polygonMode = ToVk(desc.rasterizerState.fillMode, device->adapter->features2.features.fillModeNonSolid);
+    rasterizationState.cullMode = ToVk(desc.rasterizerState.cullMode);
+    rasterizationState.frontFace = ToVk(desc.rasterizerState.frontFace);
+    // Can be managed by command buffer
+    rasterizationState.depthBiasEnable = desc.rasterizerState.depthBias != 0.0f || desc.rasterizerState.depthBiasSlopeScale != 0.0f;
+    rasterizationState.depthBiasConstantFactor = desc.rasterizerState.depthBias;
+    rasterizationState.depthBiasClamp = desc.rasterizerState.depthBiasClamp;
+    rasterizationState.depthBiasSlopeFactor = desc.rasterizerState.depthBiasSlopeScale;
+    rasterizationState.lineWidth = 1.0f;
+
+    // MultisampleState
+    // VkPipelineSampleLocationsStateCreateInfoEXT sampleLocationsState = {VK_STRUCTURE_TYPE_PIPELINE_SAMPLE_LOCATIONS_STATE_CREATE_INFO_EXT};
+    //sampleLocationsState.sampleLocationsInfo.sType = VK_STRUCTURE_TYPE_SAMPLE_LOCATIONS_INFO_EXT;
+    multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampleState.rasterizationSamples = ToVkSampleCount(desc.multisample.count);
+
+    ALIMER_ASSERT(multisampleState.rasterizationSamples <= 32);
+    if (multisampleState.rasterizationSamples > VK_SAMPLE_COUNT_1_BIT)
+    {
+        multisampleState.sampleShadingEnable = VK_FALSE;
+        multisampleState.minSampleShading = 0.0f;
+        multisampleState.alphaToCoverageEnable = desc.multisample.alphaToCoverageEnabled ? VK_TRUE : VK_FALSE;
+        multisampleState.alphaToOneEnable = VK_FALSE;
+        multisampleState.pSampleMask = nullptr;
+    }
+
+    // DepthStencilState
+    depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    if (desc.depthStencilAttachmentFormat != GPUPixelFormat_Undefined)
+    {
+        depthStencilState.depthTestEnable = (desc.depthStencilState.depthCompareFunction != GPUCompareFunction_Always || desc.depthStencilState.depthWriteEnabled) ? VK_TRUE : VK_FALSE;
+        depthStencilState.depthWriteEnable = desc.depthStencilState.depthWriteEnabled ? VK_TRUE : VK_FALSE;
+        depthStencilState.depthCompareOp = ToVk(desc.depthStencilState.depthCompareFunction);
+        if (device->adapter->features2.features.depthBounds == VK_TRUE)
+        {
+            depthStencilState.depthBoundsTestEnable = desc.depthStencilState.depthBoundsTestEnable ? VK_TRUE : VK_FALSE;
+        }
+        else
+        {
+            depthStencilState.depthBoundsTestEnable = false;
+        }
+
+        depthStencilState.stencilTestEnable = StencilTestEnabled(desc.depthStencilState) ? VK_TRUE : VK_FALSE;
+        depthStencilState.front.failOp = ToVk(desc.depthStencilState.frontFace.failOperation);
+        depthStencilState.front.passOp = ToVk(desc.depthStencilState.frontFace.passOperation);
+        depthStencilState.front.depthFailOp = ToVk(desc.depthStencilState.frontFace.depthFailOperation);
+        depthStencilState.front.compareOp = ToVk(desc.depthStencilState.frontFace.compareFunction);
+        depthStencilState.front.compareMask = desc.depthStencilState.stencilReadMask;
+        depthStencilState.front.writeMask = desc.depthStencilState.stencilWriteMask;
+        depthStencilState.front.reference = 0;
+
+        depthStencilState.back.failOp = ToVk(desc.depthStencilState.backFace.failOperation);
+        depthStencilState.back.passOp = ToVk(desc.depthStencilState.backFace.passOperation);
+        depthStencilState.back.depthFailOp = ToVk(desc.depthStencilState.backFace.depthFailOperation);
+        depthStencilState.back.compareOp = ToVk(desc.depthStencilState.backFace.compareFunction);
+        depthStencilState.back.compareMask = desc.depthStencilState.stencilReadMask;
+        depthStencilState.back.writeMask = desc.depthStencilState.stencilWriteMask;
+        depthStencilState.back.reference = 0;
+
+        depthStencilState.minDepthBounds = 0.0f;
+        depthStencilState.maxDepthBounds = 1.0f;
+    }
+
+    // RenderingInfo/ RenderPass
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+
+    // BlendState
+    blendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    blendState.logicOpEnable = VK_FALSE;
+    blendState.logicOp = VK_LOGIC_OP_CLEAR;
+    blendState.blendConstants[0] = 0.0f;
+    blendState.blendConstants[1] = 0.0f;
+    blendState.blendConstants[2] = 0.0f;
+    blendState.blendConstants[3] = 0.0f;
+
+    for (uint32_t i = 0; i < desc.colorAttachmentCount; ++i)
+    {
+        if (desc.colorAttachments[i].format == GPUPixelFormat_Undefined)
+            break;
+
+        const GPURenderPipelineColorAttachmentDesc& attachment = desc.colorAttachments[i];
+
+        blendAttachmentStates[renderingInfo.colorAttachmentCount].blendEnable = BlendEnabled(&attachment) ? VK_TRUE : VK_FALSE;
+        blendAttachmentStates[renderingInfo.colorAttachmentCount].srcColorBlendFactor = ToVk(attachment.srcColorBlendFactor);
+        blendAttachmentStates[renderingInfo.colorAttachmentCount].dstColorBlendFactor = ToVk(attachment.destColorBlendFactor);
+        blendAttachmentStates[renderingInfo.colorAttachmentCount].colorBlendOp = ToVk(attachment.colorBlendOperation);
+        blendAttachmentStates[renderingInfo.colorAttachmentCount].srcAlphaBlendFactor = ToVk(attachment.srcAlphaBlendFactor);
+        blendAttachmentStates[renderingInfo.colorAttachmentCount].dstAlphaBlendFactor = ToVk(attachment.destAlphaBlendFactor);
+        blendAttachmentStates[renderingInfo.colorAttachmentCount].alphaBlendOp = ToVk(attachment.alphaBlendOperation);
+        blendAttachmentStates[renderingInfo.colorAttachmentCount].colorWriteMask = ToVk(attachment.colorWriteMask);
+
+        colorAttachmentFormats[renderingInfo.colorAttachmentCount] = device->adapter->ToVkFormat(attachment.format);
+        renderingInfo.colorAttachmentCount++;
+    }
+
+    blendState.attachmentCount = renderingInfo.colorAttachmentCount;
+    blendState.pAttachments = blendAttachmentStates;
+
+    renderingInfo.pColorAttachmentFormats = colorAttachmentFormats;
+    renderingInfo.depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+    renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+    if (desc.depthStencilAttachmentFormat != GPUPixelFormat_Undefined)
+    {
+        renderingInfo.depthAttachmentFormat = device->adapter->ToVkFormat(desc.depthStencilAttachmentFormat);
+        if (!alimerPixelFormatIsDepthOnly(desc.depthStencilAttachmentFormat))
+        {
+            renderingInfo.stencilAttachmentFormat = renderingInfo.depthAttachmentFormat;
+        }
+    }
+
+    createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    createInfo.pNext = &renderingInfo;
+    createInfo.stageCount = (uint32_t)stages.size();
+    createInfo.pStages = stages.data();
+    createInfo.pVertexInputState = &vertexInputState;
+    createInfo.pInputAssemblyState = &inputAssemblyState;
+    createInfo.pTessellationState = nullptr;
+    createInfo.pViewportState = &viewportState;
+    createInfo.pRasterizationState = &rasterizationState;
+    createInfo.pMultisampleState = &multisampleState;
+    createInfo.pDepthStencilState = (desc.depthStencilAttachmentFormat != GPUPixelFormat_Undefined) ? &depthStencilState : nullptr;
+    createInfo.pColorBlendState = &blendState;
+    createInfo.pDynamicState = &device->dynamicStateInfo;
+    createInfo.layout = layout;
+    createInfo.renderPass = VK_NULL_HANDLE;
+    createInfo.subpass = 0;
+    createInfo.basePipelineHandle = VK_NULL_HANDLE;
+    createInfo.basePipelineIndex = -1;
+}
+
+/* VulkanQueryHeap */
+VulkanQueryHeap::~VulkanQueryHeap()
+{
+    const uint64_t frameCount = device->frameCount;
+    device->destroyMutex.lock();
+    if (handle != VK_NULL_HANDLE)
+    {
+        device->destroyedQueryPools.push_back(std::make_pair(handle, frameCount));
+        handle = VK_NULL_HANDLE;
+    }
+    device->destroyMutex.unlock();
+}
+
+void VulkanQueryHeap::SetLabel(const char* label)
+{
+    device->SetObjectName(VK_OBJECT_TYPE_QUERY_POOL, reinterpret_cast<uint64_t>(handle), label);
+}
+
+/* VulkanComputePassEncoder */
+void VulkanComputePassEncoder::Clear()
+{
+    SafeRelease(currentPipeline);
+    commandBuffer->ResetBindGroups();
+}
+
+void VulkanComputePassEncoder::Begin(const GPUComputePassDesc& desc)
+{
+    if (desc.label)
+    {
+        PushDebugGroup(desc.label);
+        hasLabel = true;
+    }
+}
+
+void VulkanComputePassEncoder::EndEncoding()
+{
+    commandBuffer->RestorePassTextures();
+
+    if (hasLabel)
+    {
+        PopDebugGroup();
+    }
+
+    commandBuffer->encoderActive = false;
+    hasLabel = false;
+    Clear();
+}
+
+void VulkanComputePassEncoder::PushDebugGroup(const char* groupLabel) const
+{
+    commandBuffer->PushDebugGroup(groupLabel);
+}
+
+void VulkanComputePassEncoder::PopDebugGroup() const
+{
+    commandBuffer->PopDebugGroup();
+}
+
+void VulkanComputePassEncoder::InsertDebugMarker(const char* markerLabel) const
+{
+    commandBuffer->InsertDebugMarker(markerLabel);
+}
+
+void VulkanComputePassEncoder::SetPipeline(GPUComputePipeline pipeline)
+{
+    VulkanComputePipeline* backendPipeline = ResolvePipeline(static_cast<VulkanComputePipeline*>(pipeline));
+    if (backendPipeline == nullptr)
+    {
+        agpuLogError("SetPipeline: Compute pipeline failed to compile and has no fallback");
+        return;
+    }
+
+    if (currentPipeline == backendPipeline)
+        return;
+
+    commandBuffer->SetPipelineLayout(backendPipeline->layout, VK_PIPELINE_BIND_POINT_COMPUTE);
+
+    commandBuffer->device->vkCmdBindPipeline(commandBuffer->handle, VK_PIPELINE_BIND_POINT_COMPUTE, backendPipeline->handle);
+    SafeRelease(currentPipeline);
+    currentPipeline = backendPipeline;
+    currentPipeline->AddRef();
+}
 
 void VulkanComputePassEncoder::SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size)
 {
-    commandBuffer->SetPushConstants(pushConstantIndex, data, size);
+    commandBuffer->SetPushConstants(pushConstantIndex, data, size);
+}
+
+void VulkanComputePassEncoder::SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup)
+{
+    commandBuffer->SetBindGroup(groupIndex, static_cast<VulkanBindGroup*>(bindGroup));
+}
+
+void VulkanComputePassEncoder::PrepareDispatch()
+{
+    commandBuffer->FlushBindGroups(VK_PIPELINE_BIND_POINT_COMPUTE);
+}
+
+void VulkanComputePassEncoder::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+{
+    PrepareDispatch();
+
+    commandBuffer->device->vkCmdDispatch(commandBuffer->handle, groupCountX, groupCountY, groupCountZ);
+}
+
+void VulkanComputePassEncoder::DispatchIndirect(GPUBuffer indirectBuffer, uint64_t indirectBufferOffset)
+{
+    PrepareDispatch();
+
+    VulkanBuffer* backendBuffer = static_cast<VulkanBuffer*>(indirectBuffer);
+    commandBuffer->device->vkCmdDispatchIndirect(commandBuffer->handle, backendBuffer->handle, indirectBufferOffset);
+}
+
+/* VulkanCopyPassEncoder */
+void VulkanCopyPassEncoder::Clear()
+{
+    hasBufferWrites = false;
+    textureTransitions.clear();
 }
 
-void VulkanComputePassEncoder::PrepareDispatch()
+void VulkanCopyPassEncoder::Begin(const GPUCopyPassDesc& desc)
 {
+    if (desc.label)
+    {
+        PushDebugGroup(desc.label);
+        hasLabel = true;
+    }
 
+    // Make prior writes from any stage visible to the transfer operations of this pass
+    commandBuffer->GlobalBarrier(
+        VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT
+    );
 }
 
-void VulkanComputePassEncoder::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+void VulkanCopyPassEncoder::EndEncoding()
 {
-    PrepareDispatch();
+    if (hasBufferWrites)
+    {
+        commandBuffer->GlobalBarrier(
+            VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT
+        );
+    }
 
-    commandBuffer->device->vkCmdDispatch(commandBuffer->handle, groupCountX, groupCountY, groupCountZ);
+    // Restore textures to the layout they had before the pass, in reverse order so overlapping transitions unwind correctly
+    for (auto it = textureTransitions.rbegin(); it != textureTransitions.rend(); ++it)
+    {
+        if (it->previousLayout == TextureLayout::Undefined)
+            continue;
+
+        commandBuffer->TextureBarrier(it->texture, it->previousLayout, it->mipLevel, 1, it->baseArrayLayer, it->layerCount, it->aspect);
+    }
+    commandBuffer->CommitBarriers();
+
+    if (hasLabel)
+    {
+        PopDebugGroup();
+    }
+
+    commandBuffer->encoderActive = false;
+    hasLabel = false;
+    Clear();
 }
 
-void VulkanComputePassEncoder::DispatchIndirect(GPUBuffer indirectBuffer, uint64_t indirectBufferOffset)
+void VulkanCopyPassEncoder::PushDebugGroup(const char* groupLabel) const
 {
-    PrepareDispatch();
+    commandBuffer->PushDebugGroup(groupLabel);
+}
 
-    VulkanBuffer* backendBuffer = static_cast<VulkanBuffer*>(indirectBuffer);
-    commandBuffer->device->vkCmdDispatchIndirect(commandBuffer->handle, backendBuffer->handle, indirectBufferOffset);
+void VulkanCopyPassEncoder::PopDebugGroup() const
+{
+    commandBuffer->PopDebugGroup();
+}
+
+void VulkanCopyPassEncoder::InsertDebugMarker(const char* markerLabel) const
+{
+    commandBuffer->InsertDebugMarker(markerLabel);
+}
+
+void VulkanCopyPassEncoder::TransitionTexture(const GPUTexelCopyTextureInfo& info, uint32_t depthOrArrayLayers, TextureLayout newLayout, VkImageSubresourceLayers& subresource)
+{
+    const VulkanTexture* texture = static_cast<const VulkanTexture*>(info.texture);
+    const bool is3D = texture->desc.dimension == GPUTextureDimension_3D;
+
+    subresource.aspectMask = GetImageAspectFlags(texture->vkFormat, info.aspect);
+    subresource.mipLevel = info.mipLevel;
+    subresource.baseArrayLayer = is3D ? 0 : info.origin.z;
+    subresource.layerCount = is3D ? 1 : depthOrArrayLayers;
+
+    const uint32_t subresourceIndex = CalculateSubresource(subresource.mipLevel, subresource.baseArrayLayer, texture->desc.mipLevelCount);
+    const TextureLayout previousLayout = texture->imageLayouts[subresourceIndex];
+    if (previousLayout == newLayout)
+        return;
+
+    textureTransitions.push_back({ texture, subresource.mipLevel, subresource.baseArrayLayer, subresource.layerCount, info.aspect, previousLayout });
+    commandBuffer->TextureBarrier(texture, newLayout, subresource.mipLevel, 1, subresource.baseArrayLayer, subresource.layerCount, info.aspect);
+}
+
+VkBufferImageCopy VulkanCopyPassEncoder::GetBufferImageCopy(const GPUTexelCopyBufferInfo& bufferInfo, const GPUTexelCopyTextureInfo& textureInfo, const GPUExtent3D& copySize, const VkImageSubresourceLayers& subresource) const
+{
+    const GPUPixelFormatInfo formatInfo = agpuPixelFormatGetInfo(textureInfo.texture->desc.format);
+    const bool is3D = textureInfo.texture->desc.dimension == GPUTextureDimension_3D;
+
+    VkBufferImageCopy region = {};
+    region.bufferOffset = bufferInfo.offset;
+    // Vulkan expresses the buffer layout in texels, not bytes
+    region.bufferRowLength = bufferInfo.bytesPerRow ? (bufferInfo.bytesPerRow / formatInfo.bytesPerBlock) * formatInfo.blockWidth : 0;
+    region.bufferImageHeight = bufferInfo.rowsPerImage ? bufferInfo.rowsPerImage * formatInfo.blockHeight : 0;
+    region.imageSubresource = subresource;
+    region.imageOffset = { (int32_t)textureInfo.origin.x, (int32_t)textureInfo.origin.y, is3D ? (int32_t)textureInfo.origin.z : 0 };
+    region.imageExtent = { copySize.width, copySize.height, is3D ? copySize.depthOrArrayLayers : 1u };
+    return region;
+}
+
+void VulkanCopyPassEncoder::CopyBufferToBuffer(GPUBuffer source, uint64_t sourceOffset, GPUBuffer destination, uint64_t destinationOffset, uint64_t size)
+{
+    VulkanBuffer* backendSource = static_cast<VulkanBuffer*>(source);
+    VulkanBuffer* backendDestination = static_cast<VulkanBuffer*>(destination);
+
+    VkBufferCopy region = {};
+    region.srcOffset = sourceOffset;
+    region.dstOffset = destinationOffset;
+    region.size = size;
+    commandBuffer->device->vkCmdCopyBuffer(commandBuffer->handle, backendSource->handle, backendDestination->handle, 1, &region);
+    hasBufferWrites = true;
+}
+
+void VulkanCopyPassEncoder::CopyBufferToTexture(const GPUTexelCopyBufferInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize)
+{
+    VulkanBuffer* backendSource = static_cast<VulkanBuffer*>(source.buffer);
+    VulkanTexture* backendDestination = static_cast<VulkanTexture*>(destination.texture);
+
+    VkImageSubresourceLayers subresource = {};
+    TransitionTexture(destination, copySize.depthOrArrayLayers, TextureLayout::CopyDest, subresource);
+    commandBuffer->CommitBarriers();
+
+    const VkBufferImageCopy region = GetBufferImageCopy(source, destination, copySize, subresource);
+    commandBuffer->device->vkCmdCopyBufferToImage(commandBuffer->handle,
+        backendSource->handle,
+        backendDestination->handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &region
+    );
+}
+
+void VulkanCopyPassEncoder::CopyTextureToBuffer(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyBufferInfo& destination, const GPUExtent3D& copySize)
+{
+    VulkanTexture* backendSource = static_cast<VulkanTexture*>(source.texture);
+    VulkanBuffer* backendDestination = static_cast<VulkanBuffer*>(destination.buffer);
+
+    VkImageSubresourceLayers subresource = {};
+    TransitionTexture(source, copySize.depthOrArrayLayers, TextureLayout::CopySource, subresource);
+    commandBuffer->CommitBarriers();
+
+    const VkBufferImageCopy region = GetBufferImageCopy(destination, source, copySize, subresource);
+    commandBuffer->device->vkCmdCopyImageToBuffer(commandBuffer->handle,
+        backendSource->handle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        backendDestination->handle,
+        1, &region
+    );
+    hasBufferWrites = true;
+}
+
+void VulkanCopyPassEncoder::CopyTextureToTexture(const GPUTexelCopyTextureInfo& source, const GPUTexelCopyTextureInfo& destination, const GPUExtent3D& copySize)
+{
+    VulkanTexture* backendSource = static_cast<VulkanTexture*>(source.texture);
+    VulkanTexture* backendDestination = static_cast<VulkanTexture*>(destination.texture);
+
+    VkImageCopy region = {};
+    TransitionTexture(source, copySize.depthOrArrayLayers, TextureLayout::CopySource, region.srcSubresource);
+    TransitionTexture(destination, copySize.depthOrArrayLayers, TextureLayout::CopyDest, region.dstSubresource);
+    commandBuffer->CommitBarriers();
+
+    const bool srcIs3D = backendSource->desc.dimension == GPUTextureDimension_3D;
+    const bool dstIs3D = backendDestination->desc.dimension == GPUTextureDimension_3D;
+    region.srcOffset = { (int32_t)source.origin.x, (int32_t)source.origin.y, srcIs3D ? (int32_t)source.origin.z : 0 };
+    region.dstOffset = { (int32_t)destination.origin.x, (int32_t)destination.origin.y, dstIs3D ? (int32_t)destination.origin.z : 0 };
+    region.extent = { copySize.width, copySize.height, (srcIs3D || dstIs3D) ? copySize.depthOrArrayLayers : 1u };
+
+    commandBuffer->device->vkCmdCopyImage(commandBuffer->handle,
+        backendSource->handle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        backendDestination->handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &region
+    );
+}
+
+void VulkanCopyPassEncoder::FillBuffer(GPUBuffer buffer, uint64_t offset, uint64_t size, uint32_t value)
+{
+    VulkanBuffer* backendBuffer = static_cast<VulkanBuffer*>(buffer);
+    commandBuffer->device->vkCmdFillBuffer(commandBuffer->handle, backendBuffer->handle, offset, size, value);
+    hasBufferWrites = true;
 }
 
 /* VulkanRenderPassEncoder */
@@ -1904,6 +2865,7 @@ void VulkanRenderPassEncoder::Clear()
 {
     currentShadingRate = _GPUShadingRate_Count;
     SafeRelease(currentPipeline);
+    commandBuffer->ResetBindGroups();
 }
 
 void VulkanRenderPassEncoder::Begin(const GPURenderPassDesc& desc)
@@ -1934,7 +2896,7 @@ void VulkanRenderPassEncoder::Begin(const GPURenderPassDesc& desc)
 
         renderArea.extent.width = std::min(renderArea.extent.width, std::max(texture->desc.width >> attachment.mipLevel, 1u));
         renderArea.extent.height = std::min(renderArea.extent.height, std::max(texture->desc.height >> attachment.mipLevel, 1u));
-        layerCount = std::min(layerCount, texture->desc.depthOrArrayLayers);
+        layerCount = std::min(layerCount, texture->GetArrayLayerCount());
 
         VkRenderingAttachmentInfo& attachmentInfo = colorAttachments[colorAttachmentCount++];
         attachmentInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
@@ -1948,7 +2910,7 @@ void VulkanRenderPassEncoder::Begin(const GPURenderPassDesc& desc)
         attachmentInfo.clearValue.color.float32[3] = attachment.clearColor.a;
 
         // Barrier
-        commandBuffer->TextureBarrier(texture, TextureLayout::RenderTarget, attachment.mipLevel, 1u, 0u, 1u);
+        commandBuffer->PassTextureBarrier(texture, TextureLayout::RenderTarget, attachment.mipLevel, 1u, 1u);
     }
 
     const bool hasDepthOrStencil =
@@ -1963,7 +2925,7 @@ void VulkanRenderPassEncoder::Begin(const GPURenderPassDesc& desc)
 
         renderArea.extent.width = std::min(renderArea.extent.width, std::max(texture->desc.width >> attachment.mipLevel, 1u));
         renderArea.extent.height = std::min(renderArea.extent.height, std::max(texture->desc.height >> attachment.mipLevel, 1u));
-        layerCount = std::min(layerCount, texture->desc.depthOrArrayLayers);
+        layerCount = std::min(layerCount, texture->GetArrayLayerCount());
 
         const GPULoadAction loadAction = _ALIMER_DEF(attachment.depthLoadAction, GPULoadAction_Clear);
         const GPUStoreAction storeAction = _ALIMER_DEF(attachment.depthStoreAction, GPUStoreAction_Discard);
@@ -1977,7 +2939,7 @@ void VulkanRenderPassEncoder::Begin(const GPURenderPassDesc& desc)
         depthAttachment.clearValue.depthStencil.depth = attachment.depthClearValue;
 
         // Barrier
-        commandBuffer->TextureBarrier(texture, attachment.depthReadOnly ? TextureLayout::DepthRead : TextureLayout::DepthWrite, attachment.mipLevel, 1u, 0u, 1u);
+        commandBuffer->PassTextureBarrier(texture, attachment.depthReadOnly ? TextureLayout::DepthRead : TextureLayout::DepthWrite, attachment.mipLevel, 1u, 1u);
     }
 
     // ShadingRate
@@ -2037,6 +2999,7 @@ void VulkanRenderPassEncoder::Begin(const GPURenderPassDesc& desc)
 void VulkanRenderPassEncoder::EndEncoding()
 {
     commandBuffer->device->vkCmdEndRendering(commandBuffer->handle);
+    commandBuffer->RestorePassTextures();
 
     if (hasLabel)
     {
@@ -2138,13 +3101,20 @@ void VulkanRenderPassEncoder::SetIndexBuffer(GPUBuffer buffer, GPUIndexType type
 
 void VulkanRenderPassEncoder::SetPipeline(GPURenderPipeline pipeline)
 {
-    if (currentPipeline == pipeline)
+    VulkanRenderPipeline* backendPipeline = ResolvePipeline(static_cast<VulkanRenderPipeline*>(pipeline));
+    if (backendPipeline == nullptr)
+    {
+        agpuLogError("SetPipeline: Render pipeline failed to compile and has no fallback");
+        return;
+    }
+
+    if (currentPipeline == backendPipeline)
         return;
 
-    VulkanRenderPipeline* backendPipeline = static_cast<VulkanRenderPipeline*>(pipeline);
-    commandBuffer->SetPipelineLayout(backendPipeline->layout);
+    commandBuffer->SetPipelineLayout(backendPipeline->layout, VK_PIPELINE_BIND_POINT_GRAPHICS);
 
-    commandBuffer->device->vkCmdBindPipeline(commandBuffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, backendPipeline->handle);
+    commandBuffer->device->vkCmdBindPipeline(commandBuffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, backendPipeline->GetHandle());
+    SafeRelease(currentPipeline);
     currentPipeline = backendPipeline;
     currentPipeline->AddRef();
 }
@@ -2154,9 +3124,14 @@ void VulkanRenderPassEncoder::SetPushConstants(uint32_t pushConstantIndex, const
     commandBuffer->SetPushConstants(pushConstantIndex, data, size);
 }
 
-void VulkanRenderPassEncoder::PrepareDraw()
+void VulkanRenderPassEncoder::SetBindGroup(uint32_t groupIndex, GPUBindGroup bindGroup)
 {
+    commandBuffer->SetBindGroup(groupIndex, static_cast<VulkanBindGroup*>(bindGroup));
+}
 
+void VulkanRenderPassEncoder::PrepareDraw()
+{
+    commandBuffer->FlushBindGroups(VK_PIPELINE_BIND_POINT_GRAPHICS);
 }
 
 void VulkanRenderPassEncoder::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
@@ -2343,6 +3318,81 @@ void VulkanRenderPassEncoder::SetShadingRate(GPUShadingRate rate)
     }
 }
 
+/* VulkanDescriptorAllocator */
+void VulkanDescriptorAllocator::Shutdown()
+{
+    for (VkDescriptorPool pool : pools)
+    {
+        device->vkDestroyDescriptorPool(device->handle, pool, nullptr);
+    }
+    pools.clear();
+    currentPool = 0;
+}
+
+void VulkanDescriptorAllocator::Reset()
+{
+    for (uint32_t i = 0; i <= currentPool && i < pools.size(); ++i)
+    {
+        VK_CHECK(device->vkResetDescriptorPool(device->handle, pools[i], 0));
+    }
+    currentPool = 0;
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::Allocate(VkDescriptorSetLayout layout)
+{
+    VkDescriptorSetAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &layout;
+
+    while (true)
+    {
+        bool newPool = false;
+        if (currentPool == pools.size())
+        {
+            const VkDescriptorPoolSize poolSizes[] = {
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 * kMaxSetsPerPool },
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * kMaxSetsPerPool },
+                { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4 * kMaxSetsPerPool },
+                { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kMaxSetsPerPool },
+                { VK_DESCRIPTOR_TYPE_SAMPLER, kMaxSetsPerPool },
+            };
+
+            VkDescriptorPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            poolInfo.maxSets = kMaxSetsPerPool;
+            poolInfo.poolSizeCount = static_cast<uint32_t>(std::size(poolSizes));
+            poolInfo.pPoolSizes = poolSizes;
+
+            VkDescriptorPool pool = VK_NULL_HANDLE;
+            VkResult result = device->vkCreateDescriptorPool(device->handle, &poolInfo, nullptr, &pool);
+            if (result != VK_SUCCESS)
+            {
+                VK_LOG_ERROR(result, "Failed to create DescriptorPool");
+                return VK_NULL_HANDLE;
+            }
+            pools.push_back(pool);
+            newPool = true;
+        }
+
+        allocateInfo.descriptorPool = pools[currentPool];
+
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VkResult result = device->vkAllocateDescriptorSets(device->handle, &allocateInfo, &descriptorSet);
+        if (result == VK_SUCCESS)
+            return descriptorSet;
+
+        // An exhausted pool moves on to the next one, a set that does not fit an empty pool never will.
+        if (newPool || (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL))
+        {
+            VK_LOG_ERROR(result, "Failed to allocate DescriptorSet");
+            return VK_NULL_HANDLE;
+        }
+
+        currentPool++;
+    }
+}
+
 /* VulkanCommandBuffer */
 VulkanCommandBuffer::~VulkanCommandBuffer()
 {
@@ -2351,12 +3401,14 @@ VulkanCommandBuffer::~VulkanCommandBuffer()
     for (uint32_t i = 0; i < queue->device->maxFramesInFlight; ++i)
     {
         queue->device->vkDestroyCommandPool(queue->device->handle, commandPools[i], nullptr);
+        descriptorAllocators[i].Shutdown();
     }
 
     //vkDestroySemaphore(device->device, semaphore, nullptr);
 
     delete computePassEncoder;
     delete renderPassEncoder;
+    delete copyPassEncoder;
 }
 
 void VulkanCommandBuffer::Clear()
@@ -2365,11 +3417,19 @@ void VulkanCommandBuffer::Clear()
     {
         surface->Release();
     }
+    ResetBindGroups();
+    for (auto& it : descriptorSets)
+    {
+        it.first->Release();
+    }
+    descriptorSets.clear();
     SafeRelease(currentPipelineLayout);
     presentSurfaces.clear();
     memoryBarriers.clear();
     imageBarriers.clear();
     bufferBarriers.clear();
+    passTextures.clear();
+    uploadWaitValue = 0;
 }
 
 void VulkanCommandBuffer::Begin(uint32_t frameIndex, const GPUCommandBufferDesc* desc)
@@ -2380,9 +3440,12 @@ void VulkanCommandBuffer::Begin(uint32_t frameIndex, const GPUCommandBufferDesc*
     //frameAllocators[frameIndex].Reset();
     computePassEncoder->Clear();
     renderPassEncoder->Clear();
+    copyPassEncoder->Clear();
     Clear();
 
     VK_CHECK(queue->device->vkResetCommandPool(queue->device->handle, commandPools[frameIndex], 0));
+    descriptorAllocators[frameIndex].Reset();
+    this->frameIndex = frameIndex;
     handle = commandBuffers[frameIndex];
 
     VkCommandBufferBeginInfo beginInfo = {};
@@ -2454,6 +3517,14 @@ VkCommandBuffer VulkanCommandBuffer::End()
     }
     CommitBarriers();
 
+#if defined(_DEBUG)
+    for (const VulkanTexture* texture : layoutChangedTextures)
+    {
+        texture->unsubmittedLayoutChanges--;
+    }
+    layoutChangedTextures.clear();
+#endif
+
     if (hasLabel)
     {
         PopDebugGroup();
@@ -2515,6 +3586,45 @@ void VulkanCommandBuffer::TextureBarrier(const VulkanTexture* texture, TextureLa
             texture->imageLayouts[iterSubresource] = newLayout;
         }
     }
+
+#if defined(_DEBUG)
+    texture->unsubmittedLayoutChanges++;
+    layoutChangedTextures.push_back(texture);
+#endif
+}
+
+void VulkanCommandBuffer::PassTextureBarrier(const VulkanTexture* texture, TextureLayout newLayout, uint32_t baseMiplevel, uint32_t levelCount, uint32_t layerCount)
+{
+    // Only sampled textures have a read layout to return to.
+    if (newLayout != TextureLayout::ShaderResource && (texture->desc.usage & GPUTextureUsage_ShaderRead))
+    {
+        passTextures.push_back({ texture, baseMiplevel, levelCount, layerCount });
+    }
+
+    TextureBarrier(texture, newLayout, baseMiplevel, levelCount, 0, layerCount);
+}
+
+void VulkanCommandBuffer::RestorePassTextures()
+{
+    // Bind groups and the bindless heap describe sampled textures in ShaderResource, and render passes can't
+    // transition them once rendering began, so attachments and storage images written by a pass are returned here.
+    for (const PassTexture& entry : passTextures)
+    {
+        TextureBarrier(entry.texture, TextureLayout::ShaderResource, entry.baseMipLevel, entry.levelCount, 0, entry.layerCount);
+    }
+    passTextures.clear();
+    CommitBarriers();
+}
+
+void VulkanCommandBuffer::GlobalBarrier(VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+{
+    VkMemoryBarrier2 barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    barrier.srcStageMask = srcStageMask;
+    barrier.srcAccessMask = srcAccessMask;
+    barrier.dstStageMask = dstStageMask;
+    barrier.dstAccessMask = dstAccessMask;
+    memoryBarriers.push_back(barrier);
 }
 
 void VulkanCommandBuffer::CommitBarriers()
@@ -2539,13 +3649,119 @@ void VulkanCommandBuffer::CommitBarriers()
     numBarriersToCommit = 0;
 }
 
-void VulkanCommandBuffer::SetPipelineLayout(VulkanPipelineLayout* newPipelineLayout)
+void VulkanCommandBuffer::SetPipelineLayout(VulkanPipelineLayout* newPipelineLayout, VkPipelineBindPoint bindPoint)
 {
     if (currentPipelineLayout == newPipelineLayout)
         return;
 
+    SafeRelease(currentPipelineLayout);
     currentPipelineLayout = newPipelineLayout;
     currentPipelineLayout->AddRef();
+
+    if (currentPipelineLayout->bindless)
+    {
+        device->bindlessManager.Bind(handle, bindPoint, currentPipelineLayout->handle);
+    }
+
+    // Layout change may disturb set compatibility, rebind everything on next draw/dispatch.
+    for (uint32_t i = 0; i < GPU_MAX_BIND_GROUPS; ++i)
+    {
+        if (bindGroups[i] != nullptr)
+            dirtyBindGroups |= (1u << i);
+    }
+}
+
+void VulkanCommandBuffer::SetBindGroup(uint32_t groupIndex, VulkanBindGroup* bindGroup)
+{
+    if (bindGroups[groupIndex] == bindGroup)
+        return;
+
+    SafeRelease(bindGroups[groupIndex]);
+    bindGroups[groupIndex] = bindGroup;
+    if (bindGroup != nullptr)
+    {
+        bindGroup->AddRef();
+        dirtyBindGroups |= (1u << groupIndex);
+    }
+}
+
+void VulkanCommandBuffer::ResetBindGroups()
+{
+    for (uint32_t i = 0; i < GPU_MAX_BIND_GROUPS; ++i)
+    {
+        SafeRelease(bindGroups[i]);
+    }
+    dirtyBindGroups = 0;
+}
+
+VkDescriptorSet VulkanCommandBuffer::GetDescriptorSet(VulkanBindGroup* bindGroup)
+{
+    auto it = descriptorSets.find(bindGroup);
+    if (it != descriptorSets.end())
+        return it->second;
+
+    VkDescriptorSet descriptorSet = descriptorAllocators[frameIndex].Allocate(bindGroup->layout->handle);
+    if (descriptorSet == VK_NULL_HANDLE)
+        return VK_NULL_HANDLE;
+
+    descriptorWrites.assign(bindGroup->writes.begin(), bindGroup->writes.end());
+    for (VkWriteDescriptorSet& write : descriptorWrites)
+    {
+        write.dstSet = descriptorSet;
+    }
+
+    device->vkUpdateDescriptorSets(device->handle, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+    bindGroup->AddRef();
+    descriptorSets[bindGroup] = descriptorSet;
+    return descriptorSet;
+}
+
+void VulkanCommandBuffer::FlushBindGroups(VkPipelineBindPoint bindPoint)
+{
+    if (dirtyBindGroups == 0 || currentPipelineLayout == nullptr)
+        return;
+
+    const uint32_t groupCount = static_cast<uint32_t>(currentPipelineLayout->bindGroupLayouts.size());
+
+    // Barriers are not allowed inside dynamic rendering. Draws rely on every pass leaving the textures it
+    // transitioned back in ShaderResource (see RestorePassTextures), which covers sampled bind group entries.
+    if (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE)
+    {
+        for (uint32_t i = 0; i < groupCount; ++i)
+        {
+            if (!(dirtyBindGroups & (1u << i)) || bindGroups[i] == nullptr)
+                continue;
+
+            for (const auto& [texture, layout] : bindGroups[i]->textures)
+            {
+                PassTextureBarrier(texture, layout, 0, texture->desc.mipLevelCount, texture->GetArrayLayerCount());
+            }
+        }
+        CommitBarriers();
+    }
+
+    for (uint32_t i = 0; i < groupCount; ++i)
+    {
+        if (!(dirtyBindGroups & (1u << i)) || bindGroups[i] == nullptr)
+            continue;
+
+        VulkanBindGroup* bindGroup = bindGroups[i];
+        if (bindGroup->layout != currentPipelineLayout->bindGroupLayouts[i])
+        {
+            agpuLogError("Vulkan: BindGroup %u layout does not match the pipeline layout", i);
+            continue;
+        }
+
+        VkDescriptorSet descriptorSet = GetDescriptorSet(bindGroup);
+        if (descriptorSet == VK_NULL_HANDLE)
+            continue;
+
+        device->vkCmdBindDescriptorSets(handle, bindPoint, currentPipelineLayout->handle, i, 1, &descriptorSet, 0, nullptr);
+    }
+
+    // Groups beyond the pipeline layout stay dirty until a layout that uses them is bound.
+    dirtyBindGroups &= ~((1u << groupCount) - 1u);
 }
 
 void VulkanCommandBuffer::SetPushConstants(uint32_t pushConstantIndex, const void* data, uint32_t size)
@@ -2668,9 +3884,28 @@ GPURenderPassEncoder VulkanCommandBuffer::BeginRenderPass(const GPURenderPassDes
     return renderPassEncoder;
 }
 
+GPUCopyPassEncoder VulkanCommandBuffer::BeginCopyPass(const GPUCopyPassDesc& desc)
+{
+    if (encoderActive)
+    {
+        agpuLogError("CommandEncoder already active");
+        return nullptr;
+    }
+
+    copyPassEncoder->Begin(desc);
+    encoderActive = true;
+    return copyPassEncoder;
+}
+
+void VulkanCommandBuffer::WaitUpload(GPUUploadTicket ticket)
+{
+    uploadWaitValue = std::max(uploadWaitValue, ticket);
+}
+
 /* VulkanQueue */
 void VulkanQueue::WaitIdle()
 {
+    std::scoped_lock lock(mutex);
     VK_CHECK(device->vkQueueWaitIdle(handle));
 }
 
@@ -2688,8 +3923,11 @@ GPUCommandBuffer VulkanQueue::AcquireCommandBuffer(const GPUCommandBufferDesc* d
         commandBuffer->computePassEncoder->commandBuffer = commandBuffer;
         commandBuffer->renderPassEncoder = new VulkanRenderPassEncoder();
         commandBuffer->renderPassEncoder->commandBuffer = commandBuffer;
+        commandBuffer->copyPassEncoder = new VulkanCopyPassEncoder();
+        commandBuffer->copyPassEncoder->commandBuffer = commandBuffer;
         commandBuffer->commandPools.resize(device->maxFramesInFlight);
         commandBuffer->commandBuffers.resize(device->maxFramesInFlight);
+        commandBuffer->descriptorAllocators.resize(device->maxFramesInFlight);
 
         // TODO: Move to per frame command pools and allocate from there? instead of per command buffer * frame?
         for (uint32_t i = 0; i < device->maxFramesInFlight; ++i)
@@ -2706,6 +3944,8 @@ GPUCommandBuffer VulkanQueue::AcquireCommandBuffer(const GPUCommandBufferDesc* d
             commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
             commandBufferInfo.commandBufferCount = 1;
             VK_CHECK(device->vkAllocateCommandBuffers(device->handle, &commandBufferInfo, &commandBuffer->commandBuffers[i]));
+
+            commandBuffer->descriptorAllocators[i].device = device;
         }
 
         commandBuffers.push_back(commandBuffer);
@@ -2728,6 +3968,23 @@ void VulkanQueue::Submit(uint32_t numCommandBuffers, GPUCommandBuffer* commandBu
     std::vector<VkSemaphore> swapchainWaitSemaphores;
     bool submitPresent = false;
 
+    // Pending resource uploads go out first, queues other than graphics wait for their final transitions.
+    const uint64_t uploadValue = device->copyAllocator.Flush();
+    uint64_t uploadWaitValue = (queueType != GPUCommandQueueType_Graphics) ? uploadValue : 0;
+    for (uint32_t i = 0; i < numCommandBuffers; i++)
+    {
+        uploadWaitValue = std::max(uploadWaitValue, static_cast<VulkanCommandBuffer*>(commandBuffers[i])->uploadWaitValue);
+    }
+
+    if (uploadWaitValue > 0)
+    {
+        VkSemaphoreSubmitInfo& waitSemaphore = submitWaitSemaphoreInfos.emplace_back();
+        waitSemaphore.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        waitSemaphore.semaphore = device->copyAllocator.timelineSemaphore;
+        waitSemaphore.value = std::min(uploadWaitValue, uploadValue);
+        waitSemaphore.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+
     for (uint32_t i = 0; i < numCommandBuffers; i++)
     {
         VulkanCommandBuffer* commandBuffer = static_cast<VulkanCommandBuffer*>(commandBuffers[i]);
@@ -2763,6 +4020,11 @@ void VulkanQueue::Submit(uint32_t numCommandBuffers, GPUCommandBuffer* commandBu
         commandBuffer->presentSurfaces.clear();
     }
 
+    VkSemaphoreSubmitInfo& submitSignalSemaphore = submitSignalSemaphoreInfos.emplace_back();
+    submitSignalSemaphore.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    submitSignalSemaphore.semaphore = submitSemaphore;
+    submitSignalSemaphore.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
     VkSubmitInfo2 submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
     submitInfo.waitSemaphoreInfoCount = (uint32_t)submitWaitSemaphoreInfos.size();
@@ -2771,7 +4033,14 @@ void VulkanQueue::Submit(uint32_t numCommandBuffers, GPUCommandBuffer* commandBu
     submitInfo.pCommandBufferInfos = submitCommandBufferInfos.data();
     submitInfo.signalSemaphoreInfoCount = (uint32_t)submitSignalSemaphoreInfos.size();
     submitInfo.pSignalSemaphoreInfos = submitSignalSemaphoreInfos.data();
-    VK_CHECK(device->vkQueueSubmit2(handle, 1, &submitInfo, fence));
+
+    // The upload allocator submits to this queue from other threads, timeline values must be signaled in order.
+    {
+        std::scoped_lock lock(mutex);
+        submitSignalSemaphore.value = submitValue.load(std::memory_order_relaxed) + 1;
+        VK_CHECK(device->vkQueueSubmit2(handle, 1, &submitInfo, fence));
+        submitValue.store(submitSignalSemaphore.value, std::memory_order_release);
+    }
 
     if (!submitPresent)
         return;
@@ -2784,7 +4053,10 @@ void VulkanQueue::Submit(uint32_t numCommandBuffers, GPUCommandBuffer* commandBu
     presentInfo.pSwapchains = submitSwapchains.data();
     presentInfo.pImageIndices = submitSwapchainImageIndices.data();
 
-    const VkResult result = device->vkQueuePresentKHR(device->queues[GPUCommandQueueType_Graphics].handle, &presentInfo);
+    VulkanQueue& presentQueue = device->queues[GPUCommandQueueType_Graphics];
+    std::unique_lock<std::mutex> presentLock(presentQueue.mutex);
+    const VkResult result = device->vkQueuePresentKHR(presentQueue.handle, &presentInfo);
+    presentLock.unlock();
     if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
     {
         // Handle outdated error in present
@@ -2853,253 +4125,850 @@ void VulkanQueue::Submit(VkFence fence)
         }
     }
 
-    swapchainUpdates.clear();
-    submitSwapchains.clear();
-    submitSwapchainImageIndices.clear();
-    submitSignalSemaphores.clear();
-    // KHR_synchronization2
-    submitWaitSemaphoreInfos.clear();
-    submitSignalSemaphoreInfos.clear();
-    submitCommandBufferInfos.clear();
-#endif // TODO
+    swapchainUpdates.clear();
+    submitSwapchains.clear();
+    submitSwapchainImageIndices.clear();
+    submitSignalSemaphores.clear();
+    // KHR_synchronization2
+    submitWaitSemaphoreInfos.clear();
+    submitSignalSemaphoreInfos.clear();
+    submitCommandBufferInfos.clear();
+#endif // TODO
+
+}
+
+GPUUploadTicket VulkanQueue::WriteBuffer(GPUBuffer buffer, uint64_t bufferOffset, const void* data, uint64_t size)
+{
+    VulkanBuffer* backendBuffer = static_cast<VulkanBuffer*>(buffer);
+
+    // Upload memory buffers are staged too, a direct memcpy could overwrite data the GPU is still reading.
+    // Only graphics queue writes need the graphics queue to wait, others wait on submit.
+    const bool transitions = queueType == GPUCommandQueueType_Graphics;
+    VulkanUploadContext context = device->copyAllocator.Allocate(size, 16, transitions, this);
+    std::memcpy(context.uploadBufferData, data, size);
+
+    VkBufferCopy copyRegion = {};
+    copyRegion.srcOffset = context.uploadBufferOffset;
+    copyRegion.dstOffset = bufferOffset;
+    copyRegion.size = size;
+
+    device->vkCmdCopyBuffer(
+        context.transferCommandBuffer,
+        context.uploadBuffer->handle,
+        backendBuffer->handle,
+        1,
+        &copyRegion
+    );
+
+    return device->copyAllocator.Submit(context);
+}
+
+GPUUploadTicket VulkanQueue::WriteTexture(GPUTexture texture, uint32_t mipLevel, uint32_t arrayLayer, const GPUTextureData& data)
+{
+    VulkanTexture* backendTexture = static_cast<VulkanTexture*>(texture);
+    const GPUTextureDesc& desc = backendTexture->desc;
+    const VkImageAspectFlags aspectMask = GetImageAspectFlags(backendTexture->vkFormat, GPUTextureAspect_All);
+    if ((desc.usage & GPUTextureUsage_Transient) ||
+        aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
+    {
+        agpuLogError("WriteTexture is not supported for transient or depth stencil textures");
+        return 0;
+    }
+
+    const GPUPixelFormatInfo formatInfo = agpuPixelFormatGetInfo(desc.format);
+    const uint32_t levelWidth = std::max(1u, desc.width >> mipLevel);
+    const uint32_t levelHeight = std::max(1u, desc.height >> mipLevel);
+    const uint32_t levelDepth = (desc.dimension == GPUTextureDimension_3D) ? std::max(1u, desc.depthOrArrayLayers >> mipLevel) : 1u;
+    const uint32_t numBlocksX = std::max(1u, levelWidth / formatInfo.blockWidth);
+    const uint32_t numBlocksY = std::max(1u, levelHeight / formatInfo.blockHeight);
+    const uint32_t dstRowPitch = numBlocksX * formatInfo.bytesPerBlock;
+    const uint32_t dstSlicePitch = dstRowPitch * numBlocksY;
+    const uint32_t srcRowPitch = data.rowPitch != 0 ? data.rowPitch : dstRowPitch;
+    const uint32_t srcSlicePitch = data.slicePitch != 0 ? data.slicePitch : srcRowPitch * numBlocksY;
+
+    // Buffer offsets of image copies must be multiple of 4 and of the texel block size.
+    const uint64_t copyAlignment = (formatInfo.bytesPerBlock % 4u) == 0 ? formatInfo.bytesPerBlock : 4u;
+    const bool transitions = queueType == GPUCommandQueueType_Graphics;
+    VulkanUploadContext context = device->copyAllocator.Allocate(uint64_t(dstSlicePitch) * levelDepth, copyAlignment, transitions, this);
+
+    for (uint32_t z = 0; z < levelDepth; ++z)
+    {
+        uint8_t* dstSlice = static_cast<uint8_t*>(context.uploadBufferData) + uint64_t(dstSlicePitch) * z;
+        const uint8_t* srcSlice = static_cast<const uint8_t*>(data.pData) + uint64_t(srcSlicePitch) * z;
+        for (uint32_t y = 0; y < numBlocksY; ++y)
+        {
+            std::memcpy(dstSlice + dstRowPitch * y, srcSlice + srcRowPitch * y, dstRowPitch);
+        }
+    }
+
+#if defined(_DEBUG)
+    // Layouts are tracked at record time, the upload runs before any command buffer still being recorded.
+    if (backendTexture->unsubmittedLayoutChanges.load() > 0)
+    {
+        agpuLogError("WriteTexture: texture layout is changed by a command buffer which has not been submitted yet");
+    }
+#endif
+
+    const bool depthOnlyFormat = alimerPixelFormatIsDepthOnly(desc.format);
+    const uint32_t subresource = CalculateSubresource(mipLevel, arrayLayer, desc.mipLevelCount);
+    const TextureLayout currentLayout = backendTexture->imageLayouts[subresource];
+    const TextureLayout finalLayout = currentLayout == TextureLayout::Undefined ? TextureLayout::CopyDest : currentLayout;
+    const VkImageLayoutMapping mappingCurrent = ConvertImageLayout(currentLayout, depthOnlyFormat);
+    const VkImageLayoutMapping mappingCopy = ConvertImageLayout(TextureLayout::CopyDest, depthOnlyFormat);
+
+    VkImageMemoryBarrier2 barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    barrier.srcAccessMask = 0;
+    barrier.dstStageMask = mappingCopy.stageFlags;
+    barrier.dstAccessMask = mappingCopy.accessMask;
+    barrier.oldLayout = mappingCurrent.layout;
+    barrier.newLayout = mappingCopy.layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = backendTexture->handle;
+    barrier.subresourceRange.aspectMask = aspectMask;
+    barrier.subresourceRange.baseMipLevel = mipLevel;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = arrayLayer;
+    barrier.subresourceRange.layerCount = 1;
+
+    VkDependencyInfo dependencyInfo = {};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependencyInfo.imageMemoryBarrierCount = 1;
+    dependencyInfo.pImageMemoryBarriers = &barrier;
+    if (currentLayout != TextureLayout::CopyDest)
+    {
+        device->vkCmdPipelineBarrier2(context.transferCommandBuffer, &dependencyInfo);
+    }
+
+    VkBufferImageCopy copyRegion = {};
+    copyRegion.bufferOffset = context.uploadBufferOffset;
+    copyRegion.imageSubresource.aspectMask = aspectMask;
+    copyRegion.imageSubresource.mipLevel = mipLevel;
+    copyRegion.imageSubresource.baseArrayLayer = arrayLayer;
+    copyRegion.imageSubresource.layerCount = 1;
+    copyRegion.imageExtent.width = levelWidth;
+    copyRegion.imageExtent.height = levelHeight;
+    copyRegion.imageExtent.depth = levelDepth;
+
+    device->vkCmdCopyBufferToImage(
+        context.transferCommandBuffer,
+        context.uploadBuffer->handle,
+        backendTexture->handle,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &copyRegion
+    );
+
+    if (finalLayout != TextureLayout::CopyDest)
+    {
+        const VkImageLayoutMapping mappingAfter = ConvertImageLayout(finalLayout, depthOnlyFormat);
+
+        barrier.srcStageMask = mappingCopy.stageFlags;
+        barrier.srcAccessMask = mappingCopy.accessMask;
+        barrier.oldLayout = mappingCopy.layout;
+        barrier.newLayout = mappingAfter.layout;
+        if (transitions)
+        {
+            barrier.dstStageMask = mappingAfter.stageFlags;
+            barrier.dstAccessMask = mappingAfter.accessMask;
+            device->vkCmdPipelineBarrier2(context.transitionCommandBuffer, &dependencyInfo);
+        }
+        else
+        {
+            // Copy queue can't name shader stages, the timeline wait makes the data visible.
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            barrier.dstAccessMask = 0;
+            device->vkCmdPipelineBarrier2(context.transferCommandBuffer, &dependencyInfo);
+        }
+    }
+    backendTexture->imageLayouts[subresource] = finalLayout;
 
+    return device->copyAllocator.Submit(context);
 }
 
 /* VulkanCopyAllocator */
 void VulkanCopyAllocator::Init(VulkanDevice* device_)
 {
     device = device_;
+
+    VkSemaphoreTypeCreateInfo timelineInfo = {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &timelineInfo;
+    VK_CHECK(device->vkCreateSemaphore(device->handle, &semaphoreInfo, nullptr, &timelineSemaphore));
+
+    GPUBufferDesc ringBufferDesc;
+    ringBufferDesc.label = "CopyAllocator::UploadRing";
+    ringBufferDesc.size = kRingSize;
+    ringBufferDesc.memoryType = GPUMemoryType_Upload;
+    ringBuffer = static_cast<VulkanBuffer*>(device->CreateBuffer(ringBufferDesc, nullptr));
+    ALIMER_ASSERT(ringBuffer != nullptr);
+    ringData = static_cast<uint8_t*>(ringBuffer->pMappedData);
 }
 
 void VulkanCopyAllocator::Shutdown()
 {
-    device->vkQueueWaitIdle(device->queues[GPUCommandQueueType_Copy].handle);
-    for (auto& context : freeList)
+    if (currentBatch != nullptr)
+    {
+        freeBatches.push_back(currentBatch);
+        currentBatch = nullptr;
+    }
+
+    for (VulkanUploadBatch* batch : pendingBatches)
     {
-        device->vkDestroyCommandPool(device->handle, context.transferCommandPool, nullptr);
-        device->vkDestroyCommandPool(device->handle, context.transitionCommandPool, nullptr);
-        device->vkDestroySemaphore(device->handle, context.semaphores[0], nullptr);
-        device->vkDestroySemaphore(device->handle, context.semaphores[1], nullptr);
-        device->vkDestroySemaphore(device->handle, context.semaphores[2], nullptr);
-        device->vkDestroyFence(device->handle, context.fence, nullptr);
+        freeBatches.push_back(batch);
+    }
+    pendingBatches.clear();
+
+    for (VulkanUploadBatch* batch : freeBatches)
+    {
+        device->vkDestroyCommandPool(device->handle, batch->transferCommandPool, nullptr);
+        device->vkDestroyCommandPool(device->handle, batch->transitionCommandPool, nullptr);
+        for (VulkanBuffer* stagingBuffer : batch->stagingBuffers)
+        {
+            stagingBuffer->Release();
+        }
+        delete batch;
+    }
+    freeBatches.clear();
 
-        context.uploadBuffer->Release();
-        context.uploadBuffer = nullptr;
-        context.uploadBufferData = nullptr;
+    if (ringBuffer != nullptr)
+    {
+        ringBuffer->Release();
+        ringBuffer = nullptr;
+        ringData = nullptr;
     }
+
+    device->vkDestroySemaphore(device->handle, timelineSemaphore, nullptr);
+    timelineSemaphore = VK_NULL_HANDLE;
 }
 
-VulkanUploadContext VulkanCopyAllocator::Allocate(uint64_t size)
+VulkanUploadContext VulkanCopyAllocator::Allocate(uint64_t size, uint64_t alignment, bool transitions, const VulkanQueue* dependency)
 {
     VulkanUploadContext context;
 
     locker.lock();
-    // Try to search for a staging buffer that can fit the request:
-    for (size_t i = 0; i < freeList.size(); ++i)
+    Retire(false);
+
+    VulkanBuffer* stagingBuffer = nullptr;
+    if (size > kMaxRingAllocationSize)
+    {
+        // Large uploads would starve the ring, give them a dedicated staging buffer released on retirement.
+        GPUBufferDesc stagingBufferDesc;
+        stagingBufferDesc.label = "CopyAllocator::StagingBuffer";
+        stagingBufferDesc.size = size;
+        stagingBufferDesc.memoryType = GPUMemoryType_Upload;
+        stagingBuffer = static_cast<VulkanBuffer*>(device->CreateBuffer(stagingBufferDesc, nullptr));
+        ALIMER_ASSERT(stagingBuffer != nullptr);
+
+        context.uploadBuffer = stagingBuffer;
+        context.uploadBufferOffset = 0;
+        context.uploadBufferData = stagingBuffer->pMappedData;
+    }
+    else if (size > 0)
     {
-        if (freeList[i].uploadBufferSize >= size)
+        for (;;)
         {
-            if (device->vkGetFenceStatus(device->handle, freeList[i].fence) == VK_SUCCESS)
+            uint64_t offset = (ringHead + alignment - 1) / alignment * alignment;
+            if ((offset % kRingSize) + size > kRingSize)
             {
-                context = std::move(freeList[i]);
-                std::swap(freeList[i], freeList.back());
-                freeList.pop_back();
+                // Allocations never straddle the end of the ring.
+                offset = (offset / kRingSize + 1) * kRingSize;
+            }
+
+            if (offset + size - ringTail <= kRingSize)
+            {
+                ringHead = offset + size;
+                context.uploadBuffer = ringBuffer;
+                context.uploadBufferOffset = offset % kRingSize;
+                context.uploadBufferData = ringData + context.uploadBufferOffset;
                 break;
             }
+
+            // Ring is full: submit what is recorded and wait for the oldest batch.
+            FlushLocked();
+            Retire(true);
         }
     }
+
+    if (currentBatch == nullptr)
+    {
+        currentBatch = AcquireBatch();
+    }
+
+    currentBatch->ringEnd = ringHead;
+    if (stagingBuffer != nullptr)
+    {
+        currentBatch->stagingBuffers.push_back(stagingBuffer);
+    }
+
+    if (dependency != nullptr)
+    {
+        uint64_t& waitValue = currentBatch->queueWaitValues[dependency->queueType];
+        waitValue = std::max(waitValue, dependency->submitValue.load(std::memory_order_acquire));
+    }
+
+    context.transferCommandBuffer = currentBatch->transferCommandBuffer;
+    if (transitions)
+    {
+        currentBatch->hasTransitions = true;
+        context.transitionCommandBuffer = currentBatch->transitionCommandBuffer;
+    }
+    return context;
+}
+
+uint64_t VulkanCopyAllocator::Submit(VulkanUploadContext context)
+{
+    ALIMER_ASSERT(context.transferCommandBuffer == currentBatch->transferCommandBuffer);
+    ALIMER_UNUSED(context);
+
+    // Commands stay in the current batch until the next flush, which signals submittedValue + 2.
+    const uint64_t value = submittedValue + 2;
     locker.unlock();
+    return value;
+}
+
+uint64_t VulkanCopyAllocator::Flush()
+{
+    std::scoped_lock lock(locker);
+    const uint64_t value = FlushLocked();
+    Retire(false);
+    return value;
+}
+
+bool VulkanCopyAllocator::IsComplete(uint64_t value)
+{
+    uint64_t completedValue = 0;
+    VK_CHECK(device->vkGetSemaphoreCounterValue(device->handle, timelineSemaphore, &completedValue));
+    return completedValue >= value;
+}
+
+void VulkanCopyAllocator::Wait(uint64_t value)
+{
+    // Waiting on the batch still being recorded requires submitting it first.
+    if (Flush() < value)
+        return;
+
+    VkSemaphoreWaitInfo waitInfo = {};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &timelineSemaphore;
+    waitInfo.pValues = &value;
+    VK_CHECK(device->vkWaitSemaphores(device->handle, &waitInfo, UINT64_MAX));
+}
+
+VulkanQueue* VulkanCopyAllocator::GetTransferQueue() const
+{
+    if (device->queues[GPUCommandQueueType_Copy].handle != VK_NULL_HANDLE)
+        return &device->queues[GPUCommandQueueType_Copy];
 
-    // If no buffer was found that fits the data then create new one.
-    if (!context.IsValid())
+    return &device->queues[GPUCommandQueueType_Graphics];
+}
+
+VulkanUploadBatch* VulkanCopyAllocator::AcquireBatch()
+{
+    VulkanUploadBatch* batch = nullptr;
+    if (!freeBatches.empty())
+    {
+        batch = freeBatches.back();
+        freeBatches.pop_back();
+
+        VK_CHECK(device->vkResetCommandPool(device->handle, batch->transferCommandPool, 0));
+        VK_CHECK(device->vkResetCommandPool(device->handle, batch->transitionCommandPool, 0));
+    }
+    else
     {
+        batch = new VulkanUploadBatch();
+
         VkCommandPoolCreateInfo poolCreateInfo = {};
         poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
         poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-        poolCreateInfo.queueFamilyIndex = device->adapter->queueFamilyIndices.familyIndices[GPUCommandQueueType_Copy];
-        VK_CHECK(device->vkCreateCommandPool(device->handle, &poolCreateInfo, nullptr, &context.transferCommandPool));
+        poolCreateInfo.queueFamilyIndex = device->adapter->queueFamilyIndices.familyIndices[GetTransferQueue()->queueType];
+        VK_CHECK(device->vkCreateCommandPool(device->handle, &poolCreateInfo, nullptr, &batch->transferCommandPool));
 
         poolCreateInfo.queueFamilyIndex = device->adapter->queueFamilyIndices.familyIndices[GPUCommandQueueType_Graphics];
-        VK_CHECK(device->vkCreateCommandPool(device->handle, &poolCreateInfo, nullptr, &context.transitionCommandPool));
+        VK_CHECK(device->vkCreateCommandPool(device->handle, &poolCreateInfo, nullptr, &batch->transitionCommandPool));
 
         VkCommandBufferAllocateInfo commandBufferInfo = {};
         commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        commandBufferInfo.commandPool = context.transferCommandPool;
+        commandBufferInfo.commandPool = batch->transferCommandPool;
         commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
         commandBufferInfo.commandBufferCount = 1u;
-        VK_CHECK(device->vkAllocateCommandBuffers(device->handle, &commandBufferInfo, &context.transferCommandBuffer));
+        VK_CHECK(device->vkAllocateCommandBuffers(device->handle, &commandBufferInfo, &batch->transferCommandBuffer));
 
-        commandBufferInfo.commandPool = context.transitionCommandPool;
-        VK_CHECK(device->vkAllocateCommandBuffers(device->handle, &commandBufferInfo, &context.transitionCommandBuffer));
+        commandBufferInfo.commandPool = batch->transitionCommandPool;
+        VK_CHECK(device->vkAllocateCommandBuffers(device->handle, &commandBufferInfo, &batch->transitionCommandBuffer));
+    }
+
+    // Begin command list in valid state.
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = nullptr;
+    VK_CHECK(device->vkBeginCommandBuffer(batch->transferCommandBuffer, &beginInfo));
+    VK_CHECK(device->vkBeginCommandBuffer(batch->transitionCommandBuffer, &beginInfo));
+
+    batch->timelineValue = 0;
+    batch->ringEnd = ringHead;
+    batch->hasTransitions = false;
+    for (uint64_t& waitValue : batch->queueWaitValues)
+    {
+        waitValue = 0;
+    }
+    return batch;
+}
 
-        VkFenceCreateInfo fenceInfo = {};
-        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        VK_CHECK(device->vkCreateFence(device->handle, &fenceInfo, nullptr, &context.fence));
+void VulkanCopyAllocator::Retire(bool wait)
+{
+    if (pendingBatches.empty())
+    {
+        if (currentBatch == nullptr)
+            ringTail = ringHead;
+        return;
+    }
 
-        VkSemaphoreCreateInfo semaphoreInfo = {};
-        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-        VK_CHECK(device->vkCreateSemaphore(device->handle, &semaphoreInfo, nullptr, &context.semaphores[0]));
-        VK_CHECK(device->vkCreateSemaphore(device->handle, &semaphoreInfo, nullptr, &context.semaphores[1]));
-        VK_CHECK(device->vkCreateSemaphore(device->handle, &semaphoreInfo, nullptr, &context.semaphores[2]));
+    uint64_t completedValue = 0;
+    VK_CHECK(device->vkGetSemaphoreCounterValue(device->handle, timelineSemaphore, &completedValue));
 
-        context.uploadBufferSize = NextPow2(size);
-        context.uploadBufferSize = std::max<uint64_t>(context.uploadBufferSize, uint64_t(65536));
+    while (!pendingBatches.empty())
+    {
+        VulkanUploadBatch* batch = pendingBatches.front();
+        if (completedValue < batch->timelineValue)
+        {
+            if (!wait)
+                break;
 
-        GPUBufferDesc uploadBufferDesc;
-        uploadBufferDesc.label = "CopyAllocator::UploadBuffer";
-        uploadBufferDesc.size = context.uploadBufferSize;
-        uploadBufferDesc.memoryType = GPUMemoryType_Upload;
+            VkSemaphoreWaitInfo waitInfo = {};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &timelineSemaphore;
+            waitInfo.pValues = &batch->timelineValue;
+            VK_CHECK(device->vkWaitSemaphores(device->handle, &waitInfo, UINT64_MAX));
+            completedValue = batch->timelineValue;
+            wait = false;
+        }
 
-        if (context.uploadBuffer)
+        pendingBatches.pop_front();
+        ringTail = batch->ringEnd;
+        for (VulkanBuffer* stagingBuffer : batch->stagingBuffers)
         {
-            context.uploadBuffer->Release();
+            stagingBuffer->Release();
         }
-        context.uploadBuffer = static_cast<VulkanBuffer*>(device->CreateBuffer(uploadBufferDesc, nullptr));
-        ALIMER_ASSERT(context.uploadBuffer != nullptr);
-        context.uploadBufferData = context.uploadBuffer->pMappedData;
+        batch->stagingBuffers.clear();
+        freeBatches.push_back(batch);
     }
+}
 
-    // Begin command list in valid state.
-    VK_CHECK(device->vkResetCommandPool(device->handle, context.transferCommandPool, 0));
-    VK_CHECK(device->vkResetCommandPool(device->handle, context.transitionCommandPool, 0));
+uint64_t VulkanCopyAllocator::FlushLocked()
+{
+    if (currentBatch == nullptr)
+        return submittedValue;
 
-    VkCommandBufferBeginInfo beginInfo = {};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    beginInfo.pInheritanceInfo = nullptr;
-    VK_CHECK(device->vkBeginCommandBuffer(context.transferCommandBuffer, &beginInfo));
-    VK_CHECK(device->vkBeginCommandBuffer(context.transitionCommandBuffer, &beginInfo));
-    VK_CHECK(device->vkResetFences(device->handle, 1, &context.fence));
+    VulkanUploadBatch* batch = currentBatch;
+    currentBatch = nullptr;
 
-    return context;
-}
+    VK_CHECK(device->vkEndCommandBuffer(batch->transferCommandBuffer));
+    VK_CHECK(device->vkEndCommandBuffer(batch->transitionCommandBuffer));
 
-void VulkanCopyAllocator::Submit(VulkanUploadContext context)
-{
-    VK_CHECK(device->vkEndCommandBuffer(context.transferCommandBuffer));
-    VK_CHECK(device->vkEndCommandBuffer(context.transitionCommandBuffer));
+    // Each batch advances the timeline by two: the copy queue signals the first value when
+    // graphics transitions follow, otherwise it signals the batch value directly.
+    const uint64_t previousValue = submittedValue;
+    const uint64_t copyValue = batch->hasTransitions ? submittedValue + 1 : submittedValue + 2;
+    submittedValue += 2;
+    batch->timelineValue = submittedValue;
 
-    VkSemaphoreSubmitInfo waitSemaphoreInfo{};
-    waitSemaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    VkSemaphoreSubmitInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    semaphoreInfo.semaphore = timelineSemaphore;
+    semaphoreInfo.value = copyValue;
+    semaphoreInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
 
     // Copy queue first
     {
-        VkCommandBufferSubmitInfo commandBufferInfo{};
-        commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
-        commandBufferInfo.commandBuffer = context.transferCommandBuffer;
+        uint32_t waitSemaphoreCount = 0;
+        VkSemaphoreSubmitInfo waitSemaphoreInfos[_GPUCommandQueueType_Count + 1] = {};
+
+        // Timeline values must increase, so wait for the previous graphics signal before overtaking it.
+        if (lastBatchHasTransitions)
+        {
+            waitSemaphoreInfos[waitSemaphoreCount] = semaphoreInfo;
+            waitSemaphoreInfos[waitSemaphoreCount].value = previousValue;
+            waitSemaphoreCount++;
+        }
+
+        // Only the queues that wrote into this batch may still read its destinations, resource creation has no dependency.
+        for (uint32_t i = 0; i < _GPUCommandQueueType_Count; ++i)
+        {
+            const VulkanQueue& queue = device->queues[i];
+            if (queue.handle == VK_NULL_HANDLE || batch->queueWaitValues[i] == 0)
+                continue;
+
+            VkSemaphoreSubmitInfo& waitSemaphoreInfo = waitSemaphoreInfos[waitSemaphoreCount++];
+            waitSemaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            waitSemaphoreInfo.semaphore = queue.submitSemaphore;
+            waitSemaphoreInfo.value = batch->queueWaitValues[i];
+            waitSemaphoreInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        }
 
-        VkSemaphoreSubmitInfo signalSemaphoreInfo = {};
-        signalSemaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-        signalSemaphoreInfo.semaphore = context.semaphores[0]; // Signal for graphics queue
-        signalSemaphoreInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        VkCommandBufferSubmitInfo commandBufferInfo = {};
+        commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+        commandBufferInfo.commandBuffer = batch->transferCommandBuffer;
 
         VkSubmitInfo2 submitInfo = {};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-        submitInfo.waitSemaphoreInfoCount = 0;
-        submitInfo.pWaitSemaphoreInfos = nullptr;
+        submitInfo.waitSemaphoreInfoCount = waitSemaphoreCount;
+        submitInfo.pWaitSemaphoreInfos = waitSemaphoreInfos;
         submitInfo.commandBufferInfoCount = 1;
         submitInfo.pCommandBufferInfos = &commandBufferInfo;
         submitInfo.signalSemaphoreInfoCount = 1;
-        submitInfo.pSignalSemaphoreInfos = &signalSemaphoreInfo;
+        submitInfo.pSignalSemaphoreInfos = &semaphoreInfo;
 
-        std::scoped_lock lock(device->queues[GPUCommandQueueType_Copy].mutex);
-        VK_CHECK(device->vkQueueSubmit2(device->queues[GPUCommandQueueType_Copy].handle, 1, &submitInfo, VK_NULL_HANDLE));
+        VulkanQueue* transferQueue = GetTransferQueue();
+        std::scoped_lock lock(transferQueue->mutex);
+        VK_CHECK(device->vkQueueSubmit2(transferQueue->handle, 1, &submitInfo, VK_NULL_HANDLE));
     }
 
-    // Graphics queue
+    // Graphics queue applies the final layout transitions and signals batch completion.
+    if (batch->hasTransitions)
     {
-        waitSemaphoreInfo.semaphore = context.semaphores[0]; // Wait for copy queue
-        waitSemaphoreInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        VkSemaphoreSubmitInfo signalSemaphoreInfo = semaphoreInfo;
+        signalSemaphoreInfo.value = batch->timelineValue;
 
-        VkCommandBufferSubmitInfo commandBufferInfo{};
+        VkCommandBufferSubmitInfo commandBufferInfo = {};
         commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
-        commandBufferInfo.commandBuffer = context.transitionCommandBuffer;
-
-        VkSemaphoreSubmitInfo signalSemaphoreInfos[2] = {};
-        signalSemaphoreInfos[0].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-        signalSemaphoreInfos[0].semaphore = context.semaphores[1]; // Signal for compute queue
-        signalSemaphoreInfos[0].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Signal for compute queue
+        commandBufferInfo.commandBuffer = batch->transitionCommandBuffer;
 
         VkSubmitInfo2 submitInfo = {};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
         submitInfo.waitSemaphoreInfoCount = 1;
-        submitInfo.pWaitSemaphoreInfos = &waitSemaphoreInfo;
+        submitInfo.pWaitSemaphoreInfos = &semaphoreInfo;
         submitInfo.commandBufferInfoCount = 1;
         submitInfo.pCommandBufferInfos = &commandBufferInfo;
+        submitInfo.signalSemaphoreInfoCount = 1;
+        submitInfo.pSignalSemaphoreInfos = &signalSemaphoreInfo;
 
-        //if (device->queues[QUEUE_VIDEO_DECODE].queue != VK_NULL_HANDLE)
-        //{
-        //    signalSemaphoreInfos[1].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-        //    signalSemaphoreInfos[1].semaphore = cmd.semaphores[2]; // signal for video decode queue
-        //    signalSemaphoreInfos[1].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // signal for video decode queue
-        //    submitInfo.signalSemaphoreInfoCount = 2;
-        //}
-        //else
+        std::scoped_lock lock(device->queues[GPUCommandQueueType_Graphics].mutex);
+        VK_CHECK(device->vkQueueSubmit2(device->queues[GPUCommandQueueType_Graphics].handle, 1, &submitInfo, VK_NULL_HANDLE));
+    }
+
+    lastBatchHasTransitions = batch->hasTransitions;
+    pendingBatches.push_back(batch);
+    return submittedValue;
+}
+
+/* VulkanPipelineCompiler */
+void VulkanPipelineCompiler::Submit(std::function<void(bool cancelled)>&& job)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (threads.empty())
+    {
+        // Leave one core for the thread recording commands
+        const uint32_t threadCount = std::clamp(std::thread::hardware_concurrency(), 2u, 5u) - 1u;
+        for (uint32_t i = 0; i < threadCount; ++i)
         {
-            submitInfo.signalSemaphoreInfoCount = 1;
+            threads.emplace_back(&VulkanPipelineCompiler::WorkerLoop, this);
         }
-        submitInfo.pSignalSemaphoreInfos = signalSemaphoreInfos;
+    }
 
-        std::scoped_lock lock(device->queues[GPUCommandQueueType_Graphics].mutex);
-        VK_CHECK(device->vkQueueSubmit2(device->queues[GPUCommandQueueType_Graphics].handle, 1, &submitInfo, VK_NULL_HANDLE));
+    jobs.push_back(std::move(job));
+    jobCondition.notify_one();
+}
+
+void VulkanPipelineCompiler::Complete(std::atomic<GPUPipelineStatus>& status, GPUPipelineStatus result)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        status.store(result, std::memory_order_release);
     }
+    completedCondition.notify_all();
+}
 
-    //if (device->queues[QUEUE_VIDEO_DECODE].queue != VK_NULL_HANDLE)
-    //{
-    //    waitSemaphoreInfo.semaphore = cmd.semaphores[2]; // wait for graphics queue
-    //    waitSemaphoreInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-    //
-    //    submitInfo.waitSemaphoreInfoCount = 1;
-    //    submitInfo.pWaitSemaphoreInfos = &waitSemaphoreInfo;
-    //    submitInfo.commandBufferInfoCount = 0;
-    //    submitInfo.pCommandBufferInfos = nullptr;
-    //    submitInfo.signalSemaphoreInfoCount = 0;
-    //    submitInfo.pSignalSemaphoreInfos = nullptr;
-    //
-    //    std::scoped_lock lock(device->queues[QUEUE_VIDEO_DECODE].locker);
-    //    res = vkQueueSubmit2(device->queues[QUEUE_VIDEO_DECODE].queue, 1, &submitInfo, VK_NULL_HANDLE);
-    //    assert(res == VK_SUCCESS);
-    //}
+GPUPipelineStatus VulkanPipelineCompiler::Wait(const std::atomic<GPUPipelineStatus>& status)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    completedCondition.wait(lock, [&status] { return status.load(std::memory_order_acquire) != GPUPipelineStatus_Pending; });
+    return status.load(std::memory_order_acquire);
+}
 
-    // This must be final submit in this function because it will also signal a fence for state tracking by CPU!
+void VulkanPipelineCompiler::Shutdown()
+{
     {
-        waitSemaphoreInfo.semaphore = context.semaphores[1]; // wait for graphics queue
-        waitSemaphoreInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        std::lock_guard<std::mutex> lock(mutex);
+        shutdown = true;
+    }
+    jobCondition.notify_all();
 
-        VkSubmitInfo2 submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-        submitInfo.waitSemaphoreInfoCount = 1;
-        submitInfo.pWaitSemaphoreInfos = &waitSemaphoreInfo;
-        submitInfo.commandBufferInfoCount = 0;
-        submitInfo.pCommandBufferInfos = nullptr;
-        submitInfo.signalSemaphoreInfoCount = 0;
-        submitInfo.pSignalSemaphoreInfos = nullptr;
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+}
+
+void VulkanPipelineCompiler::WorkerLoop()
+{
+    for (;;)
+    {
+        std::function<void(bool cancelled)> job;
+        bool cancelled = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobCondition.wait(lock, [this] { return shutdown || !jobs.empty(); });
+
+            // Queued jobs are still called on shutdown, they own references that must be released
+            if (jobs.empty())
+                return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            cancelled = shutdown;
+        }
 
-        // Final submit also signals fence!
-        std::scoped_lock lock(device->queues[GPUCommandQueueType_Compute].mutex);
-        VK_CHECK(device->vkQueueSubmit2(device->queues[GPUCommandQueueType_Compute].handle, 1, &submitInfo, context.fence));
+        job(cancelled);
     }
+}
 
-    std::scoped_lock lock(locker);
-    freeList.push_back(context);
+/* VulkanBindlessHeap */
+bool VulkanBindlessHeap::Init(VulkanDevice* device_, VkDescriptorType type_, uint32_t capacity_)
+{
+    device = device_;
+    type = type_;
+    capacity = capacity_;
+
+    // Slots may be written while other slots are in use by in-flight command buffers.
+    const VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = {};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = type;
+    binding.descriptorCount = capacity;
+    binding.stageFlags = VK_SHADER_STAGE_ALL;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+
+    VkResult result = device->vkCreateDescriptorSetLayout(device->handle, &layoutInfo, nullptr, &layout);
+    if (result != VK_SUCCESS)
+    {
+        VK_LOG_ERROR(result, "Failed to create bindless DescriptorSetLayout");
+        return false;
+    }
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = type;
+    poolSize.descriptorCount = capacity;
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    result = device->vkCreateDescriptorPool(device->handle, &poolInfo, nullptr, &pool);
+    if (result != VK_SUCCESS)
+    {
+        VK_LOG_ERROR(result, "Failed to create bindless DescriptorPool");
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = pool;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &layout;
+    result = device->vkAllocateDescriptorSets(device->handle, &allocateInfo, &set);
+    if (result != VK_SUCCESS)
+    {
+        VK_LOG_ERROR(result, "Failed to allocate bindless DescriptorSet");
+        return false;
+    }
+
+    next = std::vector<std::atomic<uint32_t>>(capacity);
+    for (uint32_t i = 0; i < capacity; ++i)
+    {
+        next[i].store(i + 1 < capacity ? i + 1 : kEndOfList, std::memory_order_relaxed);
+    }
+    freeHead.store(0, std::memory_order_release);
+    return true;
+}
+
+void VulkanBindlessHeap::Shutdown()
+{
+    if (pool != VK_NULL_HANDLE)
+    {
+        device->vkDestroyDescriptorPool(device->handle, pool, nullptr);
+        pool = VK_NULL_HANDLE;
+        set = VK_NULL_HANDLE;
+    }
+
+    if (layout != VK_NULL_HANDLE)
+    {
+        device->vkDestroyDescriptorSetLayout(device->handle, layout, nullptr);
+        layout = VK_NULL_HANDLE;
+    }
+
+    next.clear();
+    freeHead.store(kEndOfList, std::memory_order_release);
+    capacity = 0;
+}
+
+GPUBindlessIndex VulkanBindlessHeap::Allocate()
+{
+    uint64_t head = freeHead.load(std::memory_order_acquire);
+    while (true)
+    {
+        const uint32_t index = static_cast<uint32_t>(head);
+        if (index == kEndOfList)
+        {
+            agpuLogError("Vulkan: Bindless heap exhausted (%u descriptors)", capacity);
+            return GPU_INVALID_BINDLESS_INDEX;
+        }
+
+        const uint64_t tag = (head >> 32) + 1;
+        const uint64_t newHead = (tag << 32) | next[index].load(std::memory_order_relaxed);
+        if (freeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+            return static_cast<GPUBindlessIndex>(index);
+    }
+}
+
+void VulkanBindlessHeap::Free(GPUBindlessIndex index)
+{
+    if (index == GPU_INVALID_BINDLESS_INDEX || next.empty())
+        return;
+
+    uint64_t head = freeHead.load(std::memory_order_relaxed);
+    while (true)
+    {
+        next[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+
+        const uint64_t tag = (head >> 32) + 1;
+        const uint64_t newHead = (tag << 32) | static_cast<uint32_t>(index);
+        if (freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed))
+            return;
+    }
+}
+
+void VulkanBindlessHeap::Write(GPUBindlessIndex index, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo)
+{
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set;
+    write.dstBinding = 0;
+    write.dstArrayElement = static_cast<uint32_t>(index);
+    write.descriptorCount = 1;
+    write.descriptorType = type;
+    write.pImageInfo = imageInfo;
+    write.pBufferInfo = bufferInfo;
+
+    std::lock_guard<std::mutex> lock(updateMutex);
+    device->vkUpdateDescriptorSets(device->handle, 1, &write, 0, nullptr);
 }
 
+/* VulkanBindlessManager */
 void VulkanBindlessManager::Init(VulkanDevice* device_)
 {
     device = device_;
 
     // Do we support mutable descriptor types?
     mutableDescriptorType = device->adapter->mutableDescriptorTypeFeaturesEXT.mutableDescriptorType == VK_TRUE && false;
+
+    supported = device->adapter->HasFeature(GPUFeature_Bindless);
+    if (!supported)
+        return;
+
+    const VkPhysicalDeviceVulkan12Properties& properties12 = device->adapter->properties12;
+
+    VkDescriptorSetLayoutCreateInfo emptyLayoutInfo = {};
+    emptyLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    VK_CHECK(device->vkCreateDescriptorSetLayout(device->handle, &emptyLayoutInfo, nullptr, &emptySetLayout));
+
+    // Sampler count matches the D3D12 sampler heap limit, every heap is clamped to the device update-after-bind limits.
+    supported =
+        samplers.Init(device, VK_DESCRIPTOR_TYPE_SAMPLER,
+            std::min({ kMaxSamplers, properties12.maxPerStageDescriptorUpdateAfterBindSamplers, properties12.maxDescriptorSetUpdateAfterBindSamplers })) &&
+        sampledImages.Init(device, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            std::min({ kMaxSampledImages, properties12.maxPerStageDescriptorUpdateAfterBindSampledImages, properties12.maxDescriptorSetUpdateAfterBindSampledImages })) &&
+        storageImages.Init(device, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            std::min({ kMaxStorageImages, properties12.maxPerStageDescriptorUpdateAfterBindStorageImages, properties12.maxDescriptorSetUpdateAfterBindStorageImages })) &&
+        storageBuffers.Init(device, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            std::min({ kMaxStorageBuffers, properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers, properties12.maxDescriptorSetUpdateAfterBindStorageBuffers }));
+    if (!supported)
+    {
+        Shutdown();
+        device = device_;
+    }
 }
 
 void VulkanBindlessManager::Shutdown()
 {
+    if (device == nullptr)
+        return;
+
+    samplers.Shutdown();
+    sampledImages.Shutdown();
+    storageImages.Shutdown();
+    storageBuffers.Shutdown();
+
+    if (emptySetLayout != VK_NULL_HANDLE)
+    {
+        device->vkDestroyDescriptorSetLayout(device->handle, emptySetLayout, nullptr);
+        emptySetLayout = VK_NULL_HANDLE;
+    }
+
+    supported = false;
     device = nullptr;
 }
 
+void VulkanBindlessManager::FillSetLayouts(VkDescriptorSetLayout* setLayouts) const
+{
+    setLayouts[kSamplerSet] = samplers.layout;
+    setLayouts[kSampledImageSet] = sampledImages.layout;
+    setLayouts[kStorageImageSet] = storageImages.layout;
+    setLayouts[kStorageBufferSet] = storageBuffers.layout;
+}
+
+void VulkanBindlessManager::Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout) const
+{
+    const VkDescriptorSet sets[kSetCount] = {
+        samplers.set,
+        sampledImages.set,
+        storageImages.set,
+        storageBuffers.set
+    };
+    device->vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, kSamplerSet, kSetCount, sets, 0, nullptr);
+}
+
+void VulkanBindlessManager::Release(VulkanBindlessHeap& heap, GPUBindlessIndex& index)
+{
+    if (index == GPU_INVALID_BINDLESS_INDEX)
+        return;
+
+    device->destroyMutex.lock();
+    device->destroyedBindlessIndices.push_back(std::make_pair(std::make_pair(&heap, index), device->frameCount));
+    device->destroyMutex.unlock();
+    index = GPU_INVALID_BINDLESS_INDEX;
+}
+
 /* VulkanDevice */
 VulkanDevice::~VulkanDevice()
 {
+    pipelineCompiler.Shutdown();
     VK_CHECK(vkDeviceWaitIdle(handle));
 
     for (uint32_t index = 0; index < _GPUCommandQueueType_Count; ++index)
@@ -3111,6 +4980,7 @@ VulkanDevice::~VulkanDevice()
         {
             vkDestroyFence(handle, queues[index].frameFences[frameIndex], nullptr);
         }
+        vkDestroySemaphore(handle, queues[index].submitSemaphore, nullptr);
 
         // Destroy command buffers and pools
         for (size_t cmdBufferIndex = 0, count = queues[index].commandBuffers.size(); cmdBufferIndex < count; ++cmdBufferIndex)
@@ -3121,10 +4991,26 @@ VulkanDevice::~VulkanDevice()
     }
 
     copyAllocator.Shutdown();
-    bindlessManager.Shutdown();
+
+    for (auto& it : bindGroupLayoutCache)
+    {
+        for (VulkanBindGroupLayout* layout : it.second)
+        {
+            layout->Release();
+        }
+    }
+    bindGroupLayoutCache.clear();
+
+    // Requests still pending never resolve, release the buffers before the deletion queue is flushed.
+    for (const BufferMapRequest& request : bufferMapRequests)
+    {
+        ResolveBufferMapRequest(request, true);
+    }
+    bufferMapRequests.clear();
 
     // Destory pending objects.
     ProcessDeletionQueue(true);
+    bindlessManager.Shutdown();
     frameCount = 0;
 
     if (allocator != nullptr)
@@ -3159,8 +5045,15 @@ VulkanDevice::~VulkanDevice()
         externalAllocator = VK_NULL_HANDLE;
     }
 
+    for (auto& it : pipelineLibraries)
+    {
+        vkDestroyPipeline(handle, it.second, nullptr);
+    }
+    pipelineLibraries.clear();
+
     if (pipelineCache != VK_NULL_HANDLE)
     {
+        SavePipelineCache();
         vkDestroyPipelineCache(handle, pipelineCache, nullptr);
         pipelineCache = VK_NULL_HANDLE;
     }
@@ -3354,6 +5247,16 @@ bool VulkanDevice::Initialize(const GPUDeviceDesc& desc)
         enabledDeviceExtensions.push_back(VK_EXT_DESCRIPTOR_HEAP_EXTENSION_NAME);
     }
 
+    if (adapter->extensions.graphicsPipelineLibrary)
+    {
+        // Required by VK_EXT_graphics_pipeline_library, already enabled with ray tracing pipelines
+        if (!(adapter->extensions.accelerationStructure && adapter->extensions.raytracingPipeline))
+        {
+            enabledDeviceExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        }
+        enabledDeviceExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    }
+
     if (adapter->extensions.video.queue)
     {
         enabledDeviceExtensions.push_back(VK_KHR_VIDEO_QUEUE_EXTENSION_NAME);
@@ -3582,6 +5485,16 @@ bool VulkanDevice::Initialize(const GPUDeviceDesc& desc)
             {
                 VK_CHECK(vkCreateFence(handle, &fenceInfo, nullptr, &queues[i].frameFences[frameIndex]));
             }
+
+            VkSemaphoreTypeCreateInfo timelineInfo = {};
+            timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+            timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+            timelineInfo.initialValue = 0;
+
+            VkSemaphoreCreateInfo semaphoreInfo = {};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            semaphoreInfo.pNext = &timelineInfo;
+            VK_CHECK(vkCreateSemaphore(handle, &semaphoreInfo, nullptr, &queues[i].submitSemaphore));
         }
         else
         {
@@ -3677,17 +5590,45 @@ bool VulkanDevice::Initialize(const GPUDeviceDesc& desc)
         }
     }
 
-    // Create pipeline cache
+    // Create pipeline cache, seeded from the previous run when compatible
+    const void* pipelineCacheData = desc.pipelineCacheData;
+    size_t pipelineCacheDataSize = desc.pipelineCacheDataSize;
+    std::vector<uint8_t> pipelineCacheFileData;
+    if (desc.pipelineCachePath != nullptr)
+    {
+        pipelineCachePath = desc.pipelineCachePath;
+        if (pipelineCacheData == nullptr)
+        {
+            pipelineCacheFileData = ReadPipelineCacheFile(desc.pipelineCachePath);
+            pipelineCacheData = pipelineCacheFileData.data();
+            pipelineCacheDataSize = pipelineCacheFileData.size();
+        }
+    }
+
+    if (pipelineCacheDataSize > 0 && !IsPipelineCacheCompatible(pipelineCacheData, pipelineCacheDataSize, adapter->properties2.properties))
+    {
+        agpuLogWarn("Vulkan: Pipeline cache data was created by a different device or driver, ignoring it");
+        pipelineCacheDataSize = 0;
+    }
+
     VkPipelineCacheCreateInfo pipelineCacheInfo;
     pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
     pipelineCacheInfo.pNext = nullptr;
     pipelineCacheInfo.flags = 0;
-    pipelineCacheInfo.initialDataSize = 0;
-    pipelineCacheInfo.pInitialData = nullptr;
+    pipelineCacheInfo.initialDataSize = pipelineCacheDataSize;
+    pipelineCacheInfo.pInitialData = pipelineCacheDataSize > 0 ? pipelineCacheData : nullptr;
     result = vkCreatePipelineCache(handle, &pipelineCacheInfo, nullptr, &pipelineCache);
+    if (result != VK_SUCCESS && pipelineCacheInfo.initialDataSize > 0)
+    {
+        agpuLogWarn("Vulkan: Failed to create pipeline cache from initial data, starting empty");
+        pipelineCacheInfo.initialDataSize = 0;
+        pipelineCacheInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(handle, &pipelineCacheInfo, nullptr, &pipelineCache);
+    }
+
     if (result != VK_SUCCESS)
     {
-        VK_LOG_ERROR(result, "Failed to create Vulkan external memory allocator");
+        VK_LOG_ERROR(result, "Failed to create Vulkan pipeline cache");
         return false;
     }
 
@@ -3716,6 +5657,8 @@ bool VulkanDevice::Initialize(const GPUDeviceDesc& desc)
     dynamicStateInfo.dynamicStateCount = (uint32_t)psoDynamicStates.size();
     dynamicStateInfo.pDynamicStates = psoDynamicStates.data();
 
+    graphicsPipelineLibrary = adapter->graphicsPipelineLibraryFeatures.graphicsPipelineLibrary == VK_TRUE;
+
     return true;
 }
 
@@ -3729,6 +5672,79 @@ void VulkanDevice::GetLimits(GPUDeviceLimits* limits) const
     memcpy(limits, &this->limits, sizeof(GPUDeviceLimits));
 }
 
+size_t VulkanDevice::GetPipelineCacheData(void* data, size_t dataSize)
+{
+    if (pipelineCache == VK_NULL_HANDLE)
+        return 0;
+
+    size_t size = dataSize;
+    if (data == nullptr)
+    {
+        if (vkGetPipelineCacheData(handle, pipelineCache, &size, nullptr) != VK_SUCCESS)
+            return 0;
+
+        return size;
+    }
+
+    // VK_INCOMPLETE leaves a partial cache, which is still valid data
+    const VkResult result = vkGetPipelineCacheData(handle, pipelineCache, &size, data);
+    if (result != VK_SUCCESS && result != VK_INCOMPLETE)
+        return 0;
+
+    return size;
+}
+
+static bool ReplacePipelineCacheFile(const std::string& source, const std::string& target)
+{
+#if defined(_WIN32)
+    // rename fails on Windows when the target exists, MoveFileExW replaces it in place.
+    auto toWide = [](const std::string& path) {
+        std::wstring result(MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, result.data(), (int)result.size());
+        return result;
+    };
+    return MoveFileExW(toWide(source).c_str(), toWide(target).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(source.c_str(), target.c_str()) == 0;
+#endif
+}
+
+void VulkanDevice::SavePipelineCache()
+{
+    if (pipelineCachePath.empty())
+        return;
+
+    std::vector<uint8_t> data(GetPipelineCacheData(nullptr, 0));
+    if (data.empty())
+        return;
+
+    data.resize(GetPipelineCacheData(data.data(), data.size()));
+
+    // Write to a temporary file first so an interrupted save never leaves a truncated cache behind.
+    const std::string tempPath = pipelineCachePath + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        agpuLogWarn("Vulkan: Failed to open pipeline cache file '%s' for writing", tempPath.c_str());
+        return;
+    }
+
+    const bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    const bool closed = fclose(file) == 0;
+    if (!written || !closed)
+    {
+        agpuLogWarn("Vulkan: Failed to write pipeline cache file '%s'", tempPath.c_str());
+        remove(tempPath.c_str());
+        return;
+    }
+
+    if (!ReplacePipelineCacheFile(tempPath, pipelineCachePath))
+    {
+        agpuLogWarn("Vulkan: Failed to replace pipeline cache file '%s'", pipelineCachePath.c_str());
+        remove(tempPath.c_str());
+    }
+}
+
 bool VulkanDevice::HasFeature(GPUFeature feature) const
 {
     return adapter->HasFeature(feature);
@@ -3741,6 +5757,8 @@ GPUCommandQueue VulkanDevice::GetQueue(GPUCommandQueueType type)
 
 void VulkanDevice::WaitIdle()
 {
+    copyAllocator.Flush();
+
     VkResult result = vkDeviceWaitIdle(handle);
     if (result != VK_SUCCESS)
         return;
@@ -3750,6 +5768,9 @@ void VulkanDevice::WaitIdle()
 
 uint64_t VulkanDevice::CommitFrame()
 {
+    // Uploads recorded this frame without a queue submit.
+    copyAllocator.Flush();
+
     // Final submits with fences.
     for (uint32_t i = 0; i < _GPUCommandQueueType_Count; ++i)
     {
@@ -3775,10 +5796,80 @@ uint64_t VulkanDevice::CommitFrame()
     }
 
     ProcessDeletionQueue(false);
+    ProcessEvents();
 
     return frameCount;
 }
 
+void VulkanDevice::ProcessEvents()
+{
+    {
+        std::scoped_lock lock(bufferMapRequestsMutex);
+        if (bufferMapRequests.empty())
+            return;
+    }
+
+    uint64_t completedValues[_GPUCommandQueueType_Count] = {};
+    for (uint32_t i = 0; i < _GPUCommandQueueType_Count; ++i)
+    {
+        if (queues[i].handle == VK_NULL_HANDLE)
+            continue;
+
+        VK_CHECK(vkGetSemaphoreCounterValue(handle, queues[i].submitSemaphore, &completedValues[i]));
+    }
+
+    std::vector<BufferMapRequest> completedRequests;
+    {
+        std::scoped_lock lock(bufferMapRequestsMutex);
+        auto it = std::partition(bufferMapRequests.begin(), bufferMapRequests.end(), [&](const BufferMapRequest& request) {
+            for (uint32_t i = 0; i < _GPUCommandQueueType_Count; ++i)
+            {
+                if (request.submitValues[i] > completedValues[i])
+                    return true;
+            }
+            return false;
+            });
+        completedRequests.assign(it, bufferMapRequests.end());
+        bufferMapRequests.erase(it, bufferMapRequests.end());
+    }
+
+    // Callbacks run outside the lock so they can issue new map requests.
+    for (const BufferMapRequest& request : completedRequests)
+    {
+        ResolveBufferMapRequest(request, false);
+    }
+}
+
+void VulkanDevice::ResolveBufferMapRequest(const BufferMapRequest& request, bool aborted)
+{
+    VulkanBuffer* buffer = request.buffer;
+    GPUMapAsyncStatus status = GPUMapAsyncStatus_Aborted;
+    if (buffer->mapSerial == request.mapSerial && buffer->mapState == GPUBufferMapState_Pending)
+    {
+        if (aborted)
+        {
+            buffer->mapState = GPUBufferMapState_Unmapped;
+        }
+        else
+        {
+            // Readback memory may be non-coherent, make GPU writes visible to the host.
+            if (buffer->mapMode == GPUMapMode_Read)
+            {
+                VK_CHECK(vmaInvalidateAllocation(allocator, buffer->allocation, buffer->mapOffset, buffer->mapSize));
+            }
+
+            buffer->mapState = GPUBufferMapState_Mapped;
+            status = GPUMapAsyncStatus_Success;
+        }
+    }
+
+    if (request.callback)
+    {
+        request.callback(status, request.userData);
+    }
+    buffer->Release();
+}
+
 void VulkanDevice::ProcessDeletionQueue(bool force)
 {
     const auto Destroy = [&](auto&& queue, auto&& handler) {
@@ -3811,6 +5902,7 @@ void VulkanDevice::ProcessDeletionQueue(bool force)
     Destroy(destroyedSemaphores, [&](auto& item) {vkDestroySemaphore(handle, item, nullptr); });
     Destroy(destroyedSwapchains, [&](auto& item) { vkDestroySwapchainKHR(handle, item, nullptr); });
     Destroy(destroyedSurfaces, [&](auto& item) { adapter->factory->vkDestroySurfaceKHR(adapter->factory->handle, item, nullptr); });
+    Destroy(destroyedBindlessIndices, [&](auto& item) { item.first->Free(item.second); });
     destroyMutex.unlock();
 }
 
@@ -3948,6 +6040,19 @@ GPUBuffer VulkanDevice::CreateBuffer(const GPUBufferDesc& desc, const void* pIni
         buffer->deviceAddress = vkGetBufferDeviceAddress(handle, &info);
     }
 
+    if (bindlessManager.supported && (desc.usage & (GPUBufferUsage_ShaderRead | GPUBufferUsage_ShaderWrite)))
+    {
+        buffer->bindlessIndex = bindlessManager.storageBuffers.Allocate();
+        if (buffer->bindlessIndex != GPU_INVALID_BINDLESS_INDEX)
+        {
+            VkDescriptorBufferInfo bufferInfo = {};
+            bufferInfo.buffer = buffer->handle;
+            bufferInfo.offset = 0;
+            bufferInfo.range = VK_WHOLE_SIZE;
+            bindlessManager.storageBuffers.Write(buffer->bindlessIndex, nullptr, &bufferInfo);
+        }
+    }
+
     // Issue data copy on request
     if (pInitialData != nullptr)
     {
@@ -3959,7 +6064,7 @@ GPUBuffer VulkanDevice::CreateBuffer(const GPUBufferDesc& desc, const void* pIni
         }
         else
         {
-            context = copyAllocator.Allocate(createInfo.size);
+            context = copyAllocator.Allocate(desc.size);
             pMappedData = context.uploadBufferData;
         }
 
@@ -3969,7 +6074,7 @@ GPUBuffer VulkanDevice::CreateBuffer(const GPUBufferDesc& desc, const void* pIni
         {
             VkBufferCopy copyRegion = {};
             copyRegion.size = desc.size;
-            copyRegion.srcOffset = 0;
+            copyRegion.srcOffset = context.uploadBufferOffset;
             copyRegion.dstOffset = 0;
 
             vkCmdCopyBuffer(
@@ -4187,7 +6292,35 @@ GPUTexture VulkanDevice::CreateTexture(const GPUTextureDesc& desc, const GPUText
 
     const bool depthOnlyFormat = alimerPixelFormatIsDepthOnly(desc.format);
 
-    texture->numSubResources = desc.mipLevelCount * desc.depthOrArrayLayers;
+    if (bindlessManager.supported)
+    {
+        // Combined depth/stencil formats need per-aspect views, they are not exposed through the bindless heap.
+        if ((desc.usage & GPUTextureUsage_ShaderRead) && (!isDepthStencil || depthOnlyFormat))
+        {
+            texture->bindlessIndex = bindlessManager.sampledImages.Allocate();
+            if (texture->bindlessIndex != GPU_INVALID_BINDLESS_INDEX)
+            {
+                VkDescriptorImageInfo imageInfo = {};
+                imageInfo.imageView = texture->GetView(0);
+                imageInfo.imageLayout = ConvertImageLayout(TextureLayout::ShaderResource, depthOnlyFormat).layout;
+                bindlessManager.sampledImages.Write(texture->bindlessIndex, &imageInfo, nullptr);
+            }
+        }
+
+        if (desc.usage & GPUTextureUsage_ShaderWrite)
+        {
+            texture->bindlessStorageIndex = bindlessManager.storageImages.Allocate();
+            if (texture->bindlessStorageIndex != GPU_INVALID_BINDLESS_INDEX)
+            {
+                VkDescriptorImageInfo imageInfo = {};
+                imageInfo.imageView = texture->GetView(0, true);
+                imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+                bindlessManager.storageImages.Write(texture->bindlessStorageIndex, &imageInfo, nullptr);
+            }
+        }
+    }
+
+    texture->numSubResources = desc.mipLevelCount * texture->GetArrayLayerCount();
     texture->imageLayouts.resize(texture->numSubResources);
     for (uint32_t i = 0; i < texture->numSubResources; i++)
     {
@@ -4206,24 +6339,35 @@ GPUTexture VulkanDevice::CreateTexture(const GPUTextureDesc& desc, const GPUText
     {
         VulkanUploadContext uploadContext;
         void* pMappedData = nullptr;
-#if TEXTURE_STAGING
-        if (desc.memoryType == MemoryType::Upload)
-        {
-            pMappedData = texture->pMappedData;
-        }
-        else
-#endif // TEXTURE_STAGING
-
-        {
-            uploadContext = copyAllocator.Allocate(allocationInfo.size);
-            pMappedData = uploadContext.uploadBuffer->pMappedData;
-        }
 
         std::vector<VkBufferImageCopy> copyRegions;
 
         GPUPixelFormatInfo formatInfo = agpuPixelFormatGetInfo(desc.format);
         const uint32_t blockSize = formatInfo.blockWidth;
 
+        // Buffer offsets of image copies must be multiple of 4 and of the texel block size.
+        const VkDeviceSize copyAlignment = (formatInfo.bytesPerBlock % 4u) == 0 ? formatInfo.bytesPerBlock : 4u;
+        const auto AlignCopyOffset = [copyAlignment](VkDeviceSize offset) {
+            return (offset + copyAlignment - 1) / copyAlignment * copyAlignment;
+            };
+
+        {
+            VkDeviceSize stagingSize = 0;
+            for (uint32_t mipIndex = 0; mipIndex < createInfo.mipLevels; ++mipIndex)
+            {
+                const uint32_t levelWidth = std::max(1u, createInfo.extent.width >> mipIndex);
+                const uint32_t levelHeight = std::max(1u, createInfo.extent.height >> mipIndex);
+                const uint32_t levelDepth = std::max(1u, createInfo.extent.depth >> mipIndex);
+                const uint32_t numBlocksX = std::max(1u, levelWidth / blockSize);
+                const uint32_t numBlocksY = std::max(1u, levelHeight / blockSize);
+                stagingSize = AlignCopyOffset(stagingSize + VkDeviceSize(numBlocksX) * formatInfo.bytesPerBlock * numBlocksY * levelDepth);
+            }
+            stagingSize *= createInfo.arrayLayers;
+
+            uploadContext = copyAllocator.Allocate(stagingSize, copyAlignment);
+            pMappedData = uploadContext.uploadBufferData;
+        }
+
         VkDeviceSize copyOffset = 0;
         uint32_t initDataIndex = 0;
         for (uint32_t arrayIndex = 0; arrayIndex < createInfo.arrayLayers; ++arrayIndex)
@@ -4261,7 +6405,7 @@ GPUTexture VulkanDevice::CreateTexture(const GPUTextureDesc& desc, const GPUText
                 if (uploadContext.IsValid())
                 {
                     VkBufferImageCopy copyRegion = {};
-                    copyRegion.bufferOffset = copyOffset;
+                    copyRegion.bufferOffset = uploadContext.uploadBufferOffset + copyOffset;
                     copyRegion.bufferRowLength = 0;
                     copyRegion.bufferImageHeight = 0;
 
@@ -4278,7 +6422,7 @@ GPUTexture VulkanDevice::CreateTexture(const GPUTextureDesc& desc, const GPUText
                     copyRegions.push_back(copyRegion);
                 }
 
-                copyOffset += dstSlicePitch * levelDepth;
+                copyOffset = AlignCopyOffset(copyOffset + VkDeviceSize(dstSlicePitch) * levelDepth);
 
                 levelWidth = std::max(1u, levelWidth / 2);
                 levelHeight = std::max(1u, levelHeight / 2);
@@ -4333,7 +6477,7 @@ GPUTexture VulkanDevice::CreateTexture(const GPUTextureDesc& desc, const GPUText
     }
     else if (currentLayout != TextureLayout::Undefined)
     {
-        VulkanUploadContext uploadContext = copyAllocator.Allocate(allocationInfo.size);
+        VulkanUploadContext uploadContext = copyAllocator.Allocate(0);
 
         const VkImageLayoutMapping mappingAfter = ConvertImageLayout(currentLayout, depthOnlyFormat);
 
@@ -4412,20 +6556,80 @@ GPUSampler VulkanDevice::CreateSampler(const GPUSamplerDesc& desc)
         return nullptr;
     }
 
+    if (bindlessManager.supported)
+    {
+        sampler->bindlessIndex = bindlessManager.samplers.Allocate();
+        if (sampler->bindlessIndex != GPU_INVALID_BINDLESS_INDEX)
+        {
+            VkDescriptorImageInfo imageInfo = {};
+            imageInfo.sampler = sampler->handle;
+            bindlessManager.samplers.Write(sampler->bindlessIndex, &imageInfo, nullptr);
+        }
+    }
+
     return sampler;
 }
 
 GPUBindGroupLayout VulkanDevice::CreateBindGroupLayout(const GPUBindGroupLayoutDesc& desc)
 {
+    // Entries arrive sorted, identical layouts hash and compare equal.
+    size_t hash = 0;
+    for (uint32_t i = 0; i < desc.entryCount; ++i)
+    {
+        HashCombine(hash, desc.entries[i].binding);
+        HashCombine(hash, static_cast<uint32_t>(desc.entries[i].type));
+        HashCombine(hash, desc.entries[i].count);
+    }
+
+    auto matches = [&desc](const VulkanBindGroupLayout* layout) {
+        if (layout->entries.size() != desc.entryCount)
+            return false;
+
+        for (uint32_t i = 0; i < desc.entryCount; ++i)
+        {
+            const GPUBindGroupLayoutEntry& lhs = layout->entries[i];
+            const GPUBindGroupLayoutEntry& rhs = desc.entries[i];
+            if (lhs.binding != rhs.binding || lhs.type != rhs.type || lhs.count != rhs.count)
+                return false;
+        }
+        return true;
+        };
+
+    std::lock_guard<std::mutex> lock(bindGroupLayoutCacheMutex);
+    std::vector<VulkanBindGroupLayout*>& bucket = bindGroupLayoutCache[hash];
+    for (VulkanBindGroupLayout* cached : bucket)
+    {
+        if (matches(cached))
+        {
+            cached->AddRef();
+            return cached;
+        }
+    }
+
     // https://developer.arm.com/documentation/101897/0303/CPU-overheads/Optimizing-descriptor-sets-and-layouts-for-Vulkan
     // For ease of programming, VkDescriptorSetLayoutBinding::stageFlags can always be set to VK_SHADER_STAGE_ALL with no performance loss.
+    std::vector<VkDescriptorSetLayoutBinding> bindings(desc.entryCount);
+    for (uint32_t i = 0; i < desc.entryCount; ++i)
+    {
+        const GPUBindGroupLayoutEntry& entry = desc.entries[i];
+
+        VkDescriptorSetLayoutBinding& binding = bindings[i];
+        binding = {};
+        binding.binding = entry.binding + GetVkBindingShift(entry.type);
+        binding.descriptorType = ToVkDescriptorType(entry.type);
+        binding.descriptorCount = entry.count;
+        binding.stageFlags = VK_SHADER_STAGE_ALL;
+    }
+
     VulkanBindGroupLayout* layout = new VulkanBindGroupLayout();
     layout->device = this;
+    layout->hash = hash;
+    layout->entries.assign(desc.entries, desc.entries + desc.entryCount);
 
     VkDescriptorSetLayoutCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    createInfo.bindingCount = 0;
-    createInfo.pBindings = nullptr;
+    createInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    createInfo.pBindings = bindings.data();
 
     VkResult result = vkCreateDescriptorSetLayout(handle, &createInfo, nullptr, &layout->handle);
     if (result != VK_SUCCESS)
@@ -4440,13 +6644,103 @@ GPUBindGroupLayout VulkanDevice::CreateBindGroupLayout(const GPUBindGroupLayoutD
         layout->SetLabel(desc.label);
     }
 
+    // One reference for the cache, one for the caller.
+    layout->AddRef();
+    bucket.push_back(layout);
     return layout;
 }
 
+GPUBindGroup VulkanDevice::CreateBindGroup(const GPUBindGroupDesc& desc)
+{
+    VulkanBindGroup* bindGroup = new VulkanBindGroup();
+    bindGroup->device = this;
+    bindGroup->layout = static_cast<VulkanBindGroupLayout*>(desc.layout);
+    bindGroup->layout->AddRef();
+
+    // Reserved up front, writes point into these arrays.
+    bindGroup->bufferInfos.reserve(desc.entryCount);
+    bindGroup->imageInfos.reserve(desc.entryCount);
+    bindGroup->writes.reserve(desc.entryCount);
+    bindGroup->resources.reserve(desc.entryCount);
+
+    for (uint32_t i = 0; i < desc.entryCount; ++i)
+    {
+        const GPUBindGroupEntry& entry = desc.entries[i];
+
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstBinding = entry.binding + GetVkBindingShift(entry.type);
+        write.dstArrayElement = entry.arrayElement;
+        write.descriptorCount = 1;
+        write.descriptorType = ToVkDescriptorType(entry.type);
+
+        switch (entry.type)
+        {
+            case GPUBindingType_ConstantBuffer:
+            case GPUBindingType_ReadOnlyStorageBuffer:
+            case GPUBindingType_StorageBuffer:
+            {
+                VulkanBuffer* buffer = static_cast<VulkanBuffer*>(entry.buffer);
+                VkDescriptorBufferInfo& bufferInfo = bindGroup->bufferInfos.emplace_back();
+                bufferInfo.buffer = buffer->handle;
+                bufferInfo.offset = entry.offset;
+                bufferInfo.range = entry.size;
+                write.pBufferInfo = &bufferInfo;
+                bindGroup->resources.push_back(buffer);
+                break;
+            }
+
+            case GPUBindingType_SampledTexture:
+            case GPUBindingType_StorageTexture:
+            {
+                VulkanTexture* texture = static_cast<VulkanTexture*>(entry.texture);
+                const TextureLayout layout = (entry.type == GPUBindingType_StorageTexture) ? TextureLayout::UnorderedAccess : TextureLayout::ShaderResource;
+                const bool depthOnlyFormat = alimerPixelFormatIsDepthOnly(texture->desc.format);
+
+                VkDescriptorImageInfo& imageInfo = bindGroup->imageInfos.emplace_back();
+                imageInfo.imageView = texture->GetView(0, entry.type == GPUBindingType_StorageTexture);
+                imageInfo.imageLayout = ConvertImageLayout(layout, depthOnlyFormat).layout;
+                write.pImageInfo = &imageInfo;
+                bindGroup->textures.push_back(std::make_pair(texture, layout));
+                bindGroup->resources.push_back(texture);
+                break;
+            }
+
+            case GPUBindingType_Sampler:
+            {
+                VulkanSampler* sampler = static_cast<VulkanSampler*>(entry.sampler);
+                VkDescriptorImageInfo& imageInfo = bindGroup->imageInfos.emplace_back();
+                imageInfo.sampler = sampler->handle;
+                write.pImageInfo = &imageInfo;
+                bindGroup->resources.push_back(sampler);
+                break;
+            }
+
+            default:
+                ALIMER_UNREACHABLE();
+        }
+
+        bindGroup->writes.push_back(write);
+    }
+
+    for (GPUResource* resource : bindGroup->resources)
+    {
+        resource->AddRef();
+    }
+
+    if (desc.label)
+    {
+        bindGroup->SetLabel(desc.label);
+    }
+
+    return bindGroup;
+}
+
 GPUPipelineLayout VulkanDevice::CreatePipelineLayout(const GPUPipelineLayoutDesc& desc)
 {
     VulkanPipelineLayout* layout = new VulkanPipelineLayout();
     layout->device = this;
+    layout->uniqueId = nextObjectId.fetch_add(1, std::memory_order_relaxed);
 
     layout->pushConstantRanges.resize(desc.pushConstantRangeCount);
 
@@ -4464,10 +6758,31 @@ GPUPipelineLayout VulkanDevice::CreatePipelineLayout(const GPUPipelineLayoutDesc
         offset += pushConstantRange.size;
     }
 
+    VkDescriptorSetLayout setLayouts[GPU_MAX_BIND_GROUPS + VulkanBindlessManager::kSetCount] = {};
+    uint32_t setLayoutCount = desc.bindGroupLayoutCount;
+    layout->bindGroupLayouts.resize(desc.bindGroupLayoutCount);
+    for (uint32_t i = 0; i < desc.bindGroupLayoutCount; i++)
+    {
+        layout->bindGroupLayouts[i] = static_cast<VulkanBindGroupLayout*>(desc.bindGroupLayouts[i]);
+        layout->bindGroupLayouts[i]->AddRef();
+        setLayouts[i] = layout->bindGroupLayouts[i]->handle;
+    }
+
+    // Bindless heaps live at fixed set numbers right after the first bind group.
+    if (bindlessManager.supported && desc.bindGroupLayoutCount <= VulkanBindlessManager::kSamplerSet)
+    {
+        if (desc.bindGroupLayoutCount == 0)
+            setLayouts[0] = bindlessManager.emptySetLayout;
+
+        bindlessManager.FillSetLayouts(setLayouts);
+        setLayoutCount = VulkanBindlessManager::kSamplerSet + VulkanBindlessManager::kSetCount;
+        layout->bindless = true;
+    }
+
     VkPipelineLayoutCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    createInfo.setLayoutCount = 0;
-    createInfo.pSetLayouts = nullptr;
+    createInfo.setLayoutCount = setLayoutCount;
+    createInfo.pSetLayouts = setLayouts;
     createInfo.pushConstantRangeCount = desc.pushConstantRangeCount;
     createInfo.pPushConstantRanges = layout->pushConstantRanges.data();
 
@@ -4503,6 +6818,8 @@ GPUShaderModule VulkanDevice::CreateShaderModule(const GPUShaderModuleDesc* desc
     }
 
     VulkanShaderModule* shaderModule = new VulkanShaderModule();
+    shaderModule->device = this;
+    shaderModule->uniqueId = nextObjectId.fetch_add(1, std::memory_order_relaxed);
     shaderModule->entryPoint = desc->entryPoint;
     shaderModule->stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     shaderModule->stageInfo.pNext = nullptr;
@@ -4535,300 +6852,384 @@ GPUComputePipeline VulkanDevice::CreateComputePipeline(const GPUComputePipelineD
         return nullptr;
     }
 
-    if (desc.label)
-    {
-        pipeline->SetLabel(desc.label);
-    }
+    if (desc.label)
+    {
+        pipeline->SetLabel(desc.label);
+    }
+
+    return pipeline;
+}
+
+GPURenderPipeline VulkanDevice::CreateRenderPipeline(const GPURenderPipelineDesc& desc)
+{
+    VulkanRenderPipeline* pipeline = new VulkanRenderPipeline();
+    pipeline->device = this;
+    pipeline->layout = static_cast<VulkanPipelineLayout*>(desc.layout);
+    pipeline->layout->AddRef();
+
+    VulkanRenderPipelineState state;
+    state.Init(this, desc, pipeline->layout->handle);
+
+    VkResult result = CompileRenderPipeline(pipeline, state, false);
+    if (result != VK_SUCCESS)
+    {
+        delete pipeline;
+        VK_LOG_ERROR(result, "Failed to create Render Pipeline");
+        return nullptr;
+    }
+
+    if (desc.label)
+    {
+        pipeline->SetLabel(desc.label);
+    }
+
+    return pipeline;
+}
+
+GPUComputePipeline VulkanDevice::CreateComputePipelineAsync(const GPUComputePipelineDesc& desc, GPUComputePipeline fallback)
+{
+    VulkanComputePipeline* pipeline = new VulkanComputePipeline();
+    pipeline->device = this;
+    pipeline->layout = static_cast<VulkanPipelineLayout*>(desc.layout);
+    pipeline->layout->AddRef();
+    pipeline->fallback = static_cast<VulkanComputePipeline*>(fallback);
+    if (pipeline->fallback != nullptr)
+    {
+        pipeline->fallback->AddRef();
+    }
+    pipeline->status.store(GPUPipelineStatus_Pending, std::memory_order_relaxed);
+
+    // The job keeps the pipeline and the shader module alive until compilation ends
+    VulkanShaderModule* shaderModule = static_cast<VulkanShaderModule*>(desc.shader);
+    shaderModule->AddRef();
+    pipeline->AddRef();
+
+    std::string label = desc.label ? desc.label : "";
+    pipelineCompiler.Submit([this, pipeline, shaderModule, label](bool cancelled) {
+        if (cancelled)
+        {
+            pipelineCompiler.Complete(pipeline->status, GPUPipelineStatus_Error);
+            shaderModule->Release();
+            pipeline->Release();
+            return;
+        }
+
+        VkComputePipelineCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        createInfo.stage = shaderModule->stageInfo;
+        createInfo.layout = pipeline->layout->handle;
+
+        VkResult result = vkCreateComputePipelines(handle, pipelineCache, 1, &createInfo, nullptr, &pipeline->handle);
+        if (result != VK_SUCCESS)
+        {
+            VK_LOG_ERROR(result, "Failed to create Compute Pipeline");
+        }
+        else if (!label.empty())
+        {
+            SetObjectName(VK_OBJECT_TYPE_PIPELINE, reinterpret_cast<uint64_t>(pipeline->handle), label.c_str());
+        }
+
+        pipelineCompiler.Complete(pipeline->status, result == VK_SUCCESS ? GPUPipelineStatus_Ready : GPUPipelineStatus_Error);
+        shaderModule->Release();
+        pipeline->Release();
+    });
 
     return pipeline;
 }
 
-GPURenderPipeline VulkanDevice::CreateRenderPipeline(const GPURenderPipelineDesc& desc)
+GPURenderPipeline VulkanDevice::CreateRenderPipelineAsync(const GPURenderPipelineDesc& desc, GPURenderPipeline fallback)
 {
     VulkanRenderPipeline* pipeline = new VulkanRenderPipeline();
     pipeline->device = this;
     pipeline->layout = static_cast<VulkanPipelineLayout*>(desc.layout);
     pipeline->layout->AddRef();
-
-    // ShaderStages
-    std::vector<VkPipelineShaderStageCreateInfo> stages;
-    if (desc.meshShader != nullptr)
-    {
-        auto backendMeshShader = static_cast<VulkanShaderModule*>(desc.meshShader);
-        stages.push_back(backendMeshShader->stageInfo);
-
-        if (desc.amplificationShader != nullptr)
-        {
-            auto backendAmplificationShader = static_cast<VulkanShaderModule*>(desc.amplificationShader);
-            stages.push_back(backendAmplificationShader->stageInfo);
-        }
-    }
-    else
+    pipeline->fallback = static_cast<VulkanRenderPipeline*>(fallback);
+    if (pipeline->fallback != nullptr)
     {
-        auto backendVertexShader = static_cast<VulkanShaderModule*>(desc.vertexShader);
-        stages.push_back(backendVertexShader->stageInfo);
+        pipeline->fallback->AddRef();
     }
+    pipeline->status.store(GPUPipelineStatus_Pending, std::memory_order_relaxed);
 
-    if (desc.fragmentShader != nullptr)
-    {
-        auto backendFragmentShader = static_cast<VulkanShaderModule*>(desc.fragmentShader);
-        stages.push_back(backendFragmentShader->stageInfo);
-    }
+    // Translating the desc is cheap and done here, the worker only creates the pipeline
+    VulkanRenderPipelineState* state = new VulkanRenderPipelineState();
+    state->Init(this, desc, pipeline->layout->handle);
+    pipeline->AddRef();
 
-    // VertexInputState (need always be specified when using VertexShader)
-    VkPipelineVertexInputStateCreateInfo vertexInputState{};
-    vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    std::vector<VkVertexInputBindingDescription> vertexBindings;
-    std::vector<VkVertexInputAttributeDescription> vertexAttributes;
-    uint32_t attributeLocation = 0;
-    if (desc.vertexBufferLayoutCount > 0)
-    {
-        vertexBindings.resize(desc.vertexBufferLayoutCount);
+    std::string label = desc.label ? desc.label : "";
+    pipelineCompiler.Submit([this, pipeline, state, label](bool cancelled) {
+        if (cancelled)
+        {
+            pipelineCompiler.Complete(pipeline->status, GPUPipelineStatus_Error);
+            delete state;
+            pipeline->Release();
+            return;
+        }
 
-        for (uint32_t bufferIndex = 0; bufferIndex < desc.vertexBufferLayoutCount; ++bufferIndex)
+        // Already off the recording thread, link once with link time optimization
+        VkResult result = CompileRenderPipeline(pipeline, *state, true);
+        if (result != VK_SUCCESS)
         {
-            const GPUVertexBufferLayout& layout = desc.vertexBufferLayouts[bufferIndex];
-            vertexBindings[bufferIndex].binding = bufferIndex;
-            vertexBindings[bufferIndex].stride = layout.stride;
-            vertexBindings[bufferIndex].inputRate = ToVk(layout.stepMode);
+            VK_LOG_ERROR(result, "Failed to create Render Pipeline");
+        }
+        else if (!label.empty())
+        {
+            SetObjectName(VK_OBJECT_TYPE_PIPELINE, reinterpret_cast<uint64_t>(pipeline->handle), label.c_str());
+        }
 
-            // Compute stride from attributes
-            if (vertexBindings[bufferIndex].stride == 0)
-            {
-                for (uint32_t attributeIndex = 0; attributeIndex < layout.attributeCount; ++attributeIndex)
-                {
-                    const GPUVertexAttribute& attribute = layout.attributes[attributeIndex];
-                    vertexBindings[bufferIndex].stride += agpuGetVertexFormatByteSize(attribute.format);
-                }
-            }
+        pipelineCompiler.Complete(pipeline->status, result == VK_SUCCESS ? GPUPipelineStatus_Ready : GPUPipelineStatus_Error);
+        delete state;
+        pipeline->Release();
+    });
 
-            for (uint32_t attributeIndex = 0; attributeIndex < layout.attributeCount; ++attributeIndex)
-            {
-                const GPUVertexAttribute& attribute = layout.attributes[attributeIndex];
+    return pipeline;
+}
 
-                VkVertexInputAttributeDescription& vertexAttribute = vertexAttributes.emplace_back();
-                vertexAttribute.location = attributeLocation;
-                vertexAttribute.binding = bufferIndex;
-                vertexAttribute.format = ToVkVertexFormat(attribute.format);
-                vertexAttribute.offset = attribute.offset;
+VkResult VulkanDevice::CompileRenderPipeline(VulkanRenderPipeline* pipeline, const VulkanRenderPipelineState& state, bool optimize)
+{
+    const VkPipelineShaderStageCreateInfo* fragmentStage = nullptr;
+    std::vector<VkPipelineShaderStageCreateInfo> preRasterizationStages;
+    std::string preRasterizationKey;
+    std::string fragmentShaderKey;
+    AppendPipelineLibraryKey(preRasterizationKey, VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT);
+    AppendPipelineLibraryKey(fragmentShaderKey, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT);
 
-                attributeLocation++;
-            }
+    bool meshShader = false;
+    for (size_t i = 0; i < state.stages.size(); ++i)
+    {
+        if (state.stages[i].stage == VK_SHADER_STAGE_FRAGMENT_BIT)
+        {
+            fragmentStage = &state.stages[i];
+            AppendPipelineLibraryKey(fragmentShaderKey, state.shaderModules[i]->uniqueId);
         }
+        else
+        {
+            meshShader |= state.stages[i].stage == VK_SHADER_STAGE_MESH_BIT_EXT;
+            preRasterizationStages.push_back(state.stages[i]);
+            AppendPipelineLibraryKey(preRasterizationKey, state.shaderModules[i]->uniqueId);
+        }
+    }
+
+    // Mesh shading pipelines have no vertex input, they are always created monolithic
+    if (!graphicsPipelineLibrary || meshShader)
+    {
+        return vkCreateGraphicsPipelines(handle, pipelineCache, 1, &state.createInfo, nullptr, &pipeline->handle);
+    }
+
+    VkPipeline libraries[4] = {};
+
+    // Vertex input interface
+    {
+        std::string key;
+        AppendPipelineLibraryKey(key, VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT);
+        AppendPipelineLibraryKey(key, state.vertexInputState.vertexBindingDescriptionCount);
+        for (const VkVertexInputBindingDescription& binding : state.vertexBindings)
+            AppendPipelineLibraryKey(key, binding);
+        for (const VkVertexInputAttributeDescription& attribute : state.vertexAttributes)
+            AppendPipelineLibraryKey(key, attribute);
+        AppendPipelineLibraryKey(key, state.inputAssemblyState.topology);
+        AppendPipelineLibraryKey(key, state.inputAssemblyState.primitiveRestartEnable);
 
-        vertexInputState.vertexBindingDescriptionCount = (uint32_t)vertexBindings.size();
-        vertexInputState.pVertexBindingDescriptions = vertexBindings.data();
-        vertexInputState.vertexAttributeDescriptionCount = (uint32_t)vertexAttributes.size();
-        vertexInputState.pVertexAttributeDescriptions = vertexAttributes.data();
+        VkGraphicsPipelineCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.pVertexInputState = &state.vertexInputState;
+        createInfo.pInputAssemblyState = &state.inputAssemblyState;
+        libraries[0] = GetPipelineLibrary(std::move(key), VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, createInfo);
     }
 
-    // InputAssemblyState
-    VkPipelineInputAssemblyStateCreateInfo inputAssemblyState{};
-    inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssemblyState.topology = ToVk(desc.primitiveTopology);
-    switch (desc.primitiveTopology)
+    // Pre-rasterization shaders
     {
-        case GPUPrimitiveTopology_LineStrip:
-        case GPUPrimitiveTopology_TriangleStrip:
-            inputAssemblyState.primitiveRestartEnable = VK_TRUE;
-            break;
-        default:
-            inputAssemblyState.primitiveRestartEnable = VK_FALSE;
-            break;
-    }
-
-    // ViewportState
-    VkPipelineViewportStateCreateInfo viewportState = {};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.scissorCount = 1;
+        const VkPipelineRasterizationStateCreateInfo& rasterizationState = state.rasterizationState;
+        AppendPipelineLibraryKey(preRasterizationKey, pipeline->layout->uniqueId);
+        AppendPipelineLibraryKey(preRasterizationKey, rasterizationState.depthClampEnable);
+        AppendPipelineLibraryKey(preRasterizationKey, rasterizationState.polygonMode);
+        AppendPipelineLibraryKey(preRasterizationKey, rasterizationState.cullMode);
+        AppendPipelineLibraryKey(preRasterizationKey, rasterizationState.frontFace);
+        AppendPipelineLibraryKey(preRasterizationKey, rasterizationState.depthBiasEnable);
+        AppendPipelineLibraryKey(preRasterizationKey, rasterizationState.depthBiasConstantFactor);
+        AppendPipelineLibraryKey(preRasterizationKey, rasterizationState.depthBiasClamp);
+        AppendPipelineLibraryKey(preRasterizationKey, rasterizationState.depthBiasSlopeFactor);
+        AppendPipelineLibraryKey(preRasterizationKey, state.depthClipStateInfo.sType);
+        AppendPipelineLibraryKey(preRasterizationKey, state.depthClipStateInfo.depthClipEnable);
+        AppendPipelineLibraryKey(preRasterizationKey, state.rasterizationConservativeState.sType);
 
-    // RasterizationState
-    VkPipelineRasterizationStateCreateInfo rasterizationState{};
-    rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        VkGraphicsPipelineCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.pNext = &state.renderingInfo;
+        createInfo.stageCount = (uint32_t)preRasterizationStages.size();
+        createInfo.pStages = preRasterizationStages.data();
+        createInfo.pViewportState = &state.viewportState;
+        createInfo.pRasterizationState = &state.rasterizationState;
+        createInfo.layout = pipeline->layout->handle;
+        libraries[1] = GetPipelineLibrary(std::move(preRasterizationKey), VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, createInfo);
+    }
 
-    // DepthClip
-    VkPipelineRasterizationDepthClipStateCreateInfoEXT depthClipStateInfo = {};
+    // Multisample state is consumed by both fragment parts
+    std::string multisampleKey;
+    AppendPipelineLibraryKey(multisampleKey, state.multisampleState.rasterizationSamples);
+    AppendPipelineLibraryKey(multisampleKey, state.multisampleState.sampleShadingEnable);
+    AppendPipelineLibraryKey(multisampleKey, state.multisampleState.alphaToCoverageEnable);
 
-    PNEXTCHAIN_DECLARE(rasterizationState.pNext);
-    if (adapter->depthClipEnableFeatures.depthClipEnable == VK_TRUE)
+    // Fragment shader
     {
-        depthClipStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_DEPTH_CLIP_STATE_CREATE_INFO_EXT;
-        depthClipStateInfo.depthClipEnable = (desc.rasterizerState.depthClipMode == GPUDepthClipMode_Clip) ? VK_TRUE : VK_FALSE;
-
-        rasterizationState.depthClampEnable = VK_TRUE;
-        rasterizationState.pNext = &depthClipStateInfo;
+        const VkPipelineDepthStencilStateCreateInfo& depthStencilState = state.depthStencilState;
+        AppendPipelineLibraryKey(fragmentShaderKey, pipeline->layout->uniqueId);
+        fragmentShaderKey += multisampleKey;
+        AppendPipelineLibraryKey(fragmentShaderKey, state.renderingInfo.depthAttachmentFormat);
+        AppendPipelineLibraryKey(fragmentShaderKey, state.renderingInfo.stencilAttachmentFormat);
+        AppendPipelineLibraryKey(fragmentShaderKey, depthStencilState.depthTestEnable);
+        AppendPipelineLibraryKey(fragmentShaderKey, depthStencilState.depthWriteEnable);
+        AppendPipelineLibraryKey(fragmentShaderKey, depthStencilState.depthCompareOp);
+        AppendPipelineLibraryKey(fragmentShaderKey, depthStencilState.depthBoundsTestEnable);
+        AppendPipelineLibraryKey(fragmentShaderKey, depthStencilState.stencilTestEnable);
+        AppendPipelineLibraryKey(fragmentShaderKey, depthStencilState.front);
+        AppendPipelineLibraryKey(fragmentShaderKey, depthStencilState.back);
 
-        PNEXTCHAIN_APPEND_STRUCT(depthClipStateInfo);
+        VkGraphicsPipelineCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.pNext = &state.renderingInfo;
+        createInfo.stageCount = fragmentStage != nullptr ? 1u : 0u;
+        createInfo.pStages = fragmentStage;
+        createInfo.pMultisampleState = &state.multisampleState;
+        createInfo.pDepthStencilState = state.createInfo.pDepthStencilState;
+        createInfo.layout = pipeline->layout->handle;
+        libraries[2] = GetPipelineLibrary(std::move(fragmentShaderKey), VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, createInfo);
     }
 
-    VkPipelineRasterizationConservativeStateCreateInfoEXT rasterizationConservativeState = {};
-    if (desc.rasterizerState.conservativeRasterEnable)
+    // Fragment output interface
     {
-        rasterizationConservativeState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_CONSERVATIVE_STATE_CREATE_INFO_EXT;
-        rasterizationConservativeState.conservativeRasterizationMode = VK_CONSERVATIVE_RASTERIZATION_MODE_OVERESTIMATE_EXT;
-        rasterizationConservativeState.extraPrimitiveOverestimationSize = 0.0f;
+        std::string key;
+        AppendPipelineLibraryKey(key, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT);
+        key += multisampleKey;
+        AppendPipelineLibraryKey(key, state.renderingInfo.depthAttachmentFormat);
+        AppendPipelineLibraryKey(key, state.renderingInfo.stencilAttachmentFormat);
+        AppendPipelineLibraryKey(key, state.renderingInfo.colorAttachmentCount);
+        for (uint32_t i = 0; i < state.renderingInfo.colorAttachmentCount; ++i)
+        {
+            AppendPipelineLibraryKey(key, state.colorAttachmentFormats[i]);
+            AppendPipelineLibraryKey(key, state.blendAttachmentStates[i]);
+        }
+
+        VkGraphicsPipelineCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.pNext = &state.renderingInfo;
+        createInfo.pMultisampleState = &state.multisampleState;
+        createInfo.pColorBlendState = &state.blendState;
+        libraries[3] = GetPipelineLibrary(std::move(key), VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, createInfo);
+    }
+
+    for (VkPipeline library : libraries)
+    {
+        if (library == VK_NULL_HANDLE)
+            return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    VkPipelineLibraryCreateInfoKHR libraryInfo = {};
+    libraryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+    libraryInfo.libraryCount = 4;
+    libraryInfo.pLibraries = libraries;
 
-        PNEXTCHAIN_APPEND_STRUCT(rasterizationConservativeState);
+    VkGraphicsPipelineCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    createInfo.pNext = &libraryInfo;
+    createInfo.layout = pipeline->layout->handle;
+
+    // Without fast linking the relink would cost as much as the first link, do it once.
+    if (optimize || !adapter->graphicsPipelineLibraryProperties.graphicsPipelineLibraryFastLinking)
+    {
+        createInfo.flags = VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+        return vkCreateGraphicsPipelines(handle, pipelineCache, 1, &createInfo, nullptr, &pipeline->handle);
     }
 
-    rasterizationState.rasterizerDiscardEnable = VK_FALSE;
-    rasterizationState.polygonMode = ToVk(desc.rasterizerState.fillMode, adapter->features2.features.fillModeNonSolid);
-    rasterizationState.cullMode = ToVk(desc.rasterizerState.cullMode);
-    rasterizationState.frontFace = ToVk(desc.rasterizerState.frontFace);
-    // Can be managed by command buffer
-    rasterizationState.depthBiasEnable = desc.rasterizerState.depthBias != 0.0f || desc.rasterizerState.depthBiasSlopeScale != 0.0f;
-    rasterizationState.depthBiasConstantFactor = desc.rasterizerState.depthBias;
-    rasterizationState.depthBiasClamp = desc.rasterizerState.depthBiasClamp;
-    rasterizationState.depthBiasSlopeFactor = desc.rasterizerState.depthBiasSlopeScale;
-    rasterizationState.lineWidth = 1.0f;
+    // Fast link, the parts are only stitched together
+    VkResult result = vkCreateGraphicsPipelines(handle, pipelineCache, 1, &createInfo, nullptr, &pipeline->handle);
+    if (result != VK_SUCCESS)
+        return result;
 
-    // MultisampleState
-    // VkPipelineSampleLocationsStateCreateInfoEXT sampleLocationsState = {VK_STRUCTURE_TYPE_PIPELINE_SAMPLE_LOCATIONS_STATE_CREATE_INFO_EXT};
-    //sampleLocationsState.sampleLocationsInfo.sType = VK_STRUCTURE_TYPE_SAMPLE_LOCATIONS_INFO_EXT;
-    VkPipelineMultisampleStateCreateInfo multisampleState = {};
-    multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampleState.rasterizationSamples = ToVkSampleCount(desc.multisample.count);
+    // Link again with link time optimization in the background, GetHandle switches to it once ready
+    pipeline->AddRef();
+    pipelineCompiler.Submit([this, pipeline, libraries](bool cancelled) {
+        if (cancelled)
+        {
+            pipeline->Release();
+            return;
+        }
 
-    ALIMER_ASSERT(multisampleState.rasterizationSamples <= 32);
-    if (multisampleState.rasterizationSamples > VK_SAMPLE_COUNT_1_BIT)
-    {
-        multisampleState.sampleShadingEnable = VK_FALSE;
-        multisampleState.minSampleShading = 0.0f;
-        multisampleState.alphaToCoverageEnable = desc.multisample.alphaToCoverageEnabled ? VK_TRUE : VK_FALSE;
-        multisampleState.alphaToOneEnable = VK_FALSE;
-        multisampleState.pSampleMask = nullptr;
-    }
+        VkPipelineLibraryCreateInfoKHR libraryInfo = {};
+        libraryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+        libraryInfo.libraryCount = 4;
+        libraryInfo.pLibraries = libraries;
 
-    // DepthStencilState
-    VkPipelineDepthStencilStateCreateInfo depthStencilState = {};
-    depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    if (desc.depthStencilAttachmentFormat != GPUPixelFormat_Undefined)
-    {
-        depthStencilState.depthTestEnable = (desc.depthStencilState.depthCompareFunction != GPUCompareFunction_Always || desc.depthStencilState.depthWriteEnabled) ? VK_TRUE : VK_FALSE;
-        depthStencilState.depthWriteEnable = desc.depthStencilState.depthWriteEnabled ? VK_TRUE : VK_FALSE;
-        depthStencilState.depthCompareOp = ToVk(desc.depthStencilState.depthCompareFunction);
-        if (adapter->features2.features.depthBounds == VK_TRUE)
+        VkGraphicsPipelineCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.pNext = &libraryInfo;
+        createInfo.flags = VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+        createInfo.layout = pipeline->layout->handle;
+
+        VkResult result = vkCreateGraphicsPipelines(handle, pipelineCache, 1, &createInfo, nullptr, &pipeline->optimizedHandle);
+        if (result == VK_SUCCESS)
         {
-            depthStencilState.depthBoundsTestEnable = desc.depthStencilState.depthBoundsTestEnable ? VK_TRUE : VK_FALSE;
+            pipeline->optimized.store(true, std::memory_order_release);
         }
         else
         {
-            depthStencilState.depthBoundsTestEnable = false;
+            pipeline->optimizedHandle = VK_NULL_HANDLE;
+            VK_LOG_ERROR(result, "Failed to link optimized Render Pipeline, keeping the fast-linked one");
         }
 
-        depthStencilState.stencilTestEnable = StencilTestEnabled(desc.depthStencilState) ? VK_TRUE : VK_FALSE;
-        depthStencilState.front.failOp = ToVk(desc.depthStencilState.frontFace.failOperation);
-        depthStencilState.front.passOp = ToVk(desc.depthStencilState.frontFace.passOperation);
-        depthStencilState.front.depthFailOp = ToVk(desc.depthStencilState.frontFace.depthFailOperation);
-        depthStencilState.front.compareOp = ToVk(desc.depthStencilState.frontFace.compareFunction);
-        depthStencilState.front.compareMask = desc.depthStencilState.stencilReadMask;
-        depthStencilState.front.writeMask = desc.depthStencilState.stencilWriteMask;
-        depthStencilState.front.reference = 0;
-
-        depthStencilState.back.failOp = ToVk(desc.depthStencilState.backFace.failOperation);
-        depthStencilState.back.passOp = ToVk(desc.depthStencilState.backFace.passOperation);
-        depthStencilState.back.depthFailOp = ToVk(desc.depthStencilState.backFace.depthFailOperation);
-        depthStencilState.back.compareOp = ToVk(desc.depthStencilState.backFace.compareFunction);
-        depthStencilState.back.compareMask = desc.depthStencilState.stencilReadMask;
-        depthStencilState.back.writeMask = desc.depthStencilState.stencilWriteMask;
-        depthStencilState.back.reference = 0;
-
-        depthStencilState.minDepthBounds = 0.0f;
-        depthStencilState.maxDepthBounds = 1.0f;
-    }
-
-    // RenderingInfo/ RenderPass
-    VkPipelineRenderingCreateInfo renderingInfo{};
-    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
-    VkFormat colorAttachmentFormats[GPU_MAX_COLOR_ATTACHMENTS];
+        pipeline->Release();
+    });
 
-    // BlendState
-    VkPipelineColorBlendStateCreateInfo blendState{};
-    blendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    blendState.logicOpEnable = VK_FALSE;
-    blendState.logicOp = VK_LOGIC_OP_CLEAR;
-    blendState.blendConstants[0] = 0.0f;
-    blendState.blendConstants[1] = 0.0f;
-    blendState.blendConstants[2] = 0.0f;
-    blendState.blendConstants[3] = 0.0f;
-    VkPipelineColorBlendAttachmentState blendAttachmentStates[GPU_MAX_COLOR_ATTACHMENTS] = {};
+    return VK_SUCCESS;
+}
 
-    for (uint32_t i = 0; i < desc.colorAttachmentCount; ++i)
+VkPipeline VulkanDevice::GetPipelineLibrary(std::string&& key, VkGraphicsPipelineLibraryFlagsEXT part, VkGraphicsPipelineCreateInfo& createInfo)
+{
     {
-        if (desc.colorAttachments[i].format == GPUPixelFormat_Undefined)
-            break;
-
-        const GPURenderPipelineColorAttachmentDesc& attachment = desc.colorAttachments[i];
-
-        blendAttachmentStates[renderingInfo.colorAttachmentCount].blendEnable = BlendEnabled(&attachment) ? VK_TRUE : VK_FALSE;
-        blendAttachmentStates[renderingInfo.colorAttachmentCount].srcColorBlendFactor = ToVk(attachment.srcColorBlendFactor);
-        blendAttachmentStates[renderingInfo.colorAttachmentCount].dstColorBlendFactor = ToVk(attachment.destColorBlendFactor);
-        blendAttachmentStates[renderingInfo.colorAttachmentCount].colorBlendOp = ToVk(attachment.colorBlendOperation);
-        blendAttachmentStates[renderingInfo.colorAttachmentCount].srcAlphaBlendFactor = ToVk(attachment.srcAlphaBlendFactor);
-        blendAttachmentStates[renderingInfo.colorAttachmentCount].dstAlphaBlendFactor = ToVk(attachment.destAlphaBlendFactor);
-        blendAttachmentStates[renderingInfo.colorAttachmentCount].alphaBlendOp = ToVk(attachment.alphaBlendOperation);
-        blendAttachmentStates[renderingInfo.colorAttachmentCount].colorWriteMask = ToVk(attachment.colorWriteMask);
-
-        colorAttachmentFormats[renderingInfo.colorAttachmentCount] = adapter->ToVkFormat(attachment.format);
-        renderingInfo.colorAttachmentCount++;
+        std::lock_guard<std::mutex> lock(pipelineLibraryMutex);
+        auto it = pipelineLibraries.find(key);
+        if (it != pipelineLibraries.end())
+            return it->second;
     }
 
-    blendState.attachmentCount = renderingInfo.colorAttachmentCount;
-    blendState.pAttachments = blendAttachmentStates;
-
-    renderingInfo.pColorAttachmentFormats = colorAttachmentFormats;
-    renderingInfo.depthAttachmentFormat = VK_FORMAT_UNDEFINED;
-    renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
-    if (desc.depthStencilAttachmentFormat != GPUPixelFormat_Undefined)
+    // Created outside the lock so parts compile in parallel on the compiler threads
+    std::vector<VkDynamicState> dynamicStates;
+    for (VkDynamicState dynamicState : psoDynamicStates)
     {
-        renderingInfo.depthAttachmentFormat = adapter->ToVkFormat(desc.depthStencilAttachmentFormat);
-        if (!alimerPixelFormatIsDepthOnly(desc.depthStencilAttachmentFormat))
-        {
-            renderingInfo.stencilAttachmentFormat = renderingInfo.depthAttachmentFormat;
-        }
+        if ((GetDynamicStateLibraryParts(dynamicState) & part) != 0)
+            dynamicStates.push_back(dynamicState);
     }
 
-    VkGraphicsPipelineCreateInfo createInfo = {};
-    createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    createInfo.pNext = &renderingInfo;
-    createInfo.stageCount = (uint32_t)stages.size();
-    createInfo.pStages = stages.data();
-    createInfo.pVertexInputState = &vertexInputState;
-    createInfo.pInputAssemblyState = &inputAssemblyState;
-    createInfo.pTessellationState = nullptr;
-    createInfo.pViewportState = &viewportState;
-    createInfo.pRasterizationState = &rasterizationState;
-    createInfo.pMultisampleState = &multisampleState;
-    createInfo.pDepthStencilState = (desc.depthStencilAttachmentFormat != GPUPixelFormat_Undefined) ? &depthStencilState : nullptr;
-    createInfo.pColorBlendState = &blendState;
-    createInfo.pDynamicState = &dynamicStateInfo;
-    createInfo.layout = pipeline->layout->handle;
-    createInfo.renderPass = VK_NULL_HANDLE;
-    createInfo.subpass = 0;
-    createInfo.basePipelineHandle = VK_NULL_HANDLE;
-    createInfo.basePipelineIndex = -1;
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = (uint32_t)dynamicStates.size();
+    dynamicState.pDynamicStates = dynamicStates.data();
 
-    VkResult result = vkCreateGraphicsPipelines(handle, pipelineCache, 1, &createInfo, nullptr, &pipeline->handle);
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo = {};
+    libraryInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+    libraryInfo.pNext = createInfo.pNext;
+    libraryInfo.flags = part;
 
-    for (size_t i = 0; i < stages.size(); i++)
-    {
-        vkDestroyShaderModule(handle, stages[i].module, nullptr);
-    }
+    createInfo.pNext = &libraryInfo;
+    createInfo.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+    createInfo.pDynamicState = dynamicStates.empty() ? nullptr : &dynamicState;
+    createInfo.basePipelineIndex = -1;
 
+    VkPipeline library = VK_NULL_HANDLE;
+    VkResult result = vkCreateGraphicsPipelines(handle, pipelineCache, 1, &createInfo, nullptr, &library);
     if (result != VK_SUCCESS)
     {
-        delete pipeline;
-        VK_LOG_ERROR(result, "Failed to create Render Pipeline");
-        return nullptr;
+        VK_LOG_ERROR(result, "Failed to create graphics pipeline library");
+        return VK_NULL_HANDLE;
     }
 
-    if (desc.label)
+    std::lock_guard<std::mutex> lock(pipelineLibraryMutex);
+    auto [it, inserted] = pipelineLibraries.emplace(std::move(key), library);
+    if (!inserted)
     {
-        pipeline->SetLabel(desc.label);
+        // Another thread created the same part meanwhile
+        vkDestroyPipeline(handle, library, nullptr);
     }
-
-    return pipeline;
+    return it->second;
 }
 
 GPUQueryHeap VulkanDevice::CreateQueryHeap(const GPUQueryHeapDesc& desc)
@@ -5544,6 +7945,15 @@ bool VulkanAdapter::Init(VkPhysicalDevice handle_)
         addToPropertiesChain(&descriptorHeapPropertiesEXT);
     }
 
+    if (extensions.graphicsPipelineLibrary)
+    {
+        graphicsPipelineLibraryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+        addToFeatureChain(&graphicsPipelineLibraryFeatures);
+
+        graphicsPipelineLibraryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+        addToPropertiesChain(&graphicsPipelineLibraryProperties);
+    }
+
     factory->vkGetPhysicalDeviceFeatures2(handle, &features2);
     factory->vkGetPhysicalDeviceProperties2(handle, &properties2);
 
@@ -5554,6 +7964,12 @@ bool VulkanAdapter::Init(VkPhysicalDevice handle_)
         return false;
     }
 
+    if (features12.timelineSemaphore == VK_FALSE)
+    {
+        agpuLogError("Vulkan timelineSemaphore feature required.");
+        return false;
+    }
+
     synchronization2 = features13.synchronization2 == VK_TRUE || synchronization2Features.synchronization2 == VK_TRUE;
     dynamicRendering = features13.dynamicRendering == VK_TRUE || dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
 
@@ -5723,6 +8139,15 @@ bool VulkanAdapter::HasFeature(GPUFeature feature) const
                 (depthStencilResolveProperties.supportedStencilResolveModes & VK_RESOLVE_MODE_MIN_BIT) &&
                 (depthStencilResolveProperties.supportedStencilResolveModes & VK_RESOLVE_MODE_MAX_BIT);
 
+        case GPUFeature_Bindless:
+            return
+                features12.runtimeDescriptorArray == VK_TRUE &&
+                features12.descriptorBindingPartiallyBound == VK_TRUE &&
+                features12.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+                features12.descriptorBindingStorageImageUpdateAfterBind == VK_TRUE &&
+                features12.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE &&
+                properties2.properties.limits.maxBoundDescriptorSets > VulkanBindlessManager::kSetCount;
+
         default:
             return false;
     }
@@ -6034,6 +8459,10 @@ VulkanPhysicalDeviceExtensions VulkanGPUFactory::QueryPhysicalDeviceExtensions(V
         {
             extensions.descriptorHeap = true;
         }
+        else if (strcmp(vk_extensions[i].extensionName, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) == 0)
+        {
+            extensions.graphicsPipelineLibrary = true;
+        }
         else if (strcmp(vk_extensions[i].extensionName, VK_KHR_VIDEO_QUEUE_EXTENSION_NAME) == 0)
         {
             extensions.video.queue = true;
@@ -107,6 +107,7 @@ VULKAN_DEVICE_FUNCTION(vkCmdCopyBufferToImage)
 VULKAN_DEVICE_FUNCTION(vkCmdCopyImageToBuffer)
 VULKAN_DEVICE_FUNCTION(vkCmdDispatch)
 VULKAN_DEVICE_FUNCTION(vkCmdDispatchIndirect)
+VULKAN_DEVICE_FUNCTION(vkCmdFillBuffer)
 VULKAN_DEVICE_FUNCTION(vkCmdDraw)
 VULKAN_DEVICE_FUNCTION(vkCmdDrawIndexed)
 VULKAN_DEVICE_FUNCTION(vkCmdDrawIndexedIndirect)
@@ -188,6 +189,8 @@ VULKAN_DEVICE_FUNCTION(vkGetMemoryFdKHR)
 
 #if defined(VK_VERSION_1_2) 
 VULKAN_DEVICE_FUNCTION(vkGetBufferDeviceAddress)
+VULKAN_DEVICE_FUNCTION(vkGetSemaphoreCounterValue)
+VULKAN_DEVICE_FUNCTION(vkWaitSemaphores)
 #endif /* defined(VK_VERSION_1_2) */
 
 #if defined(VK_VERSION_1_2) || defined(VK_KHR_draw_indirect_count)
@@ -0,0 +1,162 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+using NUnit.Framework;
+using static Alimer.AlimerApi;
+
+namespace Alimer.Audio;
+
+[TestFixture(TestOf = typeof(AudioEngine))]
+public unsafe class AudioOfflineRenderTests
+{
+    private const int SampleRate = 48000;
+    private const int ChannelCount = 2;
+
+    [Test]
+    public void Test_Render_Silence()
+    {
+        AlimerApi.AudioEngine engine = CreateOfflineEngine();
+        Assert.That(alimerAudioEngineIsOffline(engine), Is.True);
+
+        float[] output = Render(engine, 4800);
+        Assert.That(output, Is.All.EqualTo(0.0f));
+        Assert.That(alimerAudioEngineGetTimeInPCMFrames(engine), Is.EqualTo(4800ul));
+
+        alimerAudioEngineDestroy(engine);
+    }
+
+    [Test]
+    public void Test_Render_Clip()
+    {
+        AlimerApi.AudioEngine engine = CreateOfflineEngine();
+        nint clip = CreateSineClip(0.5f);
+        nint source = alimerAudioSourceCreate(engine, clip);
+        alimerAudioSourceSetSpatializationEnabled(source, false);
+        alimerAudioSourcePlay(source);
+
+        float[] output = Render(engine, 4800);
+        Assert.That(output.Max(MathF.Abs), Is.GreaterThan(0.1f));
+
+        // The clip ends halfway through the next second, the engine clock only advances by the rendered frames.
+        float[] tail = Render(engine, SampleRate);
+        Assert.That(tail.AsSpan(tail.Length - 4800 * ChannelCount).ToArray(), Is.All.EqualTo(0.0f));
+        Assert.That(alimerAudioSourceIsPlaying(source), Is.False);
+        Assert.That(alimerAudioEngineGetTimeInPCMFrames(engine), Is.EqualTo(4800ul + SampleRate));
+
+        alimerAudioSourceRelease(source);
+        alimerAudioClipRelease(clip);
+        alimerAudioEngineDestroy(engine);
+    }
+
+    [Test]
+    public void Test_Render_DefaultVoiceLimit()
+    {
+        // maxRealVoices left at zero picks the default limit instead of virtualizing every voice.
+        AlimerApi.AudioEngine engine = CreateOfflineEngine(maxRealVoices: 0);
+        Assert.That(alimerAudioEngineGetMaxRealVoices(engine), Is.EqualTo(64u));
+
+        nint clip = CreateSineClip(0.5f);
+        nint source = alimerAudioSourceCreate(engine, clip);
+        alimerAudioSourceSetSpatializationEnabled(source, false);
+        alimerAudioSourcePlay(source);
+        alimerAudioEngineUpdate(engine);
+
+        Assert.That(alimerAudioEngineGetRealVoiceCount(engine), Is.EqualTo(1u));
+        Assert.That(Render(engine, 4800).Max(MathF.Abs), Is.GreaterThan(0.1f));
+
+        alimerAudioSourceRelease(source);
+        alimerAudioClipRelease(clip);
+        alimerAudioEngineDestroy(engine);
+    }
+
+    [Test]
+    public void Test_Render_IsDeterministic()
+    {
+        float[] first = RenderClip();
+        float[] second = RenderClip();
+
+        Assert.That(second, Is.EqualTo(first));
+
+        static float[] RenderClip()
+        {
+            AlimerApi.AudioEngine engine = CreateOfflineEngine();
+            nint clip = CreateSineClip(0.5f);
+            nint source = alimerAudioSourceCreate(engine, clip);
+            alimerAudioSourceSetSpatializationEnabled(source, false);
+            alimerAudioSourcePlay(source);
+
+            float[] output = Render(engine, SampleRate / 4);
+
+            alimerAudioSourceRelease(source);
+            alimerAudioClipRelease(clip);
+            alimerAudioEngineDestroy(engine);
+            return output;
+        }
+    }
+
+    private static AlimerApi.AudioEngine CreateOfflineEngine(uint maxRealVoices = 64)
+    {
+        AudioConfig config = new()
+        {
+            channelCount = ChannelCount,
+            sampleRate = SampleRate,
+            maxRealVoices = maxRealVoices,
+            offline = true
+        };
+
+        // Offline engines don't open a device, alimerAudioInit is not required.
+        AlimerApi.AudioEngine engine = alimerAudioEngineCreate(&config);
+        Assert.That(engine.IsNotNull, Is.True);
+        return engine;
+    }
+
+    private static float[] Render(AlimerApi.AudioEngine engine, int frameCount)
+    {
+        float[] output = new float[frameCount * ChannelCount];
+        fixed (float* outputPtr = output)
+        {
+            Assert.That(alimerAudioEngineRender(engine, outputPtr, (ulong)frameCount), Is.EqualTo((ulong)frameCount));
+        }
+
+        return output;
+    }
+
+    /// <summary>
+    /// Mono 16-bit WAV of a 440 Hz sine.
+    /// </summary>
+    private static nint CreateSineClip(float duration)
+    {
+        int frameCount = (int)(SampleRate * duration);
+
+        using MemoryStream stream = new();
+        using (BinaryWriter writer = new(stream))
+        {
+            writer.Write("RIFF"u8);
+            writer.Write(36 + frameCount * 2);
+            writer.Write("WAVE"u8);
+            writer.Write("fmt "u8);
+            writer.Write(16);
+            writer.Write((short)1);
+            writer.Write((short)1);
+            writer.Write(SampleRate);
+            writer.Write(SampleRate * 2);
+            writer.Write((short)2);
+            writer.Write((short)16);
+            writer.Write("data"u8);
+            writer.Write(frameCount * 2);
+
+            for (int i = 0; i < frameCount; i++)
+            {
+                writer.Write((short)(MathF.Sin(2.0f * MathF.PI * 440.0f * i / SampleRate) * 16000.0f));
+            }
+        }
+
+        byte[] data = stream.ToArray();
+        fixed (byte* dataPtr = data)
+        {
+            nint clip = alimerAudioClipCreateFromMemory(dataPtr, (nuint)data.Length);
+            Assert.That(clip, Is.Not.EqualTo(nint.Zero));
+            return clip;
+        }
+    }
+}
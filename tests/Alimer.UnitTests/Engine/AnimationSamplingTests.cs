@@ -0,0 +1,234 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+using System.Numerics;
+using System.Text;
+using NUnit.Framework;
+using static Alimer.AlimerApi;
+
+namespace Alimer.Engine;
+
+[TestFixture(TestOf = typeof(AlimerApi))]
+public unsafe class AnimationSamplingTests
+{
+    private const int TranslationKeyCount = 8;
+    private const float Duration = TranslationKeyCount - 1;
+
+    private Scene* _scene;
+
+    [SetUp]
+    public void SetUp()
+    {
+        byte[] source = CreateAnimatedGltf();
+        fixed (byte* sourcePtr = source)
+        {
+            _scene = alimerSceneCreateFromMemory(sourcePtr, (nuint)source.Length);
+        }
+
+        Assert.That(_scene != null, Is.True);
+        Assert.That(_scene->animationCount, Is.EqualTo(1u));
+    }
+
+    [TearDown]
+    public void TearDown()
+    {
+        alimerSceneDestroy(_scene);
+    }
+
+    [Test]
+    public void Test_Sample_InterpolatesKeys()
+    {
+        nint instance = alimerAnimationInstanceCreate(_scene, 0);
+        nint hierarchy = alimerTransformHierarchyCreateFromScene(_scene);
+        Assert.That(alimerAnimationInstanceGetDuration(instance), Is.EqualTo(Duration));
+
+        foreach (float time in new[] { 0.0f, 0.5f, 1.0f, 2.25f, 4.75f, 6.9f })
+        {
+            Sample(instance, hierarchy, time, false);
+            Assert.That(GetTranslation(hierarchy).X, Is.EqualTo(ExpectedX(time)).Within(1e-4f));
+        }
+
+        // The rotation channel steps, it holds the first key until the second one.
+        Sample(instance, hierarchy, 1.9f, false);
+        Assert.That(GetRotation(hierarchy), Is.EqualTo(Vector4.UnitW));
+        Sample(instance, hierarchy, 2.1f, false);
+        Assert.That(GetRotation(hierarchy), Is.EqualTo(QuarterTurn()));
+
+        alimerTransformHierarchyDestroy(hierarchy);
+        alimerAnimationInstanceDestroy(instance);
+    }
+
+    [Test]
+    public void Test_Sample_CachedKeyMatchesFreshInstance()
+    {
+        nint instance = alimerAnimationInstanceCreate(_scene, 0);
+        nint hierarchy = alimerTransformHierarchyCreateFromScene(_scene);
+
+        // Small forward steps, then jumps backwards and far ahead of the cached key.
+        List<float> times = [];
+        for (float time = 0.0f; time < Duration; time += 0.1f)
+        {
+            times.Add(time);
+        }
+        times.AddRange([1.5f, 0.25f, 6.5f, 3.5f, 3.4f, 0.0f, 5.99f]);
+
+        foreach (float time in times)
+        {
+            Sample(instance, hierarchy, time, false);
+
+            nint freshInstance = alimerAnimationInstanceCreate(_scene, 0);
+            nint freshHierarchy = alimerTransformHierarchyCreateFromScene(_scene);
+            Sample(freshInstance, freshHierarchy, time, false);
+
+            Assert.That(GetTranslation(hierarchy), Is.EqualTo(GetTranslation(freshHierarchy)));
+            Assert.That(GetTranslation(hierarchy).X, Is.EqualTo(ExpectedX(time)).Within(1e-4f));
+
+            alimerTransformHierarchyDestroy(freshHierarchy);
+            alimerAnimationInstanceDestroy(freshInstance);
+        }
+
+        alimerTransformHierarchyDestroy(hierarchy);
+        alimerAnimationInstanceDestroy(instance);
+    }
+
+    [Test]
+    public void Test_Sample_LoopWrapsTime()
+    {
+        nint instance = alimerAnimationInstanceCreate(_scene, 0);
+        nint hierarchy = alimerTransformHierarchyCreateFromScene(_scene);
+
+        Sample(instance, hierarchy, Duration + 1.5f, true);
+        Assert.That(GetTranslation(hierarchy).X, Is.EqualTo(ExpectedX(1.5f)).Within(1e-4f));
+
+        Sample(instance, hierarchy, -0.5f, true);
+        Assert.That(GetTranslation(hierarchy).X, Is.EqualTo(ExpectedX(Duration - 0.5f)).Within(1e-4f));
+
+        // Without looping the last key is held.
+        Sample(instance, hierarchy, Duration + 1.5f, false);
+        Assert.That(GetTranslation(hierarchy).X, Is.EqualTo(ExpectedX(Duration)));
+
+        alimerTransformHierarchyDestroy(hierarchy);
+        alimerAnimationInstanceDestroy(instance);
+    }
+
+    [Test]
+    public void Test_Sample_BatchMatchesSingleInstances()
+    {
+        // Batches of 16 instances and more are split across the job system.
+        const int instanceCount = 40;
+        nint[] instances = new nint[instanceCount];
+        nint[] hierarchies = new nint[instanceCount];
+        float[] times = new float[instanceCount];
+        for (int i = 0; i < instanceCount; i++)
+        {
+            instances[i] = alimerAnimationInstanceCreate(_scene, 0);
+            hierarchies[i] = alimerTransformHierarchyCreateFromScene(_scene);
+            times[i] = i * 0.37f;
+        }
+
+        fixed (nint* instancesPtr = instances)
+        fixed (nint* hierarchiesPtr = hierarchies)
+        fixed (float* timesPtr = times)
+        {
+            alimerAnimationSample(instanceCount, instancesPtr, timesPtr, true, hierarchiesPtr);
+        }
+
+        nint singleInstance = alimerAnimationInstanceCreate(_scene, 0);
+        nint singleHierarchy = alimerTransformHierarchyCreateFromScene(_scene);
+        for (int i = 0; i < instanceCount; i++)
+        {
+            Sample(singleInstance, singleHierarchy, times[i], true);
+            Assert.That(GetTranslation(hierarchies[i]), Is.EqualTo(GetTranslation(singleHierarchy)));
+            Assert.That(GetRotation(hierarchies[i]), Is.EqualTo(GetRotation(singleHierarchy)));
+
+            alimerTransformHierarchyDestroy(hierarchies[i]);
+            alimerAnimationInstanceDestroy(instances[i]);
+        }
+
+        alimerTransformHierarchyDestroy(singleHierarchy);
+        alimerAnimationInstanceDestroy(singleInstance);
+    }
+
+    private static void Sample(nint instance, nint hierarchy, float time, bool loop)
+    {
+        alimerAnimationSample(1, &instance, &time, loop, &hierarchy);
+    }
+
+    private static Vector3 GetTranslation(nint hierarchy)
+    {
+        Vector3 translation;
+        alimerTransformHierarchyGetLocal(hierarchy, 0, &translation, null, null);
+        return translation;
+    }
+
+    private static Vector4 GetRotation(nint hierarchy)
+    {
+        Vector4 rotation;
+        alimerTransformHierarchyGetLocal(hierarchy, 0, null, &rotation, null);
+        return rotation;
+    }
+
+    /// <summary>
+    /// Linear interpolation of the translation keys, key k is at time k with x = k * k.
+    /// </summary>
+    private static float ExpectedX(float time)
+    {
+        int key = Math.Min((int)time, TranslationKeyCount - 2);
+        float t = time - key;
+        return key * key + ((key + 1) * (key + 1) - key * key) * t;
+    }
+
+    private static Vector4 QuarterTurn()
+    {
+        return new Vector4(0.0f, MathF.Sqrt(0.5f), 0.0f, MathF.Sqrt(0.5f));
+    }
+
+    /// <summary>
+    /// Single node with a linear translation channel and a step rotation channel, the buffer is embedded as a data URI.
+    /// </summary>
+    private static byte[] CreateAnimatedGltf()
+    {
+        using MemoryStream stream = new();
+        using (BinaryWriter writer = new(stream))
+        {
+            for (int key = 0; key < TranslationKeyCount; key++)
+            {
+                writer.Write((float)key);
+            }
+
+            for (int key = 0; key < TranslationKeyCount; key++)
+            {
+                writer.Write((float)(key * key));
+                writer.Write(0.0f);
+                writer.Write(0.0f);
+            }
+
+            writer.Write(0.0f);
+            writer.Write(2.0f);
+
+            Vector4 quarterTurn = QuarterTurn();
+            foreach (Vector4 rotation in new[] { Vector4.UnitW, quarterTurn })
+            {
+                writer.Write(rotation.X);
+                writer.Write(rotation.Y);
+                writer.Write(rotation.Z);
+                writer.Write(rotation.W);
+            }
+        }
+
+        string buffer = Convert.ToBase64String(stream.ToArray());
+        string json =
+            "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"name\":\"root\"}]," +
+            "\"animations\":[{\"channels\":[{\"sampler\":0,\"target\":{\"node\":0,\"path\":\"translation\"}},{\"sampler\":1,\"target\":{\"node\":0,\"path\":\"rotation\"}}]," +
+            "\"samplers\":[{\"input\":0,\"output\":1,\"interpolation\":\"LINEAR\"},{\"input\":2,\"output\":3,\"interpolation\":\"STEP\"}]}]," +
+            $"\"buffers\":[{{\"byteLength\":168,\"uri\":\"data:application/octet-stream;base64,{buffer}\"}}]," +
+            "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":32},{\"buffer\":0,\"byteOffset\":32,\"byteLength\":96}," +
+            "{\"buffer\":0,\"byteOffset\":128,\"byteLength\":8},{\"buffer\":0,\"byteOffset\":136,\"byteLength\":32}]," +
+            "\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":8,\"type\":\"SCALAR\",\"min\":[0],\"max\":[7]}," +
+            "{\"bufferView\":1,\"componentType\":5126,\"count\":8,\"type\":\"VEC3\"}," +
+            "{\"bufferView\":2,\"componentType\":5126,\"count\":2,\"type\":\"SCALAR\",\"min\":[0],\"max\":[2]}," +
+            "{\"bufferView\":3,\"componentType\":5126,\"count\":2,\"type\":\"VEC4\"}]}";
+
+        return Encoding.UTF8.GetBytes(json);
+    }
+}
@@ -0,0 +1,323 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+using System.Numerics;
+using System.Text;
+using NUnit.Framework;
+using static Alimer.AlimerApi;
+
+namespace Alimer.Engine;
+
+[TestFixture(TestOf = typeof(AlimerApi))]
+public unsafe class SceneBVHTests
+{
+    [TestCase(1000)]
+    // Builds above 16K primitives split subtrees across the job system.
+    [TestCase(40000)]
+    public void Test_QueryBounds_MatchesBruteForce(int count)
+    {
+        CreateBoxes(count, out Vector3[] boundsMin, out Vector3[] boundsMax);
+        nint bvh = CreateBVH(boundsMin, boundsMax);
+        Random random = new(7);
+
+        for (int query = 0; query < 20; query++)
+        {
+            Vector3 queryMin = RandomVector(random, -60.0f, 50.0f);
+            Vector3 queryMax = queryMin + RandomVector(random, 1.0f, 20.0f);
+
+            List<uint> expected = [];
+            for (int i = 0; i < count; i++)
+            {
+                if (!IsEmpty(boundsMin[i], boundsMax[i]) && Overlaps(boundsMin[i], boundsMax[i], queryMin, queryMax))
+                    expected.Add((uint)i);
+            }
+
+            uint[] results = new uint[count];
+            uint resultCount;
+            fixed (uint* resultsPtr = results)
+            {
+                resultCount = alimerSceneBVHQueryBounds(bvh, &queryMin, &queryMax, resultsPtr, (uint)count);
+            }
+
+            Assert.That(Sorted(results, resultCount), Is.EqualTo(expected));
+        }
+
+        alimerSceneBVHDestroy(bvh);
+    }
+
+    [TestCase(1000)]
+    [TestCase(40000)]
+    public void Test_QueryFrustum_MatchesBruteForce(int count)
+    {
+        CreateBoxes(count, out Vector3[] boundsMin, out Vector3[] boundsMax);
+        nint bvh = CreateBVH(boundsMin, boundsMax);
+
+        foreach (Vector3 target in new[] { Vector3.Zero, new Vector3(40.0f, 0.0f, 0.0f), new Vector3(-20.0f, 30.0f, 10.0f) })
+        {
+            Vector4[] planes = CreateFrustumPlanes(new Vector3(0.0f, 5.0f, -80.0f), target);
+
+            List<uint> expected = [];
+            for (int i = 0; i < count; i++)
+            {
+                if (!IsEmpty(boundsMin[i], boundsMax[i]) && planes.All(plane => !OutsidePlane(plane, boundsMin[i], boundsMax[i])))
+                    expected.Add((uint)i);
+            }
+
+            uint[] results = new uint[count];
+            uint resultCount;
+            fixed (Vector4* planesPtr = planes)
+            fixed (uint* resultsPtr = results)
+            {
+                resultCount = alimerSceneBVHQueryFrustum(bvh, planesPtr, resultsPtr, (uint)count);
+            }
+
+            Assert.That(expected, Is.Not.Empty);
+            Assert.That(Sorted(results, resultCount), Is.EqualTo(expected));
+        }
+
+        alimerSceneBVHDestroy(bvh);
+    }
+
+    [Test]
+    public void Test_QueryFrustum_ReturnsTotalCount()
+    {
+        const int count = 1000;
+        CreateBoxes(count, out Vector3[] boundsMin, out Vector3[] boundsMax);
+        nint bvh = CreateBVH(boundsMin, boundsMax);
+
+        // Every box is inside, only maxResults indices are written.
+        Vector4[] planes = CreateBoxPlanes(new Vector3(-100.0f), new Vector3(100.0f));
+        uint[] results = new uint[count];
+        Array.Fill(results, uint.MaxValue);
+        uint resultCount;
+        fixed (Vector4* planesPtr = planes)
+        fixed (uint* resultsPtr = results)
+        {
+            resultCount = alimerSceneBVHQueryFrustum(bvh, planesPtr, resultsPtr, 10);
+        }
+
+        Assert.That(resultCount, Is.EqualTo((uint)(count - count / 100)));
+        Assert.That(results.Take(10), Is.All.LessThan((uint)count));
+        Assert.That(results.Skip(10), Is.All.EqualTo(uint.MaxValue));
+
+        alimerSceneBVHDestroy(bvh);
+    }
+
+    [TestCase(1000)]
+    [TestCase(40000)]
+    public void Test_Raycast_MatchesBruteForce(int count)
+    {
+        CreateBoxes(count, out Vector3[] boundsMin, out Vector3[] boundsMax);
+        nint bvh = CreateBVH(boundsMin, boundsMax);
+        Random random = new(11);
+
+        for (int ray = 0; ray < 50; ray++)
+        {
+            Vector3 origin = RandomVector(random, -50.0f, 50.0f) + new Vector3(0.0f, 0.0f, -100.0f);
+            Vector3 direction = Vector3.Normalize(new Vector3(0.0f, 0.0f, 100.0f) + RandomVector(random, -30.0f, 30.0f));
+            const float maxDistance = 300.0f;
+
+            int expectedIndex = -1;
+            float expectedDistance = maxDistance;
+            for (int i = 0; i < count; i++)
+            {
+                if (IsEmpty(boundsMin[i], boundsMax[i]))
+                    continue;
+
+                float distance = IntersectBounds(origin, direction, boundsMin[i], boundsMax[i]);
+                if (distance < expectedDistance)
+                {
+                    expectedDistance = distance;
+                    expectedIndex = i;
+                }
+            }
+
+            SceneRayHit hit;
+            bool found = alimerSceneBVHRaycast(bvh, &origin, &direction, maxDistance, &hit);
+            Assert.That(found, Is.EqualTo(expectedIndex >= 0));
+            if (found)
+            {
+                Assert.That(hit.primitiveIndex, Is.EqualTo((uint)expectedIndex));
+                Assert.That(hit.distance, Is.EqualTo(expectedDistance).Within(1e-3f));
+            }
+        }
+
+        alimerSceneBVHDestroy(bvh);
+    }
+
+    [Test]
+    public void Test_Raycast_Mesh()
+    {
+        byte[] source = CreateTriangleGltf();
+        fixed (byte* sourcePtr = source)
+        {
+            Scene* scene = alimerSceneCreateFromMemory(sourcePtr, (nuint)source.Length);
+            Assert.That(scene != null, Is.True);
+
+            nint bvh = alimerSceneBVHCreateFromMesh(scene->meshes);
+            Assert.That(alimerSceneBVHGetNodeCount(bvh), Is.EqualTo(1u));
+
+            Vector3 origin = new(0.25f, 0.5f, -2.0f);
+            Vector3 direction = new(0.0f, 0.0f, 2.0f);
+            SceneRayHit hit;
+            Assert.That(alimerSceneBVHRaycast(bvh, &origin, &direction, float.MaxValue, &hit), Is.True);
+            Assert.That(hit.primitiveIndex, Is.EqualTo(0u));
+            // Distance is in direction units.
+            Assert.That(hit.distance, Is.EqualTo(1.0f).Within(1e-5f));
+            Assert.That(hit.u, Is.EqualTo(0.25f).Within(1e-5f));
+            Assert.That(hit.v, Is.EqualTo(0.5f).Within(1e-5f));
+
+            Assert.That(alimerSceneBVHRaycast(bvh, &origin, &direction, 0.5f, &hit), Is.False);
+
+            origin = new Vector3(0.75f, 0.75f, -2.0f);
+            Assert.That(alimerSceneBVHRaycast(bvh, &origin, &direction, float.MaxValue, &hit), Is.False);
+
+            alimerSceneBVHDestroy(bvh);
+            alimerSceneDestroy(scene);
+        }
+    }
+
+    /// <summary>
+    /// Random boxes in [-50, 50], every hundredth box is empty (min > max) and must never be returned.
+    /// </summary>
+    private static void CreateBoxes(int count, out Vector3[] boundsMin, out Vector3[] boundsMax)
+    {
+        Random random = new(1234);
+        boundsMin = new Vector3[count];
+        boundsMax = new Vector3[count];
+        for (int i = 0; i < count; i++)
+        {
+            boundsMin[i] = RandomVector(random, -50.0f, 50.0f);
+            boundsMax[i] = boundsMin[i] + RandomVector(random, 0.1f, 3.0f);
+
+            if (i % 100 == 0)
+            {
+                (boundsMin[i], boundsMax[i]) = (boundsMax[i], boundsMin[i]);
+            }
+        }
+    }
+
+    private static nint CreateBVH(Vector3[] boundsMin, Vector3[] boundsMax)
+    {
+        fixed (Vector3* boundsMinPtr = boundsMin)
+        fixed (Vector3* boundsMaxPtr = boundsMax)
+        {
+            nint bvh = alimerSceneBVHCreate((uint)boundsMin.Length, boundsMinPtr, boundsMaxPtr);
+            Assert.That(bvh, Is.Not.EqualTo(nint.Zero));
+            return bvh;
+        }
+    }
+
+    private static Vector3 RandomVector(Random random, float min, float max)
+    {
+        return new Vector3(
+            min + random.NextSingle() * (max - min),
+            min + random.NextSingle() * (max - min),
+            min + random.NextSingle() * (max - min));
+    }
+
+    private static List<uint> Sorted(uint[] results, uint count)
+    {
+        List<uint> sorted = [.. results.Take((int)count)];
+        sorted.Sort();
+        return sorted;
+    }
+
+    private static bool IsEmpty(Vector3 boundsMin, Vector3 boundsMax)
+    {
+        return boundsMin.X > boundsMax.X || boundsMin.Y > boundsMax.Y || boundsMin.Z > boundsMax.Z;
+    }
+
+    private static bool Overlaps(Vector3 aMin, Vector3 aMax, Vector3 bMin, Vector3 bMax)
+    {
+        return aMin.X <= bMax.X && aMax.X >= bMin.X
+            && aMin.Y <= bMax.Y && aMax.Y >= bMin.Y
+            && aMin.Z <= bMax.Z && aMax.Z >= bMin.Z;
+    }
+
+    private static bool OutsidePlane(Vector4 plane, Vector3 boundsMin, Vector3 boundsMax)
+    {
+        Vector3 corner = new(
+            plane.X >= 0.0f ? boundsMax.X : boundsMin.X,
+            plane.Y >= 0.0f ? boundsMax.Y : boundsMin.Y,
+            plane.Z >= 0.0f ? boundsMax.Z : boundsMin.Z);
+        return plane.X * corner.X + plane.Y * corner.Y + plane.Z * corner.Z + plane.W < 0.0f;
+    }
+
+    /// <summary>
+    /// Slab test, returns the entry distance or float.MaxValue when the box is missed.
+    /// </summary>
+    private static float IntersectBounds(Vector3 origin, Vector3 direction, Vector3 boundsMin, Vector3 boundsMax)
+    {
+        Vector3 t1 = (boundsMin - origin) / direction;
+        Vector3 t2 = (boundsMax - origin) / direction;
+        Vector3 near = Vector3.Min(t1, t2);
+        Vector3 far = Vector3.Max(t1, t2);
+        float tmin = MathF.Max(near.X, MathF.Max(near.Y, near.Z));
+        float tmax = MathF.Min(far.X, MathF.Min(far.Y, far.Z));
+
+        if (tmax >= tmin && tmax >= 0.0f)
+            return MathF.Max(tmin, 0.0f);
+        return float.MaxValue;
+    }
+
+    /// <summary>
+    /// Perspective frustum planes (normals pointing inside) extracted from the view projection columns.
+    /// </summary>
+    private static Vector4[] CreateFrustumPlanes(Vector3 eye, Vector3 target)
+    {
+        Matrix4x4 viewProjection = Matrix4x4.CreateLookAt(eye, target, Vector3.UnitY)
+            * Matrix4x4.CreatePerspectiveFieldOfView(MathF.PI / 4.0f, 16.0f / 9.0f, 0.1f, 150.0f);
+
+        Vector4 column1 = new(viewProjection.M11, viewProjection.M21, viewProjection.M31, viewProjection.M41);
+        Vector4 column2 = new(viewProjection.M12, viewProjection.M22, viewProjection.M32, viewProjection.M42);
+        Vector4 column3 = new(viewProjection.M13, viewProjection.M23, viewProjection.M33, viewProjection.M43);
+        Vector4 column4 = new(viewProjection.M14, viewProjection.M24, viewProjection.M34, viewProjection.M44);
+
+        return [column4 + column1, column4 - column1, column4 + column2, column4 - column2, column3, column4 - column3];
+    }
+
+    private static Vector4[] CreateBoxPlanes(Vector3 min, Vector3 max)
+    {
+        return
+        [
+            new(1.0f, 0.0f, 0.0f, -min.X), new(-1.0f, 0.0f, 0.0f, max.X),
+            new(0.0f, 1.0f, 0.0f, -min.Y), new(0.0f, -1.0f, 0.0f, max.Y),
+            new(0.0f, 0.0f, 1.0f, -min.Z), new(0.0f, 0.0f, -1.0f, max.Z)
+        ];
+    }
+
+    /// <summary>
+    /// Single triangle mesh in the XY plane, the buffer is embedded as a data URI.
+    /// </summary>
+    private static byte[] CreateTriangleGltf()
+    {
+        using MemoryStream stream = new();
+        using (BinaryWriter writer = new(stream))
+        {
+            Vector3[] positions = [new(0.0f, 0.0f, 0.0f), new(1.0f, 0.0f, 0.0f), new(0.0f, 1.0f, 0.0f)];
+            foreach (Vector3 position in positions)
+            {
+                writer.Write(position.X);
+                writer.Write(position.Y);
+                writer.Write(position.Z);
+            }
+
+            writer.Write((ushort)0);
+            writer.Write((ushort)1);
+            writer.Write((ushort)2);
+            writer.Write((ushort)0);
+        }
+
+        string buffer = Convert.ToBase64String(stream.ToArray());
+        string json =
+            "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"name\":\"triangle\",\"mesh\":0}]," +
+            "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0},\"indices\":1}]}]," +
+            $"\"buffers\":[{{\"byteLength\":44,\"uri\":\"data:application/octet-stream;base64,{buffer}\"}}]," +
+            "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":36},{\"buffer\":0,\"byteOffset\":36,\"byteLength\":6}]," +
+            "\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":3,\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[1,1,0]}," +
+            "{\"bufferView\":1,\"componentType\":5123,\"count\":3,\"type\":\"SCALAR\"}]}";
+
+        return Encoding.UTF8.GetBytes(json);
+    }
+}
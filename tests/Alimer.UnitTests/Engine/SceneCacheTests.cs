@@ -0,0 +1,206 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+using System.Globalization;
+using System.Numerics;
+using System.Text;
+using NUnit.Framework;
+using static Alimer.AlimerApi;
+
+namespace Alimer.Engine;
+
+[TestFixture(TestOf = typeof(AlimerApi))]
+public unsafe class SceneCacheTests
+{
+    private string _cachePath = null!;
+
+    [SetUp]
+    public void SetUp()
+    {
+        _cachePath = Path.Combine(Path.GetTempPath(), $"alimer_scene_{Guid.NewGuid():N}.cache");
+    }
+
+    [TearDown]
+    public void TearDown()
+    {
+        if (File.Exists(_cachePath))
+        {
+            File.Delete(_cachePath);
+        }
+    }
+
+    [Test]
+    public void Test_LoadCached_RoundTrip()
+    {
+        byte[] source = CreateTriangleGltf(1.0f);
+
+        fixed (byte* sourcePtr = source)
+        {
+            Scene* imported = alimerSceneCreateFromMemory(sourcePtr, (nuint)source.Length);
+            Assert.That(imported != null, Is.True);
+            Assert.That(imported->contentHash, Is.EqualTo(0ul));
+
+            // Missing cache, imported from the source and saved.
+            Scene* rebuilt = alimerSceneLoadCached(_cachePath, sourcePtr, (nuint)source.Length, null);
+            Assert.That(rebuilt != null, Is.True);
+            Assert.That(File.Exists(_cachePath), Is.True);
+            AssertScenesEqual(imported, rebuilt);
+            ulong contentHash = rebuilt->contentHash;
+            Assert.That(contentHash, Is.Not.EqualTo(0ul));
+            alimerSceneDestroy(rebuilt);
+
+            // Up to date cache, mapped as is.
+            Scene* mapped = alimerSceneLoadCached(_cachePath, sourcePtr, (nuint)source.Length, null);
+            Assert.That(mapped != null, Is.True);
+            AssertScenesEqual(imported, mapped);
+            Assert.That(mapped->contentHash, Is.EqualTo(contentHash));
+            alimerSceneDestroy(mapped);
+
+            alimerSceneDestroy(imported);
+        }
+    }
+
+    [Test]
+    public void Test_Save_LoadWithoutSource()
+    {
+        byte[] source = CreateTriangleGltf(1.0f);
+
+        fixed (byte* sourcePtr = source)
+        {
+            Scene* imported = alimerSceneCreateFromMemory(sourcePtr, (nuint)source.Length);
+            Assert.That(imported != null, Is.True);
+            Assert.That(alimerSceneSave(imported, _cachePath), Is.True);
+
+            Scene* mapped = alimerSceneLoadCached(_cachePath, null, 0, null);
+            Assert.That(mapped != null, Is.True);
+            AssertScenesEqual(imported, mapped);
+
+            alimerSceneDestroy(mapped);
+            alimerSceneDestroy(imported);
+        }
+    }
+
+    [Test]
+    public void Test_LoadCached_StaleCacheIsRebuilt()
+    {
+        byte[] original = CreateTriangleGltf(1.0f);
+        byte[] edited = CreateTriangleGltf(2.0f);
+        ulong originalHash;
+
+        fixed (byte* sourcePtr = original)
+        {
+            Scene* scene = alimerSceneLoadCached(_cachePath, sourcePtr, (nuint)original.Length, null);
+            Assert.That(scene != null, Is.True);
+            Assert.That(scene->nodes[0].translation.X, Is.EqualTo(1.0f));
+            originalHash = scene->contentHash;
+            alimerSceneDestroy(scene);
+        }
+
+        fixed (byte* sourcePtr = edited)
+        {
+            Scene* scene = alimerSceneLoadCached(_cachePath, sourcePtr, (nuint)edited.Length, null);
+            Assert.That(scene != null, Is.True);
+            Assert.That(scene->contentHash, Is.Not.EqualTo(originalHash));
+            Assert.That(scene->nodes[0].translation.X, Is.EqualTo(2.0f));
+            alimerSceneDestroy(scene);
+        }
+
+        // The rebuilt scene was written back to the cache.
+        Scene* cached = alimerSceneLoadCached(_cachePath, null, 0, null);
+        Assert.That(cached != null, Is.True);
+        Assert.That(cached->contentHash, Is.Not.EqualTo(originalHash));
+        Assert.That(cached->nodes[0].translation.X, Is.EqualTo(2.0f));
+        alimerSceneDestroy(cached);
+    }
+
+    [Test]
+    public void Test_LoadCached_RebuildKeepsLiveScenesValid()
+    {
+        byte[] original = CreateTriangleGltf(1.0f);
+        byte[] edited = CreateTriangleGltf(2.0f);
+
+        fixed (byte* originalPtr = original)
+        fixed (byte* editedPtr = edited)
+        {
+            Scene* live = alimerSceneLoadCached(_cachePath, originalPtr, (nuint)original.Length, null);
+            Assert.That(live != null, Is.True);
+
+            // The cache is replaced while the first scene still maps the old file.
+            Scene* rebuilt = alimerSceneLoadCached(_cachePath, editedPtr, (nuint)edited.Length, null);
+            Assert.That(rebuilt != null, Is.True);
+            Assert.That(rebuilt->nodes[0].translation.X, Is.EqualTo(2.0f));
+            Assert.That(live->nodes[0].translation.X, Is.EqualTo(1.0f));
+            Assert.That(File.Exists(_cachePath + ".tmp"), Is.False);
+
+            alimerSceneDestroy(rebuilt);
+            alimerSceneDestroy(live);
+        }
+    }
+
+    [Test]
+    public void Test_LoadCached_CorruptCacheIsRejected()
+    {
+        File.WriteAllText(_cachePath, "not a scene cache");
+
+        Assert.That(alimerSceneLoadCached(_cachePath, null, 0, null) == null, Is.True);
+
+        byte[] source = CreateTriangleGltf(1.0f);
+        fixed (byte* sourcePtr = source)
+        {
+            Scene* scene = alimerSceneLoadCached(_cachePath, sourcePtr, (nuint)source.Length, null);
+            Assert.That(scene != null, Is.True);
+            Assert.That(scene->meshCount, Is.EqualTo(1u));
+            alimerSceneDestroy(scene);
+        }
+    }
+
+    private static void AssertScenesEqual(Scene* expected, Scene* actual)
+    {
+        Assert.That(actual->meshCount, Is.EqualTo(expected->meshCount));
+        Assert.That(actual->materialCount, Is.EqualTo(expected->materialCount));
+        Assert.That(actual->nodeCount, Is.EqualTo(expected->nodeCount));
+
+        for (uint i = 0; i < expected->nodeCount; i++)
+        {
+            Assert.That(actual->nodes[i].parentIndex, Is.EqualTo(expected->nodes[i].parentIndex));
+            Assert.That(actual->nodes[i].meshIndex, Is.EqualTo(expected->nodes[i].meshIndex));
+            Assert.That(actual->nodes[i].translation, Is.EqualTo(expected->nodes[i].translation));
+        }
+    }
+
+    /// <summary>
+    /// Root node translated on X with a child triangle mesh, the buffer is embedded as a data URI.
+    /// </summary>
+    private static byte[] CreateTriangleGltf(float rootX)
+    {
+        using MemoryStream stream = new();
+        using (BinaryWriter writer = new(stream))
+        {
+            Vector3[] positions = [new(0.0f, 0.0f, 0.0f), new(1.0f, 0.0f, 0.0f), new(0.0f, 1.0f, 0.0f)];
+            foreach (Vector3 position in positions)
+            {
+                writer.Write(position.X);
+                writer.Write(position.Y);
+                writer.Write(position.Z);
+            }
+
+            writer.Write((ushort)0);
+            writer.Write((ushort)1);
+            writer.Write((ushort)2);
+            writer.Write((ushort)0);
+        }
+
+        string buffer = Convert.ToBase64String(stream.ToArray());
+        string translation = rootX.ToString(CultureInfo.InvariantCulture);
+        string json =
+            "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}]," +
+            $"\"nodes\":[{{\"name\":\"root\",\"translation\":[{translation},0,0],\"children\":[1]}},{{\"name\":\"triangle\",\"mesh\":0}}]," +
+            "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0},\"indices\":1}]}]," +
+            $"\"buffers\":[{{\"byteLength\":44,\"uri\":\"data:application/octet-stream;base64,{buffer}\"}}]," +
+            "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":36},{\"buffer\":0,\"byteOffset\":36,\"byteLength\":6}]," +
+            "\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":3,\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[1,1,0]}," +
+            "{\"bufferView\":1,\"componentType\":5123,\"count\":3,\"type\":\"SCALAR\"}]}";
+
+        return Encoding.UTF8.GetBytes(json);
+    }
+}
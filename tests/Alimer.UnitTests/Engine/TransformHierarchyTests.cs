@@ -0,0 +1,141 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+using System.Numerics;
+using NUnit.Framework;
+using static Alimer.AlimerApi;
+
+namespace Alimer.Engine;
+
+[TestFixture(TestOf = typeof(AlimerApi))]
+public unsafe class TransformHierarchyTests
+{
+    [TestCase(2, 2, 4)]
+    // Levels above 4096 nodes are propagated by the job system.
+    [TestCase(4, 16, 4)]
+    public void Test_Update_MatchesReference(int rootCount, int childCount, int depth)
+    {
+        int[] parents = CreateParents(rootCount, childCount, depth);
+        nint hierarchy = CreateHierarchy(parents);
+        Assert.That(alimerTransformHierarchyGetNodeCount(hierarchy), Is.EqualTo((uint)parents.Length));
+
+        Vector3[] translations = new Vector3[parents.Length];
+        Quaternion[] rotations = new Quaternion[parents.Length];
+        for (int i = 0; i < parents.Length; i++)
+        {
+            translations[i] = new Vector3(i % 7 * 0.25f, 1.0f, i % 3 * -0.5f);
+            rotations[i] = Quaternion.CreateFromAxisAngle(Vector3.UnitY, i % 5 * 0.1f);
+            SetLocal(hierarchy, i, translations[i], rotations[i]);
+        }
+
+        alimerTransformHierarchyUpdate(hierarchy);
+        AssertWorldMatrices(hierarchy, parents, translations, rotations);
+
+        alimerTransformHierarchyDestroy(hierarchy);
+    }
+
+    [Test]
+    public void Test_Update_PropagatesRootChange()
+    {
+        int[] parents = CreateParents(4, 16, 4);
+        nint hierarchy = CreateHierarchy(parents);
+
+        Vector3[] translations = new Vector3[parents.Length];
+        Quaternion[] rotations = new Quaternion[parents.Length];
+        Array.Fill(rotations, Quaternion.Identity);
+
+        alimerTransformHierarchyUpdate(hierarchy);
+        Matrix4x4 untouchedWorld = alimerTransformHierarchyGetWorldMatrices(hierarchy)[parents.Length - 1];
+
+        // Only the subtree of the first root moves.
+        translations[0] = new Vector3(10.0f, 0.0f, 0.0f);
+        SetLocal(hierarchy, 0, translations[0], rotations[0]);
+        alimerTransformHierarchyUpdate(hierarchy);
+
+        AssertWorldMatrices(hierarchy, parents, translations, rotations);
+        Assert.That(alimerTransformHierarchyGetWorldMatrices(hierarchy)[parents.Length - 1], Is.EqualTo(untouchedWorld));
+
+        alimerTransformHierarchyDestroy(hierarchy);
+    }
+
+    /// <summary>
+    /// Breadth-first parent indices of rootCount trees where every node has childCount children.
+    /// </summary>
+    private static int[] CreateParents(int rootCount, int childCount, int depth)
+    {
+        List<int> parents = [];
+        int levelBegin = 0;
+        int levelCount = rootCount;
+        for (int i = 0; i < rootCount; i++)
+        {
+            parents.Add(-1);
+        }
+
+        for (int level = 1; level < depth; level++)
+        {
+            for (int parent = levelBegin; parent < levelBegin + levelCount; parent++)
+            {
+                for (int child = 0; child < childCount; child++)
+                {
+                    parents.Add(parent);
+                }
+            }
+
+            levelBegin += levelCount;
+            levelCount *= childCount;
+        }
+
+        return [.. parents];
+    }
+
+    private static nint CreateHierarchy(int[] parents)
+    {
+        fixed (int* parentsPtr = parents)
+        {
+            nint hierarchy = alimerTransformHierarchyCreate((uint)parents.Length, parentsPtr);
+            Assert.That(hierarchy, Is.Not.EqualTo(nint.Zero));
+            return hierarchy;
+        }
+    }
+
+    private static void SetLocal(nint hierarchy, int nodeIndex, Vector3 translation, Quaternion rotation)
+    {
+        Vector4 rotationVector = new(rotation.X, rotation.Y, rotation.Z, rotation.W);
+        Vector3 scale = Vector3.One;
+        alimerTransformHierarchySetLocal(hierarchy, (uint)nodeIndex, &translation, &rotationVector, &scale);
+    }
+
+    private static void AssertWorldMatrices(nint hierarchy, int[] parents, Vector3[] translations, Quaternion[] rotations)
+    {
+        Matrix4x4* worldMatrices = alimerTransformHierarchyGetWorldMatrices(hierarchy);
+        Matrix4x4[] expected = new Matrix4x4[parents.Length];
+        int mismatchCount = 0;
+
+        for (int i = 0; i < parents.Length; i++)
+        {
+            Matrix4x4 local = Matrix4x4.CreateFromQuaternion(rotations[i]) * Matrix4x4.CreateTranslation(translations[i]);
+            expected[i] = parents[i] < 0 ? local : local * expected[parents[i]];
+
+            if (!NearEqual(worldMatrices[i], expected[i]))
+            {
+                mismatchCount++;
+            }
+        }
+
+        Assert.That(mismatchCount, Is.EqualTo(0));
+    }
+
+    private static bool NearEqual(in Matrix4x4 left, in Matrix4x4 right)
+    {
+        for (int row = 0; row < 4; row++)
+        {
+            for (int column = 0; column < 4; column++)
+            {
+                if (MathF.Abs(left[row, column] - right[row, column]) > 1e-3f)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,48 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+using static Alimer.Graphics.Native.AlimerGPUApi;
+
+namespace Alimer.Graphics.Tests;
+
+/// <summary>
+/// Creates a device through the native alimer_gpu library, for tests of behavior that lives in the native backends.
+/// </summary>
+public abstract unsafe class NativeDeviceTestBase : IDisposable
+{
+    public GraphicsBackend BackendType { get; }
+
+    internal GPUFactory Factory { get; }
+    internal GPUAdapter Adapter { get; }
+    internal GPUDevice Device { get; }
+
+    protected NativeDeviceTestBase(GraphicsBackend backendType)
+    {
+        BackendType = backendType;
+
+        GPUFactoryDesc factoryDesc = new()
+        {
+            preferredBackend = backendType,
+#if DEBUG
+            validationMode = GraphicsValidationMode.Enabled
+#endif
+        };
+
+        Factory = agpuCreateFactory(&factoryDesc);
+        Adapter = agpuFactoryGetBestAdapter(Factory);
+
+        GPUDeviceDesc deviceDesc = new()
+        {
+            maxFramesInFlight = 2
+        };
+        Device = agpuCreateDevice(Adapter, &deviceDesc);
+    }
+
+    public void Dispose()
+    {
+        agpuDeviceWaitIdle(Device);
+        agpuDeviceRelease(Device);
+        agpuFactoryDestroy(Factory);
+        GC.SuppressFinalize(this);
+    }
+}
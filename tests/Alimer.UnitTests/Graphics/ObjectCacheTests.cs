@@ -0,0 +1,103 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+using System.Text;
+using NUnit.Framework;
+using static Alimer.Graphics.Native.AlimerGPUApi;
+
+namespace Alimer.Graphics.Tests;
+
+[TestFixture(TestOf = typeof(Sampler))]
+public abstract unsafe class ObjectCacheTests : NativeDeviceTestBase
+{
+    protected ObjectCacheTests(GraphicsBackend backendType)
+        : base(backendType)
+    {
+    }
+
+    [Test]
+    public void Test_CreateSampler_SameDescReturnsCachedObject()
+    {
+        // The label isn't part of the cache key.
+        GPUSampler first = CreateSampler("First", GPU_LOD_CLAMP_NONE);
+        GPUSampler second = CreateSampler("Second", GPU_LOD_CLAMP_NONE);
+        Assert.That(second, Is.EqualTo(first));
+
+        // Each create returns its own reference.
+        Assert.That(agpuSamplerAddRef(first), Is.EqualTo(3u));
+        Assert.That(agpuSamplerRelease(first), Is.EqualTo(2u));
+
+        agpuSamplerRelease(second);
+        agpuSamplerRelease(first);
+    }
+
+    [Test]
+    public void Test_CreateSampler_DifferentDescReturnsNewObject()
+    {
+        GPUSampler first = CreateSampler("First", GPU_LOD_CLAMP_NONE);
+        GPUSampler second = CreateSampler("Second", 4.0f);
+        Assert.That(second, Is.Not.EqualTo(first));
+
+        Assert.That(agpuSamplerRelease(second), Is.EqualTo(0u));
+        Assert.That(agpuSamplerRelease(first), Is.EqualTo(0u));
+    }
+
+    [Test]
+    public void Test_CreateSampler_ReleasedObjectLeavesCache()
+    {
+        GPUSampler first = CreateSampler("First", GPU_LOD_CLAMP_NONE);
+        Assert.That(agpuSamplerRelease(first), Is.EqualTo(0u));
+
+        // The destroyed sampler is dropped from the cache, the next create starts with a single reference.
+        GPUSampler second = CreateSampler("Second", GPU_LOD_CLAMP_NONE);
+        Assert.That(agpuSamplerAddRef(second), Is.EqualTo(2u));
+
+        agpuSamplerRelease(second);
+        agpuSamplerRelease(second);
+    }
+
+    private GPUSampler CreateSampler(string label, float lodMaxClamp)
+    {
+        byte[] labelBytes = Encoding.UTF8.GetBytes(label + '\0');
+        fixed (byte* labelPtr = labelBytes)
+        {
+            // The native defaults aren't applied to a zeroed desc, set every field.
+            GPUSamplerDesc desc = new()
+            {
+                label = labelPtr,
+                minFilter = GPUSamplerMinMagFilter.Linear,
+                magFilter = GPUSamplerMinMagFilter.Linear,
+                mipFilter = GPUSamplerMipFilter.Linear,
+                addressModeU = GPUSamplerAddressMode.Repeat,
+                addressModeV = GPUSamplerAddressMode.Repeat,
+                addressModeW = GPUSamplerAddressMode.Repeat,
+                maxAnisotropy = 1,
+                compareFunction = GPUCompareFunction.Never,
+                lodMinClamp = 0.0f,
+                lodMaxClamp = lodMaxClamp
+            };
+
+            GPUSampler sampler = agpuDeviceCreateSampler(Device, &desc);
+            Assert.That(sampler.IsNotNull, Is.True);
+            return sampler;
+        }
+    }
+}
+
+[TestFixture(TestOf = typeof(Sampler))]
+public class D3D12ObjectCacheTests : ObjectCacheTests
+{
+    public D3D12ObjectCacheTests()
+        : base(GraphicsBackend.Direct3D12)
+    {
+    }
+}
+
+[TestFixture(TestOf = typeof(Sampler))]
+public class VulkanObjectCacheTests : ObjectCacheTests
+{
+    public VulkanObjectCacheTests()
+        : base(GraphicsBackend.Vulkan)
+    {
+    }
+}
@@ -0,0 +1,167 @@
+// Copyright (c) Amer Koleci and Contributors.
+// Licensed under the MIT License (MIT). See LICENSE in the repository root for more information.
+
+using NUnit.Framework;
+using static Alimer.Graphics.Native.AlimerGPUApi;
+
+namespace Alimer.Graphics.Tests;
+
+[TestFixture(TestOf = typeof(CommandQueue))]
+public abstract unsafe class UploadTests : NativeDeviceTestBase
+{
+    private const ulong MiB = 1024 * 1024;
+
+    protected UploadTests(GraphicsBackend backendType)
+        : base(backendType)
+    {
+    }
+
+    [Test]
+    public void Test_WriteBuffer_WrapsUploadRing()
+    {
+        // 104 MiB of 8 MiB writes wraps the 64 MiB upload ring, the 20 MiB write gets a dedicated upload buffer.
+        GPUCommandQueue queue = agpuDeviceGetCommandQueue(Device, CommandQueueType.Graphics);
+        GPUBuffer buffer = CreateBuffer(128 * MiB, MemoryType.Readback);
+        byte[] expected = new byte[128 * MiB];
+
+        List<ulong> tickets = [];
+        for (ulong offset = 0; offset < 104 * MiB; offset += 8 * MiB)
+        {
+            tickets.Add(Write(queue, buffer, expected, offset, 8 * MiB, (byte)(offset / MiB + 1)));
+        }
+        tickets.Add(Write(queue, buffer, expected, 104 * MiB, 20 * MiB, 0xAB));
+
+        Assert.That(ReadWritten(buffer, tickets), Is.EqualTo(expected));
+        agpuBufferRelease(buffer);
+    }
+
+    [Test]
+    public void Test_WriteBuffer_BatchesSmallWrites()
+    {
+        GPUCommandQueue queue = agpuDeviceGetCommandQueue(Device, CommandQueueType.Graphics);
+        GPUBuffer buffer = CreateBuffer(64 * 1000, MemoryType.Readback);
+        byte[] expected = new byte[64 * 1000];
+
+        List<ulong> tickets = [];
+        for (int i = 0; i < 1000; i++)
+        {
+            tickets.Add(Write(queue, buffer, expected, (ulong)i * 64, 64, (byte)i));
+        }
+
+        Assert.That(ReadWritten(buffer, tickets), Is.EqualTo(expected));
+        agpuBufferRelease(buffer);
+    }
+
+    [Test]
+    public void Test_WriteBuffer_UploadMemory()
+    {
+        GPUCommandQueue queue = agpuDeviceGetCommandQueue(Device, CommandQueueType.Graphics);
+        GPUBuffer buffer = CreateBuffer(MiB, MemoryType.Upload);
+        byte[] expected = new byte[MiB];
+
+        List<ulong> tickets =
+        [
+            Write(queue, buffer, expected, 0, 512 * 1024, 0x11),
+            Write(queue, buffer, expected, 512 * 1024, 1024, 0x22)
+        ];
+
+        Assert.That(CopyAndRead(queue, buffer, tickets), Is.EqualTo(expected));
+        agpuBufferRelease(buffer);
+    }
+
+    private GPUBuffer CreateBuffer(ulong size, MemoryType memoryType)
+    {
+        GPUBufferDesc desc = new()
+        {
+            size = size,
+            usage = GPUBufferUsage.ShaderRead,
+            memoryType = memoryType
+        };
+
+        GPUBuffer buffer = agpuDeviceCreateBuffer(Device, &desc, null);
+        Assert.That(buffer.IsNotNull, Is.True);
+        return buffer;
+    }
+
+    /// <summary>
+    /// Fill size bytes at offset with value, both in the buffer and in expected.
+    /// </summary>
+    private static ulong Write(GPUCommandQueue queue, GPUBuffer buffer, byte[] expected, ulong offset, ulong size, byte value)
+    {
+        Span<byte> range = expected.AsSpan((int)offset, (int)size);
+        range.Fill(value);
+
+        fixed (byte* dataPtr = range)
+        {
+            return agpuCommandQueueWriteBuffer(queue, buffer, offset, dataPtr, size);
+        }
+    }
+
+    /// <summary>
+    /// Read a readback buffer once the writes completed. The writes target readback memory directly,
+    /// Vulkan private buffers can't be copy sources.
+    /// </summary>
+    private byte[] ReadWritten(GPUBuffer buffer, List<ulong> tickets)
+    {
+        foreach (ulong ticket in tickets.Distinct())
+        {
+            agpuDeviceWaitUpload(Device, ticket);
+        }
+
+        return Read(buffer);
+    }
+
+    /// <summary>
+    /// Copy the buffer to a readback buffer on the queue once the writes completed and read it.
+    /// </summary>
+    private byte[] CopyAndRead(GPUCommandQueue queue, GPUBuffer buffer, List<ulong> tickets)
+    {
+        ulong size = agpuBufferGetSize(buffer);
+        GPUBuffer readback = CreateBuffer(size, MemoryType.Readback);
+
+        GPUCommandBuffer commandBuffer = agpuCommandQueueAcquireCommandBuffer(queue, null);
+        foreach (ulong ticket in tickets.Distinct())
+        {
+            agpuCommandBufferWaitUpload(commandBuffer, ticket);
+        }
+        GPUCopyPassEncoder copyPass = agpuCommandBufferBeginCopyPass(commandBuffer, null);
+        agpuCopyPassEncoderCopyBufferToBuffer(copyPass, buffer, 0, readback, 0, size);
+        agpuCopyPassEncoderEnd(copyPass);
+        agpuCommandQueueSubmit(queue, 1, &commandBuffer);
+        agpuDeviceWaitIdle(Device);
+
+        byte[] data = Read(readback);
+        agpuBufferRelease(readback);
+        return data;
+    }
+
+    private byte[] Read(GPUBuffer readback)
+    {
+        ulong size = agpuBufferGetSize(readback);
+        agpuBufferMapAsync(readback, GPUMapMode.Read, 0, GPU_WHOLE_SIZE, null, 0);
+        agpuDeviceProcessEvents(Device);
+        Assert.That(agpuBufferGetMapState(readback), Is.EqualTo(GPUBufferMapState.Mapped));
+
+        byte[] data = new ReadOnlySpan<byte>(agpuBufferGetConstMappedRange(readback, 0, size), (int)size).ToArray();
+        agpuBufferUnmap(readback);
+        return data;
+    }
+}
+
+[TestFixture(TestOf = typeof(CommandQueue))]
+public class D3D12UploadTests : UploadTests
+{
+    public D3D12UploadTests()
+        : base(GraphicsBackend.Direct3D12)
+    {
+    }
+}
+
+[TestFixture(TestOf = typeof(CommandQueue))]
+public class VulkanUploadTests : UploadTests
+{
+    public VulkanUploadTests()
+        : base(GraphicsBackend.Vulkan)
+    {
+    }
+}